@@ -0,0 +1,169 @@
+#include <Managers/EventManager.h>
+
+#include <any>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+
+//Microbenchmark comparing NK::EventManager against the old std::any/std::function implementation
+//Mirrors the ECS hot path - Registry fires a ComponentAddEvent-sized packet on every structural change, and a couple of layers are subscribed to it
+
+
+
+//Copy of the previous EventManager (comments stripped) so the comparison stays honest as the real one evolves
+class LegacyEventManager final
+{
+public:
+	template<typename EventPacket>
+	static inline NK::EventSubscriptionID Subscribe(std::function<void(const EventPacket&)> _callback)
+	{
+		const NK::EventSubscriptionID id{ m_nextID++ };
+		const std::function<void(const std::any&)> wrapper
+		{
+			[_callback](const std::any& _data)
+			{
+				_callback(std::any_cast<const EventPacket&>(_data));
+			}
+		};
+		m_callbacks[std::type_index(typeid(EventPacket))][id] = wrapper;
+		return id;
+	}
+
+
+	template<typename Class, typename EventPacket>
+	static inline NK::EventSubscriptionID Subscribe(Class* _classInstance, std::function<void(Class*, const EventPacket&)> _memberCallback)
+	{
+		return Subscribe<EventPacket>(std::bind(_memberCallback, _classInstance, std::placeholders::_1));
+	}
+
+
+	template<typename EventPacket>
+	static inline void Unsubscribe(const NK::EventSubscriptionID _subscriptionID)
+	{
+		std::unordered_map<NK::EventSubscriptionID, std::function<void(const std::any&)>>& callbacks{ m_callbacks[std::type_index(typeid(EventPacket))] };
+		if (callbacks.erase(_subscriptionID) == 0)
+		{
+			throw std::runtime_error("LegacyEventManager::Unsubscribe() - provided subscription id is not subscribed to the provided event type");
+		}
+	}
+
+
+	template<typename EventPacket>
+	static inline void Trigger(const EventPacket& _packet)
+	{
+		const std::unordered_map<std::type_index, std::unordered_map<NK::EventSubscriptionID, std::function<void(const std::any&)>>>::iterator it{ m_callbacks.find(std::type_index(typeid(EventPacket))) };
+		if (it == m_callbacks.end())
+		{
+			return;
+		}
+		for (std::unordered_map<NK::EventSubscriptionID, std::function<void(const std::any&)>>::const_iterator callbacksIt{ it->second.begin() }; callbacksIt != it->second.end(); ++callbacksIt)
+		{
+			callbacksIt->second(_packet);
+		}
+	}
+
+
+private:
+	static inline std::atomic<NK::EventSubscriptionID> m_nextID{ 0 };
+	static inline std::unordered_map<std::type_index, std::unordered_map<NK::EventSubscriptionID, std::function<void(const std::any&)>>> m_callbacks;
+};
+
+
+
+//Same shape as NK::ComponentAddEvent without dragging the registry in
+struct BenchComponentEvent
+{
+	void* reg;
+	std::uint32_t entity;
+	std::type_index type;
+};
+
+
+
+class Listener
+{
+public:
+	void OnEvent(const BenchComponentEvent& _event) { m_sum += _event.entity; }
+	[[nodiscard]] std::uint64_t GetSum() const { return m_sum; }
+
+
+private:
+	std::uint64_t m_sum{ 0 };
+};
+
+
+
+template<typename Func>
+[[nodiscard]] static double TimeNsPerOp(const std::uint64_t _iterations, Func&& _func)
+{
+	const std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+	for (std::uint64_t i{ 0 }; i < _iterations; ++i)
+	{
+		_func(i);
+	}
+	const std::chrono::steady_clock::time_point end{ std::chrono::steady_clock::now() };
+	return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(_iterations);
+}
+
+
+
+static void RunCase(const std::size_t _subscriberCount, const std::uint64_t _iterations)
+{
+	std::vector<Listener> legacyListeners(_subscriberCount);
+	std::vector<Listener> listeners(_subscriberCount);
+	std::vector<NK::EventSubscriptionID> legacyIDs;
+	std::vector<NK::EventSubscriptionID> ids;
+	for (std::size_t i{ 0 }; i < _subscriberCount; ++i)
+	{
+		legacyIDs.push_back(LegacyEventManager::Subscribe<Listener, BenchComponentEvent>(&legacyListeners[i], &Listener::OnEvent));
+		ids.push_back(NK::EventManager::Subscribe<Listener, BenchComponentEvent>(&listeners[i], &Listener::OnEvent));
+	}
+
+	BenchComponentEvent event{ nullptr, 0, std::type_index(typeid(Listener)) };
+
+	//Warm up both paths so neither pays for first-touch page faults in the timed section
+	for (std::uint64_t i{ 0 }; i < _iterations / 10; ++i) { LegacyEventManager::Trigger(event); NK::EventManager::Trigger(event); }
+
+	const double legacyNs{ TimeNsPerOp(_iterations, [&](const std::uint64_t _i) { event.entity = static_cast<std::uint32_t>(_i); LegacyEventManager::Trigger(event); }) };
+	const double typedNs{ TimeNsPerOp(_iterations, [&](const std::uint64_t _i) { event.entity = static_cast<std::uint32_t>(_i); NK::EventManager::Trigger(event); }) };
+
+	//Checksums stop the optimiser from throwing the callbacks away and confirm both buses delivered the same events
+	std::uint64_t legacySum{ 0 };
+	std::uint64_t typedSum{ 0 };
+	for (const Listener& listener : legacyListeners) { legacySum += listener.GetSum(); }
+	for (const Listener& listener : listeners) { typedSum += listener.GetSum(); }
+
+	std::cout << std::left << std::setw(14) << _subscriberCount
+	          << std::setw(18) << std::fixed << std::setprecision(2) << legacyNs
+	          << std::setw(18) << typedNs
+	          << std::setw(10) << (legacyNs / typedNs)
+	          << (legacySum == typedSum ? "ok" : "MISMATCH") << '\n';
+
+	for (const NK::EventSubscriptionID id : legacyIDs) { LegacyEventManager::Unsubscribe<BenchComponentEvent>(id); }
+	for (const NK::EventSubscriptionID id : ids) { NK::EventManager::Unsubscribe<BenchComponentEvent>(id); }
+}
+
+
+
+int main(const int _argc, char** _argv)
+{
+	const std::uint64_t iterations{ _argc > 1 ? std::stoull(_argv[1]) : 1'000'000ull };
+
+	std::cout << "EventBus microbenchmark - " << iterations << " triggers per case\n";
+	std::cout << std::left << std::setw(14) << "subscribers" << std::setw(18) << "legacy ns/trigger" << std::setw(18) << "typed ns/trigger" << std::setw(10) << "speedup" << "checksum\n";
+
+	for (const std::size_t subscriberCount : { 1u, 2u, 4u, 16u })
+	{
+		RunCase(subscriberCount, iterations);
+	}
+
+	return 0;
+}
@@ -0,0 +1,519 @@
+#include <Components/CBoxCollider.h>
+#include <Components/CNetworkSync.h>
+#include <Components/CPhysicsBody.h>
+#include <Components/CTransform.h>
+#include <Core/Context.h>
+#include <Core/RAIIContext.h>
+#include <Core/Memory/FreeListAllocator.h>
+#include <Core/Utils/ModelLoader.h>
+#include <Core/Utils/TextureCompressor.h>
+#include <Core-ECS/Registry.h>
+#include <Managers/EventManager.h>
+#include <Networking/NetworkTransformCodec.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+//Microbenchmarks for the engine's hot paths, each timed in isolation - for comparing commit to commit, alongside NekiBench's whole-scene runs
+//Usage: NekiMicroBench [filter] [repeats]
+//- filter: only run benchmarks whose name contains this (default: run everything)
+//- repeats: how many times each benchmark is run - the median, min and max ns/op across them are reported (default: 7)
+//
+//Output is stable and tab-separated so runs can be diffed or pasted straight into a spreadsheet:
+//	# NekiMicroBench v1 - <repeats> repeats
+//	benchmark	ops	median_ns	min_ns	max_ns
+//	<group>/<name>	<ops per repeat>	<ns per op>	<ns per op>	<ns per op>
+//Benchmarks whose inputs are missing print "skipped" and a reason instead of the numbers - the file benchmarks need the sample resources, so run from the build directory
+//Names are never changed once added (add a new one instead) so old results stay comparable
+
+
+
+//Written to so the optimiser can't throw the benchmarked work away
+static volatile std::uint64_t sink{ 0 };
+static inline void Consume(const std::uint64_t _value) { sink = sink + _value; }
+static inline void Consume(const float _value) { Consume(static_cast<std::uint64_t>(std::bit_cast<std::uint32_t>(_value))); }
+
+
+
+//One repeat of a benchmark - only what's inside Time() is measured, so fixtures can be built and torn down around it
+class BenchRun final
+{
+public:
+	template<typename Func>
+	inline void Time(const std::uint64_t _ops, Func&& _func)
+	{
+		const std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+		_func();
+		m_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		m_ops += _ops;
+	}
+
+	inline void Skip(const std::string& _reason) { m_skipReason = _reason; }
+
+	[[nodiscard]] inline double GetNsPerOp() const { return m_ops ? m_ns / static_cast<double>(m_ops) : 0.0; }
+	[[nodiscard]] inline std::uint64_t GetOps() const { return m_ops; }
+	[[nodiscard]] inline const std::string& GetSkipReason() const { return m_skipReason; }
+
+
+private:
+	double m_ns{ 0.0 };
+	std::uint64_t m_ops{ 0 };
+	std::string m_skipReason;
+};
+
+
+
+static constexpr std::uint32_t ENTITY_COUNT{ 10'000 };
+
+
+//ENTITY_COUNT entities, each with the first _componentCount of CTransform / CNetworkSync / CPhysicsBody / CBoxCollider
+static void PopulateRegistry(NK::Registry& _reg, const std::size_t _componentCount)
+{
+	for (std::uint32_t i{ 0 }; i < ENTITY_COUNT; ++i)
+	{
+		const NK::Entity entity{ _reg.Create() };
+		_reg.GetComponent<NK::CTransform>(entity).SetLocalPosition({ static_cast<float>(i), 0.0f, 0.0f });
+		if (_componentCount > 1) { _reg.AddComponent<NK::CNetworkSync>(entity).networkID = i; }
+		if (_componentCount > 2) { _reg.AddComponent<NK::CPhysicsBody>(entity); }
+		if (_componentCount > 3) { _reg.AddComponent<NK::CBoxCollider>(entity); }
+	}
+}
+
+
+
+//Registry
+static void BenchRegistryCreateDestroy(BenchRun& _run)
+{
+	NK::Registry reg{ ENTITY_COUNT };
+	std::vector<NK::Entity> entities(ENTITY_COUNT);
+	_run.Time(ENTITY_COUNT, [&]()
+	{
+		for (NK::Entity& entity : entities) { entity = reg.Create(); }
+		for (const NK::Entity entity : entities) { reg.Destroy(entity); }
+	});
+}
+
+
+static void BenchRegistryAddComponent(BenchRun& _run)
+{
+	NK::Registry reg{ ENTITY_COUNT };
+	PopulateRegistry(reg, 1);
+	std::vector<NK::Entity> entities;
+	for (auto&& [transform] : reg.View<NK::CTransform>()) { entities.push_back(reg.GetEntity(transform)); }
+
+	_run.Time(ENTITY_COUNT, [&]()
+	{
+		for (const NK::Entity entity : entities) { reg.AddComponent<NK::CNetworkSync>(entity); }
+	});
+}
+
+
+static void BenchRegistryRemoveComponent(BenchRun& _run)
+{
+	NK::Registry reg{ ENTITY_COUNT };
+	PopulateRegistry(reg, 2);
+	std::vector<NK::Entity> entities;
+	for (auto&& [transform] : reg.View<NK::CTransform>()) { entities.push_back(reg.GetEntity(transform)); }
+
+	_run.Time(ENTITY_COUNT, [&]()
+	{
+		for (const NK::Entity entity : entities) { reg.RemoveComponent<NK::CNetworkSync>(entity); }
+	});
+}
+
+
+static void BenchRegistryGetComponent(BenchRun& _run)
+{
+	NK::Registry reg{ ENTITY_COUNT };
+	PopulateRegistry(reg, 2);
+	std::vector<NK::Entity> entities;
+	for (auto&& [transform] : reg.View<NK::CTransform>()) { entities.push_back(reg.GetEntity(transform)); }
+
+	_run.Time(ENTITY_COUNT, [&]()
+	{
+		for (const NK::Entity entity : entities) { Consume(static_cast<std::uint64_t>(reg.GetComponent<NK::CNetworkSync>(entity).networkID)); }
+	});
+}
+
+
+static void BenchView1(BenchRun& _run)
+{
+	NK::Registry reg{ ENTITY_COUNT };
+	PopulateRegistry(reg, 1);
+	_run.Time(ENTITY_COUNT, [&]()
+	{
+		for (auto&& [transform] : reg.View<NK::CTransform>()) { Consume(transform.GetLocalPosition().x); }
+	});
+}
+
+
+static void BenchView2(BenchRun& _run)
+{
+	NK::Registry reg{ ENTITY_COUNT };
+	PopulateRegistry(reg, 2);
+	_run.Time(ENTITY_COUNT, [&]()
+	{
+		for (auto&& [transform, networkSync] : reg.View<NK::CTransform, NK::CNetworkSync>()) { Consume(transform.GetLocalPosition().x); Consume(static_cast<std::uint64_t>(networkSync.networkID)); }
+	});
+}
+
+
+static void BenchView3(BenchRun& _run)
+{
+	NK::Registry reg{ ENTITY_COUNT };
+	PopulateRegistry(reg, 3);
+	_run.Time(ENTITY_COUNT, [&]()
+	{
+		for (auto&& [transform, networkSync, physicsBody] : reg.View<NK::CTransform, NK::CNetworkSync, NK::CPhysicsBody>()) { Consume(transform.GetLocalPosition().x + physicsBody.GetMass()); Consume(static_cast<std::uint64_t>(networkSync.networkID)); }
+	});
+}
+
+
+static void BenchView4(BenchRun& _run)
+{
+	NK::Registry reg{ ENTITY_COUNT };
+	PopulateRegistry(reg, 4);
+	_run.Time(ENTITY_COUNT, [&]()
+	{
+		for (auto&& [transform, networkSync, physicsBody, boxCollider] : reg.View<NK::CTransform, NK::CNetworkSync, NK::CPhysicsBody, NK::CBoxCollider>()) { Consume(transform.GetLocalPosition().x + physicsBody.GetMass() + boxCollider.GetHalfExtents().x); Consume(static_cast<std::uint64_t>(networkSync.networkID)); }
+	});
+}
+
+
+static void BenchRegistrySave(BenchRun& _run)
+{
+	NK::Registry reg{ ENTITY_COUNT };
+	PopulateRegistry(reg, 4);
+	const std::string path{ (std::filesystem::temp_directory_path() / "NekiMicroBench.nkscene").string() };
+	_run.Time(ENTITY_COUNT, [&]() { reg.Save(path); });
+	std::filesystem::remove(path);
+}
+
+
+static void BenchRegistryLoad(BenchRun& _run)
+{
+	const std::string path{ (std::filesystem::temp_directory_path() / "NekiMicroBench.nkscene").string() };
+	{
+		NK::Registry reg{ ENTITY_COUNT };
+		PopulateRegistry(reg, 4);
+		reg.Save(path);
+	}
+	NK::Registry reg{ ENTITY_COUNT };
+	_run.Time(ENTITY_COUNT, [&]() { reg.Load(path); });
+	std::filesystem::remove(path);
+}
+
+
+
+//Events
+struct MicroBenchEvent
+{
+	std::uint32_t value;
+};
+
+
+static void BenchEventTrigger(BenchRun& _run)
+{
+	constexpr std::uint64_t triggers{ 100'000 };
+	std::uint64_t sum{ 0 };
+	std::vector<NK::EventSubscriptionID> ids;
+	for (std::size_t i{ 0 }; i < 4; ++i)
+	{
+		ids.push_back(NK::EventManager::Subscribe<MicroBenchEvent>([&sum](const MicroBenchEvent& _event) { sum += _event.value; }));
+	}
+
+	_run.Time(triggers, [&]()
+	{
+		for (std::uint64_t i{ 0 }; i < triggers; ++i) { NK::EventManager::Trigger(MicroBenchEvent{ static_cast<std::uint32_t>(i) }); }
+	});
+
+	Consume(sum);
+	for (const NK::EventSubscriptionID id : ids) { NK::EventManager::Unsubscribe<MicroBenchEvent>(id); }
+}
+
+
+
+//Jobs
+//Lots of small ParallelFor()s over one-element chunks - mostly job overhead, and the counter on ParallelFor()'s stack is created and destroyed thousands of times while workers are still finishing with it (worth running under tsan / asan after touching JobSystem)
+static void BenchParallelForTinyChunks(BenchRun& _run)
+{
+	constexpr std::uint64_t calls{ 5'000 };
+	constexpr std::size_t chunks{ 64 };
+	NK::JobSystem& jobSystem{ *NK::Context::GetJobSystem() };
+	std::atomic<std::uint64_t> sum{ 0 };
+
+	_run.Time(calls, [&]()
+	{
+		for (std::uint64_t i{ 0 }; i < calls; ++i)
+		{
+			jobSystem.ParallelFor(chunks, 1, [&sum](const std::size_t _index) { sum.fetch_add(_index, std::memory_order_relaxed); });
+		}
+	});
+
+	Consume(sum.load());
+}
+
+
+
+//Allocators
+static void BenchFreeListAllocator(BenchRun& _run)
+{
+	NK::FreeListAllocator allocator{ ENTITY_COUNT };
+	std::vector<std::uint32_t> indices(ENTITY_COUNT);
+	_run.Time(ENTITY_COUNT, [&]()
+	{
+		for (std::uint32_t& index : indices) { index = allocator.Allocate(); }
+		for (const std::uint32_t index : indices) { allocator.Free(index); }
+	});
+}
+
+
+static void BenchTrackingAllocator(BenchRun& _run)
+{
+	NK::IAllocator& allocator{ *NK::Context::GetAllocator() };
+	std::vector<void*> allocations(ENTITY_COUNT);
+	_run.Time(ENTITY_COUNT, [&]()
+	{
+		for (void*& allocation : allocations) { allocation = allocator.Allocate(64, __FILE__, __LINE__, false); }
+		for (void* const allocation : allocations) { allocator.Free(allocation, false); }
+	});
+}
+
+
+
+//Resource loading
+static void BenchModelLoaderNKModel(BenchRun& _run)
+{
+	const std::string path{ "Samples/Resource-Files/nkmodels/Prefabs/Cube.nkmodel" };
+	if (!std::filesystem::exists(path)) { _run.Skip(path + " not found"); return; }
+
+	for (std::size_t i{ 0 }; i < 20; ++i)
+	{
+		_run.Time(1, [&]() { Consume(static_cast<std::uint64_t>(NK::ModelLoader::LoadModel(path)->meshes.size())); });
+		//Both caches would otherwise turn every load after the first into a lookup
+		NK::ModelLoader::UnloadModel(path);
+		NK::TextureCompressor::ClearCache();
+		NK::ImageLoader::ClearCache();
+	}
+}
+
+
+static void BenchTextureCompressorLoadImage(BenchRun& _run)
+{
+	const std::string path{ "Samples/Resource-Files/Skyboxes/Lake Pier/irradiance.ktx" };
+	if (!std::filesystem::exists(path)) { _run.Skip(path + " not found"); return; }
+
+	for (std::size_t i{ 0 }; i < 20; ++i)
+	{
+		NK::ImageData* imageData{ nullptr };
+		_run.Time(1, [&]() { imageData = NK::TextureCompressor::LoadImage(path, false, false); });
+		Consume(static_cast<std::uint64_t>(imageData->desc.size.x));
+		NK::TextureCompressor::FreeImage(imageData);
+	}
+}
+
+
+
+//Networking
+//Full snapshots - every entity, as sent to a client that hasn't acked anything yet
+static void BenchNetworkTransformEncode(BenchRun& _run)
+{
+	NK::Registry reg{ ENTITY_COUNT };
+	PopulateRegistry(reg, 1);
+	const NK::NetworkTransformQuantisation quantisation{};
+	std::vector<NK::QuantisedTransform> states;
+	const std::vector<NK::QuantisedTransform> noBaseline;
+	std::vector<std::uint8_t> bytes; //Reused like a pooled buffer would be - only the first run has to grow it
+	for (std::size_t i{ 0 }; i < 10; ++i)
+	{
+		_run.Time(ENTITY_COUNT, [&]()
+		{
+			bytes.clear();
+			NK::NetworkTransformCodec::Capture(reg, quantisation, states);
+			Consume(static_cast<std::uint64_t>(NK::NetworkTransformCodec::Encode(0, states, NK::NetworkTransformCodec::NO_SNAPSHOT, noBaseline, quantisation, bytes)));
+		});
+	}
+}
+
+
+static void BenchNetworkTransformDecode(BenchRun& _run)
+{
+	NK::Registry reg{ ENTITY_COUNT };
+	PopulateRegistry(reg, 1);
+	const NK::NetworkTransformQuantisation quantisation{};
+	std::vector<NK::QuantisedTransform> states;
+	const std::vector<NK::QuantisedTransform> noBaseline;
+	NK::NetworkTransformCodec::Capture(reg, quantisation, states);
+	std::vector<std::uint8_t> bytes;
+	static_cast<void>(NK::NetworkTransformCodec::Encode(0, states, NK::NetworkTransformCodec::NO_SNAPSHOT, noBaseline, quantisation, bytes));
+	for (std::size_t i{ 0 }; i < 10; ++i)
+	{
+		_run.Time(ENTITY_COUNT, [&]()
+		{
+			NK::BitReader reader{ bytes.data(), bytes.size() };
+			std::uint32_t sequence;
+			std::uint32_t baselineSequence;
+			NK::NetworkTransformCodec::DecodeHeader(reader, sequence, baselineSequence);
+			static_cast<void>(NK::NetworkTransformCodec::Decode(reader, noBaseline, quantisation, states));
+			NK::NetworkTransformCodec::Apply(states, noBaseline, quantisation, reg);
+		});
+	}
+}
+
+
+//Deltas - one in ten entities has moved since the baseline
+static void MoveEveryTenthEntity(NK::Registry& _reg)
+{
+	std::uint32_t i{ 0 };
+	for (auto&& [transform] : _reg.View<NK::CTransform>())
+	{
+		if (i++ % 10 == 0) { transform.SetLocalPosition(transform.GetLocalPosition() + glm::vec3(0.0f, 1.0f, 0.0f)); }
+	}
+}
+
+
+static void BenchNetworkTransformEncodeDelta(BenchRun& _run)
+{
+	NK::Registry reg{ ENTITY_COUNT };
+	PopulateRegistry(reg, 1);
+	const NK::NetworkTransformQuantisation quantisation{};
+	std::vector<NK::QuantisedTransform> baseline;
+	NK::NetworkTransformCodec::Capture(reg, quantisation, baseline);
+	MoveEveryTenthEntity(reg);
+	std::vector<NK::QuantisedTransform> states;
+	std::vector<std::uint8_t> bytes; //Reused like a pooled buffer would be - only the first run has to grow it
+	for (std::size_t i{ 0 }; i < 10; ++i)
+	{
+		_run.Time(ENTITY_COUNT, [&]()
+		{
+			bytes.clear();
+			NK::NetworkTransformCodec::Capture(reg, quantisation, states);
+			Consume(static_cast<std::uint64_t>(NK::NetworkTransformCodec::Encode(1, states, 0, baseline, quantisation, bytes)));
+		});
+	}
+}
+
+
+static void BenchNetworkTransformDecodeDelta(BenchRun& _run)
+{
+	NK::Registry reg{ ENTITY_COUNT };
+	PopulateRegistry(reg, 1);
+	const NK::NetworkTransformQuantisation quantisation{};
+	std::vector<NK::QuantisedTransform> baseline;
+	NK::NetworkTransformCodec::Capture(reg, quantisation, baseline);
+	MoveEveryTenthEntity(reg);
+	std::vector<NK::QuantisedTransform> states;
+	NK::NetworkTransformCodec::Capture(reg, quantisation, states);
+	std::vector<std::uint8_t> bytes;
+	static_cast<void>(NK::NetworkTransformCodec::Encode(1, states, 0, baseline, quantisation, bytes));
+	for (std::size_t i{ 0 }; i < 10; ++i)
+	{
+		_run.Time(ENTITY_COUNT, [&]()
+		{
+			NK::BitReader reader{ bytes.data(), bytes.size() };
+			std::uint32_t sequence;
+			std::uint32_t baselineSequence;
+			NK::NetworkTransformCodec::DecodeHeader(reader, sequence, baselineSequence);
+			static_cast<void>(NK::NetworkTransformCodec::Decode(reader, baseline, quantisation, states));
+			NK::NetworkTransformCodec::Apply(states, baseline, quantisation, reg);
+		});
+	}
+}
+
+
+
+struct MicroBenchmark
+{
+	const char* name;
+	void(*func)(BenchRun&);
+};
+
+static const MicroBenchmark benchmarks[]
+{
+	{ "registry/create_destroy",			&BenchRegistryCreateDestroy },
+	{ "registry/add_component",				&BenchRegistryAddComponent },
+	{ "registry/remove_component",			&BenchRegistryRemoveComponent },
+	{ "registry/get_component",				&BenchRegistryGetComponent },
+	{ "registry/view_1",					&BenchView1 },
+	{ "registry/view_2",					&BenchView2 },
+	{ "registry/view_3",					&BenchView3 },
+	{ "registry/view_4",					&BenchView4 },
+	{ "registry/save",						&BenchRegistrySave },
+	{ "registry/load",						&BenchRegistryLoad },
+	{ "events/trigger_4_subscribers",		&BenchEventTrigger },
+	{ "jobs/parallel_for_tiny_chunks",		&BenchParallelForTinyChunks },
+	{ "allocators/free_list",				&BenchFreeListAllocator },
+	{ "allocators/tracking_64b",			&BenchTrackingAllocator },
+	{ "resources/model_loader_nkmodel",		&BenchModelLoaderNKModel },
+	{ "resources/texture_compressor_ktx",	&BenchTextureCompressorLoadImage },
+	{ "network/transform_encode",			&BenchNetworkTransformEncode },
+	{ "network/transform_decode",			&BenchNetworkTransformDecode },
+	{ "network/transform_encode_delta",		&BenchNetworkTransformEncodeDelta },
+	{ "network/transform_decode_delta",		&BenchNetworkTransformDecodeDelta },
+};
+
+
+
+int main(const int _argc, char** _argv)
+{
+	const std::string filter{ _argc > 1 ? _argv[1] : "" };
+	const std::size_t repeats{ _argc > 2 ? std::max<std::size_t>(1, std::stoull(_argv[2])) : 7 };
+
+	//Only what Registry::Save() / Load() need
+	NK::TypeRegistry::Register<NK::CTransform>("C_TRANSFORM");
+	NK::TypeRegistry::Register<NK::CNetworkSync>("C_NETWORK_SYNC");
+	NK::TypeRegistry::Register<NK::CPhysicsBody>("C_PHYSICS_BODY");
+	NK::TypeRegistry::Register<NK::CBoxCollider>("C_BOX_COLLIDER");
+
+	//Keep stdout to the results
+	NK::LoggerConfig loggerConfig{ NK::LOGGER_TYPE::CONSOLE, true };
+	loggerConfig.SetDefaultChannelBitfield(NK::LOGGER_CHANNEL::ERROR);
+	constexpr NK::TrackingAllocatorConfig trackingAllocatorConfig{ NK::TRACKING_ALLOCATOR_VERBOSITY_FLAGS::ALL };
+	constexpr NK::AllocatorConfig allocatorConfig{ NK::ALLOCATOR_TYPE::TRACKING, trackingAllocatorConfig };
+	const NK::RAIIContext context{ NK::ContextConfig(loggerConfig, allocatorConfig) };
+
+	std::cout << "# NekiMicroBench v1 - " << repeats << " repeats\n";
+	std::cout << "benchmark\tops\tmedian_ns\tmin_ns\tmax_ns\n";
+	std::cout << std::fixed << std::setprecision(2);
+
+	for (const MicroBenchmark& benchmark : benchmarks)
+	{
+		if (std::string(benchmark.name).find(filter) == std::string::npos) { continue; }
+
+		std::vector<double> nsPerOp;
+		std::uint64_t ops{ 0 };
+		std::string skipReason;
+		for (std::size_t i{ 0 }; i < repeats; ++i)
+		{
+			BenchRun run;
+			benchmark.func(run);
+			if (!run.GetSkipReason().empty())
+			{
+				skipReason = run.GetSkipReason();
+				break;
+			}
+			nsPerOp.push_back(run.GetNsPerOp());
+			ops = run.GetOps();
+		}
+
+		if (!skipReason.empty())
+		{
+			std::cout << benchmark.name << "\tskipped\t" << skipReason << '\n';
+			continue;
+		}
+		std::ranges::sort(nsPerOp);
+		std::cout << benchmark.name << '\t' << ops << '\t' << nsPerOp[nsPerOp.size() / 2] << '\t' << nsPerOp.front() << '\t' << nsPerOp.back() << '\n';
+	}
+
+	NK::ModelLoader::ClearCache();
+	return 0;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+
+enum class BENCH_ACTIONS
+{
+	BOOST,
+};
+
+
+//Chain roots without a physics body spin about y every fixed update, so the whole chain under them has to be re-resolved
+struct CSpinner
+{
+	float speed; //Radians per second
+	float angle;
+};
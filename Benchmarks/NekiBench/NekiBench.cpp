@@ -0,0 +1,544 @@
+#include "CSpinner.h"
+#include "StressLayer.h"
+
+#include <Components/CBoxCollider.h>
+#include <Components/CInput.h>
+#include <Components/CLight.h>
+#include <Components/CModelRenderer.h>
+#include <Components/CPhysicsBody.h>
+#include <Components/CTransform.h>
+#include <Core/EngineConfig.h>
+#include <Core/RAIIContext.h>
+#include <Core/Layers/PhysicsLayer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <new>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+	#define NOMINMAX
+	#include <windows.h>
+	#include <malloc.h>
+	#include <psapi.h>
+	#ifdef ERROR
+		#undef ERROR //Conflicts with LOGGER_CHANNEL::ERROR
+	#endif
+#else
+	#include <sys/resource.h>
+#endif
+
+
+//Headless stress runner - procedurally builds a scene of N entities, runs it for K lockstep ticks (see EngineConfig::lockstep) and writes per-layer timings, allocations per frame and peak memory to a json file
+//Nothing here opens a window, so it runs the same in NEKI_HEADLESS and regular builds - in regular builds the model renderers and lights are just component data, there's no RenderLayer to draw them
+//Configured through environment variables so runs can be scripted without rebuilding:
+//	NEKI_BENCH_ENTITIES			- total entities (default: 10000)
+//	NEKI_BENCH_TICKS			- measured frames, each one fixed update + one update (default: 600)
+//	NEKI_BENCH_WARMUP			- frames run before measuring starts, at least 1 (default: 60)
+//	NEKI_BENCH_DEPTH			- transforms per parent->child chain, 1 for no hierarchy (default: 4)
+//	NEKI_BENCH_PHYSICS			- fraction of entities with a dynamic physics body - only chain roots get one (default: 0.05)
+//	NEKI_BENCH_MODELS			- fraction of entities with a CModelRenderer (default: 0.5)
+//	NEKI_BENCH_LIGHTS			- fraction of entities with a CLight (default: 0.01)
+//	NEKI_BENCH_INPUTS			- fraction of entities with a CInput (default: 0.01)
+//	NEKI_BENCH_SEED				- seed for the scene layout (default: 1)
+//	NEKI_BENCH_OUTPUT			- where to write the results (default: NekiBench.json)
+
+
+
+//Every operator new in the process is counted, engine worker threads included - allocations through NK_NEW go through the tracking allocator instead, so they're not
+namespace
+{
+	std::atomic<std::uint64_t> allocationCount{ 0 };
+	std::atomic<std::uint64_t> allocatedBytes{ 0 };
+}
+
+
+void* operator new(const std::size_t _size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	allocatedBytes.fetch_add(_size, std::memory_order_relaxed);
+	if (void* const ptr{ std::malloc(_size ? _size : 1) }) { return ptr; }
+	throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t _size) { return operator new(_size); }
+void operator delete(void* _ptr) noexcept { std::free(_ptr); }
+void operator delete[](void* _ptr) noexcept { std::free(_ptr); }
+void operator delete(void* _ptr, std::size_t) noexcept { std::free(_ptr); }
+void operator delete[](void* _ptr, std::size_t) noexcept { std::free(_ptr); }
+
+//Over-aligned types (e.g. anything alignas(64)) skip the overloads above, so they need counting too
+void* operator new(const std::size_t _size, const std::align_val_t _alignment)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	allocatedBytes.fetch_add(_size, std::memory_order_relaxed);
+	const std::size_t alignment{ static_cast<std::size_t>(_alignment) };
+	#if defined(_WIN32)
+		if (void* const ptr{ _aligned_malloc(_size ? _size : 1, alignment) }) { return ptr; }
+	#else
+		//std::aligned_alloc() wants the size to be a multiple of the alignment
+		if (void* const ptr{ std::aligned_alloc(alignment, ((_size ? _size : 1) + alignment - 1) / alignment * alignment) }) { return ptr; }
+	#endif
+	throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t _size, const std::align_val_t _alignment) { return operator new(_size, _alignment); }
+
+#if defined(_WIN32)
+	void operator delete(void* _ptr, std::align_val_t) noexcept { _aligned_free(_ptr); }
+	void operator delete[](void* _ptr, std::align_val_t) noexcept { _aligned_free(_ptr); }
+	void operator delete(void* _ptr, std::size_t, std::align_val_t) noexcept { _aligned_free(_ptr); }
+	void operator delete[](void* _ptr, std::size_t, std::align_val_t) noexcept { _aligned_free(_ptr); }
+#else
+	void operator delete(void* _ptr, std::align_val_t) noexcept { std::free(_ptr); }
+	void operator delete[](void* _ptr, std::align_val_t) noexcept { std::free(_ptr); }
+	void operator delete(void* _ptr, std::size_t, std::align_val_t) noexcept { std::free(_ptr); }
+	void operator delete[](void* _ptr, std::size_t, std::align_val_t) noexcept { std::free(_ptr); }
+#endif
+
+
+
+[[nodiscard]] static std::uint64_t GetPeakMemoryBytes()
+{
+	#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters{};
+		return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? static_cast<std::uint64_t>(counters.PeakWorkingSetSize) : 0;
+	#else
+		rusage usage{};
+		getrusage(RUSAGE_SELF, &usage);
+		return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024; //Reported in KiB on linux
+	#endif
+}
+
+
+
+[[nodiscard]] static std::uint64_t GetEnvUInt(const char* _name, const std::uint64_t _default)
+{
+	const char* const value{ std::getenv(_name) };
+	return value ? std::stoull(value) : _default;
+}
+
+[[nodiscard]] static double GetEnvDouble(const char* _name, const double _default)
+{
+	const char* const value{ std::getenv(_name) };
+	return value ? std::stod(value) : _default;
+}
+
+[[nodiscard]] static std::string GetEnvString(const char* _name, const std::string& _default)
+{
+	const char* const value{ std::getenv(_name) };
+	return value ? std::string(value) : _default;
+}
+
+
+
+struct BenchConfig
+{
+	std::uint32_t entities;
+	std::uint32_t ticks;
+	std::uint32_t warmupTicks;
+	std::uint32_t hierarchyDepth;
+	double physicsFraction;
+	double modelFraction;
+	double lightFraction;
+	double inputFraction;
+	std::uint32_t seed;
+	std::string outputPath;
+};
+
+[[nodiscard]] static BenchConfig ReadBenchConfig()
+{
+	BenchConfig config{};
+	config.entities = static_cast<std::uint32_t>(GetEnvUInt("NEKI_BENCH_ENTITIES", 10'000));
+	config.ticks = static_cast<std::uint32_t>(GetEnvUInt("NEKI_BENCH_TICKS", 600));
+	config.warmupTicks = std::max(1u, static_cast<std::uint32_t>(GetEnvUInt("NEKI_BENCH_WARMUP", 60))); //The first frame never runs a fixed update
+	config.hierarchyDepth = std::max(1u, static_cast<std::uint32_t>(GetEnvUInt("NEKI_BENCH_DEPTH", 4)));
+	config.physicsFraction = std::clamp(GetEnvDouble("NEKI_BENCH_PHYSICS", 0.05), 0.0, 1.0);
+	config.modelFraction = std::clamp(GetEnvDouble("NEKI_BENCH_MODELS", 0.5), 0.0, 1.0);
+	config.lightFraction = std::clamp(GetEnvDouble("NEKI_BENCH_LIGHTS", 0.01), 0.0, 1.0);
+	config.inputFraction = std::clamp(GetEnvDouble("NEKI_BENCH_INPUTS", 0.01), 0.0, 1.0);
+	config.seed = static_cast<std::uint32_t>(GetEnvUInt("NEKI_BENCH_SEED", 1));
+	config.outputPath = GetEnvString("NEKI_BENCH_OUTPUT", "NekiBench.json");
+	return config;
+}
+
+
+
+static const NK::PhysicsObjectLayer bodyObjectLayer{ "Bench Body", 0, NK::DynamicBroadPhaseLayer };
+static const NK::PhysicsObjectLayer floorObjectLayer{ "Bench Floor", 1, NK::KinematicBroadPhaseLayer };
+
+
+
+//How many of each component the scene actually ended up with
+struct SceneCounts
+{
+	std::uint32_t roots;
+	std::uint32_t physicsBodies;
+	std::uint32_t spinners;
+	std::uint32_t modelRenderers;
+	std::uint32_t lights;
+	std::uint32_t inputs;
+};
+
+
+
+class StressScene final : public NK::Scene
+{
+public:
+	explicit StressScene(const BenchConfig& _config) : Scene(_config.entities + 1)
+	{
+		std::mt19937 rng{ _config.seed };
+		std::uniform_real_distribution<float> unitDistribution{ 0.0f, 1.0f };
+
+		//Chains of hierarchyDepth transforms, each child a unit above its parent - the roots are laid out on a square grid
+		constexpr float spacing{ 3.0f };
+		const std::uint32_t rootCount{ (_config.entities + _config.hierarchyDepth - 1) / _config.hierarchyDepth };
+		const std::uint32_t gridSize{ static_cast<std::uint32_t>(std::ceil(std::sqrt(static_cast<double>(rootCount)))) };
+
+		std::vector<NK::Entity> entities;
+		std::vector<NK::Entity> roots;
+		entities.reserve(_config.entities);
+		roots.reserve(rootCount);
+		for (std::uint32_t i{ 0 }; i < _config.entities; ++i)
+		{
+			const NK::Entity entity{ m_reg.Create() };
+			const std::uint32_t chainIndex{ i % _config.hierarchyDepth };
+			const std::uint32_t root{ static_cast<std::uint32_t>(roots.size()) - (chainIndex == 0 ? 0 : 1) };
+			const glm::vec3 rootPosition{ static_cast<float>(root % gridSize) * spacing, 0.5f, static_cast<float>(root / gridSize) * spacing };
+
+			NK::CTransform& transform{ m_reg.GetComponent<NK::CTransform>(entity) };
+			transform.name = "Stress Entity " + std::to_string(i);
+			transform.SetLocalPosition(rootPosition + glm::vec3(0.0f, static_cast<float>(chainIndex), 0.0f));
+			if (chainIndex == 0) { roots.push_back(entity); }
+			else { transform.SetParent(m_reg, &m_reg.GetComponent<NK::CTransform>(entities.back())); }
+			entities.push_back(entity);
+		}
+
+
+		//Physics bodies go on a random selection of roots, dropped from a random height onto the floor so there's a steady stream of contacts early on - every other root spins instead
+		std::ranges::shuffle(roots, rng);
+		m_counts.roots = rootCount;
+		m_counts.physicsBodies = std::min(static_cast<std::uint32_t>(std::lround(_config.physicsFraction * _config.entities)), rootCount);
+		for (std::uint32_t i{ 0 }; i < rootCount; ++i)
+		{
+			if (i < m_counts.physicsBodies)
+			{
+				NK::CTransform& transform{ m_reg.GetComponent<NK::CTransform>(roots[i]) };
+				transform.SetLocalPosition(transform.GetLocalPosition() + glm::vec3(0.0f, 1.0f + unitDistribution(rng) * 4.0f, 0.0f));
+				NK::CPhysicsBody& physicsBody{ m_reg.AddComponent<NK::CPhysicsBody>(roots[i]) };
+				physicsBody.SetMass(1.0f);
+				physicsBody.SetMotionType(NK::MOTION_TYPE::DYNAMIC);
+				physicsBody.SetObjectLayer(bodyObjectLayer);
+				m_reg.AddComponent<NK::CBoxCollider>(roots[i]).SetHalfExtents({ 0.5f, 0.5f, 0.5f });
+			}
+			else
+			{
+				m_reg.AddComponent<CSpinner>(roots[i]) = CSpinner{ 0.5f + unitDistribution(rng) * 1.5f, 0.0f };
+			}
+		}
+		m_counts.spinners = rootCount - m_counts.physicsBodies;
+
+		if (m_counts.physicsBodies > 0)
+		{
+			const float halfWidth{ static_cast<float>(gridSize) * spacing * 0.5f + spacing };
+			const NK::Entity floorEntity{ m_reg.Create() };
+			NK::CTransform& floorTransform{ m_reg.GetComponent<NK::CTransform>(floorEntity) };
+			floorTransform.name = "Floor";
+			floorTransform.SetLocalPosition({ halfWidth - spacing, -0.5f, halfWidth - spacing });
+			floorTransform.SetLocalScale({ halfWidth, 0.5f, halfWidth });
+			NK::CPhysicsBody& floorPhysicsBody{ m_reg.AddComponent<NK::CPhysicsBody>(floorEntity) };
+			floorPhysicsBody.SetMotionType(NK::MOTION_TYPE::KINEMATIC);
+			floorPhysicsBody.SetObjectLayer(floorObjectLayer);
+			m_reg.AddComponent<NK::CBoxCollider>(floorEntity).SetHalfExtents({ 1.0f, 1.0f, 1.0f });
+		}
+
+
+		//Everything else can go on any entity
+		std::ranges::shuffle(entities, rng);
+		m_counts.modelRenderers = static_cast<std::uint32_t>(std::lround(_config.modelFraction * _config.entities));
+		for (std::uint32_t i{ 0 }; i < m_counts.modelRenderers; ++i)
+		{
+			m_reg.AddComponent<NK::CModelRenderer>(entities[i]);
+		}
+
+		std::ranges::shuffle(entities, rng);
+		m_counts.lights = static_cast<std::uint32_t>(std::lround(_config.lightFraction * _config.entities));
+		for (std::uint32_t i{ 0 }; i < m_counts.lights; ++i)
+		{
+			NK::CLight& light{ m_reg.AddComponent<NK::CLight>(entities[i]) };
+			light.SetLightType(NK::LIGHT_TYPE::POINT);
+			light.light->SetColour({ unitDistribution(rng), unitDistribution(rng), unitDistribution(rng) });
+		}
+
+		std::ranges::shuffle(entities, rng);
+		m_counts.inputs = static_cast<std::uint32_t>(std::lround(_config.inputFraction * _config.entities));
+		for (std::uint32_t i{ 0 }; i < m_counts.inputs; ++i)
+		{
+			m_reg.AddComponent<NK::CInput>(entities[i]).AddActionToMap(BENCH_ACTIONS::BOOST);
+		}
+	}
+
+
+	virtual void Update() override {}
+
+
+	[[nodiscard]] inline const SceneCounts& GetCounts() const { return m_counts; }
+
+
+private:
+	SceneCounts m_counts{};
+};
+
+
+
+class BenchApp final : public NK::Application
+{
+public:
+	explicit BenchApp(const BenchConfig& _config) : Application(1), m_config(_config)
+	{
+		//Register types
+		NK::TypeRegistry::Register<BENCH_ACTIONS>("BENCH_ACTIONS");
+		NK::TypeRegistry::Register(bodyObjectLayer);
+		NK::TypeRegistry::Register(floorObjectLayer);
+
+		NK::Context::GetLogger()->IndentLog(NK::LOGGER_CHANNEL::INFO, NK::LOGGER_LAYER::APPLICATION, "Building stress scene - " + std::to_string(m_config.entities) + " entities\n");
+		const std::chrono::steady_clock::time_point buildStart{ std::chrono::steady_clock::now() };
+		m_stressScene = NK_NEW(StressScene, m_config);
+		m_scenes.push_back(NK::UniquePtr<NK::Scene>(m_stressScene));
+		m_activeScene = 0;
+		m_sceneBuildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+		NK::Registry& reg{ m_scenes[m_activeScene]->m_reg };
+
+
+		//Pre-app layers
+		m_stressLayer = NK::UniquePtr<StressLayer>(NK_NEW(StressLayer, reg));
+		m_preAppLayers.push_back(m_stressLayer.get());
+
+
+		//Post-app layers
+		const SceneCounts& counts{ m_stressScene->GetCounts() };
+		if (counts.physicsBodies > 0)
+		{
+			NK::PhysicsLayerDesc physicsLayerDesc{};
+			physicsLayerDesc.objectLayers = { bodyObjectLayer, floorObjectLayer };
+			physicsLayerDesc.objectLayerCollisionPartners = {
+			{
+				bodyObjectLayer, { bodyObjectLayer, floorObjectLayer }
+			},
+			{
+				floorObjectLayer, { bodyObjectLayer }
+			}};
+			physicsLayerDesc.maxBodies = std::max(1024u, counts.physicsBodies + 1);
+			physicsLayerDesc.maxBodyPairs = std::max(1024u, counts.physicsBodies * 8);
+			physicsLayerDesc.maxContactConstraints = std::max(1024u, counts.physicsBodies * 8);
+			m_physicsLayer = NK::UniquePtr<NK::PhysicsLayer>(NK_NEW(NK::PhysicsLayer, reg, physicsLayerDesc));
+			m_postAppLayers.push_back(m_physicsLayer.get());
+		}
+	}
+
+
+
+	virtual void Update() override
+	{
+		m_scenes[m_activeScene]->Update();
+
+		//Frames are measured from one Update() to the next, so the post-app update (and the frame time / allocations) of frame N are picked up in frame N + 1
+		const std::chrono::steady_clock::time_point now{ std::chrono::steady_clock::now() };
+		const std::uint64_t allocations{ allocationCount.load(std::memory_order_relaxed) };
+		const std::uint64_t bytes{ allocatedBytes.load(std::memory_order_relaxed) };
+
+		if (m_frame > m_config.warmupTicks)
+		{
+			m_frameMs.push_back(std::chrono::duration<double, std::milli>(now - m_lastFrameTimePoint).count());
+			m_allocationsPerFrame.push_back(static_cast<double>(allocations - m_lastAllocationCount));
+			m_allocatedBytesPerFrame.push_back(static_cast<double>(bytes - m_lastAllocatedBytes));
+			RecordPhase(NK::LAYER_PHASE::POST_APP_UPDATE);
+		}
+
+		if (m_frame == m_config.warmupTicks + m_config.ticks)
+		{
+			WriteReport();
+			m_shutdown = true;
+		}
+		else if (m_frame >= m_config.warmupTicks)
+		{
+			RecordPhase(NK::LAYER_PHASE::PRE_APP_FIXED_UPDATE);
+			RecordPhase(NK::LAYER_PHASE::PRE_APP_UPDATE);
+			RecordPhase(NK::LAYER_PHASE::POST_APP_FIXED_UPDATE);
+		}
+
+		m_lastFrameTimePoint = now;
+		m_lastAllocationCount = allocations;
+		m_lastAllocatedBytes = bytes;
+		++m_frame;
+	}
+
+
+private:
+	struct LayerSamples
+	{
+		NK::LAYER_PHASE phase;
+		std::string layer;
+		std::vector<double> ms;
+	};
+
+
+	void RecordPhase(const NK::LAYER_PHASE _phase)
+	{
+		const NK::LayerGraph& graph{ GetLayerGraph(_phase) };
+		if (graph.GetTimings().empty()) { return; }
+
+		m_phaseWallMs[_phase].push_back(graph.GetWallTimeMs());
+		for (const NK::LayerTiming& timing : graph.GetTimings())
+		{
+			const std::vector<LayerSamples>::iterator it{ std::ranges::find_if(m_layerSamples, [&](const LayerSamples& _samples) { return _samples.phase == _phase && _samples.layer == timing.layer->GetName(); }) };
+			if (it != m_layerSamples.end()) { it->ms.push_back(timing.durationMs); }
+			else { m_layerSamples.push_back(LayerSamples{ _phase, timing.layer->GetName(), { timing.durationMs } }); }
+		}
+	}
+
+
+	//{ "mean": ..., "p50": ..., "p99": ..., "max": ..., "samples": ... } - percentiles are nearest-rank
+	static void WriteStats(std::ostream& _stream, std::vector<double> _samples)
+	{
+		if (_samples.empty())
+		{
+			_stream << "{ \"mean\": 0, \"p50\": 0, \"p99\": 0, \"max\": 0, \"samples\": 0 }";
+			return;
+		}
+
+		std::ranges::sort(_samples);
+		const auto percentile{ [&](const double _p) { return _samples[static_cast<std::size_t>(std::ceil(_p * static_cast<double>(_samples.size()))) - 1]; } };
+		const double mean{ std::accumulate(_samples.begin(), _samples.end(), 0.0) / static_cast<double>(_samples.size()) };
+		_stream << "{ \"mean\": " << mean << ", \"p50\": " << percentile(0.5) << ", \"p99\": " << percentile(0.99) << ", \"max\": " << _samples.back() << ", \"samples\": " << _samples.size() << " }";
+	}
+
+
+	void WriteReport() const
+	{
+		const SceneCounts& counts{ m_stressScene->GetCounts() };
+
+		std::ostringstream json;
+		json << std::fixed << std::setprecision(4);
+		json << "{\n";
+		json << "\t\"config\": {\n";
+		json << "\t\t\"entities\": " << m_config.entities << ",\n";
+		json << "\t\t\"ticks\": " << m_config.ticks << ",\n";
+		json << "\t\t\"warmupTicks\": " << m_config.warmupTicks << ",\n";
+		json << "\t\t\"hierarchyDepth\": " << m_config.hierarchyDepth << ",\n";
+		json << "\t\t\"seed\": " << m_config.seed << ",\n";
+		json << "\t\t\"fixedUpdateTimestep\": " << NK::Context::GetFixedUpdateTimestep() << ",\n";
+		#ifdef NEKI_HEADLESS
+			json << "\t\t\"headless\": true\n";
+		#else
+			json << "\t\t\"headless\": false\n";
+		#endif
+		json << "\t},\n";
+
+		json << "\t\"components\": { \"roots\": " << counts.roots << ", \"physicsBodies\": " << counts.physicsBodies << ", \"spinners\": " << counts.spinners << ", \"modelRenderers\": " << counts.modelRenderers << ", \"lights\": " << counts.lights << ", \"inputs\": " << counts.inputs << " },\n";
+		json << "\t\"sceneBuildMs\": " << m_sceneBuildMs << ",\n";
+
+		json << "\t\"frameMs\": ";
+		WriteStats(json, m_frameMs);
+		json << ",\n";
+
+		json << "\t\"phases\": [\n";
+		for (std::map<NK::LAYER_PHASE, std::vector<double>>::const_iterator it{ m_phaseWallMs.begin() }; it != m_phaseWallMs.end(); ++it)
+		{
+			json << "\t\t{ \"phase\": \"" << NK::LayerGraph::GetPhaseName(it->first) << "\", \"wallMs\": ";
+			WriteStats(json, it->second);
+			json << (std::next(it) == m_phaseWallMs.end() ? " }\n" : " },\n");
+		}
+		json << "\t],\n";
+
+		json << "\t\"layers\": [\n";
+		for (std::size_t i{ 0 }; i < m_layerSamples.size(); ++i)
+		{
+			json << "\t\t{ \"phase\": \"" << NK::LayerGraph::GetPhaseName(m_layerSamples[i].phase) << "\", \"layer\": \"" << m_layerSamples[i].layer << "\", \"ms\": ";
+			WriteStats(json, m_layerSamples[i].ms);
+			json << (i + 1 == m_layerSamples.size() ? " }\n" : " },\n");
+		}
+		json << "\t],\n";
+
+		json << "\t\"allocationsPerFrame\": ";
+		WriteStats(json, m_allocationsPerFrame);
+		json << ",\n";
+		json << "\t\"allocatedBytesPerFrame\": ";
+		WriteStats(json, m_allocatedBytesPerFrame);
+		json << ",\n";
+		json << "\t\"peakMemoryBytes\": " << GetPeakMemoryBytes() << ",\n";
+		json << "\t\"checksum\": " << m_stressLayer->GetChecksum() << "\n";
+		json << "}\n";
+
+		std::ofstream file(m_config.outputPath, std::ios::trunc);
+		if (!file.is_open())
+		{
+			NK::Context::GetLogger()->IndentLog(NK::LOGGER_CHANNEL::ERROR, NK::LOGGER_LAYER::APPLICATION, "Failed to open " + m_config.outputPath + " for writing\n");
+			return;
+		}
+		file << json.str();
+
+		std::ostringstream summary;
+		summary << std::fixed << std::setprecision(3) << "Wrote results for " << m_frameMs.size() << " frame(s) to " << m_config.outputPath << "\n";
+		NK::Context::GetLogger()->IndentLog(NK::LOGGER_CHANNEL::SUCCESS, NK::LOGGER_LAYER::APPLICATION, summary.str());
+	}
+
+
+	BenchConfig m_config;
+	StressScene* m_stressScene; //Owned by m_scenes
+	double m_sceneBuildMs;
+
+	std::uint64_t m_frame{ 0 };
+	std::chrono::steady_clock::time_point m_lastFrameTimePoint{};
+	std::uint64_t m_lastAllocationCount{ 0 };
+	std::uint64_t m_lastAllocatedBytes{ 0 };
+
+	std::vector<double> m_frameMs;
+	std::vector<double> m_allocationsPerFrame;
+	std::vector<double> m_allocatedBytesPerFrame;
+	std::map<NK::LAYER_PHASE, std::vector<double>> m_phaseWallMs;
+	std::vector<LayerSamples> m_layerSamples;
+
+	//Pre-app layers
+	NK::UniquePtr<StressLayer> m_stressLayer;
+
+	//Post-app layers
+	NK::UniquePtr<NK::PhysicsLayer> m_physicsLayer;
+};
+
+
+
+[[nodiscard]] NK::ContextConfig CreateContext()
+{
+	//Keep the console quiet apart from problems and the result line
+	NK::LoggerConfig loggerConfig{ NK::LOGGER_TYPE::CONSOLE, true };
+	loggerConfig.SetDefaultChannelBitfield(NK::LOGGER_CHANNEL::WARNING | NK::LOGGER_CHANNEL::ERROR);
+	loggerConfig.SetLayerChannelBitfield(NK::LOGGER_LAYER::APPLICATION, NK::LOGGER_CHANNEL::INFO | NK::LOGGER_CHANNEL::WARNING | NK::LOGGER_CHANNEL::ERROR | NK::LOGGER_CHANNEL::SUCCESS);
+
+	//Still tracking (so leaks are reported at shutdown), but logging every allocation would swamp the timings
+	constexpr NK::TrackingAllocatorConfig trackingAllocatorConfig{ NK::TRACKING_ALLOCATOR_VERBOSITY_FLAGS::NONE };
+	constexpr NK::AllocatorConfig allocatorConfig{ NK::ALLOCATOR_TYPE::TRACKING, trackingAllocatorConfig };
+
+	return NK::ContextConfig(loggerConfig, allocatorConfig);
+}
+
+
+
+[[nodiscard]] NK::EngineConfig CreateEngine()
+{
+	NK::EngineConfig config{ NK_NEW(BenchApp, ReadBenchConfig()) };
+	config.lockstep = true;
+	config.sleepBetweenTicks = false;
+	return config;
+}
@@ -0,0 +1,66 @@
+#include "StressLayer.h"
+
+#include <Components/CInput.h>
+#include <Components/CTransform.h>
+#include <Core/Context.h>
+#include <Core/Debug/Profiler.h>
+
+
+StressLayer::StressLayer(NK::Registry& _reg) : ILayer(_reg)
+{
+	m_logger.Indent();
+	m_logger.Log(NK::LOGGER_CHANNEL::HEADING, NK::LOGGER_LAYER::APPLICATION, "Initialising Stress Layer\n");
+	m_logger.Unindent();
+}
+
+
+
+StressLayer::~StressLayer()
+{
+	m_logger.Indent();
+	m_logger.Log(NK::LOGGER_CHANNEL::HEADING, NK::LOGGER_LAYER::APPLICATION, "Shutting Down Stress Layer\n");
+	m_logger.Unindent();
+}
+
+
+
+void StressLayer::FixedUpdate()
+{
+	const float timestep{ NK::Context::GetFixedUpdateTimestep() };
+	for (auto&& [spinner, transform] : m_reg.get().View<CSpinner, NK::CTransform>())
+	{
+		spinner.angle += spinner.speed * timestep;
+		transform.SetLocalRotation(glm::angleAxis(spinner.angle, glm::vec3(0.0f, 1.0f, 0.0f)));
+	}
+}
+
+
+
+void StressLayer::Update()
+{
+	{
+		NK_PROFILE_SCOPE("StressLayer - Inputs");
+		for (auto&& [input] : m_reg.get().View<NK::CInput>())
+		{
+			if (input.GetActionState<NK::ButtonState>(BENCH_ACTIONS::BOOST).held) { m_checksum += 1.0f; }
+		}
+	}
+
+	{
+		NK_PROFILE_SCOPE("StressLayer - Resolve Transforms");
+		//GetModelMatrix() walks up to the root for every transform, so deeper hierarchies cost more per entity
+		for (auto&& [transform] : m_reg.get().View<NK::CTransform>())
+		{
+			m_checksum += transform.GetModelMatrix()[3].x;
+		}
+	}
+}
+
+
+
+NK::LayerAccess StressLayer::GetAccess(const NK::LAYER_PHASE _phase) const
+{
+	if (NK::IsFixedUpdatePhase(_phase)) { return NK::LayerAccess{}.Write<CSpinner>().Write<NK::CTransform>(); }
+	//GetModelMatrix() refreshes the cached local matrices, so this is a write even though nothing visibly changes
+	return NK::LayerAccess{}.Read<NK::CInput>().Write<NK::CTransform>();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CSpinner.h"
+
+#include <Core/Layers/ILayer.h>
+#include <Core-ECS/Registry.h>
+#include <Types/NekiTypes.h>
+
+
+
+//Stands in for gameplay code in NekiBench - spins the CSpinner roots each fixed update, then each update reads every CInput and resolves every CTransform's world matrix the way a renderer would
+class StressLayer final : public NK::ILayer
+{
+public:
+	explicit StressLayer(NK::Registry& _reg);
+	virtual ~StressLayer() override;
+
+	virtual void FixedUpdate() override;
+	virtual void Update() override;
+	[[nodiscard]] virtual NK::LayerAccess GetAccess(NK::LAYER_PHASE _phase) const override;
+	[[nodiscard]] inline virtual const char* GetName() const override { return "Stress Layer"; }
+
+	//Folded from everything Update() reads, so none of it can be optimised away
+	[[nodiscard]] inline float GetChecksum() const { return m_checksum; }
+
+
+private:
+	float m_checksum{ 0.0f };
+};
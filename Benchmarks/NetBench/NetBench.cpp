@@ -0,0 +1,485 @@
+#include <Networking/NetworkConnection.h>
+#include <Networking/PacketFragmenter.h>
+#include <Networking/PacketHeader.h>
+#include <Networking/PacketReassembler.h>
+#include <Networking/SocketPoller.h>
+#include <SFML/Network.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+#if defined(__linux__)
+	#include <sys/resource.h>
+#endif
+
+
+//Tests and measurements for the networking code below the layers
+//Usage: NekiNetBench [mode] [loss] [messages] [seed]
+//- mode (default: fragmentation):
+//	- fragmentation: loopback test for UDP fragmentation - sends packets from 1KB to 200KB (so mostly too big for one datagram, occasionally not) through a PacketFragmenter between two real sockets on 127.0.0.1, with some of the fragments deliberately not sent, and checks what a PacketReassembler puts back together on the other end
+//	  delivered should come out around expected_delivered ((1 - loss)^fragments, summed over every packet) - and with no loss, every packet should arrive
+//	- channels: two NetworkConnections ticking at 60Hz over a simulated link (50-70ms each way), one sending a reliable-ordered message every tick - reports how long they take to be handed over on the other end
+//	- scaling: 10 to 1000 clients connected over loopback TCP, a few of them sending a packet each tick - compares finding the packets with a non-blocking receive() on every socket (scan) against asking a SocketPoller which sockets are ready (poll), like ServerNetworkLayer
+//	  also times letting them all in, accepting in batches of up to 64 like ServerNetworkLayerDesc::maxConnectionsPerTick - ignores loss, and messages is how many ticks each way is timed for per client count
+//- loss: chance (0-1) of each datagram being dropped before it's sent (default: 0)
+//- messages: how many packets / messages to send (default: 1000)
+//- seed: for sizes, contents, latencies and which datagrams get dropped - the same seed always does the same thing (default: 1)
+//
+//Output is tab-separated, like NekiMicroBench:
+//	# NekiNetBench v1 - <mode>, <messages> messages, <loss> loss, seed <seed>
+//	metric	value
+//	<metric>	<value>
+//scaling prints one row per client count instead, under a header of its own
+//Exits with 1 if anything arrives corrupted or out of order, or anything's missing that shouldn't be
+
+
+
+static constexpr std::size_t MAX_DATAGRAM_SIZE{ 1200 };
+static constexpr std::size_t MIN_PACKET_SIZE{ 1024 };
+static constexpr std::size_t MAX_PACKET_SIZE{ 200 * 1024 };
+static constexpr double TICK_LENGTH{ 1.0 / 60.0 }; //Each packet is sent a "tick" after the last, so lost ones time out in the reassembler like they would in game
+
+
+//Packet contents are worked out from the message index and byte position, so what arrives can be checked without keeping everything that was sent
+static inline std::uint8_t GetPacketByte(const std::uint32_t _message, const std::size_t _position)
+{
+	std::uint64_t x{ (static_cast<std::uint64_t>(_message) << 32) ^ _position };
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdull;
+	x ^= x >> 33;
+	return static_cast<std::uint8_t>(x);
+}
+
+
+
+//PACKET_CODE::TRANSFORM, the message index, then filler - like a real (very big) transform snapshot as far as the fragmenter's concerned
+static void BuildPacket(const std::uint32_t _message, const std::size_t _size, std::vector<std::uint8_t>& _packet)
+{
+	_packet.clear();
+	NK::PacketHeader::Write(_packet, NK::PACKET_CODE::TRANSFORM);
+	for (std::size_t i{ 0 }; i < sizeof(_message); ++i) { _packet.push_back(static_cast<std::uint8_t>(_message >> (8 * i))); }
+	for (std::size_t i{ _packet.size() }; i < _size; ++i) { _packet.push_back(GetPacketByte(_message, i)); }
+}
+
+
+
+static bool CheckPacket(const std::vector<std::uint8_t>& _packet, std::uint32_t& _message)
+{
+	constexpr std::size_t headerSize{ sizeof(std::underlying_type_t<NK::PACKET_CODE>) + sizeof(_message) };
+	if (_packet.size() < headerSize) { return false; }
+	std::vector<std::uint8_t> code;
+	NK::PacketHeader::Write(code, NK::PACKET_CODE::TRANSFORM);
+	if (std::memcmp(_packet.data(), code.data(), code.size()) != 0) { return false; }
+
+	_message = 0;
+	for (std::size_t i{ 0 }; i < sizeof(_message); ++i) { _message |= static_cast<std::uint32_t>(_packet[code.size() + i]) << (8 * i); }
+	for (std::size_t i{ headerSize }; i < _packet.size(); ++i)
+	{
+		if (_packet[i] != GetPacketByte(_message, i)) { return false; }
+	}
+	return true;
+}
+
+
+
+static int RunFragmentation(const double _loss, const std::uint32_t _messageCount, const std::uint32_t _seed)
+{
+	sf::UdpSocket sender;
+	sf::UdpSocket receiver;
+	if (sender.bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost) != sf::Socket::Status::Done || receiver.bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost) != sf::Socket::Status::Done)
+	{
+		std::cerr << "Failed to bind loopback sockets\n";
+		return 1;
+	}
+	receiver.setBlocking(false);
+	const unsigned short receiverPort{ receiver.getLocalPort() };
+
+	NK::PacketFragmenter fragmenter{ MAX_DATAGRAM_SIZE };
+	NK::PacketReassembler reassembler{ MAX_PACKET_SIZE, 4, 1.0 };
+
+	std::mt19937 rng{ _seed };
+	std::uniform_int_distribution<std::size_t> sizeDistribution{ MIN_PACKET_SIZE, MAX_PACKET_SIZE };
+	std::bernoulli_distribution lossDistribution{ _loss };
+
+	std::vector<std::uint8_t> packet;
+	std::vector<std::uint8_t> reassembled;
+	std::vector<std::uint8_t> datagram(sf::UdpSocket::MaxDatagramSize);
+	std::vector<bool> delivered(_messageCount, false);
+	std::uint64_t bytesSent{ 0 };
+	std::uint64_t fragmentsSent{ 0 };
+	std::uint64_t fragmentsDropped{ 0 };
+	std::uint64_t corrupted{ 0 };
+	std::uint64_t duplicates{ 0 };
+	double expectedDelivered{ 0.0 };
+	double time{ 0.0 };
+
+	constexpr std::size_t codeSize{ sizeof(std::underlying_type_t<NK::PACKET_CODE>) };
+	std::vector<std::uint8_t> fragmentCode;
+	NK::PacketHeader::Write(fragmentCode, NK::PACKET_CODE::FRAGMENT);
+
+	//Pulls everything waiting on the receiver through the reassembler - done after every datagram so the socket's receive buffer never fills up and drops things on its own
+	const auto drain{ [&]()
+	{
+		std::size_t received{ 0 };
+		std::optional<sf::IpAddress> address;
+		unsigned short port{ 0 };
+		while (receiver.receive(datagram.data(), datagram.size(), received, address, port) == sf::Socket::Status::Done)
+		{
+			//Like ClientNetworkLayer - anything small enough went as it is, anything else needs putting back together
+			if (received >= codeSize && std::memcmp(datagram.data(), fragmentCode.data(), codeSize) == 0)
+			{
+				if (!reassembler.Add(datagram.data() + codeSize, received - codeSize, time, reassembled)) { continue; }
+			}
+			else { reassembled.assign(datagram.begin(), datagram.begin() + received); }
+
+			std::uint32_t message{ 0 };
+			if (!CheckPacket(reassembled, message) || message >= _messageCount) { ++corrupted; }
+			else if (delivered[message]) { ++duplicates; }
+			else { delivered[message] = true; }
+		}
+	} };
+
+	const std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+	for (std::uint32_t message{ 0 }; message < _messageCount; ++message)
+	{
+		BuildPacket(message, sizeDistribution(rng), packet);
+		bytesSent += packet.size();
+
+		std::size_t fragmentCount{ 0 };
+		fragmenter.Send(packet, [&](const std::uint8_t* _data, const std::size_t _size)
+		{
+			++fragmentCount;
+			if (lossDistribution(rng))
+			{
+				++fragmentsDropped;
+				return;
+			}
+			if (sender.send(_data, _size, sf::IpAddress::LocalHost, receiverPort) != sf::Socket::Status::Done)
+			{
+				std::cerr << "Failed to send fragment\n";
+			}
+			++fragmentsSent;
+			drain();
+		});
+		expectedDelivered += std::pow(1.0 - _loss, static_cast<double>(fragmentCount));
+
+		drain();
+		time += TICK_LENGTH;
+	}
+	const double seconds{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+
+	std::size_t deliveredCount{ 0 };
+	for (const bool d : delivered) { deliveredCount += d; }
+
+	std::cout << "# NekiNetBench v1 - fragmentation, " << _messageCount << " messages, " << _loss << " loss, seed " << _seed << '\n';
+	std::cout << "metric\tvalue\n";
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "sent\t" << _messageCount << '\n';
+	std::cout << "delivered\t" << deliveredCount << '\n';
+	std::cout << "expected_delivered\t" << expectedDelivered << '\n';
+	std::cout << "corrupted\t" << corrupted << '\n';
+	std::cout << "duplicates\t" << duplicates << '\n';
+	std::cout << "fragments_sent\t" << fragmentsSent << '\n';
+	std::cout << "fragments_dropped\t" << fragmentsDropped << '\n';
+	std::cout << "reassembler_dropped\t" << reassembler.GetDroppedPacketCount() << '\n';
+	std::cout << "reassembler_malformed\t" << reassembler.GetMalformedFragmentCount() << '\n';
+	std::cout << "reassembler_pending_bytes\t" << reassembler.GetPendingBytes() << '\n';
+	std::cout << "throughput_mb_s\t" << (static_cast<double>(bytesSent) / (1024.0 * 1024.0)) / seconds << '\n';
+
+	const bool failed{ corrupted != 0 || duplicates != 0 || reassembler.GetMalformedFragmentCount() != 0 || (_loss == 0.0 && deliveredCount != _messageCount) };
+	return failed ? 1 : 0;
+}
+
+
+
+static int RunChannels(const double _loss, const std::uint32_t _messageCount, const std::uint32_t _seed)
+{
+	constexpr double linkLatency{ 0.05 };
+	constexpr double linkJitter{ 0.02 };
+	constexpr double drainTime{ 10.0 }; //How long to keep going after the last message is sent, for the stragglers
+
+	std::mt19937 rng{ _seed };
+	std::bernoulli_distribution lossDistribution{ _loss };
+	std::uniform_real_distribution<double> latencyDistribution{ linkLatency, linkLatency + linkJitter };
+	std::uniform_int_distribution<std::size_t> sizeDistribution{ sizeof(std::uint32_t), 256 };
+
+	NK::NetworkConnection sender{ NK::NetworkConnectionConfig{} };
+	NK::NetworkConnection receiver{ NK::NetworkConnectionConfig{} };
+	struct InFlight
+	{
+		double arrival;
+		bool toReceiver;
+		std::vector<std::uint8_t> bytes;
+	};
+	std::vector<InFlight> link;
+
+	std::vector<double> sendTimes;
+	std::vector<double> latencies;
+	std::vector<std::uint8_t> message;
+	std::uint32_t nextExpected{ 0 };
+	std::uint64_t outOfOrder{ 0 };
+	std::uint64_t corrupted{ 0 };
+	std::uint64_t refused{ 0 };
+
+	const double lastSend{ static_cast<double>(_messageCount) * TICK_LENGTH };
+	for (std::uint64_t tick{ 0 }; nextExpected < _messageCount && static_cast<double>(tick) * TICK_LENGTH < lastSend + drainTime; ++tick)
+	{
+		const double time{ static_cast<double>(tick) * TICK_LENGTH };
+		if (sendTimes.size() < _messageCount)
+		{
+			const std::uint32_t index{ static_cast<std::uint32_t>(sendTimes.size()) };
+			message.resize(sizeDistribution(rng));
+			for (std::size_t i{ 0 }; i < message.size(); ++i) { message[i] = GetPacketByte(index, i); }
+			std::memcpy(message.data(), &index, sizeof(index));
+			if (sender.Send(NK::NETWORK_CHANNEL::RELIABLE_ORDERED, message.data(), message.size())) { sendTimes.push_back(time); }
+			else { ++refused; }
+		}
+
+		//Both ends send a packet every tick, like the layers do with their state packets
+		for (const bool toReceiver : { true, false })
+		{
+			std::vector<std::uint8_t> bytes;
+			(toReceiver ? sender : receiver).Write(bytes, time, 1024);
+			if (!lossDistribution(rng)) { link.push_back({ time + latencyDistribution(rng), toReceiver, std::move(bytes) }); }
+		}
+
+		for (std::size_t i{ 0 }; i < link.size();)
+		{
+			if (link[i].arrival > time)
+			{
+				++i;
+				continue;
+			}
+			NK::NetworkConnection& connection{ link[i].toReceiver ? receiver : sender };
+			if (connection.Read(link[i].bytes.data(), link[i].bytes.size(), time) != link[i].bytes.size()) { ++corrupted; }
+			link[i] = std::move(link.back());
+			link.pop_back();
+		}
+
+		receiver.PopReceived([&](const NK::NETWORK_CHANNEL, const std::uint8_t* _data, const std::size_t _size)
+		{
+			std::uint32_t index{ 0 };
+			if (_size < sizeof(index))
+			{
+				++corrupted;
+				return;
+			}
+			std::memcpy(&index, _data, sizeof(index));
+			if (index != nextExpected || index >= sendTimes.size())
+			{
+				++outOfOrder;
+				return;
+			}
+			for (std::size_t i{ sizeof(index) }; i < _size; ++i)
+			{
+				if (_data[i] != GetPacketByte(index, i))
+				{
+					++corrupted;
+					break;
+				}
+			}
+			latencies.push_back(time - sendTimes[index]);
+			++nextExpected;
+		});
+		sender.PopReceived([&](const NK::NETWORK_CHANNEL, const std::uint8_t*, const std::size_t) { ++corrupted; }); //Nothing goes the other way
+	}
+
+	std::ranges::sort(latencies);
+	const auto percentile{ [&](const double _p) { return latencies.empty() ? 0.0 : latencies[std::min(latencies.size() - 1, static_cast<std::size_t>(_p * static_cast<double>(latencies.size())))] * 1000.0; } };
+
+	std::cout << "# NekiNetBench v1 - channels, " << _messageCount << " messages, " << _loss << " loss, seed " << _seed << '\n';
+	std::cout << "metric\tvalue\n";
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "sent\t" << sendTimes.size() << '\n';
+	std::cout << "refused\t" << refused << '\n';
+	std::cout << "delivered\t" << nextExpected << '\n';
+	std::cout << "out_of_order\t" << outOfOrder << '\n';
+	std::cout << "corrupted\t" << corrupted << '\n';
+	std::cout << "resent\t" << sender.GetResentCount() << '\n';
+	std::cout << "rtt_ms\t" << sender.GetRoundTripTime() * 1000.0 << '\n';
+	std::cout << "latency_p50_ms\t" << percentile(0.5) << '\n';
+	std::cout << "latency_p99_ms\t" << percentile(0.99) << '\n';
+	std::cout << "latency_max_ms\t" << percentile(1.0) << '\n';
+
+	const bool failed{ corrupted != 0 || outOfOrder != 0 || (_loss < 1.0 && nextExpected != sendTimes.size()) };
+	return failed ? 1 : 0;
+}
+
+
+
+static int RunScaling(const std::uint32_t _tickCount, const std::uint32_t _seed)
+{
+	constexpr std::array<std::size_t, 6> clientCounts{ 10, 50, 100, 250, 500, 1000 };
+	constexpr std::size_t acceptBatchSize{ 64 };
+	constexpr double activeFraction{ 0.05 }; //Clients sending something each tick - most have nothing to say most of the time
+
+	#if defined(__linux__)
+		//Two sockets a client, which is past the usual soft limit of 1024 by the end
+		rlimit limit{};
+		if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+		{
+			limit.rlim_cur = limit.rlim_max;
+			setrlimit(RLIMIT_NOFILE, &limit);
+		}
+	#endif
+
+	std::mt19937 rng{ _seed };
+
+	std::cout << "# NekiNetBench v1 - scaling, " << _tickCount << " ticks, seed " << _seed << '\n';
+	std::cout << "clients\taccept_ms\taccept_batches\tscan_us\tpoll_us\tready_sockets\tspeedup\n";
+	std::cout << std::fixed << std::setprecision(2);
+
+	for (const std::size_t clientCount : clientCounts)
+	{
+		sf::TcpListener listener;
+		if (listener.listen(sf::Socket::AnyPort, sf::IpAddress::LocalHost) != sf::Socket::Status::Done)
+		{
+			std::cerr << "Failed to listen on loopback\n";
+			return 1;
+		}
+		listener.setBlocking(false);
+		const unsigned short port{ listener.getLocalPort() };
+
+		NK::SocketPoller poller;
+		constexpr std::uint64_t listenerID{ std::numeric_limits<std::uint64_t>::max() };
+		if (!poller.Add(listener, listenerID))
+		{
+			std::cerr << "Failed to add the listener to the poller\n";
+			return 1;
+		}
+
+
+		//Connect a batch at a time (so the listen backlog never overflows), and time letting each batch in
+		std::vector<sf::TcpSocket> clients(clientCount);
+		std::vector<sf::TcpSocket> connections(clientCount);
+		std::vector<std::uint64_t> ready;
+		std::size_t accepted{ 0 };
+		std::size_t acceptBatches{ 0 };
+		double acceptSeconds{ 0.0 };
+		for (std::size_t connected{ 0 }; accepted < clientCount;)
+		{
+			for (const std::size_t batchEnd{ std::min(connected + acceptBatchSize, clientCount) }; connected < batchEnd; ++connected)
+			{
+				if (clients[connected].connect(sf::IpAddress::LocalHost, port, sf::seconds(5.0f)) != sf::Socket::Status::Done)
+				{
+					std::cerr << "Failed to connect client " << connected << " of " << clientCount << " - out of file descriptors?\n";
+					return 1;
+				}
+			}
+
+			const std::size_t acceptedBefore{ accepted };
+			const std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+			poller.Wait(sf::milliseconds(1000), ready);
+			for (std::size_t i{ 0 }; i < acceptBatchSize && accepted < connected; ++i)
+			{
+				connections[accepted].setBlocking(false);
+				if (listener.accept(connections[accepted]) != sf::Socket::Status::Done) { break; }
+				if (!poller.Add(connections[accepted], accepted))
+				{
+					std::cerr << "Failed to add connection " << accepted << " to the poller\n";
+					return 1;
+				}
+				++accepted;
+			}
+			acceptSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			++acceptBatches;
+			if (accepted == acceptedBefore)
+			{
+				std::cerr << "Timed out accepting connections (" << accepted << " of " << clientCount << ")\n";
+				return 1;
+			}
+		}
+
+
+		//Alternate between the two ways of finding the packets, with the same traffic for both
+		const std::size_t activeCount{ std::max<std::size_t>(1, static_cast<std::size_t>(static_cast<double>(clientCount) * activeFraction)) };
+		std::uniform_int_distribution<std::size_t> clientDistribution{ 0, clientCount - 1 };
+		std::uint64_t sent{ 0 };
+		std::uint64_t received{ 0 };
+		std::uint64_t readySockets{ 0 };
+		double scanSeconds{ 0.0 };
+		double pollSeconds{ 0.0 };
+		sf::Packet packet;
+		const auto receiveAll{ [&](sf::TcpSocket& _connection)
+		{
+			while (_connection.receive(packet) == sf::Socket::Status::Done) { ++received; }
+		} };
+
+		for (std::uint32_t tick{ 0 }; tick < 2 * _tickCount; ++tick)
+		{
+			for (std::size_t i{ 0 }; i < activeCount; ++i)
+			{
+				packet.clear();
+				packet << tick;
+				if (clients[clientDistribution(rng)].send(packet) == sf::Socket::Status::Done) { ++sent; }
+			}
+
+			const std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+			if (tick % 2 == 0)
+			{
+				for (sf::TcpSocket& connection : connections) { receiveAll(connection); }
+				scanSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			}
+			else
+			{
+				poller.Wait(sf::Time::Zero, ready);
+				for (const std::uint64_t id : ready) { if (id != listenerID) { receiveAll(connections[id]); } }
+				pollSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				readySockets += ready.size();
+			}
+		}
+
+		//Anything that hadn't quite made it through loopback by the time it was looked for
+		for (sf::TcpSocket& connection : connections) { receiveAll(connection); }
+		if (received != sent)
+		{
+			std::cerr << clientCount << " clients: sent " << sent << " packets but received " << received << '\n';
+			return 1;
+		}
+
+		const double scanUs{ scanSeconds / static_cast<double>(_tickCount) * 1e6 };
+		const double pollUs{ pollSeconds / static_cast<double>(_tickCount) * 1e6 };
+		std::cout << clientCount << '\t' << acceptSeconds * 1000.0 << '\t' << acceptBatches << '\t' << scanUs << '\t' << pollUs << '\t' << static_cast<double>(readySockets) / static_cast<double>(_tickCount) << '\t' << (pollUs > 0.0 ? scanUs / pollUs : 0.0) << '\n';
+
+		for (sf::TcpSocket& connection : connections) { poller.Remove(connection); }
+	}
+
+	return 0;
+}
+
+
+
+int main(const int _argc, char** _argv)
+{
+	//The mode can be left out
+	int arg{ 1 };
+	std::string mode{ "fragmentation" };
+	if (_argc > 1 && !std::isdigit(static_cast<unsigned char>(_argv[1][0])) && _argv[1][0] != '.') { mode = _argv[arg++]; }
+
+	const double loss{ _argc > arg ? std::stod(_argv[arg]) : 0.0 };
+	const std::uint32_t messageCount{ _argc > arg + 1 ? static_cast<std::uint32_t>(std::stoul(_argv[arg + 1])) : 1000u };
+	const std::uint32_t seed{ _argc > arg + 2 ? static_cast<std::uint32_t>(std::stoul(_argv[arg + 2])) : 1u };
+	if (loss < 0.0 || loss > 1.0)
+	{
+		std::cerr << "loss must be between 0 and 1\n";
+		return 1;
+	}
+
+	if (mode == "fragmentation") { return RunFragmentation(loss, messageCount, seed); }
+	if (mode == "channels") { return RunChannels(loss, messageCount, seed); }
+	if (mode == "scaling") { return RunScaling(messageCount, seed); }
+	std::cerr << "Unknown mode \"" << mode << "\" - expected fragmentation, channels or scaling\n";
+	return 1;
+}
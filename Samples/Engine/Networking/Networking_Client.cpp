@@ -96,7 +96,7 @@ public:
 		
 
 		//Pre-app layers
-		m_windowLayer = NK::UniquePtr<NK::WindowLayer>(NK_NEW(NK::WindowLayer, m_reg));
+		m_windowLayer = NK::UniquePtr<NK::WindowLayer>(NK_NEW(NK::WindowLayer, m_reg, m_window.get()));
 		NK::InputLayerDesc inputLayerDesc{ m_window.get() };
 		m_inputLayer = NK::UniquePtr<NK::InputLayer>(NK_NEW(NK::InputLayer, m_scenes[m_activeScene]->m_reg, inputLayerDesc));
 		m_playerLayer = NK::UniquePtr<PlayerLayer>(NK_NEW(PlayerLayer, m_scenes[m_activeScene]->m_reg));
@@ -159,7 +159,7 @@ private:
 
 [[nodiscard]] NK::ContextConfig CreateContext()
 {
-	NK::LoggerConfig loggerConfig{ NK::LOGGER_TYPE::CONSOLE, true };
+	NK::LoggerConfig loggerConfig{ NK::LOGGER_TYPE::ASYNC_CONSOLE, true }; //Per-packet logging shouldn't stall the network tick on console i/o
 	loggerConfig.SetLayerChannelBitfield(NK::LOGGER_LAYER::VULKAN_GENERAL, NK::LOGGER_CHANNEL::WARNING | NK::LOGGER_CHANNEL::ERROR);
 	loggerConfig.SetLayerChannelBitfield(NK::LOGGER_LAYER::VULKAN_VALIDATION, NK::LOGGER_CHANNEL::WARNING | NK::LOGGER_CHANNEL::ERROR);
 	loggerConfig.SetLayerChannelBitfield(NK::LOGGER_LAYER::TRACKING_ALLOCATOR, NK::LOGGER_CHANNEL::WARNING | NK::LOGGER_CHANNEL::ERROR);
@@ -0,0 +1,124 @@
+#include "CPlayer.h"
+#include "PlayerLayer.h"
+
+#include <cstdlib>
+#include <string>
+#include <Components/CInput.h>
+#include <Components/CTransform.h>
+#include <Core/EngineConfig.h>
+#include <Core/RAIIContext.h>
+#include <Core/Layers/ServerNetworkLayer.h>
+#include <Managers/InputManager.h>
+
+
+//Same game as Networking_Server, but with no window - build with NEKI_HEADLESS to drop glfw/x11 entirely
+//Set NEKI_SERVER_PORT to run several instances side by side (default: 7777)
+
+
+class GameScene final : public NK::Scene
+{
+public:
+	explicit GameScene() : Scene(1)
+	{
+		m_playerEntity = m_reg.Create();
+		m_reg.AddComponent<NK::CInput>(m_playerEntity);
+		NK::CTransform& transform{ m_reg.AddComponent<NK::CTransform>(m_playerEntity) };
+		transform.SetPosition(glm::vec3(0, 0, 3));
+		CPlayer& player{ m_reg.AddComponent<CPlayer>(m_playerEntity) };
+		player.movementSpeed = 10.0f;
+
+		//Nothing gets pressed on this end, the bindings just tell the server what type of state each action carries when it arrives from a client
+		NK::ButtonBinding aBinding{ NK::KEYBOARD::A };
+		NK::ButtonBinding dBinding{ NK::KEYBOARD::D };
+		NK::ButtonBinding sBinding{ NK::KEYBOARD::S };
+		NK::ButtonBinding wBinding{ NK::KEYBOARD::W };
+		NK::Axis1DBinding moveHorizontalBinding{ { aBinding, dBinding }, { -1, 1 } };
+		NK::Axis1DBinding moveVerticalBinding{ { sBinding, wBinding }, { -1, 1 } };
+		NK::Axis2DBinding moveBinding{ NK::Axis2DBinding({ moveHorizontalBinding, moveVerticalBinding }) };
+		NK::InputManager::BindActionToInput(PLAYER_ACTIONS::MOVE, moveBinding);
+	}
+
+
+	virtual void Update() override {}
+
+
+private:
+	NK::Entity m_playerEntity;
+};
+
+
+class GameApp final : public NK::Application
+{
+public:
+	explicit GameApp() : Application(1)
+	{
+		//Register types
+		NK::TypeRegistry::Register<PLAYER_ACTIONS>("PLAYER_ACTIONS");
+		
+		m_scenes.push_back(NK::UniquePtr<NK::Scene>(NK_NEW(GameScene)));
+		m_activeScene = 0;
+
+
+		//Pre-app layers
+		NK::ServerNetworkLayerDesc serverDesc{};
+		serverDesc.maxClients = 2;
+		serverDesc.type = NK::SERVER_TYPE::LAN;
+		m_serverNetworkLayer = NK::UniquePtr<NK::ServerNetworkLayer>(NK_NEW(NK::ServerNetworkLayer, m_scenes[m_activeScene]->m_reg, serverDesc));
+		m_playerLayer = NK::UniquePtr<PlayerLayer>(NK_NEW(PlayerLayer, m_scenes[m_activeScene]->m_reg));
+		
+		m_preAppLayers.push_back(m_serverNetworkLayer.get());
+		
+		
+		//Post-app layers
+		m_postAppLayers.push_back(m_playerLayer.get());
+		m_postAppLayers.push_back(m_serverNetworkLayer.get());
+
+
+		const char* const portEnv{ std::getenv("NEKI_SERVER_PORT") };
+		const unsigned short port{ portEnv ? static_cast<unsigned short>(std::stoul(portEnv)) : static_cast<unsigned short>(7777) };
+		const NK::NETWORK_LAYER_ERROR_CODE err{ m_serverNetworkLayer->Host(port) };
+		if (!NET_SUCCESS(err))
+		{
+			NK::Context::GetLogger()->IndentLog(NK::LOGGER_CHANNEL::ERROR, NK::LOGGER_LAYER::APPLICATION, "Failed to host - error = " + std::to_string(std::to_underlying(err)) + "\n");
+			throw std::runtime_error("");
+		}
+		NK::Context::GetLogger()->IndentLog(NK::LOGGER_CHANNEL::SUCCESS, NK::LOGGER_LAYER::APPLICATION, "Hosting headless server on port " + std::to_string(port) + "\n");
+	}
+
+
+
+	virtual void Update() override
+	{
+		m_scenes[m_activeScene]->Update();
+	}
+
+
+private:
+	//Pre-app layers
+	NK::UniquePtr<NK::ServerNetworkLayer> m_serverNetworkLayer;
+	NK::UniquePtr<PlayerLayer> m_playerLayer;
+	
+	//Post-app layers
+};
+
+
+
+[[nodiscard]] NK::ContextConfig CreateContext()
+{
+	NK::LoggerConfig loggerConfig{ NK::LOGGER_TYPE::ASYNC_CONSOLE, true };
+	loggerConfig.SetLayerChannelBitfield(NK::LOGGER_LAYER::TRACKING_ALLOCATOR, NK::LOGGER_CHANNEL::WARNING | NK::LOGGER_CHANNEL::ERROR);
+
+	constexpr NK::TrackingAllocatorConfig trackingAllocatorConfig{ NK::TRACKING_ALLOCATOR_VERBOSITY_FLAGS::ALL };
+	constexpr NK::AllocatorConfig allocatorConfig{ NK::ALLOCATOR_TYPE::TRACKING, trackingAllocatorConfig };
+
+	return NK::ContextConfig(loggerConfig, allocatorConfig);
+}
+
+
+
+[[nodiscard]] NK::EngineConfig CreateEngine()
+{
+	NK::EngineConfig config{ NK_NEW(GameApp) };
+	config.sleepBetweenTicks = true; //Even in a non-headless build, there's no point spinning between ticks without anything to draw
+	return config;
+}
@@ -83,7 +83,7 @@ public:
 		
 
 		//Pre-app layers
-		m_windowLayer = NK::UniquePtr<NK::WindowLayer>(NK_NEW(NK::WindowLayer, m_reg));
+		m_windowLayer = NK::UniquePtr<NK::WindowLayer>(NK_NEW(NK::WindowLayer, m_reg, m_window.get()));
 		NK::ServerNetworkLayerDesc serverDesc{};
 		serverDesc.maxClients = 2;
 		serverDesc.type = NK::SERVER_TYPE::LAN;
@@ -135,7 +135,7 @@ private:
 
 [[nodiscard]] NK::ContextConfig CreateContext()
 {
-	NK::LoggerConfig loggerConfig{ NK::LOGGER_TYPE::CONSOLE, true };
+	NK::LoggerConfig loggerConfig{ NK::LOGGER_TYPE::ASYNC_CONSOLE, true }; //Per-packet logging shouldn't stall the network tick on console i/o
 	loggerConfig.SetLayerChannelBitfield(NK::LOGGER_LAYER::VULKAN_GENERAL, NK::LOGGER_CHANNEL::WARNING | NK::LOGGER_CHANNEL::ERROR);
 	loggerConfig.SetLayerChannelBitfield(NK::LOGGER_LAYER::VULKAN_VALIDATION, NK::LOGGER_CHANNEL::WARNING | NK::LOGGER_CHANNEL::ERROR);
 	loggerConfig.SetLayerChannelBitfield(NK::LOGGER_LAYER::TRACKING_ALLOCATOR, NK::LOGGER_CHANNEL::WARNING | NK::LOGGER_CHANNEL::ERROR);
@@ -4,7 +4,6 @@
 
 #include <Core/Layers/ILayer.h>
 #include <Core-ECS/Registry.h>
-#include <Graphics/Window.h>
 #include <Managers/EventManager.h>
 #include <Types/NekiTypes.h>
 
@@ -25,6 +25,7 @@
 #include <Managers/TimeManager.h>
 
 #include <imgui.h>
+#include <span>
 #include <glm/gtx/string_cast.hpp>
 
 
@@ -131,7 +132,8 @@ public:
 		
 		
 		//Collision event
-		NK::EventManager::Subscribe<GameScene2, NK::CollisionEvent>(this, &GameScene2::OnCollision);
+		//Collision events are queued from physics worker threads and handed over in one batch per dispatch
+		NK::EventManager::SubscribeQueued<GameScene2, NK::CollisionEvent>(this, &GameScene2::OnCollisions);
 	}
 
 
@@ -142,9 +144,9 @@ public:
 	
 	
 	
-	inline void OnCollision(const NK::CollisionEvent& _event)
+	inline void OnCollisions(const std::span<const NK::CollisionEvent> _events)
 	{
-		std::cout << "Collision occurred\n";
+		std::cout << _events.size() << " collision(s) occurred\n";
 	}
 
 
@@ -324,7 +326,7 @@ public:
 
 
 		//Pre-app layers
-		m_windowLayer = NK::UniquePtr<NK::WindowLayer>(NK_NEW(NK::WindowLayer, m_reg));
+		m_windowLayer = NK::UniquePtr<NK::WindowLayer>(NK_NEW(NK::WindowLayer, m_reg, m_window.get()));
 		NK::InputLayerDesc inputLayerDesc{ m_window.get() };
 		m_inputLayer = NK::UniquePtr<NK::InputLayer>(NK_NEW(NK::InputLayer, m_scenes[m_activeScene]->m_reg, inputLayerDesc));
 		
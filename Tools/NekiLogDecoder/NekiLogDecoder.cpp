@@ -0,0 +1,289 @@
+#include <Core/Debug/BinaryLogFormat.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+//Turns the .nklog files written by NK::BinaryLogger back into text (the same layout ConsoleLogger prints, prefixed with a timestamp) or JSON (one object per line)
+//Usage: NekiLogDecoder [--json] <file or directory>...
+//Directories are expanded to every .nklog file inside them, in rotation order
+
+
+
+using namespace NK::BinaryLogFormat;
+
+
+
+//Widths match ILogger::LOGGER_WIDTH
+constexpr int CHANNEL_WIDTH{ 10 };
+constexpr int LAYER_WIDTH{ 25 };
+
+
+
+[[nodiscard]] static std::string EscapeJSON(const std::string_view _string)
+{
+	std::string out;
+	out.reserve(_string.size() + 2);
+	for (const char c : _string)
+	{
+		switch (c)
+		{
+		case '"':	out += "\\\""; break;
+		case '\\':	out += "\\\\"; break;
+		case '\n':	out += "\\n"; break;
+		case '\r':	out += "\\r"; break;
+		case '\t':	out += "\\t"; break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				char buffer[8];
+				std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+				out += buffer;
+			}
+			else { out += c; }
+			break;
+		}
+	}
+	return out;
+}
+
+
+
+[[nodiscard]] static std::string ArgToJSON(const NK::LogArg& _arg)
+{
+	switch (_arg.type)
+	{
+	case NK::LOG_ARG_TYPE::STRING:	return "\"" + EscapeJSON(_arg.s) + "\"";
+	case NK::LOG_ARG_TYPE::BOOL:	return (_arg.b ? "true" : "false");
+	default:						return _arg.ToString();
+	}
+}
+
+
+
+//Returns false if the file isn't a valid log
+static bool DecodeFile(const std::filesystem::path& _path, const bool _json)
+{
+	std::ifstream file(_path, std::ios::binary);
+	if (!file)
+	{
+		std::cerr << "Failed to open " << _path.string() << '\n';
+		return false;
+	}
+	const std::vector<char> data{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+	FileHeader header{};
+	if (data.size() < sizeof(header)) { std::cerr << _path.string() << " is too small to be a log file\n"; return false; }
+	std::memcpy(&header, data.data(), sizeof(header));
+	if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) { std::cerr << _path.string() << " is not a Neki binary log\n"; return false; }
+	if (header.version != VERSION) { std::cerr << _path.string() << " has unsupported version " << header.version << " (expected " << VERSION << ")\n"; return false; }
+
+	std::unordered_map<std::uint32_t, std::string> formats;
+	std::unordered_map<std::uint32_t, std::string> layers;
+	std::vector<NK::LogArg> args;
+
+	std::size_t offset{ sizeof(header) };
+	while (offset + sizeof(RecordHeader) <= data.size())
+	{
+		RecordHeader recordHeader{};
+		std::memcpy(&recordHeader, data.data() + offset, sizeof(recordHeader));
+		if (recordHeader.size == 0 || recordHeader.type == RECORD_TYPE::END) { break; } //Unwritten space (file was never closed, e.g. the process crashed)
+		if (recordHeader.size < sizeof(RecordHeader) || offset + recordHeader.size > data.size())
+		{
+			std::cerr << _path.string() << " - record at offset " << offset << " is truncated or corrupt, stopping\n";
+			break;
+		}
+
+		const std::size_t recordOffset{ offset };
+		const char* body{ data.data() + offset + sizeof(RecordHeader) };
+		const char* const bodyEnd{ data.data() + offset + recordHeader.size };
+		const std::size_t bodySize{ recordHeader.size - sizeof(RecordHeader) };
+		offset += recordHeader.size;
+
+		switch (recordHeader.type)
+		{
+		case RECORD_TYPE::FORMAT_DEFINITION:
+		{
+			FormatDefinitionRecord definition{};
+			if (bodySize < sizeof(definition))
+			{
+				std::cerr << _path.string() << " - record at offset " << recordOffset << " is truncated or corrupt, stopping\n";
+				return true;
+			}
+			std::memcpy(&definition, body, sizeof(definition));
+			if (body + sizeof(definition) + definition.length > bodyEnd) { break; }
+			formats[definition.formatID] = std::string(body + sizeof(definition), definition.length);
+			break;
+		}
+
+		case RECORD_TYPE::LAYER_NAME:
+		{
+			LayerNameRecord layer{};
+			if (bodySize < sizeof(layer))
+			{
+				std::cerr << _path.string() << " - record at offset " << recordOffset << " is truncated or corrupt, stopping\n";
+				return true;
+			}
+			std::memcpy(&layer, body, sizeof(layer));
+			if (body + sizeof(layer) + layer.length > bodyEnd) { break; }
+			layers[layer.layer] = std::string(body + sizeof(layer), layer.length);
+			break;
+		}
+
+		case RECORD_TYPE::MESSAGE:
+		{
+			MessageRecord message{};
+			if (bodySize < sizeof(message))
+			{
+				std::cerr << _path.string() << " - record at offset " << recordOffset << " is truncated or corrupt, stopping\n";
+				return true;
+			}
+			std::memcpy(&message, body, sizeof(message));
+			const char* cursor{ body + sizeof(message) };
+
+			args.clear();
+			bool valid{ true };
+			for (std::uint8_t i{ 0 }; i < message.argCount && valid; ++i)
+			{
+				if (cursor + 1 > bodyEnd) { valid = false; break; }
+				NK::LOG_ARG_TYPE type;
+				std::memcpy(&type, cursor, sizeof(type));
+				cursor += sizeof(type);
+
+				if (type == NK::LOG_ARG_TYPE::STRING)
+				{
+					std::uint32_t length{ 0 };
+					if (cursor + sizeof(length) > bodyEnd) { valid = false; break; }
+					std::memcpy(&length, cursor, sizeof(length));
+					cursor += sizeof(length);
+					if (cursor + length > bodyEnd) { valid = false; break; }
+					args.emplace_back(std::string_view(cursor, length));
+					cursor += length;
+				}
+				else
+				{
+					std::uint64_t value{ 0 };
+					if (cursor + sizeof(value) > bodyEnd) { valid = false; break; }
+					std::memcpy(&value, cursor, sizeof(value));
+					cursor += sizeof(value);
+					switch (type)
+					{
+					case NK::LOG_ARG_TYPE::INT:		args.emplace_back(static_cast<std::int64_t>(value)); break;
+					case NK::LOG_ARG_TYPE::UINT:	args.emplace_back(value); break;
+					case NK::LOG_ARG_TYPE::FLOAT:	{ double f; std::memcpy(&f, &value, sizeof(f)); args.emplace_back(f); break; }
+					case NK::LOG_ARG_TYPE::BOOL:	args.emplace_back(value != 0); break;
+					default:						valid = false; break;
+					}
+				}
+			}
+			if (!valid)
+			{
+				std::cerr << _path.string() << " - message record has malformed arguments, skipping\n";
+				break;
+			}
+
+			const std::unordered_map<std::uint32_t, std::string>::const_iterator formatIt{ formats.find(message.formatID) };
+			const std::string format{ formatIt != formats.end() ? formatIt->second : "<unknown format " + std::to_string(message.formatID) + ">" };
+			const std::string text{ NK::FormatLogMessage(format, args) };
+			const std::string channel{ message.channel < std::size(CHANNEL_NAMES) ? CHANNEL_NAMES[message.channel] : "DEFAULT" };
+			const std::unordered_map<std::uint32_t, std::string>::const_iterator layerIt{ layers.find(message.layer) };
+			const std::string layer{ layerIt != layers.end() ? layerIt->second : "LAYER " + std::to_string(message.layer) };
+			const bool formatted{ (std::to_underlying(message.flags) & std::to_underlying(MESSAGE_FLAGS::FORMATTED)) != 0 };
+
+			if (_json)
+			{
+				std::cout << "{\"file\":" << header.fileIndex
+				          << ",\"time_ns\":" << (header.startUnixTimeNs + message.timestampNs)
+				          << ",\"thread\":" << message.threadID
+				          << ",\"channel\":\"" << channel << '"'
+				          << ",\"layer\":\"" << EscapeJSON(layer) << '"'
+				          << ",\"indentation\":" << message.indentation
+				          << ",\"formatted\":" << (formatted ? "true" : "false")
+				          << ",\"format\":\"" << EscapeJSON(format) << '"'
+				          << ",\"args\":[";
+				for (std::size_t i{ 0 }; i < args.size(); ++i) { std::cout << (i == 0 ? "" : ",") << ArgToJSON(args[i]); }
+				std::cout << "],\"message\":\"" << EscapeJSON(text) << "\"}\n";
+			}
+			else
+			{
+				//Raw messages are usually continuations of the previous line, so they get no prefix - same as on the console
+				if (formatted)
+				{
+					std::cout << '[' << std::right << std::setw(14) << std::fixed << std::setprecision(6) << (static_cast<double>(message.timestampNs) / 1e9) << "] "
+					          << std::left << std::setw(CHANNEL_WIDTH) << ("[" + channel + "]")
+					          << std::left << std::setw(LAYER_WIDTH) << ("[" + layer + "]");
+				}
+				std::cout << std::string(std::max<int>(message.indentation, 0) * 2, ' ') << text;
+			}
+			break;
+		}
+
+		default:
+			//Unknown record types from a newer writer are skipped over
+			break;
+		}
+	}
+
+	return true;
+}
+
+
+
+int main(const int _argc, char** _argv)
+{
+	bool json{ false };
+	std::vector<std::filesystem::path> files;
+
+	for (int i{ 1 }; i < _argc; ++i)
+	{
+		const std::string_view arg{ _argv[i] };
+		if (arg == "--json") { json = true; continue; }
+		if (arg == "--help" || arg == "-h")
+		{
+			std::cout << "Usage: NekiLogDecoder [--json] <file or directory>...\n";
+			return 0;
+		}
+
+		const std::filesystem::path path{ arg };
+		if (std::filesystem::is_directory(path))
+		{
+			std::vector<std::filesystem::path> directoryFiles;
+			for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(path))
+			{
+				if (entry.is_regular_file() && entry.path().extension() == FILE_EXTENSION) { directoryFiles.push_back(entry.path()); }
+			}
+			//File names end in <start time>_<zero-padded index>, so name order is rotation order
+			std::ranges::sort(directoryFiles);
+			files.insert(files.end(), directoryFiles.begin(), directoryFiles.end());
+		}
+		else
+		{
+			files.push_back(path);
+		}
+	}
+
+	if (files.empty())
+	{
+		std::cerr << "Usage: NekiLogDecoder [--json] <file or directory>...\n";
+		return 1;
+	}
+
+	bool success{ true };
+	for (const std::filesystem::path& file : files)
+	{
+		success &= DecodeFile(file, json);
+	}
+	std::cout << std::flush;
+
+	return (success ? 0 : 1);
+}
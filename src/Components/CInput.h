@@ -18,7 +18,9 @@ namespace NK
 		friend class ClientNetworkLayer;
 		friend class ServerNetworkLayer;
 		friend class InputLayer;
+		friend class NetworkInputCodec;
 		friend class PlayerCameraLayer;
+		friend class Replay;
 		
 		
 	public:
@@ -4,12 +4,20 @@
 
 #include "CImGuiInspectorRenderable.h"
 
-#include <Graphics/GPUUploader.h>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
 
 
 namespace NK
 {
 
+	//Only pointed to here, so GPUUploader.h (and the RHI behind it) stays out of anything that just needs the component - e.g. NEKI_HEADLESS builds, where none of it is compiled
+	struct GPUModel;
+
+
 	struct CModelRenderer final : public CImGuiInspectorRenderable
 	{
 		friend class ModelVisibilityLayer;
@@ -4,9 +4,12 @@
 
 #include <Core/Utils/Serialisation/Serialisation.h>
 #include <Core/Utils/Serialisation/TypeRegistry.h>
+#include <Networking/PacketStreamBuf.h>
 #include <Types/NekiTypes.h>
 
+#include <ostream>
 #include <SFML/Network.hpp>
+#include <cereal/archives/binary.hpp>
 
 
 namespace NK
@@ -21,12 +24,13 @@ namespace NK
 			eventPacket << std::to_underlying(PACKET_CODE::EVENT);
 			eventPacket << TypeRegistry::GetConstant(typeid(EventPacket));
 
-			std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+			//Archived straight onto the end of the packet
+			PacketOutputStreamBuf buf{ eventPacket };
+			std::ostream stream{ &buf };
 			{
-				cereal::BinaryOutputArchive archive(ss);
-				archive(inputComponents);
+				cereal::BinaryOutputArchive archive(stream);
+				archive(_packet);
 			}
-			eventPacket.append(ss.str().c_str(), ss.str().size());
 		}
 		
 		SERIALISE_MEMBER_FUNC(eventPacket)
@@ -17,6 +17,7 @@ namespace NK
 
 	struct CTransform final : public CImGuiInspectorRenderable
 	{
+		friend class Engine;
 		friend class Registry;
 		friend class RenderLayer;
 		friend class PhysicsLayer;
@@ -62,6 +63,29 @@ namespace NK
 			return localMatrix;
 		}
 
+		//Same result as GetModelMatrix(), but never writes the cached local matrix - for layers that only declare read access to CTransform (see LayerAccess) and so might be running alongside other readers
+		[[nodiscard]] inline glm::mat4 ComputeModelMatrix() const
+		{
+			const glm::mat4 local{ localMatrixDirty ? glm::translate(glm::mat4(1.0f), localPos) * glm::mat4_cast(localRot) * glm::scale(glm::mat4(1.0f), localScale) : localMatrix };
+			return (parent ? parent->ComputeModelMatrix() * local : local);
+		}
+
+		//The model matrix to draw with - blends between the last two fixed updates by _alpha (see FixedStepScheduler::GetAlpha()) so things moved at the fixed rate still move smoothly at higher frame rates
+		//Anything that's been moved outside of the fixed update since (e.g. in Update() or by the editor) is just drawn where it is
+		[[nodiscard]] inline glm::mat4 ComputeInterpolatedModelMatrix(const float _alpha) const
+		{
+			glm::mat4 local;
+			if (localPos == fixedEndPos && localRot == fixedEndRot && localScale == fixedEndScale && (fixedStartPos != fixedEndPos || fixedStartRot != fixedEndRot || fixedStartScale != fixedEndScale))
+			{
+				local = glm::translate(glm::mat4(1.0f), glm::mix(fixedStartPos, fixedEndPos, _alpha)) * glm::mat4_cast(glm::slerp(fixedStartRot, fixedEndRot, _alpha)) * glm::scale(glm::mat4(1.0f), glm::mix(fixedStartScale, fixedEndScale, _alpha));
+			}
+			else
+			{
+				local = (localMatrixDirty ? glm::translate(glm::mat4(1.0f), localPos) * glm::mat4_cast(localRot) * glm::scale(glm::mat4(1.0f), localScale) : localMatrix);
+			}
+			return (parent ? parent->ComputeInterpolatedModelMatrix(_alpha) * local : local);
+		}
+
 		
 		//Returns true if successful
 		//(will return false in the case of an attempted circular parenting)
@@ -170,6 +194,20 @@ namespace NK
 		
 		
 	private:
+		//To be called by the Engine around the last fixed update of each frame
+		inline void StoreFixedUpdateStartState()
+		{
+			fixedStartPos = localPos;
+			fixedStartRot = localRot;
+			fixedStartScale = localScale;
+		}
+		inline void StoreFixedUpdateEndState()
+		{
+			fixedEndPos = localPos;
+			fixedEndRot = localRot;
+			fixedEndScale = localScale;
+		}
+		
 		//To be called by the PhysicsLayer
 		inline void SyncPosition(const glm::vec3 _val)
 		{
@@ -288,6 +326,14 @@ namespace NK
 		glm::quat localRot{ glm::quat(1.0f, 0.0f, 0.0f, 0.0f) }; //identity quaternion (wxyz: .w=1, .xyz=0)
 		glm::vec3 localScale{ glm::vec3(1.0f) };
 		
+		//Local pos/rot/scale from before and after the last fixed update, for ComputeInterpolatedModelMatrix()
+		glm::vec3 fixedStartPos{ glm::vec3(0.0f) };
+		glm::quat fixedStartRot{ glm::quat(1.0f, 0.0f, 0.0f, 0.0f) };
+		glm::vec3 fixedStartScale{ glm::vec3(1.0f) };
+		glm::vec3 fixedEndPos{ glm::vec3(0.0f) };
+		glm::quat fixedEndRot{ glm::quat(1.0f, 0.0f, 0.0f, 0.0f) };
+		glm::vec3 fixedEndScale{ glm::vec3(1.0f) };
+		
 		
 		//UI
 		bool local{ true }; //Local if true, world if false
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <Core/Memory/Allocation.h>
-#include <Graphics/Window.h>
+#ifndef NEKI_HEADLESS
+	#include <Graphics/Window.h>
+#endif
 
 
 namespace NK
@@ -3,6 +3,8 @@
 #include "Entity.h"
 #include "Registry.h"
 
+#include <utility>
+
 
 namespace NK
 {
@@ -18,10 +20,17 @@ namespace NK
 			std::size_t minSize{ SIZE_MAX };
 
 			//Fold expression to find the smallest pool, this is so sick....
+			//Goes through the const GetPool() so a missing pool isn't created here - views are built by layers running in parallel, and only AddComponent() (a structural change) may insert into the registry's pool map
+			//A missing pool means no entity has that component, so the view is empty
 			([&]
 			{
-				const ComponentPool<Components>* componentPool{ m_reg->GetPool<Components>() };
-				if (componentPool->components.size() < minSize)
+				const ComponentPool<Components>* componentPool{ std::as_const(*m_reg).GetPool<Components>() };
+				if (!componentPool)
+				{
+					minSize = 0;
+					m_iteratingPoolEntities = &m_noEntities;
+				}
+				else if (componentPool->components.size() < minSize)
 				{
 					minSize = componentPool->components.size();
 					m_iteratingPoolEntities = &(componentPool->indexToEntity);
@@ -102,6 +111,9 @@ namespace NK
 
 		//Iterate over entities in the smallest component pool for efficiency
 		const std::vector<Entity>* m_iteratingPoolEntities;
+
+		//What m_iteratingPoolEntities points at when one of the pools doesn't exist yet
+		inline static const std::vector<Entity> m_noEntities{};
 	};
 
 }
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include <memory>
 #include <typeindex>
 #include <unordered_map>
+#include <utility>
 #include <fstream>
 #include <filesystem>
 
@@ -261,8 +262,9 @@ namespace NK
 				throw std::invalid_argument("Registry::RemoveComponent() - provided _entity (" + std::to_string(_entity) + ") is not in registry.");
 			}
 			
-			ComponentPool<Component>* pool{ GetPool<Component>() };
-			if (!pool->entityToIndex.contains(_entity))
+			//Const lookup so this never creates a pool - it's called from views on layers running in parallel
+			ComponentPool<Component>* pool{ const_cast<ComponentPool<Component>*>(std::as_const(*this).GetPool<Component>()) };
+			if (!pool || !pool->entityToIndex.contains(_entity))
 			{
 				throw std::invalid_argument("Registry::GetComponent() - provided _entity (" + std::to_string(_entity) + ") does not have the provided component.");
 			}
@@ -347,6 +349,7 @@ namespace NK
 		}
 		
 		
+		//Creates the pool if it doesn't exist yet - this inserts into m_componentPools, so it's only for structural changes (adding / removing components), never for lookups that could be running on more than one thread
 		template<typename Component>
 		[[nodiscard]] inline ComponentPool<Component>* GetPool()
 		{
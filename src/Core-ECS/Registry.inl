@@ -3,6 +3,7 @@
 #include "ComponentView.h"
 
 #include <Components/CCamera.h>
+#include <Core/Debug/Profiler.h>
 
 
 namespace NK
@@ -44,6 +45,8 @@ namespace NK
 	
 	inline void Registry::Load(const std::string& _filepath)
 	{
+		NK_PROFILE_SCOPE("Registry::Load()");
+
 		if (!std::filesystem::exists(_filepath))
 		{
 			throw std::runtime_error("Registry::Load() - Failed to open filepath (" + _filepath +") for loading.");
@@ -2,6 +2,10 @@
 
 #include "Scene.h"
 #include "Layers/ILayer.h"
+#include "Layers/LayerGraph.h"
+
+#include <iomanip>
+#include <sstream>
 
 
 namespace NK
@@ -18,18 +22,12 @@ namespace NK
 
 		inline virtual void PreFixedUpdate() const final
 		{
-			for (ILayer* const l : m_preAppLayers)
-			{
-				l->FixedUpdate();
-			}
+			m_preAppFixedUpdateGraph.Execute(m_preAppLayers);
 		}
 		
 		inline virtual void PreUpdate() const final
 		{
-			for (ILayer* const l : m_preAppLayers)
-			{
-				l->Update();
-			}
+			m_preAppUpdateGraph.Execute(m_preAppLayers);
 		}
 
 		//Call m_scenes[m_activeScene]->Update() somewhere in your inherited Application::Update() method
@@ -39,19 +37,52 @@ namespace NK
 
 		inline virtual void PostFixedUpdate() const final
 		{
-			for (ILayer* const l : m_postAppLayers)
-			{
-				l->FixedUpdate();
-			}
+			m_postAppFixedUpdateGraph.Execute(m_postAppLayers);
 		}
 		
 		inline virtual void PostUpdate() const final
 		{
-			for (ILayer* const l : m_postAppLayers)
+			m_postAppUpdateGraph.Execute(m_postAppLayers);
+		}
+
+		//Timings from the last time _phase was run - layers that don't conflict (see ILayer::GetAccess()) overlap, so the phase takes as long as its critical path rather than the sum of its layers
+		[[nodiscard]] inline const LayerGraph& GetLayerGraph(const LAYER_PHASE _phase) const
+		{
+			switch (_phase)
 			{
-				l->Update();
+			case LAYER_PHASE::PRE_APP_FIXED_UPDATE:		return m_preAppFixedUpdateGraph;
+			case LAYER_PHASE::PRE_APP_UPDATE:			return m_preAppUpdateGraph;
+			case LAYER_PHASE::POST_APP_FIXED_UPDATE:	return m_postAppFixedUpdateGraph;
+			default:									return m_postAppUpdateGraph;
 			}
 		}
+
+		//Logs each layer's timing in every phase, with the layers on each phase's critical path marked
+		inline void LogLayerTimings() const
+		{
+			ILogger& logger{ *Context::GetLogger() };
+			logger.Indent();
+			logger.Log(LOGGER_CHANNEL::HEADING, LOGGER_LAYER::ENGINE, "Layer Timings (* = critical path, [W] = ran on a worker thread)\n");
+			for (const LAYER_PHASE phase : { LAYER_PHASE::PRE_APP_FIXED_UPDATE, LAYER_PHASE::PRE_APP_UPDATE, LAYER_PHASE::POST_APP_FIXED_UPDATE, LAYER_PHASE::POST_APP_UPDATE })
+			{
+				const LayerGraph& graph{ GetLayerGraph(phase) };
+				if (graph.GetTimings().empty()) { continue; }
+
+				std::ostringstream stream;
+				stream << std::fixed << std::setprecision(3) << LayerGraph::GetPhaseName(phase) << " - " << graph.GetWallTimeMs() << "ms wall, " << graph.GetCriticalPathMs() << "ms critical path\n";
+				logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::ENGINE, stream.str());
+
+				logger.Indent();
+				for (const LayerTiming& timing : graph.GetTimings())
+				{
+					stream.str("");
+					stream << (timing.criticalPath ? "* " : "  ") << (timing.mainThread ? "    " : "[W] ") << timing.layer->GetName() << " - start " << timing.startMs << "ms, took " << timing.durationMs << "ms\n";
+					logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::ENGINE, stream.str());
+				}
+				logger.Unindent();
+			}
+			logger.Unindent();
+		}
 		
 
 
@@ -60,6 +91,12 @@ namespace NK
 		std::vector<ILayer*> m_preAppLayers;
 		std::vector<ILayer*> m_postAppLayers;
 
+		//Built from the layer vectors above - rebuilt automatically whenever they change
+		mutable LayerGraph m_preAppFixedUpdateGraph{ LAYER_PHASE::PRE_APP_FIXED_UPDATE };
+		mutable LayerGraph m_preAppUpdateGraph{ LAYER_PHASE::PRE_APP_UPDATE };
+		mutable LayerGraph m_postAppFixedUpdateGraph{ LAYER_PHASE::POST_APP_FIXED_UPDATE };
+		mutable LayerGraph m_postAppUpdateGraph{ LAYER_PHASE::POST_APP_UPDATE };
+
 		std::vector<UniquePtr<Scene>> m_scenes;
 		std::size_t m_activeScene{ 0 };
 
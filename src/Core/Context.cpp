@@ -1,10 +1,17 @@
 #include "Context.h"
 
+#include "Debug/AsyncLogger.h"
+#include "Debug/BinaryLogger.h"
 #include "Debug/ConsoleLogger.h"
 #include "Memory/TrackingAllocator.h"
+#include "Replay/Replay.h"
 
+#include <cstdlib>
 #include <stdexcept>
-#include <GLFW/glfw3.h>
+#include <string>
+#ifndef NEKI_HEADLESS
+	#include <GLFW/glfw3.h>
+#endif
 
 
 namespace NK
@@ -12,20 +19,25 @@ namespace NK
 	
 	ILogger* Context::m_logger{ nullptr };
 	IAllocator* Context::m_allocator{ nullptr };
+	JobSystem* Context::m_jobSystem{ nullptr };
 	LAYER_UPDATE_STATE Context::m_layerUpdateState{ LAYER_UPDATE_STATE::PRE_APP };
 	CLight* Context::m_activeLightView{ nullptr };
 	bool Context::m_editorActive{ false };
 	bool Context::m_paused{ false };
 	bool Context::m_popupOpen{ false };
 	float Context::m_fixedUpdateTimestep{ 1 / 60.0f };
+	const FixedStepScheduler* Context::m_fixedStepScheduler{ nullptr };
+	FramePacer* Context::m_framePacer{ nullptr };
 
 
+	#ifndef NEKI_HEADLESS
 	void GLFWErrorCallback(int _error, const char* _description)
 	{
 		std::string msg{ _description };
 		if (msg.back() != '\n') { msg += '\n'; } //glfw just like sometimes doesn't do this
 		Context::GetLogger()->IndentLog(LOGGER_CHANNEL::ERROR, LOGGER_LAYER::GLFW, msg);
 	}
+	#endif
 
 
 
@@ -37,6 +49,10 @@ namespace NK
 		{
 		case LOGGER_TYPE::CONSOLE: m_logger = new ConsoleLogger(_config.loggerConfig);
 			break;
+		case LOGGER_TYPE::ASYNC_CONSOLE: m_logger = new AsyncLogger(_config.loggerConfig);
+			break;
+		case LOGGER_TYPE::BINARY: m_logger = new BinaryLogger(_config.loggerConfig);
+			break;
 		default: throw std::runtime_error("Context::Context() - _config.loggerConfig.type not recognised.\n");
 		}
 
@@ -45,9 +61,27 @@ namespace NK
 		case ALLOCATOR_TYPE::TRACKING: m_allocator = new TrackingAllocator(*m_logger, _config.allocatorDesc.trackingAllocator); break;
 		}
 
-		glfwSetErrorCallback(GLFWErrorCallback);
-		glfwInit();
-		m_logger->IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::CONTEXT, "GLFW Initialised\n");
+		m_jobSystem = new JobSystem(*m_logger, _config.jobSystemConfig);
+
+		//Environment variables take priority over the config, so any build can record or replay without being changed
+		ReplayConfig replayConfig{ _config.replayConfig };
+		if (const char* const path{ std::getenv("NEKI_REPLAY_RECORD") }) { replayConfig.recordPath = path; }
+		if (const char* const path{ std::getenv("NEKI_REPLAY_PLAYBACK") }) { replayConfig.playbackPath = path; }
+		if (const char* const fast{ std::getenv("NEKI_REPLAY_FAST") }) { replayConfig.asFastAsPossible = (std::string(fast) == "1"); }
+		if (!replayConfig.recordPath.empty() && !replayConfig.playbackPath.empty())
+		{
+			throw std::runtime_error("Context::Initialise() - Can't record a replay and play one back at the same time");
+		}
+		if (!replayConfig.recordPath.empty()) { Replay::StartRecording(replayConfig.recordPath); }
+		else if (!replayConfig.playbackPath.empty()) { Replay::StartPlayback(replayConfig.playbackPath, replayConfig.asFastAsPossible); }
+
+		#ifndef NEKI_HEADLESS
+			glfwSetErrorCallback(GLFWErrorCallback);
+			glfwInit();
+			m_logger->IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::CONTEXT, "GLFW Initialised\n");
+		#else
+			m_logger->IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::CONTEXT, "Headless build - skipping GLFW initialisation\n");
+		#endif
 		
 		m_logger->Log(LOGGER_CHANNEL::INFO, LOGGER_LAYER::CONTEXT, "Context Initialised\n");
 	}
@@ -59,9 +93,14 @@ namespace NK
 		m_logger->Indent();
 		m_logger->Log(LOGGER_CHANNEL::HEADING, LOGGER_LAYER::CONTEXT, "Shutting Down Context\n");
 		
-		glfwTerminate();
-		m_logger->IndentLog(LOGGER_CHANNEL::SUCCESS, LOGGER_LAYER::CONTEXT, "GLFW Terminated\n");
+		Replay::Stop();
+		
+		#ifndef NEKI_HEADLESS
+			glfwTerminate();
+			m_logger->IndentLog(LOGGER_CHANNEL::SUCCESS, LOGGER_LAYER::CONTEXT, "GLFW Terminated\n");
+		#endif
 		
+		delete m_jobSystem;
 		delete m_allocator;
 		m_logger->Unindent();
 		delete m_logger;
@@ -2,12 +2,15 @@
 
 #include "ContextConfig.h"
 #include "Debug/ILogger.h"
+#include "Jobs/JobSystem.h"
 #include "Memory/IAllocator.h"
 
 
 namespace NK
 {
 	struct CLight;
+	class FixedStepScheduler;
+	class FramePacer;
 
 	//Global static context class
 	class Context
@@ -21,12 +24,15 @@ namespace NK
 
 		[[nodiscard]] inline static ILogger* GetLogger() { return m_logger; }
 		[[nodiscard]] inline static IAllocator* GetAllocator() { return m_allocator; }
+		[[nodiscard]] inline static JobSystem* GetJobSystem() { return m_jobSystem; }
 		[[nodiscard]] inline static LAYER_UPDATE_STATE GetLayerUpdateState() { return m_layerUpdateState; }
 		[[nodiscard]] inline static CLight* GetActiveLightView() { return m_activeLightView; }
 		[[nodiscard]] inline static bool GetEditorActive() { return m_editorActive; }
 		[[nodiscard]] inline static bool GetPaused() { return m_paused; }
 		[[nodiscard]] inline static bool GetPopupOpen() { return m_popupOpen; }
 		[[nodiscard]] inline static float GetFixedUpdateTimestep() { return m_fixedUpdateTimestep; }
+		[[nodiscard]] inline static const FixedStepScheduler* GetFixedStepScheduler() { return m_fixedStepScheduler; } //nullptr outside of Engine::Run()
+		[[nodiscard]] inline static FramePacer* GetFramePacer() { return m_framePacer; } //nullptr outside of Engine::Run()
 		
 		inline static void SetLayerUpdateState(const LAYER_UPDATE_STATE _state) { m_layerUpdateState = _state; }
 		inline static void SetActiveLightView(CLight* _light) { m_activeLightView = _light; }
@@ -34,17 +40,22 @@ namespace NK
 		inline static void SetPaused(const bool _paused) { m_paused = _paused; }
 		inline static void SetPopupOpen(const bool _inputting) { m_popupOpen = _inputting; }
 		inline static void SetFixedUpdateTimestep(const float _timestep) { m_fixedUpdateTimestep = _timestep; }
+		inline static void SetFixedStepScheduler(const FixedStepScheduler* _scheduler) { m_fixedStepScheduler = _scheduler; }
+		inline static void SetFramePacer(FramePacer* _framePacer) { m_framePacer = _framePacer; }
 
 
 	protected:
 		static ILogger* m_logger;
 		static IAllocator* m_allocator;
+		static JobSystem* m_jobSystem;
 		static LAYER_UPDATE_STATE m_layerUpdateState;
 		static CLight* m_activeLightView; //todo: this is very ugly, this shouldn't be here, find a better way of doing this
 		static bool m_editorActive; //todo: this is very ugly, this shouldn't be here, find a better way of doing this
 		static bool m_paused; //todo: this is very ugly, this shouldn't be here, find a better way of doing this
 		static bool m_popupOpen; //todo: this is very ugly, this shouldn't be here, find a better way of doing this
 		static float m_fixedUpdateTimestep;
+		static const FixedStepScheduler* m_fixedStepScheduler;
+		static FramePacer* m_framePacer;
 	};
 	
 }
\ No newline at end of file
@@ -11,6 +11,8 @@ namespace NK
 		LoggerConfig loggerConfig;
 		AllocatorConfig allocatorDesc;
 		float fixedUpdateTimestep{ 1.0f / 60.0f }; //In seconds (Default: 1.0f / 60.0f)
+		JobSystemConfig jobSystemConfig{};
+		ReplayConfig replayConfig{}; //Started here rather than by the Engine so the application's constructor (e.g. connecting to a server) already knows whether it's being played back
 	};
 	
 }
\ No newline at end of file
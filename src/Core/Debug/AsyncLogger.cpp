@@ -0,0 +1,263 @@
+#include "AsyncLogger.h"
+
+#include "ConsoleLogger.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <exception>
+#include <iostream>
+
+
+namespace NK
+{
+
+	AsyncLogger::AsyncLogger(const LoggerConfig& _config)
+	: ILogger(_config), m_asyncConfig(_config.GetAsyncConfig()),
+	  m_capacity(std::bit_ceil(std::max<std::uint64_t>(m_asyncConfig.capacity, 16))), m_mask(m_capacity - 1),
+	  m_slots(std::make_unique<Slot[]>(m_capacity))
+	{
+		for (std::uint64_t i{ 0 }; i < m_capacity; ++i)
+		{
+			m_slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		m_thread = std::thread(&AsyncLogger::Consume, this);
+
+		m_crashFlushTarget.store(this, std::memory_order_release);
+		InstallCrashHandlers();
+	}
+
+
+
+	AsyncLogger::~AsyncLogger()
+	{
+		const AsyncLogger* expected{ this };
+		m_crashFlushTarget.compare_exchange_strong(expected, nullptr);
+
+		//Background thread drains everything that's left before exiting
+		m_shutdown.store(true, std::memory_order_release);
+		Wake();
+		m_thread.join();
+		Drain();
+		std::cout << std::flush;
+	}
+
+
+
+	void AsyncLogger::Flush() const
+	{
+		//Anything claimed before this point has to be written before returning
+		//Drain on this thread rather than waiting on the background thread - if it's already mid-drain, Drain() just returns and we go round again
+		const std::uint64_t target{ m_head.load(std::memory_order_acquire) };
+		while (m_tail.load(std::memory_order_acquire) < target)
+		{
+			if (!Drain()) { std::this_thread::yield(); }
+		}
+		std::cout << std::flush;
+	}
+
+
+
+	void AsyncLogger::Push(const LOGGER_CHANNEL _channel, const LOGGER_LAYER _layer, std::string_view _message, const std::int32_t _indentationValue, const bool _formatted) const
+	{
+		//Check if channel is enabled for the specified layer
+		//If it's not, just early return
+		if (!IsEnabled(_channel, _layer)) { return; }
+
+		//Indentation is tracked on the logging thread, so it has to be resolved now rather than when the record is written
+		const std::int32_t indentation{ _indentationValue == INT32_MAX ? indentationLevel.load(std::memory_order_relaxed) : _indentationValue };
+
+		//Cap a single record at a quarter of the ring so one huge message can't starve everything else
+		const std::uint64_t maxSlots{ m_capacity / 4 };
+		const std::uint64_t maxLength{ maxSlots * Slot::TEXT_SIZE };
+		if (_message.size() > maxLength) { _message = _message.substr(0, maxLength); }
+		const std::uint64_t slotCount{ std::max<std::uint64_t>(1, (_message.size() + Slot::TEXT_SIZE - 1) / Slot::TEXT_SIZE) };
+
+		const bool isError{ _channel == LOGGER_CHANNEL::ERROR };
+		const bool block{ isError || m_asyncConfig.overflowPolicy == LOGGER_OVERFLOW_POLICY::BLOCK };
+
+
+		//Claim slotCount contiguous slots
+		std::uint64_t pos{ m_head.load(std::memory_order_relaxed) };
+		while (true)
+		{
+			//A slot is free for position p when its sequence is p
+			//Less than p means the consumer hasn't got to the previous lap's record yet (ring is full), greater than p means another producer has already claimed it
+			std::int64_t diff{ 0 };
+			for (std::uint64_t i{ 0 }; i < slotCount; ++i)
+			{
+				const std::uint64_t seq{ m_slots[(pos + i) & m_mask].sequence.load(std::memory_order_acquire) };
+				diff = static_cast<std::int64_t>(seq - (pos + i));
+				if (diff != 0) { break; }
+			}
+
+			if (diff == 0)
+			{
+				if (m_head.compare_exchange_weak(pos, pos + slotCount, std::memory_order_relaxed)) { break; }
+				continue; //pos has been reloaded by the failed CAS
+			}
+
+			if (diff < 0)
+			{
+				//Ring is full
+				if (!block)
+				{
+					m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+				Wake();
+				std::this_thread::yield();
+			}
+			pos = m_head.load(std::memory_order_relaxed);
+		}
+
+
+		//Fill and publish the claimed slots
+		for (std::uint64_t i{ 0 }; i < slotCount; ++i)
+		{
+			Slot& slot{ m_slots[(pos + i) & m_mask] };
+			const std::size_t offset{ i * Slot::TEXT_SIZE };
+			const std::size_t length{ std::min(Slot::TEXT_SIZE, _message.size() - offset) };
+			slot.channel = _channel;
+			slot.layer = _layer;
+			slot.indentation = indentation;
+			slot.length = static_cast<std::uint16_t>(length);
+			slot.formatted = _formatted;
+			slot.last = (i == slotCount - 1);
+			std::memcpy(slot.text, _message.data() + offset, length);
+			slot.sequence.store(pos + i + 1, std::memory_order_release);
+		}
+
+		//Pairs with the fence in Consume() - either we see the consumer is asleep, or it sees our record before going to sleep
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_consumerSleeping.load(std::memory_order_relaxed)) { Wake(); }
+
+		//Errors are usually followed by a throw or a crash, make sure they (and everything before them) actually make it out
+		if (isError) { Flush(); }
+	}
+
+
+
+	void AsyncLogger::Consume()
+	{
+		while (true)
+		{
+			if (Drain()) { continue; }
+			if (HasPending()) { std::this_thread::yield(); continue; } //Someone else is draining (Flush()), or the rest of a multi-slot record is still being written
+			if (m_shutdown.load(std::memory_order_acquire)) { break; }
+
+			//Nothing to do - go to sleep until a producer wakes us
+			//Pairs with the fence in Push() - either the producer sees m_consumerSleeping, or we see its record here
+			const std::uint32_t wakeCount{ m_wakeCounter.load(std::memory_order_acquire) };
+			m_consumerSleeping.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!HasPending() && !m_shutdown.load(std::memory_order_acquire))
+			{
+				m_wakeCounter.wait(wakeCount, std::memory_order_acquire);
+			}
+			m_consumerSleeping.store(false, std::memory_order_relaxed);
+		}
+	}
+
+
+
+	bool AsyncLogger::HasPending() const
+	{
+		const std::uint64_t tail{ m_tail.load(std::memory_order_acquire) };
+		return m_slots[tail & m_mask].sequence.load(std::memory_order_acquire) == tail + 1;
+	}
+
+
+
+	bool AsyncLogger::Drain() const
+	{
+		if (m_draining.test_and_set(std::memory_order_acquire)) { return false; }
+
+		bool wrote{ false };
+		std::uint64_t tail{ m_tail.load(std::memory_order_relaxed) };
+		while (true)
+		{
+			Slot& slot{ m_slots[tail & m_mask] };
+			if (slot.sequence.load(std::memory_order_acquire) != tail + 1) { break; } //Not published yet
+
+			//Records spanning multiple slots get stitched back together - if the rest hasn't been published yet, the partial record stays in the scratch buffer until next time
+			m_recordScratch.append(slot.text, slot.length);
+			if (slot.last)
+			{
+				const std::uint64_t dropped{ m_droppedCount.exchange(0, std::memory_order_relaxed) };
+				if (dropped != 0)
+				{
+					ConsoleLogger::Write(LOGGER_CHANNEL::WARNING, LOGGER_LAYER::ENGINE, "AsyncLogger ring buffer was full - dropped " + std::to_string(dropped) + " message(s)\n", 0, true);
+				}
+				ConsoleLogger::Write(slot.channel, slot.layer, m_recordScratch, slot.indentation, slot.formatted);
+				m_recordScratch.clear();
+				wrote = true;
+			}
+
+			//Hand the slot back to the producers for the next lap
+			slot.sequence.store(tail + m_capacity, std::memory_order_release);
+			++tail;
+			m_tail.store(tail, std::memory_order_release);
+		}
+
+		m_draining.clear(std::memory_order_release);
+		return wrote;
+	}
+
+
+
+	void AsyncLogger::Wake() const
+	{
+		m_wakeCounter.fetch_add(1, std::memory_order_release);
+		m_wakeCounter.notify_one();
+	}
+
+
+
+	void AsyncLogger::InstallCrashHandlers()
+	{
+		static std::atomic<bool> installed{ false };
+		if (installed.exchange(true)) { return; }
+
+		static std::terminate_handler previousTerminateHandler{ nullptr };
+		previousTerminateHandler = std::set_terminate([]()
+		{
+			CrashFlush();
+			if (previousTerminateHandler) { previousTerminateHandler(); }
+			std::abort();
+		});
+
+		//Writing to the console from a signal handler isn't async-signal-safe - this is a best-effort attempt to get the last messages out before the process dies
+		for (const int signal : { SIGSEGV, SIGABRT, SIGFPE, SIGILL })
+		{
+			std::signal(signal, [](const int _signal)
+			{
+				CrashFlush();
+				std::signal(_signal, SIG_DFL);
+				std::raise(_signal);
+			});
+		}
+	}
+
+
+
+	void AsyncLogger::CrashFlush()
+	{
+		const AsyncLogger* logger{ m_crashFlushTarget.exchange(nullptr) };
+		if (!logger) { return; }
+
+		//Don't wait forever - the crash might have happened on the background thread mid-drain, in which case m_draining is never getting released
+		const std::chrono::steady_clock::time_point deadline{ std::chrono::steady_clock::now() + std::chrono::milliseconds(200) };
+		const std::uint64_t target{ logger->m_head.load(std::memory_order_acquire) };
+		while (logger->m_tail.load(std::memory_order_acquire) < target && std::chrono::steady_clock::now() < deadline)
+		{
+			if (!logger->Drain()) { std::this_thread::yield(); }
+		}
+		std::cout << std::flush;
+		std::cerr << std::flush;
+	}
+
+}
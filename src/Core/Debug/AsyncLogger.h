@@ -0,0 +1,106 @@
+#pragma once
+
+#include "ILogger.h"
+
+#include <Types/NekiTypes.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+
+
+namespace NK
+{
+
+	//Logger that pushes compact records into a lock-free ring buffer and leaves the formatting and console i/o to a background thread
+	//Producers only pay for a channel check, a CAS, and a memcpy of the message
+	//Errors are flushed synchronously (the calling thread waits for the background thread to catch up) since they're often followed by a throw
+	class AsyncLogger final : public ILogger
+	{
+	public:
+		explicit AsyncLogger(const LoggerConfig& _config);
+		virtual ~AsyncLogger() override;
+
+		//Blocks until every message logged before this call has been written
+		void Flush() const;
+
+
+	private:
+		virtual inline void LogImpl(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, const std::string& _message, std::int32_t _indentationValue) const override
+		{
+			Push(_channel, _layer, _message, _indentationValue, true);
+		}
+
+		virtual inline void RawLogImpl(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, const std::string& _message, std::int32_t _indentationValue) const override
+		{
+			Push(_channel, _layer, _message, _indentationValue, false);
+		}
+
+		//Called from LogImpl and RawLogImpl, taking _formatted accordingly
+		void Push(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, std::string_view _message, std::int32_t _indentationValue, bool _formatted) const;
+
+		//Background thread loop
+		void Consume();
+
+		//Write out every published record - returns false if there was nothing to write
+		//Only one thread may drain at a time, guarded by m_draining
+		bool Drain() const;
+
+		//Whether the next record slot has been published
+		[[nodiscard]] bool HasPending() const;
+
+		void Wake() const;
+
+		//Best-effort flush from the terminate handler / fatal signal handlers, in case the process goes down before the destructor runs
+		static void InstallCrashHandlers();
+		static void CrashFlush();
+
+
+		//One fixed-size slot in the ring - messages that don't fit in a single slot spill over into the following ones
+		//A record's slots are always claimed together so they're contiguous
+		struct Slot
+		{
+			static constexpr std::size_t SIZE{ 256 };
+			static constexpr std::size_t HEADER_SIZE{ sizeof(std::atomic<std::uint64_t>) + sizeof(LOGGER_CHANNEL) + sizeof(LOGGER_LAYER) + sizeof(std::int32_t) + sizeof(std::uint16_t) + 2 * sizeof(bool) };
+			static constexpr std::size_t TEXT_SIZE{ SIZE - HEADER_SIZE };
+
+			std::atomic<std::uint64_t> sequence; //Vyukov-style - equals the slot's position when free, position + 1 when published
+			LOGGER_CHANNEL channel;
+			LOGGER_LAYER layer;
+			std::int32_t indentation;
+			std::uint16_t length;
+			bool formatted;
+			bool last; //Final slot of the record
+			char text[TEXT_SIZE];
+		};
+		static_assert(sizeof(Slot) == Slot::SIZE, "AsyncLogger::Slot - unexpected padding, update HEADER_SIZE");
+
+
+		const AsyncLoggerConfig m_asyncConfig;
+		const std::uint64_t m_capacity;
+		const std::uint64_t m_mask;
+		std::unique_ptr<Slot[]> m_slots;
+
+		alignas(64) mutable std::atomic<std::uint64_t> m_head{ 0 }; //Next position to be claimed by a producer
+		alignas(64) mutable std::atomic<std::uint64_t> m_tail{ 0 }; //Next position to be written out by the consumer
+
+		mutable std::atomic<std::uint64_t> m_droppedCount{ 0 };
+
+		//The background thread sleeps on m_wakeCounter when the ring is empty - producers only bump and notify it when m_consumerSleeping is set
+		mutable std::atomic<std::uint32_t> m_wakeCounter{ 0 };
+		mutable std::atomic<bool> m_consumerSleeping{ false };
+		mutable std::atomic_flag m_draining;
+		std::atomic<bool> m_shutdown{ false };
+
+		mutable std::string m_recordScratch; //Reassembly buffer for multi-slot records, only touched by whoever holds m_draining
+
+		std::thread m_thread;
+
+		//The logger the crash handlers should flush
+		static inline std::atomic<const AsyncLogger*> m_crashFlushTarget{ nullptr };
+	};
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "LogArg.h"
+
+#include <cstdint>
+
+
+//On-disk layout of the files written by BinaryLogger - shared with the NekiLogDecoder tool, so this stays standalone (no NekiTypes)
+//Everything is little-endian, written with memcpy from the structs below
+//
+//File:		FileHeader, then records back-to-back until either end-of-file or a record with size 0 (unwritten, zero-filled space)
+//Record:	RecordHeader, then a type-specific body, padded to RECORD_ALIGNMENT
+//	MESSAGE:			MessageRecord, then argCount args - each is a LOG_ARG_TYPE byte followed by 8 bytes of value, or (for STRING) a uint32 length and the characters
+//	FORMAT_DEFINITION:	FormatDefinitionRecord, then the format string characters - written the first time a format id is used in each file
+//	LAYER_NAME:			LayerNameRecord, then the layer name characters - every layer is written once at the start of each file
+//
+//Each file is self-contained so old files can be deleted by rotation without breaking the ones that are left
+
+
+namespace NK::BinaryLogFormat
+{
+
+	inline constexpr char MAGIC[8]{ 'N', 'K', 'B', 'L', 'O', 'G', '\0', '\0' };
+	inline constexpr std::uint32_t VERSION{ 1 };
+	inline constexpr std::uint32_t RECORD_ALIGNMENT{ 8 };
+	inline constexpr const char* FILE_EXTENSION{ ".nklog" };
+
+
+	enum class RECORD_TYPE : std::uint8_t
+	{
+		END					= 0,
+		MESSAGE				= 1,
+		FORMAT_DEFINITION	= 2,
+		LAYER_NAME			= 3,
+	};
+
+
+	enum class MESSAGE_FLAGS : std::uint8_t
+	{
+		NONE		= 0,
+		FORMATTED	= 1 << 0, //Logged through Log() rather than RawLog() - the decoder prints channel and layer prefixes
+	};
+
+
+	struct FileHeader
+	{
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t fileIndex;		//Position of this file in the rotation sequence, starting at 0
+		std::uint64_t startUnixTimeNs;	//Wall-clock time at which the logger was created - record timestamps are relative to this
+		std::uint64_t reserved;
+	};
+	static_assert(sizeof(FileHeader) == 32);
+
+
+	struct RecordHeader
+	{
+		std::uint32_t size; //Including this header and padding
+		RECORD_TYPE type;
+		std::uint8_t reserved[3];
+	};
+	static_assert(sizeof(RecordHeader) == 8);
+
+
+	struct MessageRecord
+	{
+		std::uint64_t timestampNs; //Steady-clock nanoseconds since FileHeader::startUnixTimeNs
+		std::uint32_t formatID;
+		std::uint32_t threadID;
+		std::uint32_t layer;
+		std::int16_t indentation;
+		std::uint8_t channel; //LOGGER_CHANNEL bit index
+		MESSAGE_FLAGS flags;
+		std::uint8_t argCount;
+		std::uint8_t reserved[7];
+	};
+	static_assert(sizeof(MessageRecord) == 32);
+
+
+	struct FormatDefinitionRecord
+	{
+		std::uint32_t formatID;
+		std::uint32_t length;
+	};
+	static_assert(sizeof(FormatDefinitionRecord) == 8);
+
+
+	struct LayerNameRecord
+	{
+		std::uint32_t layer;
+		std::uint32_t length;
+	};
+	static_assert(sizeof(LayerNameRecord) == 8);
+
+
+	[[nodiscard]] inline constexpr std::uint32_t AlignRecordSize(const std::uint32_t _size)
+	{
+		return (_size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+	}
+
+
+	//Indexed by MessageRecord::channel
+	inline constexpr const char* CHANNEL_NAMES[]{ "HEADING", "INFO", "WARNING", "ERROR", "SUCCESS" };
+
+}
@@ -0,0 +1,348 @@
+#include "BinaryLogger.h"
+
+#include "BinaryLogFormat.h"
+#include "ConsoleLogger.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+
+namespace NK
+{
+
+	namespace
+	{
+		//Anything smaller can't hold the header, the layer names, and a reasonable number of records
+		constexpr std::uint64_t MIN_FILE_SIZE{ 64 * 1024 };
+
+		//Longer string arguments are truncated
+		constexpr std::size_t MAX_STRING_LENGTH{ 16 * 1024 };
+
+		std::atomic<std::uint32_t> nextThreadID{ 0 };
+	}
+
+
+
+	BinaryLogger::BinaryLogger(const LoggerConfig& _config)
+	: ILogger(_config), m_binaryConfig(_config.GetBinaryConfig()), m_startTime(std::chrono::steady_clock::now()),
+	  m_startUnixTimeNs(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count())
+	{
+		if (m_binaryConfig.fileSize < MIN_FILE_SIZE)
+		{
+			throw std::invalid_argument("BinaryLogger::BinaryLogger() - _config.GetBinaryConfig().fileSize (" + std::to_string(m_binaryConfig.fileSize) + ") must be at least " + std::to_string(MIN_FILE_SIZE));
+		}
+
+		std::filesystem::create_directories(m_binaryConfig.directory);
+
+		//First file is created here rather than on the background thread so a bad directory gets reported straight away
+		m_current = CreateSegment(m_nextFileIndex++);
+		m_thread = std::thread(&BinaryLogger::Work, this);
+	}
+
+
+
+	BinaryLogger::~BinaryLogger()
+	{
+		//Wait out any in-flight writes, then hand the current file to the background thread to be closed
+		while (m_writeGuard.test_and_set(std::memory_order_acquire)) { std::this_thread::yield(); }
+		m_disabled = true;
+		{
+			const std::lock_guard lock(m_workerMutex);
+			if (m_current.file) { m_retired.push_back(std::move(m_current)); }
+			m_shutdown = true;
+		}
+		m_writeGuard.clear(std::memory_order_release);
+
+		m_workerCondition.notify_all();
+		m_thread.join();
+	}
+
+
+
+	void BinaryLogger::Flush() const
+	{
+		while (m_writeGuard.test_and_set(std::memory_order_acquire)) { std::this_thread::yield(); }
+		if (m_current.file) { m_current.file->FlushAsync(); }
+		m_writeGuard.clear(std::memory_order_release);
+	}
+
+
+
+	void BinaryLogger::LogImpl(const LOGGER_CHANNEL _channel, const LOGGER_LAYER _layer, const std::string& _message, const std::int32_t _indentationValue) const
+	{
+		if (!IsEnabled(_channel, _layer)) { return; }
+		const LogArg arg{ _message };
+		Write(_channel, _layer, LogFormatSite::PLAIN_MESSAGE_ID, LogFormatSite::PLAIN_MESSAGE_FORMAT, { &arg, 1 }, _indentationValue, true);
+	}
+
+
+
+	void BinaryLogger::RawLogImpl(const LOGGER_CHANNEL _channel, const LOGGER_LAYER _layer, const std::string& _message, const std::int32_t _indentationValue) const
+	{
+		if (!IsEnabled(_channel, _layer)) { return; }
+		const LogArg arg{ _message };
+		Write(_channel, _layer, LogFormatSite::PLAIN_MESSAGE_ID, LogFormatSite::PLAIN_MESSAGE_FORMAT, { &arg, 1 }, _indentationValue, false);
+	}
+
+
+
+	void BinaryLogger::LogFormatImpl(const LOGGER_CHANNEL _channel, const LOGGER_LAYER _layer, const LogFormatSite& _site, const std::span<const LogArg> _args, const std::int32_t _indentationValue, const bool _formatted) const
+	{
+		if (!IsEnabled(_channel, _layer)) { return; }
+		Write(_channel, _layer, _site.id, _site.format, _args, _indentationValue, _formatted);
+	}
+
+
+
+	void BinaryLogger::Write(const LOGGER_CHANNEL _channel, const LOGGER_LAYER _layer, const std::uint32_t _formatID, const char* _format, std::span<const LogArg> _args, const std::int32_t _indentationValue, const bool _formatted) const
+	{
+		using namespace BinaryLogFormat;
+
+		//Indentation is tracked on the logging thread, so it has to be resolved now
+		const std::int32_t indentation{ _indentationValue == INT32_MAX ? indentationLevel.load(std::memory_order_relaxed) : _indentationValue };
+		if (_args.size() > UINT8_MAX) { _args = _args.first(UINT8_MAX); }
+
+
+		//Encode into a per-thread scratch buffer first so the time spent holding m_writeGuard is just a memcpy
+		thread_local std::vector<std::byte> scratch;
+		thread_local const std::uint32_t threadID{ nextThreadID.fetch_add(1, std::memory_order_relaxed) };
+
+		std::size_t unalignedSize{ sizeof(RecordHeader) + sizeof(MessageRecord) };
+		for (const LogArg& arg : _args)
+		{
+			unalignedSize += sizeof(LOG_ARG_TYPE) + (arg.type == LOG_ARG_TYPE::STRING ? sizeof(std::uint32_t) + std::min(arg.s.size(), MAX_STRING_LENGTH) : sizeof(std::uint64_t));
+		}
+		const std::uint32_t recordSize{ AlignRecordSize(static_cast<std::uint32_t>(unalignedSize)) };
+		scratch.resize(recordSize);
+		std::byte* out{ scratch.data() };
+
+		const RecordHeader header{ recordSize, RECORD_TYPE::MESSAGE, {} };
+		std::memcpy(out, &header, sizeof(header));
+		out += sizeof(header);
+
+		MessageRecord message{};
+		message.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_startTime).count();
+		message.formatID = _formatID;
+		message.threadID = threadID;
+		message.layer = std::to_underlying(_layer);
+		message.indentation = static_cast<std::int16_t>(std::clamp<std::int32_t>(indentation, INT16_MIN, INT16_MAX));
+		message.channel = static_cast<std::uint8_t>(std::countr_zero(std::to_underlying(_channel)));
+		message.flags = (_formatted ? MESSAGE_FLAGS::FORMATTED : MESSAGE_FLAGS::NONE);
+		message.argCount = static_cast<std::uint8_t>(_args.size());
+		std::memcpy(out, &message, sizeof(message));
+		out += sizeof(message);
+
+		for (const LogArg& arg : _args)
+		{
+			std::memcpy(out, &arg.type, sizeof(arg.type));
+			out += sizeof(arg.type);
+			if (arg.type == LOG_ARG_TYPE::STRING)
+			{
+				const std::uint32_t length{ static_cast<std::uint32_t>(std::min(arg.s.size(), MAX_STRING_LENGTH)) };
+				std::memcpy(out, &length, sizeof(length));
+				std::memcpy(out + sizeof(length), arg.s.data(), length);
+				out += sizeof(length) + length;
+			}
+			else
+			{
+				//Every non-string type lives in the union, so copying the widest member covers all of them
+				static_assert(sizeof(LogArg::u) == sizeof(std::uint64_t));
+				const std::uint64_t value{ arg.type == LOG_ARG_TYPE::BOOL ? static_cast<std::uint64_t>(arg.b) : arg.u };
+				std::memcpy(out, &value, sizeof(value));
+				out += sizeof(value);
+			}
+		}
+		std::memset(out, 0, scratch.data() + recordSize - out); //Alignment padding
+
+		const std::size_t formatLength{ std::strlen(_format) };
+		const std::uint32_t definitionSize{ AlignRecordSize(static_cast<std::uint32_t>(sizeof(RecordHeader) + sizeof(FormatDefinitionRecord) + formatLength)) };
+
+
+		//Append to the current file
+		while (m_writeGuard.test_and_set(std::memory_order_acquire)) { std::this_thread::yield(); }
+
+		if (!m_disabled)
+		{
+			bool needsDefinition{ _formatID >= m_definedFormats.size() || !m_definedFormats[_formatID] };
+
+			bool fits{ m_current.used + (needsDefinition ? definitionSize : 0) + recordSize <= m_current.file->GetSize() };
+			if (!fits && Rotate())
+			{
+				//Formats get redefined in every file
+				needsDefinition = true;
+				fits = m_current.used + definitionSize + recordSize <= m_current.file->GetSize();
+			}
+
+			//If it still doesn't fit it's bigger than an entire file - just drop it
+			if (fits && !m_disabled)
+			{
+				std::byte* const data{ m_current.file->GetData() };
+				if (needsDefinition)
+				{
+					const RecordHeader definitionHeader{ definitionSize, RECORD_TYPE::FORMAT_DEFINITION, {} };
+					const FormatDefinitionRecord definition{ _formatID, static_cast<std::uint32_t>(formatLength) };
+					std::memcpy(data + m_current.used, &definitionHeader, sizeof(definitionHeader));
+					std::memcpy(data + m_current.used + sizeof(definitionHeader), &definition, sizeof(definition));
+					std::memcpy(data + m_current.used + sizeof(definitionHeader) + sizeof(definition), _format, formatLength);
+					m_current.used += definitionSize; //Padding is already zero - the file is zero-filled
+
+					if (_formatID >= m_definedFormats.size()) { m_definedFormats.resize(_formatID + 1, false); }
+					m_definedFormats[_formatID] = true;
+				}
+				std::memcpy(data + m_current.used, scratch.data(), recordSize);
+				m_current.used += recordSize;
+			}
+		}
+
+		m_writeGuard.clear(std::memory_order_release);
+
+
+		//Errors are usually followed by a throw, make them visible without having to decode the file
+		if (_channel == LOGGER_CHANNEL::ERROR && m_binaryConfig.mirrorErrorsToConsole)
+		{
+			ConsoleLogger::Write(_channel, _layer, FormatLogMessage(_format, _args), indentation, _formatted);
+		}
+	}
+
+
+
+	bool BinaryLogger::Rotate() const
+	{
+		std::unique_lock lock(m_workerMutex);
+
+		//The background thread normally has the next file ready long before it's needed - this only waits if files are being filled faster than they can be created
+		m_workerCondition.wait(lock, [this]() { return m_prepared.file || m_workerFailed; });
+
+		m_retired.push_back(std::move(m_current));
+		m_current = {};
+		m_definedFormats.clear();
+
+		if (!m_prepared.file)
+		{
+			//Background thread couldn't create the file and has already reported why
+			m_disabled = true;
+		}
+		else
+		{
+			m_current = std::move(m_prepared);
+			m_prepared = {};
+		}
+
+		lock.unlock();
+		m_workerCondition.notify_all();
+		return !m_disabled;
+	}
+
+
+
+	void BinaryLogger::Work()
+	{
+		std::unique_lock lock(m_workerMutex);
+		while (true)
+		{
+			m_workerCondition.wait(lock, [this]() { return m_shutdown || !m_retired.empty() || (!m_prepared.file && !m_workerFailed); });
+
+			//Finish off old files - shrink them down to what was written, then delete the oldest if there are too many
+			if (!m_retired.empty())
+			{
+				std::vector<Segment> retired{ std::move(m_retired) };
+				m_retired.clear();
+				lock.unlock();
+
+				for (Segment& segment : retired)
+				{
+					m_finishedFiles.push_back(segment.file->GetPath());
+					segment.file->Close(segment.used);
+				}
+				while (m_binaryConfig.maxFiles != 0 && m_finishedFiles.size() > m_binaryConfig.maxFiles)
+				{
+					std::error_code error;
+					std::filesystem::remove(m_finishedFiles.front(), error);
+					m_finishedFiles.pop_front();
+				}
+
+				lock.lock();
+				continue;
+			}
+
+			if (m_shutdown) { break; }
+
+			//Get the next file ready
+			if (!m_prepared.file && !m_workerFailed)
+			{
+				const std::uint32_t index{ m_nextFileIndex++ };
+				lock.unlock();
+
+				Segment segment;
+				bool failed{ false };
+				try
+				{
+					segment = CreateSegment(index);
+				}
+				catch (const std::exception& _e)
+				{
+					ConsoleLogger::Write(LOGGER_CHANNEL::ERROR, LOGGER_LAYER::ENGINE, "BinaryLogger failed to create the next log file - binary logging will stop once the current file is full - " + std::string(_e.what()) + "\n", 0, true);
+					failed = true;
+				}
+
+				lock.lock();
+				m_prepared = std::move(segment);
+				m_workerFailed = failed;
+				m_workerCondition.notify_all();
+			}
+		}
+
+		//The prepared file never got written to, don't leave it lying around
+		if (m_prepared.file)
+		{
+			const std::filesystem::path path{ m_prepared.file->GetPath() };
+			m_prepared = {};
+			std::error_code error;
+			std::filesystem::remove(path, error);
+		}
+	}
+
+
+
+	BinaryLogger::Segment BinaryLogger::CreateSegment(const std::uint32_t _index) const
+	{
+		using namespace BinaryLogFormat;
+
+		std::string indexString{ std::to_string(_index) };
+		if (indexString.size() < 4) { indexString.insert(0, 4 - indexString.size(), '0'); }
+		const std::filesystem::path path{ std::filesystem::path(m_binaryConfig.directory) / (m_binaryConfig.baseName + "_" + std::to_string(m_startUnixTimeNs / 1'000'000'000) + "_" + indexString + FILE_EXTENSION) };
+
+		Segment segment{ std::make_unique<MappedFile>(path, m_binaryConfig.fileSize) };
+		segment.file->Prefault();
+		std::byte* const data{ segment.file->GetData() };
+
+		FileHeader header{};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.fileIndex = _index;
+		header.startUnixTimeNs = m_startUnixTimeNs;
+		std::memcpy(data, &header, sizeof(header));
+		segment.used = sizeof(header);
+
+		//Layer names go in every file so the decoder doesn't depend on the LOGGER_LAYER enum it was built against
+		for (std::size_t layer{ 0 }; layer < LOGGER_LAYER_COUNT; ++layer)
+		{
+			std::string name{ LayerToString(static_cast<LOGGER_LAYER>(layer)) };
+			if (name.size() >= 2 && name.front() == '[' && name.back() == ']') { name = name.substr(1, name.size() - 2); }
+
+			const std::uint32_t recordSize{ AlignRecordSize(static_cast<std::uint32_t>(sizeof(RecordHeader) + sizeof(LayerNameRecord) + name.size())) };
+			const RecordHeader recordHeader{ recordSize, RECORD_TYPE::LAYER_NAME, {} };
+			const LayerNameRecord record{ static_cast<std::uint32_t>(layer), static_cast<std::uint32_t>(name.size()) };
+			std::memcpy(data + segment.used, &recordHeader, sizeof(recordHeader));
+			std::memcpy(data + segment.used + sizeof(recordHeader), &record, sizeof(record));
+			std::memcpy(data + segment.used + sizeof(recordHeader) + sizeof(record), name.data(), name.size());
+			segment.used += recordSize;
+		}
+
+		return segment;
+	}
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "ILogger.h"
+
+#include <Core/Utils/MappedFile.h>
+#include <Types/NekiTypes.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+
+namespace NK
+{
+
+	//Logger that writes compact binary records (see BinaryLogFormat.h) into memory-mapped files, rotating to a new file when the current one fills up
+	//Logging threads encode the record and copy it straight into the mapping under a spinlock - no formatting, no syscalls
+	//A background thread creates and prefaults the next file ahead of time and closes/deletes old ones, so rotation is just a pointer swap
+	//Records live in the page cache as soon as they're written, so they survive the process crashing
+	//Use NK_LOGF() for the cheapest path - plain Log() calls are stored as a single string argument
+	class BinaryLogger final : public ILogger
+	{
+	public:
+		explicit BinaryLogger(const LoggerConfig& _config);
+		virtual ~BinaryLogger() override;
+
+		//Ask the OS to start writing the current file back to disk
+		void Flush() const;
+
+
+	private:
+		virtual void LogImpl(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, const std::string& _message, std::int32_t _indentationValue) const override;
+		virtual void RawLogImpl(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, const std::string& _message, std::int32_t _indentationValue) const override;
+		virtual void LogFormatImpl(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, const LogFormatSite& _site, std::span<const LogArg> _args, std::int32_t _indentationValue, bool _formatted) const override;
+
+		//Encode and append a message record
+		void Write(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, std::uint32_t _formatID, const char* _format, std::span<const LogArg> _args, std::int32_t _indentationValue, bool _formatted) const;
+
+		//Swap the current file for the one prepared by the background thread - caller must hold m_writeGuard
+		//Returns false if there's no file to swap to (the background thread failed to create one), in which case logging is disabled
+		bool Rotate() const;
+
+		//Background thread loop
+		void Work();
+
+
+		struct Segment
+		{
+			std::unique_ptr<MappedFile> file;
+			std::size_t used{ 0 };
+		};
+
+		//Create, prefault, and write the header and layer names for file _index
+		[[nodiscard]] Segment CreateSegment(std::uint32_t _index) const;
+
+
+		const BinaryLoggerConfig m_binaryConfig;
+		const std::chrono::steady_clock::time_point m_startTime;
+		const std::uint64_t m_startUnixTimeNs;
+
+		//Everything below m_writeGuard is only touched by whoever holds it
+		mutable std::atomic_flag m_writeGuard;
+		mutable Segment m_current;
+		mutable std::vector<bool> m_definedFormats; //Indexed by LogFormatSite::id - whether the format has been written to the current file yet
+		mutable bool m_disabled{ false };
+
+		//Hand-off between the logging threads and the background thread
+		mutable std::mutex m_workerMutex;
+		mutable std::condition_variable m_workerCondition;
+		mutable Segment m_prepared; //file is null while the background thread is still creating it
+		mutable std::vector<Segment> m_retired;
+		mutable bool m_workerFailed{ false };
+		bool m_shutdown{ false };
+		std::uint32_t m_nextFileIndex{ 0 };
+		std::deque<std::filesystem::path> m_finishedFiles; //Oldest first, only touched by the background thread
+
+		std::thread m_thread;
+	};
+
+}
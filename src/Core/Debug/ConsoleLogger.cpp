@@ -7,12 +7,8 @@
 namespace NK
 {
 
-	void ConsoleLogger::LogRawLogImpl(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, const std::string& _message, std::int32_t _indentationValue, bool _formatted) const
+	void ConsoleLogger::Write(const LOGGER_CHANNEL _channel, const LOGGER_LAYER _layer, const std::string_view _message, const std::int32_t _indentation, const bool _formatted)
 	{
-		//Check if channel is enabled for the specified layer
-		//If it's not, just early return
-		if ((m_config.GetChannelBitfieldForLayer(_layer) & _channel) == LOGGER_CHANNEL::NONE) { return; }
-
 		std::string channelStr;
 		std::string colourCode;
 
@@ -45,10 +41,10 @@ namespace NK
 			break;
 		}
 
-		//Add spaces to start of message based on indentationLevel or _indentationValue override if it has been provided (!INT32_MAX)
+		//Add spaces to start of message based on the indentation level
 		constexpr std::uint32_t spacesPerIndent{ 2 };
-		std::string indentedMessage{ _message };
-		indentedMessage.insert(0, std::max((_indentationValue == INT32_MAX ? indentationLevel : _indentationValue), 0) * spacesPerIndent, ' '); //Clamp indentation level to 0
+		std::string indentedMessage(std::max(_indentation, 0) * spacesPerIndent, ' '); //Clamp indentation level to 0
+		indentedMessage += _message;
 		
 		std::reference_wrapper<std::ostream> stream{ std::cout };
 		if (_channel == LOGGER_CHANNEL::ERROR)
@@ -66,5 +62,17 @@ namespace NK
 
 		if (_channel == LOGGER_CHANNEL::ERROR) { stream.get() << std::flush; }
 	}
+
+
+
+	void ConsoleLogger::LogRawLogImpl(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, const std::string& _message, std::int32_t _indentationValue, bool _formatted) const
+	{
+		//Check if channel is enabled for the specified layer
+		//If it's not, just early return
+		if (!IsEnabled(_channel, _layer)) { return; }
+
+		//Use indentationLevel unless an _indentationValue override has been provided (!INT32_MAX)
+		Write(_channel, _layer, _message, (_indentationValue == INT32_MAX ? indentationLevel.load(std::memory_order_relaxed) : _indentationValue), _formatted);
+	}
 	
 }
\ No newline at end of file
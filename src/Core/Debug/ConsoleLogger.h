@@ -4,6 +4,8 @@
 
 #include <Types/NekiTypes.h>
 
+#include <string_view>
+
 
 namespace NK
 {
@@ -13,6 +15,10 @@ namespace NK
 	public:
 		explicit ConsoleLogger(const LoggerConfig& _config) : ILogger(_config) {}
 
+		//Formats and writes a single message straight to std::cout (std::cerr for errors) - doesn't check the logger config
+		//_indentation is the final, already-resolved indentation level. Shared with AsyncLogger's background thread.
+		static void Write(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, std::string_view _message, std::int32_t _indentation, bool _formatted);
+
 
 	private:
 		//Logs _message from _layer to the _channel channel (if the channel is enabled for the specified layer)
@@ -64,6 +64,9 @@ namespace NK
 		case LOGGER_LAYER::ENGINE:						return "[ENGINE]";
 		case LOGGER_LAYER::CONTEXT:						return "[CONTEXT]";
 		case LOGGER_LAYER::TRACKING_ALLOCATOR:			return "[TRACKING ALLOCATOR]";
+		case LOGGER_LAYER::JOB_SYSTEM:					return "[JOB SYSTEM]";
+		case LOGGER_LAYER::PROFILER:					return "[PROFILER]";
+		case LOGGER_LAYER::REPLAY:						return "[REPLAY]";
 
 		case LOGGER_LAYER::RENDER_LAYER:				return "[RENDER LAYER]";
 		case LOGGER_LAYER::CLIENT_NETWORK_LAYER:		return "[CLIENT NETWORK LAYER]";
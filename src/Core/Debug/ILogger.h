@@ -1,10 +1,22 @@
 #pragma once
 
+#include "LogArg.h"
 #include "LoggerConfig.h"
 
 #include <Types/NekiTypes.h>
 
+#include <atomic>
+#include <initializer_list>
+#include <span>
 #include <string>
+#include <utility>
+
+
+//Bitfield of LOGGER_CHANNELs that get compiled in - anything not in here compiles to nothing when logged through Log()/RawLog()/NK_LOG()
+//Define it for the whole build (e.g. -DNEKI_LOG_COMPILED_CHANNELS=0x1C to strip HEADING and INFO)
+#ifndef NEKI_LOG_COMPILED_CHANNELS
+	#define NEKI_LOG_COMPILED_CHANNELS 0xFFFFFFFFu
+#endif
 
 
 namespace NK
@@ -20,6 +32,8 @@ namespace NK
 		//Optionally, pass in an indentation level to override the member
 		inline void Log(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, const std::string& _message, std::int32_t _indentationLevel=INT32_MAX) const
 		{
+			if (!IsCompiledIn(_channel)) { return; }
+			
 			//Use non-virtual-interface pattern due to default parameter
 			LogImpl(_channel, _layer, _message, _indentationLevel);
 		}
@@ -27,6 +41,8 @@ namespace NK
 		//Same as Log(), but doesn't include any formatting
 		inline void RawLog(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, const std::string& _message, std::int32_t _indentationLevel=INT32_MAX) const
 		{
+			if (!IsCompiledIn(_channel)) { return; }
+			
 			//Use non-virtual-interface pattern due to default parameter
 			RawLogImpl(_channel, _layer, _message, _indentationLevel);
 		};
@@ -35,7 +51,7 @@ namespace NK
 		inline void IndentLog(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, const std::string& _message)
 		{
 			Indent();
-			Log(_channel, _layer, _message, indentationLevel);
+			Log(_channel, _layer, _message, indentationLevel.load(std::memory_order_relaxed));
 			Unindent();
 		}
 
@@ -43,18 +59,47 @@ namespace NK
 		inline void IndentRawLog(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, const std::string& _message)
 		{
 			Indent();
-			RawLog(_channel, _layer, _message, indentationLevel);
+			RawLog(_channel, _layer, _message, indentationLevel.load(std::memory_order_relaxed));
 			Unindent();
 		}
 
+		//Structured version of Log() - _site.format is a string with "{}" placeholders and _args are substituted into it in order
+		//Text sinks format the message straight away, binary sinks store the format id and the raw arguments instead
+		//Prefer the NK_LOGF macros below, which create the call site for you
+		inline void LogFormat(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, const LogFormatSite& _site, std::initializer_list<LogArg> _args, std::int32_t _indentationLevel=INT32_MAX) const
+		{
+			if (!IsCompiledIn(_channel)) { return; }
+			LogFormatImpl(_channel, _layer, _site, std::span<const LogArg>(_args.begin(), _args.size()), _indentationLevel, true);
+		}
+
+		//Same as LogFormat(), but doesn't include any formatting
+		inline void RawLogFormat(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, const LogFormatSite& _site, std::initializer_list<LogArg> _args, std::int32_t _indentationLevel=INT32_MAX) const
+		{
+			if (!IsCompiledIn(_channel)) { return; }
+			LogFormatImpl(_channel, _layer, _site, std::span<const LogArg>(_args.begin(), _args.size()), _indentationLevel, false);
+		}
+
 		//Increment the indentation level
-		inline void Indent() { ++indentationLevel; }
+		inline void Indent() { indentationLevel.fetch_add(1, std::memory_order_relaxed); }
 
 		//Decrement the indentation level
 		//indentation value can be negative and it will be clamped to 0 when outputting - this lets you have an "indentation buffer region"
 		//If indentationLevel is -1, 0-indented logs will be at the same indentation level as 1-indented logs (0 indents)
-		inline void Unindent() { --indentationLevel; }
+		inline void Unindent() { indentationLevel.fetch_sub(1, std::memory_order_relaxed); }
+
 
+		//Whether a message on _channel from _layer would actually be output
+		//Cheap enough to call before building a message - prefer the NK_LOG macros below which do this for you
+		[[nodiscard]] inline bool IsEnabled(const LOGGER_CHANNEL _channel, const LOGGER_LAYER _layer) const
+		{
+			return IsCompiledIn(_channel) && (m_config.GetChannelBitfieldForLayer(_layer) & _channel) != LOGGER_CHANNEL::NONE;
+		}
+
+		//Whether _channel survives NEKI_LOG_COMPILED_CHANNELS
+		[[nodiscard]] static inline constexpr bool IsCompiledIn(const LOGGER_CHANNEL _channel)
+		{
+			return (static_cast<std::uint32_t>(NEKI_LOG_COMPILED_CHANNELS) & std::to_underlying(_channel)) != 0;
+		}
 
 		inline const LoggerConfig& GetLoggerConfig() const { return m_config; }
 		
@@ -76,6 +121,15 @@ namespace NK
 		//NVI impls
 		virtual void LogImpl(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, const std::string& _message, std::int32_t _indentationLevel) const = 0;
 		virtual void RawLogImpl(LOGGER_CHANNEL _channel, LOGGER_LAYER _layer, const std::string& _message, std::int32_t _indentationLevel) const = 0;
+
+		//Text sinks don't need to override this - the arguments just get substituted in and the result goes through LogImpl() / RawLogImpl()
+		virtual void LogFormatImpl(const LOGGER_CHANNEL _channel, const LOGGER_LAYER _layer, const LogFormatSite& _site, const std::span<const LogArg> _args, const std::int32_t _indentationLevel, const bool _formatted) const
+		{
+			if (!IsEnabled(_channel, _layer)) { return; }
+			const std::string message{ FormatLogMessage(_site.format, _args) };
+			if (_formatted) { LogImpl(_channel, _layer, message, _indentationLevel); }
+			else { RawLogImpl(_channel, _layer, message, _indentationLevel); }
+		}
 		
 		//For older Windows systems
 		//Attempt to enable ANSI support for access to ANSI colour codes
@@ -89,8 +143,40 @@ namespace NK
 			CHANNEL = 10,
 			LAYER = 25,
 		};
-		int32_t indentationLevel{ 0 }; //Stores the amount of indents currently active - controlled by Indent() and Unindent() - can be negative, acting as a buffer region
+		std::atomic<std::int32_t> indentationLevel{ 0 }; //Stores the amount of indents currently active - controlled by Indent() and Unindent() - can be negative, acting as a buffer region
+		//Atomic since layers can run (and log) on different threads at once - the indentation may then interleave, but nothing tears
 		
 		const LoggerConfig m_config;
 	};
-}
\ No newline at end of file
+}
+
+
+
+//Lazy logging macros - the message expression is only evaluated if the channel is enabled for the layer, so string concatenation / std::to_string() calls cost nothing when the message would be filtered out anyway
+//Channels stripped by NEKI_LOG_COMPILED_CHANNELS compile away entirely - _channel must be a constant expression
+//_logger is an ILogger& (e.g. m_logger, *Context::GetLogger()), any extra arguments are forwarded after the message (e.g. an indentation override)
+#define NK_LOG(_logger, _channel, _layer, ...) \
+	do { if constexpr (::NK::ILogger::IsCompiledIn(_channel)) { if ((_logger).IsEnabled(_channel, _layer)) { (_logger).Log(_channel, _layer, __VA_ARGS__); } } } while (0)
+
+#define NK_RAW_LOG(_logger, _channel, _layer, ...) \
+	do { if constexpr (::NK::ILogger::IsCompiledIn(_channel)) { if ((_logger).IsEnabled(_channel, _layer)) { (_logger).RawLog(_channel, _layer, __VA_ARGS__); } } } while (0)
+
+#define NK_INDENT_LOG(_logger, _channel, _layer, ...) \
+	do { if constexpr (::NK::ILogger::IsCompiledIn(_channel)) { if ((_logger).IsEnabled(_channel, _layer)) { (_logger).IndentLog(_channel, _layer, __VA_ARGS__); } } } while (0)
+
+#define NK_INDENT_RAW_LOG(_logger, _channel, _layer, ...) \
+	do { if constexpr (::NK::ILogger::IsCompiledIn(_channel)) { if ((_logger).IsEnabled(_channel, _layer)) { (_logger).IndentRawLog(_channel, _layer, __VA_ARGS__); } } } while (0)
+
+
+
+//Structured logging macros - same laziness as NK_LOG, but the message is a "{}" format string literal plus arguments rather than a pre-built string
+//Binary sinks store the format once per file and just the arguments per message, which is a lot cheaper than building the string
+//e.g. NK_LOGF(m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::ENGINE, "Client {} connected from {}:{}\n", index, address, port);
+#define NK_LOGF(_logger, _channel, _layer, _format, ...) \
+	do { if constexpr (::NK::ILogger::IsCompiledIn(_channel)) { if ((_logger).IsEnabled(_channel, _layer)) { static const ::NK::LogFormatSite nkLogFormatSite{ _format }; (_logger).LogFormat(_channel, _layer, nkLogFormatSite, { __VA_ARGS__ }); } } } while (0)
+
+#define NK_RAW_LOGF(_logger, _channel, _layer, _format, ...) \
+	do { if constexpr (::NK::ILogger::IsCompiledIn(_channel)) { if ((_logger).IsEnabled(_channel, _layer)) { static const ::NK::LogFormatSite nkLogFormatSite{ _format }; (_logger).RawLogFormat(_channel, _layer, nkLogFormatSite, { __VA_ARGS__ }); } } } while (0)
+
+#define NK_INDENT_LOGF(_logger, _channel, _layer, _format, ...) \
+	do { if constexpr (::NK::ILogger::IsCompiledIn(_channel)) { if ((_logger).IsEnabled(_channel, _layer)) { static const ::NK::LogFormatSite nkLogFormatSite{ _format }; (_logger).Indent(); (_logger).LogFormat(_channel, _layer, nkLogFormatSite, { __VA_ARGS__ }); (_logger).Unindent(); } } } while (0)
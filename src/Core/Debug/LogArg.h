@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+
+//Standalone on purpose (no NekiTypes) - the log decoder tool includes this without linking the engine
+
+
+namespace NK
+{
+
+	enum class LOG_ARG_TYPE : std::uint8_t
+	{
+		INT		= 0,
+		UINT	= 1,
+		FLOAT	= 2,
+		BOOL	= 3,
+		STRING	= 4,
+	};
+
+
+	//One argument to a structured log call (NK_LOGF())
+	//Only ever lives for the duration of the log call - strings are referenced, not copied, so sinks have to copy them out before returning
+	struct LogArg
+	{
+		template<typename T>
+		requires (std::integral<T> && !std::same_as<T, bool> && std::is_signed_v<T>)
+		LogArg(const T _value) : type(LOG_ARG_TYPE::INT), i(_value) {}
+
+		template<typename T>
+		requires (std::integral<T> && !std::same_as<T, bool> && std::is_unsigned_v<T>)
+		LogArg(const T _value) : type(LOG_ARG_TYPE::UINT), u(_value) {}
+
+		template<typename T>
+		requires (std::is_enum_v<T>)
+		LogArg(const T _value) : LogArg(std::to_underlying(_value)) {}
+
+		LogArg(const bool _value) : type(LOG_ARG_TYPE::BOOL), b(_value) {}
+		LogArg(const float _value) : type(LOG_ARG_TYPE::FLOAT), f(_value) {}
+		LogArg(const double _value) : type(LOG_ARG_TYPE::FLOAT), f(_value) {}
+		LogArg(const char* _value) : type(LOG_ARG_TYPE::STRING), s(_value) {}
+		LogArg(const std::string_view _value) : type(LOG_ARG_TYPE::STRING), s(_value) {}
+		LogArg(const std::string& _value) : type(LOG_ARG_TYPE::STRING), s(_value) {}
+
+		[[nodiscard]] std::string ToString() const
+		{
+			switch (type)
+			{
+			case LOG_ARG_TYPE::INT:		return std::to_string(i);
+			case LOG_ARG_TYPE::UINT:	return std::to_string(u);
+			case LOG_ARG_TYPE::FLOAT:	return std::to_string(f);
+			case LOG_ARG_TYPE::BOOL:	return (b ? "true" : "false");
+			case LOG_ARG_TYPE::STRING:	return std::string(s);
+			}
+			return {};
+		}
+
+		LOG_ARG_TYPE type;
+		union
+		{
+			std::int64_t i;
+			std::uint64_t u;
+			double f;
+			bool b;
+		};
+		std::string_view s;
+	};
+
+
+	//A structured log call site - one of these is created per NK_LOGF() invocation as a function-local static
+	//The id is process-unique so binary sinks can write the format string once and refer to it by id afterwards
+	struct LogFormatSite
+	{
+		explicit LogFormatSite(const char* _format) : format(_format), id(m_nextID.fetch_add(1, std::memory_order_relaxed)) {}
+
+		const char* const format;
+		const std::uint32_t id;
+
+		//0 is reserved for plain Log() / RawLog() messages, which are stored as the "{}" format with a single string argument
+		static constexpr std::uint32_t PLAIN_MESSAGE_ID{ 0 };
+		static constexpr const char* PLAIN_MESSAGE_FORMAT{ "{}" };
+
+
+	private:
+		static inline std::atomic<std::uint32_t> m_nextID{ 1 };
+	};
+
+
+	//Substitutes each "{}" in _format with the next argument - the only placeholder supported, "{{" and "}}" escape braces
+	//Surplus placeholders are left as-is, surplus arguments are ignored
+	[[nodiscard]] inline std::string FormatLogMessage(const std::string_view _format, const std::span<const LogArg> _args)
+	{
+		std::string out;
+		out.reserve(_format.size() + _args.size() * 8);
+		std::size_t argIndex{ 0 };
+		for (std::size_t i{ 0 }; i < _format.size(); ++i)
+		{
+			const char c{ _format[i] };
+			const bool hasNext{ i + 1 < _format.size() };
+			if (c == '{' && hasNext && _format[i + 1] == '{') { out += '{'; ++i; }
+			else if (c == '}' && hasNext && _format[i + 1] == '}') { out += '}'; ++i; }
+			else if (c == '{' && hasNext && _format[i + 1] == '}' && argIndex < _args.size()) { out += _args[argIndex++].ToString(); ++i; }
+			else { out += c; }
+		}
+		return out;
+	}
+
+}
@@ -1,5 +1,8 @@
 #include "LoggerConfig.h"
 
+#include <stdexcept>
+#include <string>
+
 
 namespace NK
 {
@@ -10,6 +13,7 @@ namespace NK
 	{
 		if (_enableAll) { m_defaultChannelBitfield = LOGGER_CHANNEL::INFO | LOGGER_CHANNEL::HEADING | LOGGER_CHANNEL::WARNING | LOGGER_CHANNEL::ERROR | LOGGER_CHANNEL::SUCCESS; }
 		else { m_defaultChannelBitfield = LOGGER_CHANNEL::NONE; }
+		m_layerChannelBitfield.fill(m_defaultChannelBitfield);
 	}
 
 
@@ -17,26 +21,23 @@ namespace NK
 	void LoggerConfig::SetDefaultChannelBitfield(LOGGER_CHANNEL _channels)
 	{
 		m_defaultChannelBitfield = _channels;
+		for (std::size_t i{ 0 }; i < LOGGER_LAYER_COUNT; ++i)
+		{
+			if (!m_layerExplicitlySet[i]) { m_layerChannelBitfield[i] = _channels; }
+		}
 	}
 
 
 
 	void LoggerConfig::SetLayerChannelBitfield(LOGGER_LAYER _layer, LOGGER_CHANNEL _channels)
 	{
-		m_layerChannelBitfield[_layer] = _channels;
-	}
-
-
-
-	LOGGER_CHANNEL LoggerConfig::GetChannelBitfieldForLayer(LOGGER_LAYER _layer) const
-	{
-		//If a specific channel bitfield has been set for this layer, return it. Otherwise, just return the default
-		const std::unordered_map<LOGGER_LAYER, LOGGER_CHANNEL>::const_iterator it{ m_layerChannelBitfield.find(_layer) };
-		if (it != m_layerChannelBitfield.end())
+		const std::size_t index{ static_cast<std::size_t>(_layer) };
+		if (index >= LOGGER_LAYER_COUNT)
 		{
-			return it->second;
+			throw std::invalid_argument("LoggerConfig::SetLayerChannelBitfield() - _layer (" + std::to_string(index) + ") is out of range");
 		}
-		return m_defaultChannelBitfield;
+		m_layerChannelBitfield[index] = _channels;
+		m_layerExplicitlySet.set(index);
 	}
 
 
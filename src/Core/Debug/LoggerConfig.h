@@ -2,7 +2,8 @@
 
 #include <Types/NekiTypes.h>
 
-#include <unordered_map>
+#include <array>
+#include <bitset>
 
 
 namespace NK
@@ -22,13 +23,29 @@ namespace NK
 		void SetLayerChannelBitfield(LOGGER_LAYER _layer, LOGGER_CHANNEL _channels);
 
 		//Get the logging channels for a specific layer
-		[[nodiscard]] LOGGER_CHANNEL GetChannelBitfieldForLayer(LOGGER_LAYER _layer) const;
+		//Constant-time array lookup, this gets hit by every log call
+		[[nodiscard]] inline LOGGER_CHANNEL GetChannelBitfieldForLayer(const LOGGER_LAYER _layer) const
+		{
+			const std::size_t index{ static_cast<std::size_t>(_layer) };
+			return (index < LOGGER_LAYER_COUNT ? m_layerChannelBitfield[index] : m_defaultChannelBitfield);
+		}
+
+		//Only used when type is LOGGER_TYPE::ASYNC_CONSOLE
+		inline void SetAsyncConfig(const AsyncLoggerConfig& _config) { m_asyncConfig = _config; }
+		[[nodiscard]] inline const AsyncLoggerConfig& GetAsyncConfig() const { return m_asyncConfig; }
+
+		//Only used when type is LOGGER_TYPE::BINARY
+		inline void SetBinaryConfig(const BinaryLoggerConfig& _config) { m_binaryConfig = _config; }
+		[[nodiscard]] inline const BinaryLoggerConfig& GetBinaryConfig() const { return m_binaryConfig; }
 
 		const LOGGER_TYPE type;
 
 
 	private:
 		LOGGER_CHANNEL m_defaultChannelBitfield;
-		std::unordered_map<LOGGER_LAYER, LOGGER_CHANNEL> m_layerChannelBitfield;
+		std::array<LOGGER_CHANNEL, LOGGER_LAYER_COUNT> m_layerChannelBitfield; //Resolved bitfield for every layer - layers that haven't been explicitly set mirror m_defaultChannelBitfield
+		std::bitset<LOGGER_LAYER_COUNT> m_layerExplicitlySet; //So SetDefaultChannelBitfield() doesn't stomp on layers that have been set with SetLayerChannelBitfield()
+		AsyncLoggerConfig m_asyncConfig{};
+		BinaryLoggerConfig m_binaryConfig{};
 	};
 }
\ No newline at end of file
@@ -0,0 +1,309 @@
+#include "Profiler.h"
+
+#include <Core/Context.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <imgui.h>
+
+
+namespace NK
+{
+
+	namespace
+	{
+		constexpr const char* FRAME_EVENT_NAME{ "Frame" };
+
+		//Event names are mostly identifiers, but pass names etc. could be anything
+		void WriteJSONString(std::ostream& _stream, const std::string_view _string)
+		{
+			_stream << '"';
+			for (const char c : _string)
+			{
+				switch (c)
+				{
+				case '"':	_stream << "\\\""; break;
+				case '\\':	_stream << "\\\\"; break;
+				case '\n':	_stream << "\\n"; break;
+				case '\t':	_stream << "\\t"; break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20) { _stream << ' '; }
+					else { _stream << c; }
+				}
+			}
+			_stream << '"';
+		}
+	}
+
+
+
+	void Profiler::SetThreadName(const std::string_view _name)
+	{
+		ThreadBuffer& buffer{ GetThreadBuffer() };
+		const std::lock_guard lock(buffer.nameMutex);
+		buffer.name = _name;
+	}
+
+
+
+	const char* Profiler::InternName(const std::string_view _name)
+	{
+		const std::lock_guard lock(m_threadBuffersMutex);
+		//Nodes of an unordered_set don't move on rehash, so c_str() stays valid
+		return m_internedNames.emplace(_name).first->c_str();
+	}
+
+
+
+	void Profiler::Record(const char* _name, const std::int64_t _startNs, const std::int64_t _endNs, const std::uint32_t _depth)
+	{
+		ThreadBuffer& buffer{ GetThreadBuffer() };
+		const std::uint64_t index{ buffer.written.load(std::memory_order_relaxed) };
+
+		//Pairs with the fence in ReadEvents() - a reader that sees any of the stores below is guaranteed to then see written >= index, and so knows the slot's old event is gone
+		std::atomic_thread_fence(std::memory_order_release);
+		EventSlot& slot{ buffer.events[index % EVENTS_PER_THREAD] };
+		slot.name.store(_name, std::memory_order_relaxed);
+		slot.startNs.store(_startNs, std::memory_order_relaxed);
+		slot.endNs.store(_endNs, std::memory_order_relaxed);
+		slot.depth.store(_depth, std::memory_order_relaxed);
+
+		buffer.written.store(index + 1, std::memory_order_release);
+	}
+
+
+
+	void Profiler::ReadEvents(const ThreadBuffer& _buffer, std::vector<ProfileEvent>& _events)
+	{
+		_events.clear();
+
+		const std::uint64_t end{ _buffer.written.load(std::memory_order_acquire) };
+		const std::uint64_t begin{ end - std::min<std::uint64_t>(end, EVENTS_PER_THREAD) };
+		for (std::uint64_t i{ begin }; i < end; ++i)
+		{
+			const EventSlot& slot{ _buffer.events[i % EVENTS_PER_THREAD] };
+			_events.push_back(ProfileEvent{ slot.name.load(std::memory_order_relaxed), slot.startNs.load(std::memory_order_relaxed), slot.endNs.load(std::memory_order_relaxed), slot.depth.load(std::memory_order_relaxed) });
+		}
+
+		//The thread kept recording while we copied - event i shares its slot with event i + EVENTS_PER_THREAD, which could have been part-written over it if that's <= the latest write index
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const std::uint64_t latest{ _buffer.written.load(std::memory_order_relaxed) };
+		const std::uint64_t firstIntact{ latest + 1 > EVENTS_PER_THREAD ? latest + 1 - EVENTS_PER_THREAD : 0 };
+		if (firstIntact > begin)
+		{
+			_events.erase(_events.begin(), _events.begin() + static_cast<std::ptrdiff_t>(std::min<std::uint64_t>(firstIntact - begin, _events.size())));
+		}
+	}
+
+
+
+	Profiler::ThreadBuffer& Profiler::GetThreadBuffer()
+	{
+		if (!m_threadBuffer)
+		{
+			std::unique_ptr<ThreadBuffer> buffer{ std::make_unique<ThreadBuffer>() };
+			buffer->events = std::make_unique<EventSlot[]>(EVENTS_PER_THREAD);
+
+			const std::lock_guard lock(m_threadBuffersMutex);
+			buffer->id = static_cast<std::uint32_t>(m_threadBuffers.size());
+			buffer->name = "Thread " + std::to_string(buffer->id);
+			m_threadBuffer = buffer.get();
+			m_threadBuffers.push_back(std::move(buffer));
+		}
+		return *m_threadBuffer;
+	}
+
+
+
+	void Profiler::EndFrame()
+	{
+		const std::int64_t now{ Now() };
+		const std::int64_t frameStartNs{ m_frameStartNs };
+		m_frameStartNs = now;
+		++m_frameIndex;
+		if (!IsEnabled()) { return; }
+
+		//The first frame after enabling starts wherever the last EndFrame() happened to be
+		Record(FRAME_EVENT_NAME, frameStartNs, now, 0);
+
+		const float frameTimeMs{ static_cast<float>(now - frameStartNs) / 1'000'000.0f };
+		m_frameTimesMs[m_frameTimesHead] = frameTimeMs;
+		m_frameTimesHead = (m_frameTimesHead + 1) % FRAME_HISTORY;
+
+		//Spikes are copied out straight away, before the ring buffers have a chance to wrap over them
+		if (m_captureSpikes && frameTimeMs >= m_spikeThresholdMs)
+		{
+			CaptureFrame(m_lastSpike, frameStartNs, now, m_frameIndex);
+		}
+
+		//The last frame's events are only collected if the panel is drawn
+		m_lastFrame.startNs = frameStartNs;
+		m_lastFrame.endNs = now;
+		m_lastFrame.frameIndex = m_frameIndex;
+	}
+
+
+
+	void Profiler::CaptureFrame(FrameCapture& _capture, const std::int64_t _startNs, const std::int64_t _endNs, const std::uint64_t _frameIndex)
+	{
+		_capture.frameIndex = _frameIndex;
+		_capture.startNs = _startNs;
+		_capture.endNs = _endNs;
+		_capture.threads.clear();
+
+		std::vector<ProfileEvent> events;
+		const std::lock_guard lock(m_threadBuffersMutex);
+		for (const std::unique_ptr<ThreadBuffer>& buffer : m_threadBuffers)
+		{
+			FrameEvents frameEvents{ buffer->id, {}, {} };
+			{
+				const std::lock_guard nameLock(buffer->nameMutex);
+				frameEvents.threadName = buffer->name;
+			}
+			ReadEvents(*buffer, events);
+			for (const ProfileEvent& event : events)
+			{
+				if (event.startNs >= _startNs && event.startNs < _endNs && event.name != FRAME_EVENT_NAME)
+				{
+					frameEvents.events.push_back(event);
+				}
+			}
+			if (frameEvents.events.empty()) { continue; }
+
+			//Events are recorded as scopes close (children before their parents) - put them back in the order they opened in
+			std::ranges::sort(frameEvents.events, [](const ProfileEvent& _a, const ProfileEvent& _b) { return _a.startNs != _b.startNs ? _a.startNs < _b.startNs : _a.depth < _b.depth; });
+			_capture.threads.push_back(std::move(frameEvents));
+		}
+	}
+
+
+
+	void Profiler::ExportChromeTrace(const std::filesystem::path& _path)
+	{
+		std::ofstream file(_path);
+		if (!file.is_open())
+		{
+			throw std::runtime_error("Profiler::ExportChromeTrace() - Failed to open " + _path.string() + " for writing");
+		}
+
+		std::size_t eventCount{ 0 };
+		file << std::fixed << std::setprecision(3);
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		bool first{ true };
+		const auto separator{ [&]() { if (!first) { file << ",\n"; } first = false; } };
+
+		std::vector<ProfileEvent> events;
+		const std::lock_guard lock(m_threadBuffersMutex);
+		for (const std::unique_ptr<ThreadBuffer>& buffer : m_threadBuffers)
+		{
+			separator();
+			file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id << ",\"args\":{\"name\":";
+			{
+				const std::lock_guard nameLock(buffer->nameMutex);
+				WriteJSONString(file, buffer->name);
+			}
+			file << "}}";
+
+			//Complete ("X") events - the viewer works out the nesting from the timestamps
+			ReadEvents(*buffer, events);
+			for (const ProfileEvent& event : events)
+			{
+				separator();
+				file << "{\"name\":";
+				WriteJSONString(file, event.name);
+				file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id << ",\"ts\":" << (event.startNs / 1000.0) << ",\"dur\":" << ((event.endNs - event.startNs) / 1000.0) << "}";
+				++eventCount;
+			}
+		}
+		file << "\n]}\n";
+
+		Context::GetLogger()->IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::PROFILER, "Exported " + std::to_string(eventCount) + " profiler event(s) to " + _path.string() + "\n");
+	}
+
+
+
+	void Profiler::DrawImGuiPanel()
+	{
+		bool enabled{ IsEnabled() };
+		if (ImGui::Checkbox("Record", &enabled)) { SetEnabled(enabled); }
+		ImGui::SameLine();
+		if (ImGui::Button("Export Chrome Trace"))
+		{
+			ExportChromeTrace("NekiProfile.json");
+		}
+		if (ImGui::IsItemHovered())
+		{
+			ImGui::SetTooltip("Writes everything still in the per-thread buffers to NekiProfile.json in the working directory - open it in ui.perfetto.dev or chrome://tracing");
+		}
+
+		//Frame times, oldest on the left
+		float maxFrameTimeMs{ 0.0f };
+		for (const float frameTimeMs : m_frameTimesMs) { maxFrameTimeMs = std::max(maxFrameTimeMs, frameTimeMs); }
+		char overlay[32];
+		std::snprintf(overlay, sizeof(overlay), "max %.2fms", maxFrameTimeMs);
+		ImGui::PlotLines("##FrameTimes", m_frameTimesMs, static_cast<int>(FRAME_HISTORY), static_cast<int>(m_frameTimesHead), overlay, 0.0f, std::max(maxFrameTimeMs, m_spikeThresholdMs), ImVec2(-1.0f, 60.0f));
+
+		ImGui::Checkbox("Capture Spikes Over", &m_captureSpikes);
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(100.0f);
+		ImGui::DragFloat("ms", &m_spikeThresholdMs, 0.1f, 1.0f, 1000.0f, "%.1f");
+		ImGui::SameLine();
+		ImGui::BeginDisabled(m_lastSpike.threads.empty());
+		ImGui::Checkbox("Show Last Spike", &m_showSpike);
+		ImGui::EndDisabled();
+
+		ImGui::Separator();
+
+		if (m_showSpike && !m_lastSpike.threads.empty())
+		{
+			DrawFrameCapture(m_lastSpike);
+		}
+		else if (enabled)
+		{
+			CaptureFrame(m_lastFrame, m_lastFrame.startNs, m_lastFrame.endNs, m_lastFrame.frameIndex);
+			DrawFrameCapture(m_lastFrame);
+		}
+	}
+
+
+
+	void Profiler::DrawFrameCapture(const FrameCapture& _capture)
+	{
+		const double frameTimeMs{ static_cast<double>(_capture.endNs - _capture.startNs) / 1'000'000.0 };
+		ImGui::Text("Frame %llu - %.3fms", static_cast<unsigned long long>(_capture.frameIndex), frameTimeMs);
+
+		for (const FrameEvents& thread : _capture.threads)
+		{
+			ImGui::PushID(static_cast<int>(thread.threadID));
+			if (ImGui::CollapsingHeader(thread.threadName.c_str(), ImGuiTreeNodeFlags_DefaultOpen))
+			{
+				if (ImGui::BeginTable("Scopes", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingStretchProp))
+				{
+					ImGui::TableSetupColumn("Scope");
+					ImGui::TableSetupColumn("ms");
+					ImGui::TableSetupColumn("% of frame");
+					ImGui::TableHeadersRow();
+
+					for (const ProfileEvent& event : thread.events)
+					{
+						const double durationMs{ static_cast<double>(event.endNs - event.startNs) / 1'000'000.0 };
+						ImGui::TableNextRow();
+						ImGui::TableNextColumn();
+						ImGui::SetCursorPosX(ImGui::GetCursorPosX() + static_cast<float>(event.depth) * 12.0f);
+						ImGui::TextUnformatted(event.name);
+						ImGui::TableNextColumn();
+						ImGui::Text("%.3f", durationMs);
+						ImGui::TableNextColumn();
+						ImGui::Text("%.1f", frameTimeMs > 0.0 ? 100.0 * durationMs / frameTimeMs : 0.0);
+					}
+					ImGui::EndTable();
+				}
+			}
+			ImGui::PopID();
+		}
+	}
+
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+
+//Set to 0 for the whole build (NEKI_ENABLE_PROFILER=OFF in cmake) to compile every NK_PROFILE_SCOPE() out entirely
+#ifndef NEKI_PROFILER_ENABLED
+	#define NEKI_PROFILER_ENABLED 1
+#endif
+
+
+namespace NK
+{
+
+	struct ProfileEvent
+	{
+		const char* name; //Has to outlive the profiler - a string literal, or Profiler::InternName() for anything built at runtime
+		std::int64_t startNs; //Relative to Profiler::GetStartTimePoint()
+		std::int64_t endNs;
+		std::uint32_t depth; //How many scopes were open on the thread when this one started
+	};
+
+
+	//Hierarchical cpu profiler - NK_PROFILE_SCOPE() records the time spent in a scope into a ring buffer owned by the calling thread, so threads never contend with each other while recording
+	//Recording takes no locks - each ring has one writer (its thread) and publishes events through an atomic write index, and readers (exports, spikes and the panel) copy it out and throw away anything that was overwritten while they were copying
+	//Recording is off until SetEnabled(true), and a scope that's hit while it's off costs one relaxed atomic load
+	//Captures export to Chrome's trace event format (open in ui.perfetto.dev or chrome://tracing), and DrawImGuiPanel() shows the last frame's scopes in the editor
+	class Profiler final
+	{
+	public:
+		static constexpr std::size_t EVENTS_PER_THREAD{ 1 << 15 }; //Once full, a thread's oldest events are overwritten
+		static constexpr std::size_t FRAME_HISTORY{ 240 };
+
+
+		static inline void SetEnabled(const bool _enabled) { m_enabled.store(_enabled, std::memory_order_relaxed); }
+		[[nodiscard]] static inline bool IsEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+
+		//Name shown for the calling thread in exported captures and the panel (e.g. "Main", "Job Worker 3")
+		static void SetThreadName(std::string_view _name);
+
+		//A copy of _name that lives as long as the program - for scopes with names that aren't string literals (e.g. render graph pass names)
+		//Takes a lock, so look names up once and hang onto the pointer rather than calling this per-scope
+		[[nodiscard]] static const char* InternName(std::string_view _name);
+
+		//Call once per frame from the main thread (Engine::Run() does this) - records a "Frame" event spanning back to the previous call and keeps the frame for the panel
+		static void EndFrame();
+
+		//Write every event still held by the ring buffers as Chrome trace event json
+		static void ExportChromeTrace(const std::filesystem::path& _path);
+
+		//Frame time graph, spike capture and the scopes of the last (or last spike) frame - main thread only, between ImGui::NewFrame() and ImGui::Render()
+		static void DrawImGuiPanel();
+
+		[[nodiscard]] static inline std::chrono::steady_clock::time_point GetStartTimePoint() { return m_startTimePoint; }
+		[[nodiscard]] static inline std::int64_t Now() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_startTimePoint).count(); }
+
+		//Used by ProfileScope
+		static void Record(const char* _name, std::int64_t _startNs, std::int64_t _endNs, std::uint32_t _depth);
+
+
+	private:
+		//A ProfileEvent that can be read by another thread while its owner is overwriting it - readers can see a torn event, but ReadEvents() throws those away
+		struct EventSlot
+		{
+			std::atomic<const char*> name{ nullptr };
+			std::atomic<std::int64_t> startNs{ 0 };
+			std::atomic<std::int64_t> endNs{ 0 };
+			std::atomic<std::uint32_t> depth{ 0 };
+		};
+
+		struct ThreadBuffer
+		{
+			std::unique_ptr<EventSlot[]> events; //Ring of EVENTS_PER_THREAD - only written by the thread that owns it
+			std::atomic<std::uint64_t> written{ 0 }; //Events before this are complete
+			std::uint32_t id;
+			std::mutex nameMutex; //Guards name - SetThreadName() isn't on the hot path
+			std::string name;
+		};
+
+		struct FrameEvents
+		{
+			std::uint32_t threadID;
+			std::string threadName;
+			std::vector<ProfileEvent> events; //Sorted by start time
+		};
+
+		struct FrameCapture
+		{
+			std::uint64_t frameIndex;
+			std::int64_t startNs;
+			std::int64_t endNs;
+			std::vector<FrameEvents> threads;
+		};
+
+
+		[[nodiscard]] static ThreadBuffer& GetThreadBuffer();
+		//Copies every event still held by _buffer into _events, oldest first - safe while its thread is still recording
+		static void ReadEvents(const ThreadBuffer& _buffer, std::vector<ProfileEvent>& _events);
+		static void CaptureFrame(FrameCapture& _capture, std::int64_t _startNs, std::int64_t _endNs, std::uint64_t _frameIndex);
+		static void DrawFrameCapture(const FrameCapture& _capture);
+
+
+		inline static std::atomic<bool> m_enabled{ false };
+		inline static const std::chrono::steady_clock::time_point m_startTimePoint{ std::chrono::steady_clock::now() };
+
+		inline static std::mutex m_threadBuffersMutex; //Guards m_threadBuffers and m_internedNames
+		inline static std::vector<std::unique_ptr<ThreadBuffer>> m_threadBuffers; //Kept after their thread exits so their events can still be exported
+		inline static std::unordered_set<std::string> m_internedNames;
+		inline static thread_local ThreadBuffer* m_threadBuffer{ nullptr };
+
+		//Main thread only
+		inline static std::int64_t m_frameStartNs{ 0 };
+		inline static std::uint64_t m_frameIndex{ 0 };
+		inline static float m_frameTimesMs[FRAME_HISTORY]{};
+		inline static std::size_t m_frameTimesHead{ 0 };
+		inline static float m_spikeThresholdMs{ 33.3f };
+		inline static bool m_captureSpikes{ false };
+		inline static bool m_showSpike{ false };
+		inline static FrameCapture m_lastFrame{};
+		inline static FrameCapture m_lastSpike{};
+	};
+
+
+	//Records the time between its construction and destruction - use through NK_PROFILE_SCOPE()
+	class ProfileScope final
+	{
+	public:
+		explicit inline ProfileScope(const char* _name)
+		{
+			if (!Profiler::IsEnabled()) { return; }
+			m_name = _name;
+			m_depth = m_threadDepth++;
+			m_startNs = Profiler::Now();
+		}
+
+		inline ~ProfileScope()
+		{
+			if (!m_name) { return; }
+			Profiler::Record(m_name, m_startNs, Profiler::Now(), m_depth);
+			--m_threadDepth;
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+
+	private:
+		const char* m_name{ nullptr }; //Null if the profiler was disabled when the scope started
+		std::int64_t m_startNs{ 0 };
+		std::uint32_t m_depth{ 0 };
+
+		inline static thread_local std::uint32_t m_threadDepth{ 0 };
+	};
+
+}
+
+
+
+#define NK_PROFILE_CONCAT_IMPL(_a, _b) _a##_b
+#define NK_PROFILE_CONCAT(_a, _b) NK_PROFILE_CONCAT_IMPL(_a, _b)
+
+//Profile the rest of the enclosing scope under _name (a const char* that outlives the profiler - see Profiler::InternName())
+#if NEKI_PROFILER_ENABLED
+	#define NK_PROFILE_SCOPE(_name) const ::NK::ProfileScope NK_PROFILE_CONCAT(nkProfileScope, __LINE__){ _name }
+#else
+	#define NK_PROFILE_SCOPE(_name) static_cast<void>(0)
+#endif
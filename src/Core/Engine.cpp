@@ -2,13 +2,18 @@
 
 #include "Context.h"
 #include "Debug/ConsoleLogger.h"
+#include "Debug/Profiler.h"
 #include "Memory/TrackingAllocator.h"
+#include "Replay/Replay.h"
 
+#include <Components/CTransform.h>
+#include <Managers/EventManager.h>
 #include <Managers/InputManager.h>
 #include <Managers/TimeManager.h>
 
+#include <chrono>
+#include <string>
 #include <stdexcept>
-#include <GLFW/glfw3.h>
 
 
 
@@ -16,8 +21,9 @@ namespace NK
 {
 
 	Engine::Engine(const EngineConfig& _config)
-	: m_application(UniquePtr<Application>(_config.application)), m_fixedUpdateSpeedFactor(_config.fixedUpdateSpeedFactor), m_timestepAccumulator(0.0f)
+	: m_application(UniquePtr<Application>(_config.application)), m_fixedStepScheduler(_config.maxFixedUpdatesPerFrame), m_framePacer(_config.targetFPS, _config.inactiveTargetFPS), m_fixedUpdateSpeedFactor(_config.fixedUpdateSpeedFactor), m_layerTimingLogInterval(_config.layerTimingLogInterval), m_layerTimingLogTimer(0.0f), m_sleepBetweenTicks(_config.sleepBetweenTicks), m_lockstep(_config.lockstep), m_interpolateTransforms(_config.interpolateTransforms)
 	{
+		Profiler::SetEnabled(_config.enableProfiler);
 		Context::GetLogger()->Log(LOGGER_CHANNEL::INFO, LOGGER_LAYER::ENGINE, "Engine Initialised\n");
 	}
 
@@ -25,6 +31,8 @@ namespace NK
 	
 	Engine::~Engine()
 	{
+		Context::SetFixedStepScheduler(nullptr);
+		Context::SetFramePacer(nullptr);
 		Context::GetLogger()->Indent();
 		Context::GetLogger()->Log(LOGGER_CHANNEL::HEADING, LOGGER_LAYER::ENGINE, "Shutting Down Engine\n");
 		Context::GetLogger()->Unindent();
@@ -34,35 +42,125 @@ namespace NK
 
 	void Engine::Run()
 	{
+		Profiler::SetThreadName("Main");
+		Context::SetFixedStepScheduler(&m_fixedStepScheduler);
+		Context::SetFramePacer(&m_framePacer);
+		
 		bool firstFrame{ true };
 		while (!m_application->m_shutdown)
 		{
-			TimeManager::Update();
-			if (firstFrame)
+			if (m_sleepBetweenTicks && !m_lockstep && !firstFrame && m_fixedUpdateSpeedFactor > 0.0f && !Replay::IsPlaying())
 			{
-				firstFrame = false;
+				NK_PROFILE_SCOPE("Sleep Until Next Tick");
+				//Sleep off whatever's left until the next fixed update - the deadline is relative to the last TimeManager::Update() so time spent on the frame itself counts towards it
+				const double secondsUntilNextTick{ (Context::GetFixedUpdateTimestep() - m_fixedStepScheduler.GetAccumulator()) / m_fixedUpdateSpeedFactor };
+				if (secondsUntilNextTick > 0.0)
+				{
+					TimeManager::SleepUntil(TimeManager::GetLastUpdateTimePoint() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(secondsUntilNextTick)));
+				}
+			}
+			else if (!m_lockstep && !firstFrame && !Replay::IsPlaying())
+			{
+				NK_PROFILE_SCOPE("Frame Pacing");
+				m_framePacer.Wait();
+			}
+			
+			if (Replay::IsPlaying())
+			{
+				if (!Replay::PlayNextFrame())
+				{
+					m_application->m_shutdown = true;
+					break;
+				}
+				//Hold each frame for as long as it took when it was recorded, unless it's meant to be running flat out
+				if (!Replay::GetAsFastAsPossible())
+				{
+					TimeManager::SleepUntil(TimeManager::GetLastUpdateTimePoint() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(Replay::GetFrameDeltaTime())));
+				}
+				TimeManager::Update(Replay::GetFrameDeltaTime());
+				Context::SetFixedUpdateTimestep(Replay::GetFrameFixedUpdateTimestep());
 			}
 			else
 			{
-				m_timestepAccumulator += TimeManager::GetDeltaTime() * m_fixedUpdateSpeedFactor;
+				if (m_lockstep) { TimeManager::Update(Context::GetFixedUpdateTimestep()); }
+				else { TimeManager::Update(); }
+				m_framePacer.RecordFrameTime(TimeManager::GetDeltaTime());
+				Replay::BeginRecordingFrame(TimeManager::GetDeltaTime(), Context::GetFixedUpdateTimestep());
 			}
 			
-			while (m_timestepAccumulator >= Context::GetFixedUpdateTimestep())
+			const std::uint32_t fixedUpdates{ m_fixedStepScheduler.Advance(firstFrame ? 0.0 : TimeManager::GetDeltaTime() * m_fixedUpdateSpeedFactor, Context::GetFixedUpdateTimestep()) };
+			firstFrame = false;
+			
+			for (std::uint32_t i{ 0 }; i < fixedUpdates; ++i)
 			{
+				NK_PROFILE_SCOPE("Fixed Update");
+				//Only the last fixed update of the frame is interpolated across, so that's the only one the start state is needed for
+				if (m_interpolateTransforms && i == fixedUpdates - 1) { StoreTransformStates(true); }
+				
 				Context::SetLayerUpdateState(LAYER_UPDATE_STATE::PRE_APP);
 				m_application->PreFixedUpdate();
-				m_application->FixedUpdate();
+				//Hand out anything the layers queued up (e.g. collision events from jolt's worker threads) before the app sees this tick
+				EventManager::DispatchQueued();
+				{
+					NK_PROFILE_SCOPE("Application::FixedUpdate()");
+					m_application->FixedUpdate();
+				}
 				Context::SetLayerUpdateState(LAYER_UPDATE_STATE::POST_APP);
 				m_application->PostFixedUpdate();
-				m_timestepAccumulator -= Context::GetFixedUpdateTimestep();
+				EventManager::DispatchQueued();
 			}
+			if (m_interpolateTransforms && fixedUpdates > 0) { StoreTransformStates(false); }
 			
-			Context::SetLayerUpdateState(LAYER_UPDATE_STATE::PRE_APP);
-			m_application->PreUpdate();
-			m_application->Update();
-			Context::SetLayerUpdateState(LAYER_UPDATE_STATE::POST_APP);
-			m_application->PostUpdate();
+			{
+				NK_PROFILE_SCOPE("Update");
+				Context::SetLayerUpdateState(LAYER_UPDATE_STATE::PRE_APP);
+				m_application->PreUpdate();
+				EventManager::DispatchQueued();
+				//Recording picks up the inputs the pre-app layers just gathered, playback overwrites them with the recorded ones
+				Replay::SyncInputs(GetActiveRegistry());
+				{
+					NK_PROFILE_SCOPE("Application::Update()");
+					m_application->Update();
+				}
+				Context::SetLayerUpdateState(LAYER_UPDATE_STATE::POST_APP);
+				m_application->PostUpdate();
+				EventManager::DispatchQueued();
+			}
+
+			if (m_layerTimingLogInterval > 0.0f)
+			{
+				m_layerTimingLogTimer += TimeManager::GetDeltaTime();
+				if (m_layerTimingLogTimer >= m_layerTimingLogInterval)
+				{
+					m_layerTimingLogTimer = 0.0f;
+					m_application->LogLayerTimings();
+					Context::GetLogger()->IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::ENGINE, "Frame time: " + std::to_string(m_framePacer.GetAverageFrameTime() * 1000.0) + "ms average, " + std::to_string(m_framePacer.GetFrameTimeStdDev() * 1000.0) + "ms std dev, " + std::to_string(m_framePacer.GetMaxFrameTime() * 1000.0) + "ms max, " + std::to_string(m_framePacer.GetLateFrames()) + " late" + (m_framePacer.GetIdle() ? " (idle)\n" : "\n"));
+				}
+			}
+
+			Replay::EndFrame();
+			Profiler::EndFrame();
 		}
 	}
 
+
+
+	void Engine::StoreTransformStates(const bool _start)
+	{
+		NK_PROFILE_SCOPE("Engine::StoreTransformStates()");
+		for (auto&& [transform] : GetActiveRegistry().View<CTransform>())
+		{
+			if (_start) { transform.StoreFixedUpdateStartState(); }
+			else { transform.StoreFixedUpdateEndState(); }
+		}
+	}
+
+
+
+	Registry& Engine::GetActiveRegistry() const
+	{
+		if (m_application->m_activeScene < m_application->m_scenes.size()) { return m_application->m_scenes[m_application->m_activeScene]->m_reg; }
+		return m_application->m_reg;
+	}
+
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "Application.h"
 #include "EngineConfig.h"
+#include "FixedStepScheduler.h"
+#include "FramePacer.h"
 #include "Layers/ILayer.h"
 #include "Memory/Allocation.h"
 
@@ -19,9 +21,21 @@ namespace NK
 
 
 	private:
+		//Snapshot every CTransform's local pos/rot/scale from before (_start) or after the last fixed update of the frame, for CTransform::ComputeInterpolatedModelMatrix()
+		void StoreTransformStates(bool _start);
+		//The active scene's registry, which is where the game's entities live - falls back to the application's own registry if there are no scenes
+		[[nodiscard]] Registry& GetActiveRegistry() const;
+		
+		
 		UniquePtr<Application> m_application;
-		float m_timestepAccumulator;
+		FixedStepScheduler m_fixedStepScheduler;
+		FramePacer m_framePacer;
 		float m_fixedUpdateSpeedFactor;
+		float m_layerTimingLogInterval;
+		float m_layerTimingLogTimer;
+		bool m_sleepBetweenTicks;
+		bool m_lockstep;
+		bool m_interpolateTransforms;
 	};
 	
 }
\ No newline at end of file
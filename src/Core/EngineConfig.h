@@ -2,6 +2,8 @@
 
 #include "Application.h"
 
+#include <cstdint>
+
 
 namespace NK
 {
@@ -11,6 +13,36 @@ namespace NK
 		Application* application;
 		
 		float fixedUpdateSpeedFactor{ 1.0f }; //Default: 1.0f
+		float layerTimingLogInterval{ 0.0f }; //Seconds between logging per-layer timings (see Application::LogLayerTimings()) - 0 to disable. Default: 0.0f
+		bool enableProfiler{ false }; //Start recording NK_PROFILE_SCOPE()s straight away rather than waiting for Profiler::SetEnabled() (or the editor's profiler panel). Default: false
+		
+		//Cap on frames per second - each frame is waited out with a sleep, then a spin for the last bit, so they come out evenly (see FramePacer). 0 for no cap. Default: 0.0f
+		float targetFPS{ 0.0f };
+		//Frames per second while the window is unfocused or minimised, or the editor is paused - the wait is event-driven where there's a window, so input still wakes it straight away
+		//Keeps a few idle editor instances from each burning a core. 0 to carry on at targetFPS. Default: 20.0f
+		float inactiveTargetFPS{ 20.0f };
+		
+		std::uint32_t maxFixedUpdatesPerFrame{ 5 }; //Cap on catch-up fixed updates after a long frame - time past this is dropped and the simulation slows down instead (see FixedStepScheduler). 0 for no cap. Default: 5
+		
+		//Step time by exactly one fixed timestep every frame, however long the frame really took - so every frame runs one FixedUpdate() and one Update(), back to back with no sleeping
+		//For benchmarks (see Benchmarks/NekiBench), where every run has to do the same work regardless of how fast the machine is. Default: false
+		bool lockstep{ false };
+		
+		//Sleep until the next fixed update is due instead of running Update() as fast as possible - each loop then does exactly one FixedUpdate() and one Update()
+		//For dedicated servers, which have nothing to gain from extra frames and shouldn't be burning a core each. Default: true in NEKI_HEADLESS builds, false otherwise
+		#ifdef NEKI_HEADLESS
+			bool sleepBetweenTicks{ true };
+		#else
+			bool sleepBetweenTicks{ false };
+		#endif
+		
+		//Keep each CTransform's state from before and after the last fixed update so the RenderLayer can draw in between them (see CTransform::ComputeInterpolatedModelMatrix())
+		//Nothing is drawn in NEKI_HEADLESS builds, so there's no point paying for it there. Default: false in NEKI_HEADLESS builds, true otherwise
+		#ifdef NEKI_HEADLESS
+			bool interpolateTransforms{ false };
+		#else
+			bool interpolateTransforms{ true };
+		#endif
 	};
 	
 }
\ No newline at end of file
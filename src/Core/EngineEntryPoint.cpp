@@ -12,6 +12,7 @@
 #include <Components/CSelected.h>
 #include <Components/CSkybox.h>
 #include <Components/CTransform.h>
+#include <Core/Utils/ModelLoader.h>
 #include <Graphics/Camera/Camera.h>
 #include <Graphics/Camera/PlayerCamera.h>
 #include <Graphics/Lights/DirectionalLight.h>
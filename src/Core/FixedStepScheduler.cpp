@@ -0,0 +1,55 @@
+#include "FixedStepScheduler.h"
+
+#include "Context.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+
+namespace NK
+{
+
+	std::uint32_t FixedStepScheduler::Advance(const double _deltaTime, const float _timestep)
+	{
+		m_accumulator += _deltaTime;
+
+		//Done in doubles - after a long enough stall the step count wouldn't fit in anything smaller
+		const double availableSteps{ std::floor(m_accumulator / _timestep) };
+		const double steps{ m_maxStepsPerFrame == 0 ? availableSteps : std::min(availableSteps, static_cast<double>(m_maxStepsPerFrame)) };
+		const double dropped{ (availableSteps - steps) * _timestep };
+
+		//Only whole steps are dropped - the leftover fraction is kept so GetAlpha() carries on smoothly from where it was
+		m_accumulator -= availableSteps * _timestep;
+		m_alpha = static_cast<float>(std::clamp(m_accumulator / _timestep, 0.0, 1.0));
+		m_stepsLastFrame = static_cast<std::uint32_t>(steps);
+
+		if (_deltaTime > 0.0)
+		{
+			//Exponential moving average with a time constant of about a second, so it doesn't flicker with every frame time
+			const float frameDilation{ static_cast<float>(std::clamp((_deltaTime - dropped) / _deltaTime, 0.0, 1.0)) };
+			const float weight{ static_cast<float>(std::min(_deltaTime, 1.0)) };
+			m_timeDilation += (frameDilation - m_timeDilation) * weight;
+		}
+
+		if (dropped > 0.0)
+		{
+			m_droppedTime += dropped;
+			m_droppedTimeThisStreak += dropped;
+			if (!m_droppingSteps)
+			{
+				m_droppingSteps = true;
+				Context::GetLogger()->IndentLog(LOGGER_CHANNEL::WARNING, LOGGER_LAYER::ENGINE, "Fixed update can't keep up - running at most " + std::to_string(m_maxStepsPerFrame) + " step(s) per frame and dropping the rest, so the simulation is running slower than real time\n");
+			}
+		}
+		else if (m_droppingSteps)
+		{
+			m_droppingSteps = false;
+			Context::GetLogger()->IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::ENGINE, "Fixed update caught up - " + std::to_string(m_droppedTimeThisStreak * 1000.0) + "ms of simulation time was dropped\n");
+			m_droppedTimeThisStreak = 0.0;
+		}
+
+		return m_stepsLastFrame;
+	}
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+
+namespace NK
+{
+
+	//Decides how many fixed updates Engine::Run() does each frame
+	//Real time is banked in an accumulator and spent in fixed-size steps - but at most maxStepsPerFrame of them, so one long frame (a hitch, a breakpoint, a slow level load) can't snowball into more and more catch-up steps that each make the next frame even longer
+	//Time that couldn't be caught up on is dropped, and the simulation runs slower than real time for a bit instead - GetTimeDilation() reports how much
+	class FixedStepScheduler final
+	{
+	public:
+		explicit FixedStepScheduler(const std::uint32_t _maxStepsPerFrame) : m_maxStepsPerFrame(_maxStepsPerFrame) {}
+
+		//Bank _deltaTime seconds (already scaled by the engine's speed factor) and return how many steps of _timestep to run this frame
+		[[nodiscard]] std::uint32_t Advance(double _deltaTime, float _timestep);
+
+		//How far the current time is between the last fixed update and the next one, from 0 to 1 - for blending between the last two fixed states (see CTransform::ComputeInterpolatedModelMatrix())
+		[[nodiscard]] inline float GetAlpha() const { return m_alpha; }
+		//Seconds of banked time, less than one timestep (unless steps were just dropped)
+		[[nodiscard]] inline double GetAccumulator() const { return m_accumulator; }
+		//Simulated time / real time, smoothed over roughly the last second - 1 when keeping up, lower while steps are being dropped
+		[[nodiscard]] inline float GetTimeDilation() const { return m_timeDilation; }
+		[[nodiscard]] inline std::uint32_t GetStepsLastFrame() const { return m_stepsLastFrame; }
+		//Total seconds of simulation time dropped since startup
+		[[nodiscard]] inline double GetDroppedTime() const { return m_droppedTime; }
+
+		[[nodiscard]] inline std::uint32_t GetMaxStepsPerFrame() const { return m_maxStepsPerFrame; }
+		inline void SetMaxStepsPerFrame(const std::uint32_t _maxStepsPerFrame) { m_maxStepsPerFrame = _maxStepsPerFrame; }
+
+
+	private:
+		std::uint32_t m_maxStepsPerFrame; //0 = no limit
+		double m_accumulator{ 0.0 };
+		float m_alpha{ 0.0f };
+		float m_timeDilation{ 1.0f };
+		std::uint32_t m_stepsLastFrame{ 0 };
+		double m_droppedTime{ 0.0 };
+		bool m_droppingSteps{ false }; //Whether the last frame had to drop time - just so the warning is logged once when it starts rather than every frame
+		double m_droppedTimeThisStreak{ 0.0 };
+	};
+
+}
@@ -0,0 +1,80 @@
+#include "FramePacer.h"
+
+#include "Context.h"
+
+#include <Managers/TimeManager.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace NK
+{
+
+	void FramePacer::Wait()
+	{
+		const std::chrono::steady_clock::time_point now{ std::chrono::steady_clock::now() };
+		const bool inactive{ m_windowInactive || Context::GetPaused() };
+		m_idle = inactive && m_inactiveTargetFPS > 0.0f && std::chrono::duration<double>(now - m_lastActivity).count() > ACTIVITY_GRACE_PERIOD;
+
+		const float fps{ m_idle ? m_inactiveTargetFPS : m_targetFPS };
+		m_currentTarget = (fps > 0.0f ? 1.0 / fps : 0.0);
+		if (m_currentTarget <= 0.0) { return; }
+
+		const std::chrono::steady_clock::time_point deadline{ TimeManager::GetLastUpdateTimePoint() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(m_currentTarget)) };
+		if (deadline <= now) { return; }
+
+		if (!m_idle)
+		{
+			TimeManager::WaitUntil(deadline);
+			return;
+		}
+
+		if (m_eventWaiter)
+		{
+			m_eventWaiter(std::chrono::duration<double>(deadline - now).count());
+			//Woken up well before the timeout - something happened, so go back to the full rate for a bit
+			if (std::chrono::steady_clock::now() + std::chrono::milliseconds(1) < deadline)
+			{
+				m_lastActivity = std::chrono::steady_clock::now();
+				m_idle = false;
+			}
+		}
+		else
+		{
+			TimeManager::SleepUntil(deadline);
+		}
+	}
+
+
+
+	void FramePacer::RecordFrameTime(const double _deltaTime)
+	{
+		m_frameTimes[m_frameTimeIndex] = _deltaTime;
+		m_frameTargets[m_frameTimeIndex] = (m_idle ? 0.0 : m_currentTarget);
+		m_frameTimeIndex = (m_frameTimeIndex + 1) % FRAME_HISTORY_SIZE;
+		m_frameTimeCount = std::min(m_frameTimeCount + 1, FRAME_HISTORY_SIZE);
+
+		//Recomputed from scratch - it's only a few hundred values, and running totals would drift
+		double sum{ 0.0 };
+		double max{ 0.0 };
+		std::uint32_t late{ 0 };
+		for (std::size_t i{ 0 }; i < m_frameTimeCount; ++i)
+		{
+			sum += m_frameTimes[i];
+			max = std::max(max, m_frameTimes[i]);
+			if (m_frameTargets[i] > 0.0 && m_frameTimes[i] > m_frameTargets[i] + 0.001) { ++late; }
+		}
+		m_averageFrameTime = sum / static_cast<double>(m_frameTimeCount);
+
+		double squaredDeviations{ 0.0 };
+		for (std::size_t i{ 0 }; i < m_frameTimeCount; ++i)
+		{
+			squaredDeviations += (m_frameTimes[i] - m_averageFrameTime) * (m_frameTimes[i] - m_averageFrameTime);
+		}
+		m_frameTimeStdDev = std::sqrt(squaredDeviations / static_cast<double>(m_frameTimeCount));
+		m_maxFrameTime = max;
+		m_lateFrames = late;
+	}
+
+}
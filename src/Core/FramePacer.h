@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace NK
+{
+
+	//Decides how long Engine::Run() waits before starting each frame, and keeps stats on how evenly frames are coming out
+	//With a target FPS, each frame starts 1/targetFPS after the last one - slept for most of the way and spun for the last bit (see TimeManager::WaitUntil()) so frames land on time rather than whenever the OS gets round to waking the thread
+	//While the engine is inactive (window unfocused or minimised, or the editor paused) it drops to the inactive target FPS, and waits with the event waiter if there is one so input wakes it straight away - no spinning, since nobody's watching that closely
+	//A burst of activity (anything that wakes the event waiter early) keeps it at the full rate for a moment, so e.g. moving around the editor while paused doesn't crawl along at the inactive rate
+	class FramePacer final
+	{
+	public:
+		typedef void(*EventWaiter)(double _timeoutSeconds); //Blocks until an event arrives or the timeout runs out (e.g. glfwWaitEventsTimeout)
+
+
+		explicit FramePacer(const float _targetFPS, const float _inactiveTargetFPS) : m_targetFPS(_targetFPS), m_inactiveTargetFPS(_inactiveTargetFPS) {}
+
+		//Engine - at the start of each frame, before TimeManager::Update()
+		//Blocks until the next frame is due, counting from the last TimeManager::Update()
+		void Wait();
+		//Engine - straight after TimeManager::Update(), with the frame's real delta time
+		void RecordFrameTime(double _deltaTime);
+
+		//Set every frame by whatever owns the window (see WindowLayer) - whether it's unfocused or minimised
+		inline void SetWindowInactive(const bool _inactive) { m_windowInactive = _inactive; }
+		//Set by whatever owns the window - nullptr to fall back to plain sleeping while inactive
+		inline void SetEventWaiter(const EventWaiter _eventWaiter) { m_eventWaiter = _eventWaiter; }
+
+		//Whether the last Wait() ran at the inactive rate
+		[[nodiscard]] inline bool GetIdle() const { return m_idle; }
+		[[nodiscard]] inline float GetTargetFPS() const { return m_targetFPS; }
+		inline void SetTargetFPS(const float _targetFPS) { m_targetFPS = _targetFPS; }
+		[[nodiscard]] inline float GetInactiveTargetFPS() const { return m_inactiveTargetFPS; }
+		inline void SetInactiveTargetFPS(const float _inactiveTargetFPS) { m_inactiveTargetFPS = _inactiveTargetFPS; }
+
+		//Frame time stats over the last FRAME_HISTORY_SIZE frames, in seconds
+		[[nodiscard]] inline double GetAverageFrameTime() const { return m_averageFrameTime; }
+		[[nodiscard]] inline double GetFrameTimeStdDev() const { return m_frameTimeStdDev; }
+		[[nodiscard]] inline double GetMaxFrameTime() const { return m_maxFrameTime; }
+		//Frames in the history that came out more than a millisecond later than the target
+		[[nodiscard]] inline std::uint32_t GetLateFrames() const { return m_lateFrames; }
+
+
+	private:
+		inline static constexpr std::size_t FRAME_HISTORY_SIZE{ 240 };
+		inline static constexpr double ACTIVITY_GRACE_PERIOD{ 0.5 }; //Seconds to stay at the full rate after something wakes the event waiter
+
+		float m_targetFPS; //0 = no limit
+		float m_inactiveTargetFPS; //0 = same as m_targetFPS
+
+		bool m_windowInactive{ false };
+		EventWaiter m_eventWaiter{ nullptr };
+		bool m_idle{ false };
+		double m_currentTarget{ 0.0 }; //The frame time the last Wait() waited out to
+		std::chrono::steady_clock::time_point m_lastActivity{};
+
+		std::array<double, FRAME_HISTORY_SIZE> m_frameTimes{};
+		std::array<double, FRAME_HISTORY_SIZE> m_frameTargets{}; //The frame time each frame was waited out to - 0 if it wasn't limited
+		std::size_t m_frameTimeIndex{ 0 };
+		std::size_t m_frameTimeCount{ 0 };
+		double m_averageFrameTime{ 0.0 };
+		double m_frameTimeStdDev{ 0.0 };
+		double m_maxFrameTime{ 0.0 };
+		std::uint32_t m_lateFrames{ 0 };
+	};
+
+}
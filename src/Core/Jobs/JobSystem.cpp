@@ -0,0 +1,306 @@
+#include "JobSystem.h"
+
+#include <Core/Debug/Profiler.h>
+
+#include <bit>
+#include <stdexcept>
+#include <string>
+
+
+namespace NK
+{
+
+	thread_local std::int32_t JobSystem::m_threadDequeIndex{ -1 };
+	thread_local JobSystem* JobSystem::m_threadJobSystem{ nullptr };
+
+
+	namespace
+	{
+		//Per-thread cache of free jobs - jobs are freed on whichever thread ran them, so the caches drift, but stay bounded
+		struct JobCache
+		{
+			static constexpr std::size_t MAX_SIZE{ 1024 };
+
+			~JobCache() { for (Job* job : jobs) { delete job; } }
+			std::vector<Job*> jobs;
+		};
+		thread_local JobCache jobCache;
+
+		//Number of empty FindJob() rounds before a worker goes to sleep
+		constexpr std::uint32_t SPIN_COUNT{ 64 };
+	}
+
+
+
+	JobSystem::JobSystem(ILogger& _logger, const JobSystemConfig& _config)
+	: m_logger(_logger)
+	{
+		m_logger.Indent();
+		m_logger.Log(LOGGER_CHANNEL::HEADING, LOGGER_LAYER::JOB_SYSTEM, "Initialising Job System\n");
+
+		if (_config.dequeCapacity == 0 || !std::has_single_bit(_config.dequeCapacity))
+		{
+			throw std::invalid_argument("JobSystem::JobSystem() - _config.dequeCapacity (" + std::to_string(_config.dequeCapacity) + ") must be a power of 2");
+		}
+
+		//Leave a core for the thread that created the job system - it runs jobs too, but only while waiting
+		const std::uint32_t hardwareThreads{ std::max(std::thread::hardware_concurrency(), 1u) };
+		const std::uint32_t workerCount{ _config.workerCount != 0 ? _config.workerCount : std::max(hardwareThreads - 1, 1u) };
+
+		m_deques.reserve(workerCount + 1);
+		for (std::uint32_t i{ 0 }; i < workerCount + 1; ++i)
+		{
+			m_deques.push_back(std::make_unique<WorkStealingDeque<Job>>(_config.dequeCapacity));
+		}
+
+		m_threadDequeIndex = 0;
+		m_threadJobSystem = this;
+
+		m_threads.reserve(workerCount);
+		for (std::uint32_t i{ 0 }; i < workerCount; ++i)
+		{
+			m_threads.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+		}
+
+		m_logger.IndentLog(LOGGER_CHANNEL::SUCCESS, LOGGER_LAYER::JOB_SYSTEM, "Job System Initialised - " + std::to_string(workerCount) + " worker thread(s)\n");
+		m_logger.Unindent();
+	}
+
+
+
+	JobSystem::~JobSystem()
+	{
+		m_logger.Indent();
+		m_logger.Log(LOGGER_CHANNEL::HEADING, LOGGER_LAYER::JOB_SYSTEM, "Shutting Down Job System\n");
+
+		//Run whatever is still queued so nothing is leaked and no counter is left hanging
+		while (Job* job{ FindJob() }) { Execute(job); }
+
+		m_shutdown.store(true, std::memory_order_seq_cst);
+		WakeWorkers(GetWorkerCount());
+		for (std::thread& thread : m_threads) { thread.join(); }
+
+		if (m_threadJobSystem == this)
+		{
+			m_threadDequeIndex = -1;
+			m_threadJobSystem = nullptr;
+		}
+
+		m_logger.IndentLog(LOGGER_CHANNEL::SUCCESS, LOGGER_LAYER::JOB_SYSTEM, "Job System Shut Down\n");
+		m_logger.Unindent();
+	}
+
+
+
+	void JobSystem::Wait(JobCounter& _counter)
+	{
+		std::uint32_t idleRounds{ 0 };
+		while (!_counter.IsDone())
+		{
+			if (Job* job{ FindJob() })
+			{
+				Execute(job);
+				idleRounds = 0;
+				continue;
+			}
+
+			//Nothing to help with - the jobs we're waiting on are running elsewhere
+			if (++idleRounds > SPIN_COUNT) { std::this_thread::yield(); }
+		}
+
+		const std::lock_guard lock(_counter.m_mutex);
+		if (_counter.m_exception)
+		{
+			const std::exception_ptr exception{ std::exchange(_counter.m_exception, nullptr) };
+			std::rethrow_exception(exception);
+		}
+	}
+
+
+
+	bool JobSystem::TryRunOne()
+	{
+		Job* const job{ FindJob() };
+		if (!job) { return false; }
+		Execute(job);
+		return true;
+	}
+
+
+
+	void JobSystem::Submit(Job* _job)
+	{
+		const bool ownsDeque{ m_threadJobSystem == this && m_threadDequeIndex >= 0 };
+		if (!ownsDeque || !m_deques[m_threadDequeIndex]->Push(_job))
+		{
+			const std::lock_guard lock(m_injectionMutex);
+			m_injectionQueue.push_back(_job);
+			m_injectionCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		WakeWorkers(1);
+	}
+
+
+
+	void JobSystem::Execute(Job* _job)
+	{
+		JobCounter* const counter{ _job->counter };
+
+		try
+		{
+			_job->invoke(*_job);
+		}
+		catch (...)
+		{
+			if (counter)
+			{
+				const std::lock_guard lock(counter->m_mutex);
+				if (!counter->m_exception) { counter->m_exception = std::current_exception(); }
+			}
+			else
+			{
+				try { throw; }
+				catch (const std::exception& _e) { m_logger.IndentLog(LOGGER_CHANNEL::ERROR, LOGGER_LAYER::JOB_SYSTEM, "Uncaught exception in fire-and-forget job - " + std::string(_e.what()) + "\n"); }
+				catch (...) { m_logger.IndentLog(LOGGER_CHANNEL::ERROR, LOGGER_LAYER::JOB_SYSTEM, "Uncaught non-std::exception in fire-and-forget job\n"); }
+			}
+		}
+
+		_job->destroy(*_job);
+		FreeJob(_job);
+
+		if (!counter) { return; }
+
+		//Last job on the counter releases everything waiting on it
+		//The mutex pairs with RunAfter() - either it sees the counter isn't done and adds its continuation before we take it, or it sees 0 and submits the job itself
+		//Wait() can't return (and the counter can't go out of scope) until m_active hits 0, so every job's decrement of it has to be the last thing it does to the counter
+		//A separate count rather than a flag the last job sets - a flag could still be set from an earlier time m_pending hit 0, while a newer job is still using the counter
+		std::vector<Job*> continuations;
+		if (counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			const std::lock_guard lock(counter->m_mutex);
+			continuations.swap(counter->m_continuations);
+		}
+		counter->m_active.fetch_sub(1, std::memory_order_release);
+		for (Job* continuation : continuations) { Submit(continuation); }
+	}
+
+
+
+	Job* JobSystem::FindJob()
+	{
+		const bool ownsDeque{ m_threadJobSystem == this && m_threadDequeIndex >= 0 };
+		const std::size_t ownIndex{ ownsDeque ? static_cast<std::size_t>(m_threadDequeIndex) : 0 };
+
+		if (ownsDeque)
+		{
+			if (Job* job{ m_deques[ownIndex]->Pop() }) { return job; }
+		}
+
+		if (m_injectionCount.load(std::memory_order_relaxed) != 0)
+		{
+			const std::lock_guard lock(m_injectionMutex);
+			if (!m_injectionQueue.empty())
+			{
+				Job* const job{ m_injectionQueue.front() };
+				m_injectionQueue.pop_front();
+				m_injectionCount.fetch_sub(1, std::memory_order_relaxed);
+				return job;
+			}
+		}
+
+		//Start at the next deque along so thieves spread out rather than all hammering deque 0
+		const std::size_t dequeCount{ m_deques.size() };
+		for (std::size_t i{ 1 }; i <= dequeCount; ++i)
+		{
+			const std::size_t victim{ (ownIndex + i) % dequeCount };
+			if (ownsDeque && victim == ownIndex) { continue; }
+			if (Job* job{ m_deques[victim]->Steal() }) { return job; }
+		}
+
+		return nullptr;
+	}
+
+
+
+	bool JobSystem::HasWork() const
+	{
+		if (m_injectionCount.load(std::memory_order_relaxed) != 0) { return true; }
+		for (const std::unique_ptr<WorkStealingDeque<Job>>& deque : m_deques)
+		{
+			if (!deque->Empty()) { return true; }
+		}
+		return false;
+	}
+
+
+
+	void JobSystem::WorkerLoop(const std::uint32_t _index)
+	{
+		m_threadDequeIndex = static_cast<std::int32_t>(_index);
+		m_threadJobSystem = this;
+		Profiler::SetThreadName("Job Worker " + std::to_string(_index));
+
+		std::uint32_t idleRounds{ 0 };
+		while (true)
+		{
+			if (Job* job{ FindJob() })
+			{
+				Execute(job);
+				idleRounds = 0;
+				continue;
+			}
+
+			if (m_shutdown.load(std::memory_order_acquire)) { break; }
+
+			if (++idleRounds < SPIN_COUNT)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			//Go to sleep until there's more work
+			//Pairs with the fence in WakeWorkers() - either the submitter sees us in m_sleepingCount, or we see its job in HasWork()
+			const std::uint32_t wakeCount{ m_wakeCounter.load(std::memory_order_acquire) };
+			m_sleepingCount.fetch_add(1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!HasWork() && !m_shutdown.load(std::memory_order_acquire))
+			{
+				m_wakeCounter.wait(wakeCount, std::memory_order_acquire);
+			}
+			m_sleepingCount.fetch_sub(1, std::memory_order_relaxed);
+			idleRounds = 0;
+		}
+	}
+
+
+
+	void JobSystem::WakeWorkers(const std::uint32_t _count)
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_sleepingCount.load(std::memory_order_relaxed) == 0) { return; }
+
+		m_wakeCounter.fetch_add(1, std::memory_order_release);
+		if (_count == 1) { m_wakeCounter.notify_one(); }
+		else { m_wakeCounter.notify_all(); }
+	}
+
+
+
+	Job* JobSystem::AllocateJob()
+	{
+		if (jobCache.jobs.empty()) { return new Job; }
+		Job* const job{ jobCache.jobs.back() };
+		jobCache.jobs.pop_back();
+		return job;
+	}
+
+
+
+	void JobSystem::FreeJob(Job* _job)
+	{
+		if (jobCache.jobs.size() < JobCache::MAX_SIZE) { jobCache.jobs.push_back(_job); }
+		else { delete _job; }
+	}
+
+}
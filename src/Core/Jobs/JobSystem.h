@@ -0,0 +1,248 @@
+#pragma once
+
+#include "WorkStealingDeque.h"
+
+#include <Core/Debug/ILogger.h>
+#include <Types/NekiTypes.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace NK
+{
+
+	class JobSystem;
+	struct Job;
+
+
+	//Tracks a group of jobs - JobSystem::Wait() returns once every job run against the counter has finished
+	//A counter can also gate other jobs (JobSystem::RunAfter()), which is how dependencies are expressed
+	//Counters can be reused once they've been waited on, but must outlive every job run against them
+	class JobCounter final
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		//Goes off m_active rather than m_pending, as the last job still touches the counter after taking m_pending to 0 - the counter can't be destroyed until it's finished with it
+		[[nodiscard]] inline bool IsDone() const { return m_active.load(std::memory_order_acquire) == 0; }
+
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<std::uint32_t> m_pending{ 0 };
+		std::atomic<std::uint32_t> m_active{ 0 }; //Same as m_pending, but each job only decrements it as the very last thing it does to the counter (see JobSystem::Execute())
+
+		//Only touched when a job is made dependent on this counter, or the counter hits 0 - not on the common path
+		std::mutex m_mutex;
+		std::vector<Job*> m_continuations; //Jobs waiting on this counter to hit 0
+		std::exception_ptr m_exception; //First exception thrown by a job run against this counter, rethrown by JobSystem::Wait()
+	};
+
+
+	//A type-erased unit of work - small callables are stored inline, bigger ones on the heap
+	struct Job
+	{
+		static constexpr std::size_t STORAGE_SIZE{ 48 };
+
+		void (*invoke)(Job& _job);
+		void (*destroy)(Job& _job);
+		JobCounter* counter;
+		alignas(std::max_align_t) std::byte storage[STORAGE_SIZE];
+	};
+
+
+	//Engine-wide job system owned by Context
+	//Each worker thread has its own work-stealing deque - jobs run from a worker (or the thread that created the job system) go on that thread's deque, everything else goes through a shared injection queue
+	//Idle workers steal from each other before going to sleep
+	//Threads waiting on a counter run other jobs while they wait rather than blocking
+	class JobSystem final
+	{
+	public:
+		explicit JobSystem(ILogger& _logger, const JobSystemConfig& _config);
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+
+		//Run _func on any thread, incrementing _counter until it has finished
+		template<typename Func>
+		inline void Run(JobCounter& _counter, Func&& _func)
+		{
+			AddPending(_counter);
+			Submit(CreateJob(&_counter, std::forward<Func>(_func)));
+		}
+
+		//Fire-and-forget version of Run() - exceptions thrown by _func are logged and otherwise ignored
+		template<typename Func>
+		inline void Run(Func&& _func)
+		{
+			Submit(CreateJob(nullptr, std::forward<Func>(_func)));
+		}
+
+		//Same as Run(), but _func doesn't start until every job run against _dependency has finished
+		//_counter counts the job from now, so waiting on it also waits for _dependency
+		template<typename Func>
+		inline void RunAfter(JobCounter& _dependency, JobCounter& _counter, Func&& _func)
+		{
+			AddPending(_counter);
+			Job* const job{ CreateJob(&_counter, std::forward<Func>(_func)) };
+
+			//Checked under the dependency's mutex so this can't race with the last of its jobs finishing (see Execute())
+			//m_pending rather than IsDone() - once it's 0 the last job has taken (or is about to take) the continuations, so anything added now would never be submitted
+			{
+				const std::lock_guard lock(_dependency.m_mutex);
+				if (_dependency.m_pending.load(std::memory_order_acquire) != 0)
+				{
+					_dependency.m_continuations.push_back(job);
+					return;
+				}
+			}
+			Submit(job);
+		}
+
+		//Calls _func(i) for every i in [0, _count), split into chunks of _grainSize run across the workers (0 picks a chunk size automatically)
+		//The calling thread runs the first chunk itself and then helps out until everything has finished
+		template<typename Func>
+		void ParallelFor(std::size_t _count, std::size_t _grainSize, Func&& _func);
+
+		//Run other jobs until every job run against _counter has finished
+		//Rethrows the first exception thrown by any of them
+		void Wait(JobCounter& _counter);
+
+		//Run a single pending job on the calling thread - returns false if there wasn't one
+		//For threads that are waiting on something other than a JobCounter but still want to help out in the meantime
+		bool TryRunOne();
+
+		//Number of background worker threads - doesn't include the thread that created the job system, which also runs jobs while it's waiting
+		[[nodiscard]] inline std::uint32_t GetWorkerCount() const { return static_cast<std::uint32_t>(m_threads.size()); }
+
+
+	private:
+		static inline void AddPending(JobCounter& _counter)
+		{
+			_counter.m_active.fetch_add(1, std::memory_order_relaxed);
+			_counter.m_pending.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		template<typename Func>
+		[[nodiscard]] Job* CreateJob(JobCounter* _counter, Func&& _func);
+
+		void Submit(Job* _job);
+		void Execute(Job* _job);
+
+		//Own deque, then the injection queue, then steal - nullptr if there's nothing anywhere
+		[[nodiscard]] Job* FindJob();
+		[[nodiscard]] bool HasWork() const;
+
+		void WorkerLoop(std::uint32_t _index);
+		void WakeWorkers(std::uint32_t _count);
+
+		//Jobs are recycled through a small per-thread cache rather than going back to the allocator every time
+		[[nodiscard]] static Job* AllocateJob();
+		static void FreeJob(Job* _job);
+
+
+		ILogger& m_logger;
+
+		//Index 0 belongs to the thread that created the job system, 1..n to the worker threads
+		std::vector<std::unique_ptr<WorkStealingDeque<Job>>> m_deques;
+		std::vector<std::thread> m_threads;
+
+		//Jobs submitted from threads that don't own a deque (or whose deque is full)
+		std::mutex m_injectionMutex;
+		std::deque<Job*> m_injectionQueue;
+		std::atomic<std::size_t> m_injectionCount{ 0 };
+
+		//Idle workers sleep on m_wakeCounter - submitters only bump and notify it when m_sleepingCount says someone is asleep
+		std::atomic<std::uint32_t> m_wakeCounter{ 0 };
+		std::atomic<std::uint32_t> m_sleepingCount{ 0 };
+		std::atomic<bool> m_shutdown{ false };
+
+		//Which deque the current thread owns (-1 if none), and which job system it belongs to
+		static thread_local std::int32_t m_threadDequeIndex;
+		static thread_local JobSystem* m_threadJobSystem;
+	};
+
+
+
+	template<typename Func>
+	Job* JobSystem::CreateJob(JobCounter* _counter, Func&& _func)
+	{
+		using Callable = std::decay_t<Func>;
+
+		Job* const job{ AllocateJob() };
+		job->counter = _counter;
+
+		if constexpr (sizeof(Callable) <= Job::STORAGE_SIZE && alignof(Callable) <= alignof(std::max_align_t))
+		{
+			::new (static_cast<void*>(job->storage)) Callable(std::forward<Func>(_func));
+			job->invoke = [](Job& _job) { (*std::launder(reinterpret_cast<Callable*>(_job.storage)))(); };
+			job->destroy = [](Job& _job) { std::launder(reinterpret_cast<Callable*>(_job.storage))->~Callable(); };
+		}
+		else
+		{
+			Callable* const callable{ new Callable(std::forward<Func>(_func)) };
+			std::memcpy(job->storage, &callable, sizeof(callable));
+			job->invoke = [](Job& _job) { Callable* callable; std::memcpy(&callable, _job.storage, sizeof(callable)); (*callable)(); };
+			job->destroy = [](Job& _job) { Callable* callable; std::memcpy(&callable, _job.storage, sizeof(callable)); delete callable; };
+		}
+
+		return job;
+	}
+
+
+
+	template<typename Func>
+	void JobSystem::ParallelFor(const std::size_t _count, std::size_t _grainSize, Func&& _func)
+	{
+		if (_count == 0) { return; }
+
+		//Aim for a few chunks per thread so stealing can even out uneven work
+		if (_grainSize == 0) { _grainSize = std::max<std::size_t>(1, _count / ((GetWorkerCount() + 1) * 4)); }
+		if (_count <= _grainSize)
+		{
+			for (std::size_t i{ 0 }; i < _count; ++i) { _func(i); }
+			return;
+		}
+
+		JobCounter counter;
+		for (std::size_t begin{ _grainSize }; begin < _count; begin += _grainSize)
+		{
+			const std::size_t end{ std::min(begin + _grainSize, _count) };
+			Run(counter, [&_func, begin, end]()
+			{
+				for (std::size_t i{ begin }; i < end; ++i) { _func(i); }
+			});
+		}
+
+		//The other chunks reference _func and counter, so they have to finish before this returns - even if the first chunk throws
+		try
+		{
+			for (std::size_t i{ 0 }; i < _grainSize; ++i) { _func(i); }
+		}
+		catch (...)
+		{
+			try { Wait(counter); } catch (...) {}
+			throw;
+		}
+		Wait(counter);
+	}
+
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+
+namespace NK
+{
+
+	//Fixed-capacity Chase-Lev deque (the C11 version from Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models")
+	//The owning thread pushes and pops at the bottom (LIFO, so it stays on cache-warm work), any other thread can steal from the top (FIFO, so thieves take the oldest and usually biggest work)
+	template<typename T>
+	class WorkStealingDeque final
+	{
+	public:
+		//_capacity must be a power of 2
+		explicit WorkStealingDeque(const std::uint32_t _capacity)
+		: m_capacity(_capacity), m_mask(_capacity - 1), m_buffer(std::make_unique<std::atomic<T*>[]>(_capacity)) {}
+
+		WorkStealingDeque(const WorkStealingDeque&) = delete;
+		WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+
+		//Owner only - returns false if the deque is full
+		bool Push(T* _item)
+		{
+			const std::int64_t bottom{ m_bottom.load(std::memory_order_relaxed) };
+			const std::int64_t top{ m_top.load(std::memory_order_acquire) };
+			if (bottom - top >= static_cast<std::int64_t>(m_capacity)) { return false; }
+
+			m_buffer[bottom & m_mask].store(_item, std::memory_order_relaxed);
+			m_bottom.store(bottom + 1, std::memory_order_release); //Publishes the item (and whatever it points to) to thieves
+			return true;
+		}
+
+
+		//Owner only - returns nullptr if the deque is empty (or a thief took the last item)
+		T* Pop()
+		{
+			const std::int64_t bottom{ m_bottom.load(std::memory_order_relaxed) - 1 };
+			m_bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			std::int64_t top{ m_top.load(std::memory_order_relaxed) };
+
+			if (top > bottom)
+			{
+				//Empty
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			T* item{ m_buffer[bottom & m_mask].load(std::memory_order_relaxed) };
+			if (top == bottom)
+			{
+				//Last item - race any thieves for it
+				if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) { item = nullptr; }
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+			return item;
+		}
+
+
+		//Any thread - returns nullptr if the deque is empty or another thread got there first
+		T* Steal()
+		{
+			std::int64_t top{ m_top.load(std::memory_order_acquire) };
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const std::int64_t bottom{ m_bottom.load(std::memory_order_acquire) };
+			if (top >= bottom) { return nullptr; }
+
+			T* item{ m_buffer[top & m_mask].load(std::memory_order_relaxed) };
+			if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) { return nullptr; }
+			return item;
+		}
+
+
+		//Approximate - only used to decide whether it's worth a worker going to sleep
+		[[nodiscard]] bool Empty() const
+		{
+			return m_top.load(std::memory_order_acquire) >= m_bottom.load(std::memory_order_acquire);
+		}
+
+
+	private:
+		const std::uint32_t m_capacity;
+		const std::uint32_t m_mask;
+		std::unique_ptr<std::atomic<T*>[]> m_buffer;
+
+		alignas(64) std::atomic<std::int64_t> m_top{ 0 };
+		alignas(64) std::atomic<std::int64_t> m_bottom{ 0 };
+	};
+
+}
@@ -3,21 +3,28 @@
 #include <Components/CInput.h>
 #include <Components/CNetworkSync.h>
 #include <Components/CTransform.h>
+#include <Core/Debug/Profiler.h>
+#include <Core/Replay/Replay.h>
 #include <Core/Utils/Timer.h>
-
-#include <queue>
-#include <cereal/archives/binary.hpp>
+#include <Managers/EventManager.h>
+#include <Managers/TimeManager.h>
+#include <Networking/NetworkInputCodec.h>
+#include <Networking/PacketHeader.h>
 
 
 namespace NK
 {
 
 	ClientNetworkLayer::ClientNetworkLayer(Registry& _reg, const ClientNetworkLayerDesc& _desc)
-	: ILayer(_reg), m_desc(_desc), m_state(CLIENT_STATE::DISCONNECTED)
+	: ILayer(_reg), m_desc(_desc), m_state(CLIENT_STATE::DISCONNECTED), m_lastAppliedSnapshot(NetworkTransformCodec::NO_SNAPSHOT),
+	  m_reassembler(m_desc.maxReassembledPacketSize, m_desc.maxPendingReassemblies, m_desc.reassemblyTimeout), m_connection(m_desc.connection), m_networkEventHandler(nullptr)
 	{
 		m_logger.Indent();
 		m_logger.Log(LOGGER_CHANNEL::HEADING, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Initialising Client Network Layer\n");
 		
+		NetworkTransformCodec::ValidateQuantisation(m_desc.transformQuantisation);
+		for (NetworkTransformSnapshot& snapshot : m_transformSnapshots) { snapshot.sequence = NetworkTransformCodec::NO_SNAPSHOT; }
+		
 		m_logger.Unindent();
 	}
 
@@ -59,6 +66,21 @@ namespace NK
 			m_logger.IndentLog(LOGGER_CHANNEL::ERROR, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Connect() called on a ClientNetworkLayer whose m_state != CLIENT_STATE::DISCONNECTED - m_state = " + std::to_string(std::to_underlying(m_state)));
 			throw std::runtime_error("");
 		}
+
+		//A new server numbers its snapshots from 0 again
+		for (NetworkTransformSnapshot& snapshot : m_transformSnapshots) { snapshot.sequence = NetworkTransformCodec::NO_SNAPSHOT; }
+		m_lastAppliedSnapshot = NetworkTransformCodec::NO_SNAPSHOT;
+		m_reassembler.Clear();
+		m_connection = NetworkConnection{ m_desc.connection }; //Like the server's end of it
+		
+		if (Replay::IsPlaying())
+		{
+			//Everything the server sent is coming from the recording instead
+			m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Replay is being played back - not connecting, server packets will come from the recording\n");
+			m_state = CLIENT_STATE::CONNECTED;
+			m_logger.Unindent();
+			return NETWORK_LAYER_ERROR_CODE::SUCCESS;
+		}
 		
 		m_serverAddress = sf::IpAddress::resolve(_ip);
 		if (!m_serverAddress.has_value())
@@ -154,6 +176,14 @@ namespace NK
 		}
 
 
+		if (Replay::IsPlaying())
+		{
+			m_state = CLIENT_STATE::DISCONNECTED;
+			m_logger.Unindent();
+			return NETWORK_LAYER_ERROR_CODE::SUCCESS;
+		}
+
+
 		m_state = CLIENT_STATE::DISCONNECTING;
 		m_tcpSocket.setBlocking(true);
 		sf::Packet outgoingPacket;
@@ -176,58 +206,72 @@ namespace NK
 
 	void ClientNetworkLayer::PreAppUpdate()
 	{
-		//Serialise all CInputs and send them to the server over UDP
-		std::queue<NetworkInputData> inputComponents;
-		for (auto&& [input] : m_reg.get().View<CInput>())
-		{
-			NetworkInputData data{};
-			data.entity = m_reg.get().GetEntity(input);
-			data.actionStates = input.actionStates;
-			inputComponents.push(data);
-		}
-		if (inputComponents.empty())
-		{
-			m_logger.IndentLog(LOGGER_CHANNEL::WARNING, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "No `CInput`s found in registry\n");
-			return;
-		}
-		std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+		//Not connected to anything during playback
+		if (Replay::IsPlaying()) { return; }
+		
+		//Bit-pack all CInputs and send them to the server over UDP - with any channel messages in front
+		NetworkBufferPool::Buffer inputBuffer{ m_bufferPool.Acquire() };
+		std::vector<std::uint8_t>& input{ inputBuffer.Get() };
+		PacketHeader::Write(input, PACKET_CODE::INPUT);
+		if (NetworkInputCodec::Encode(m_reg.get(), input) == 0)
 		{
-			cereal::BinaryOutputArchive archive(ss);
-			archive(inputComponents);
+			NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "No `CInput`s found in registry\n");
+			input.clear();
 		}
-		sf::Packet outgoingPacket;
-		outgoingPacket << std::to_underlying(PACKET_CODE::INPUT);
-		outgoingPacket.append(ss.str().c_str(), ss.str().size());
-		if (m_udpSocket.send(outgoingPacket, m_serverAddress.value(), m_serverPort) == sf::Socket::Status::Error)
+
+		const double time{ TimeManager::GetTotalTime() };
+		if (input.empty() && !m_connection.NeedsPacket(time)) { return; }
+		NetworkBufferPool::Buffer buffer{ m_bufferPool.Acquire() };
+		std::vector<std::uint8_t>& bytes{ buffer.Get() };
+		PacketHeader::Write(bytes, PACKET_CODE::MESSAGES);
+		m_connection.Write(bytes, time, m_desc.maxMessageBytesPerPacket);
+		bytes.insert(bytes.end(), input.begin(), input.end());
+		if (m_udpSocket.send(bytes.data(), bytes.size(), m_serverAddress.value(), m_serverPort) == sf::Socket::Status::Error)
 		{
 			m_logger.IndentLog(LOGGER_CHANNEL::ERROR, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Failed to send UDP packet to server\n");
 		}
+	}
 
 
-		//Send all enqueued event packets to the server over TCP
-		while (!m_tcpEventQueue.empty())
+
+	void ClientNetworkLayer::PostAppUpdate()
+	{
+		NK_PROFILE_SCOPE("ClientNetworkLayer - Receive");
+
+		//Gather packets - from the sockets, or from the recording when a replay is being played back
+		std::vector<std::pair<ClientIndex, sf::Packet>> tcpPackets;
+		std::vector<std::pair<ClientIndex, sf::Packet>> udpPackets;
+		if (Replay::IsPlaying())
+		{
+			tcpPackets = Replay::GetPackets(REPLAY_PACKET_CHANNEL::CLIENT_TCP);
+			udpPackets = Replay::GetPackets(REPLAY_PACKET_CHANNEL::CLIENT_UDP);
+		}
+		else
 		{
-			sf::Packet packet{ std::move(m_tcpEventQueue.front()) };
-			if (m_tcpSocket.send(outgoingPacket) == sf::Socket::Status::Error)
+			sf::Packet incomingData;
+			m_tcpSocket.setBlocking(false);
+			while (m_tcpSocket.receive(incomingData) == sf::Socket::Status::Done)
 			{
-				m_logger.IndentLog(LOGGER_CHANNEL::ERROR, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Failed to send TCP event packet to server\n");
+				Replay::RecordPacket(REPLAY_PACKET_CHANNEL::CLIENT_TCP, 0, incomingData);
+				tcpPackets.emplace_back(0, incomingData);
 			}
 
-			m_tcpEventQueue.pop();
+			std::optional<sf::IpAddress> incomingClientIP;
+			unsigned short incomingClientPort;
+			m_udpSocket.setBlocking(false);
+			while (m_udpSocket.receive(incomingData, incomingClientIP, incomingClientPort) == sf::Socket::Status::Done)
+			{
+				if ((incomingClientIP != m_serverAddress) || (incomingClientPort != m_serverPort)) { continue; }
+				Replay::RecordPacket(REPLAY_PACKET_CHANNEL::CLIENT_UDP, 0, incomingData);
+				udpPackets.emplace_back(0, incomingData);
+			}
 		}
-	}
-
-
-
-	void ClientNetworkLayer::PostAppUpdate()
-	{
-		sf::Packet incomingData;
 		
 		
 		//TCP
-		m_tcpSocket.setBlocking(false);
-		while (m_tcpSocket.receive(incomingData) == sf::Socket::Status::Done)
+		for (std::pair<ClientIndex, sf::Packet>& tcpPacket : tcpPackets)
 		{
+			sf::Packet& incomingData{ tcpPacket.second };
 			std::underlying_type_t<PACKET_CODE> codeValue;
 			incomingData >> codeValue;
 			const PACKET_CODE code{ static_cast<PACKET_CODE>(codeValue) };
@@ -235,53 +279,198 @@ namespace NK
 			{
 			case PACKET_CODE::ENTITY_SPAWN:
 			{
-				
+				break;
+			}
+			default:
+			{
+				NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Server sent invalid TCP packet code - code = " + std::to_string(codeValue) + "\n");
+				break;
 			}
 			}
 		}
 		
 		
-		//UDP
-		std::optional<sf::IpAddress> incomingClientIP;
-		unsigned short incomingClientPort;
-		m_udpSocket.setBlocking(false);
-		while (m_udpSocket.receive(incomingData, incomingClientIP, incomingClientPort) == sf::Socket::Status::Done)
+		//UDP - fragments are recorded as they came in and put back together here, so playback goes through the same path
+		for (std::pair<ClientIndex, sf::Packet>& udpPacket : udpPackets)
 		{
-			if ((incomingClientIP != m_serverAddress) || (incomingClientPort != m_serverPort)) { continue; }
-			std::underlying_type_t<PACKET_CODE> codeValue;
-			incomingData >> codeValue;
-			const PACKET_CODE code{ static_cast<PACKET_CODE>(codeValue) };
-			switch (code)
+			ProcessUDPPacket(udpPacket.second, false, false);
+		}
+	}
+
+
+
+	void ClientNetworkLayer::ProcessUDPPacket(sf::Packet& _packet, const bool _reassembled, const bool _inMessages)
+	{
+		std::underlying_type_t<PACKET_CODE> codeValue;
+		_packet >> codeValue;
+		const PACKET_CODE code{ static_cast<PACKET_CODE>(codeValue) };
+		switch (code)
+		{
+		case PACKET_CODE::TRANSFORM:
+		{
+			DecodeAndApplyTransforms(_packet);
+			break;
+		}
+		case PACKET_CODE::FRAGMENT:
+		{
+			if (_reassembled)
 			{
-			case PACKET_CODE::TRANSFORM:
+				NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Reassembled packet is itself a fragment - dropping it\n");
+				break;
+			}
+			const std::size_t readPosition{ _packet.getReadPosition() };
+			if (!m_reassembler.Add(static_cast<const std::uint8_t*>(_packet.getData()) + readPosition, _packet.getDataSize() - readPosition, TimeManager::GetTotalTime(), m_reassembled)) { break; }
+
+			//m_reassembledPacket's only ever touched from here, and the nested call can't get back in (see above)
+			m_reassembledPacket.clear();
+			m_reassembledPacket.append(m_reassembled.data(), m_reassembled.size());
+			ProcessUDPPacket(m_reassembledPacket, true, _inMessages);
+			break;
+		}
+		case PACKET_CODE::MESSAGES:
+		{
+			if (_inMessages)
 			{
-				//Deserialise all CTransforms and apply them
-				std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
-				ss.write(static_cast<const char*>(incomingData.getData()) + incomingData.getReadPosition(), incomingData.getDataSize());
-				std::queue<NetworkTransformData> transformData;
-				{
-					cereal::BinaryInputArchive archive(ss);
-					archive(transformData);
-				}
+				NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Messages packet is inside another - dropping it\n");
+				break;
+			}
+			const std::uint8_t* data{ static_cast<const std::uint8_t*>(_packet.getData()) + _packet.getReadPosition() };
+			const std::size_t size{ _packet.getDataSize() - _packet.getReadPosition() };
+			const std::size_t messagesSize{ m_connection.Read(data, size, TimeManager::GetTotalTime()) };
+			if (!messagesSize)
+			{
+				NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Received a malformed messages packet - dropping it\n");
+				break;
+			}
+			m_connection.PopReceived([&](const NETWORK_CHANNEL, const std::uint8_t* _data, const std::size_t _size) { ProcessMessage(_data, _size); });
+
+			//Then whatever it's carrying
+			if (messagesSize == size) { break; }
+			m_innerPacket.clear();
+			m_innerPacket.append(data + messagesSize, size - messagesSize);
+			ProcessUDPPacket(m_innerPacket, _reassembled, true);
+			break;
+		}
+		default:
+		{
+			NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Server sent invalid packet code - code = " + std::to_string(codeValue) + "\n");
+			break;
+		}
+		}
+	}
+
+
 
-				while (!transformData.empty())
+	void ClientNetworkLayer::ProcessMessage(const std::uint8_t* _data, const std::size_t _size)
+	{
+		m_messagePacket.clear();
+		m_messagePacket.append(_data, _size);
+		std::underlying_type_t<PACKET_CODE> codeValue;
+		m_messagePacket >> codeValue;
+		switch (static_cast<PACKET_CODE>(codeValue))
+		{
+		case PACKET_CODE::EVENT:
+		{
+			if (!m_networkEventHandler)
+			{
+				NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Received an event with no NetworkEventHandler set (see SetNetworkEventHandler()) - ignoring it\n");
+				break;
+			}
+			m_networkEventHandler->HandleEvent(m_messagePacket);
+			break;
+		}
+		case PACKET_CODE::RELEVANCY:
+		{
+			//Entities that have come into range, then ones that have gone out of it
+			for (const bool relevant : { true, false })
+			{
+				std::uint32_t count{ 0 };
+				m_messagePacket >> count;
+				for (std::uint32_t i{ 0 }; i < count && m_messagePacket; ++i)
 				{
-					const NetworkTransformData& data{ transformData.back() };
-					CTransform& trans{ m_reg.get().GetComponent<CTransform>(data.entity) };
-					trans.SetLocalPosition(data.pos);
-					trans.SetLocalRotation(data.rot);
-					trans.SetLocalScale(data.scale);
-					transformData.pop();
+					Entity entity;
+					if (m_messagePacket >> entity) { EventManager::Trigger(NetworkRelevancyEvent{ entity, relevant }); }
 				}
-				break;
 			}
-			default:
+			if (!m_messagePacket)
 			{
-				m_logger.IndentLog(LOGGER_CHANNEL::WARNING, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Server sent invalid packet code - code = " + std::to_string(codeValue) + "\n");
-				break;
+				NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Received a malformed relevancy message\n");
 			}
+			break;
+		}
+		default:
+		{
+			NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Server sent invalid message code - code = " + std::to_string(codeValue) + "\n");
+			break;
+		}
+		}
+	}
+
+
+
+	bool ClientNetworkLayer::QueueMessage(const NETWORK_CHANNEL _channel, const sf::Packet& _packet)
+	{
+		if (!m_connection.Send(_channel, static_cast<const std::uint8_t*>(_packet.getData()), _packet.getDataSize()))
+		{
+			m_logger.IndentLog(LOGGER_CHANNEL::ERROR, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Failed to queue a " + std::to_string(_packet.getDataSize()) + " byte message for the server - too big, or too many reliable messages waiting on acks\n");
+			return false;
+		}
+		return true;
+	}
+
+
+
+	void ClientNetworkLayer::DecodeAndApplyTransforms(const sf::Packet& _packet)
+	{
+		BitReader reader{ static_cast<const std::uint8_t*>(_packet.getData()) + _packet.getReadPosition(), _packet.getDataSize() - _packet.getReadPosition() };
+		std::uint32_t sequence;
+		std::uint32_t baselineSequence;
+		NetworkTransformCodec::DecodeHeader(reader, sequence, baselineSequence);
+		if (reader.HasOverrun())
+		{
+			NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Received a malformed transform snapshot - dropping it\n");
+			return;
+		}
+
+		//UDP doesn't keep things in order - anything older than what's already been applied is out of date
+		//(Sequence numbers would wrap after 2^32 snapshots - over two years at 60Hz)
+		if (m_lastAppliedSnapshot != NetworkTransformCodec::NO_SNAPSHOT && sequence <= m_lastAppliedSnapshot) { return; }
+
+		const std::vector<QuantisedTransform> noBaseline;
+		const NetworkTransformSnapshot* baseline{ nullptr };
+		if (baselineSequence != NetworkTransformCodec::NO_SNAPSHOT)
+		{
+			baseline = &m_transformSnapshots[baselineSequence % NetworkTransformCodec::SNAPSHOT_HISTORY_SIZE];
+			if (baseline->sequence != baselineSequence)
+			{
+				NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Received a transform snapshot relative to snapshot " + std::to_string(baselineSequence) + ", which is no longer held - dropping it\n");
+				return;
 			}
 		}
+
+		if (!NetworkTransformCodec::Decode(reader, baseline ? baseline->states : noBaseline, m_desc.transformQuantisation, m_decodedTransforms))
+		{
+			NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Received a malformed transform snapshot - dropping it\n");
+			return;
+		}
+
+		//Only touch the transforms that differ from what was last applied
+		const NetworkTransformSnapshot& previous{ m_transformSnapshots[m_lastAppliedSnapshot % NetworkTransformCodec::SNAPSHOT_HISTORY_SIZE] };
+		NetworkTransformCodec::Apply(m_decodedTransforms, (m_lastAppliedSnapshot != NetworkTransformCodec::NO_SNAPSHOT && previous.sequence == m_lastAppliedSnapshot) ? previous.states : noBaseline, m_desc.transformQuantisation, m_reg.get());
+
+		NetworkTransformSnapshot& snapshot{ m_transformSnapshots[sequence % NetworkTransformCodec::SNAPSHOT_HISTORY_SIZE] };
+		snapshot.sequence = sequence;
+		std::swap(snapshot.states, m_decodedTransforms);
+		m_lastAppliedSnapshot = sequence;
+
+		//Let the server know it can encode against this one from now on - during playback the server isn't there, and the deltas are already in the recording
+		if (Replay::IsPlaying()) { return; }
+		sf::Packet ackPacket;
+		ackPacket << std::to_underlying(PACKET_CODE::SNAPSHOT_ACK) << sequence;
+		if (m_udpSocket.send(ackPacket, m_serverAddress.value(), m_serverPort) == sf::Socket::Status::Error)
+		{
+			m_logger.IndentLog(LOGGER_CHANNEL::ERROR, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Failed to send snapshot ack to server\n");
+		}
 	}
 
 }
@@ -2,11 +2,19 @@
 
 #include "ILayer.h"
 
+#include <Components/CNetworkEvent.h>
 #include <Core/Utils/Serialisation/TypeRegistry.h>
 #include <Core-ECS/Registry.h>
+#include <Networking/NetworkBufferPool.h>
+#include <Networking/NetworkConnection.h>
+#include <Networking/NetworkEventHandler.h>
+#include <Networking/NetworkTransformCodec.h>
+#include <Networking/PacketReassembler.h>
 #include <SFML/Network.hpp>
 #include <Types/NekiTypes.h>
 
+#include <array>
+
 
 namespace NK
 {
@@ -20,6 +28,16 @@ namespace NK
 
 		double serverConnectTimeout{ 5.0 }; //Time in seconds the client is allowed to spend trying to connect to the server before timing out
 		double serverClientIndexPacketTimeout{ 5.0 }; //Time in seconds the client is allowed to spend waiting to receive their client index packet from the server
+		NetworkTransformQuantisation transformQuantisation{}; //Must match the server's ServerNetworkLayerDesc::transformQuantisation
+
+		//Putting fragmented UDP packets back together (see ServerNetworkLayerDesc::maxDatagramSize) - bounded so a misbehaving server can't make the client hold on to unlimited memory
+		std::uint32_t maxReassembledPacketSize{ 1u << 20 }; //Bytes - fragments claiming to be part of anything bigger are thrown away
+		std::uint32_t maxPendingReassemblies{ 4 }; //Packets that can be part-way through at once - starting another gives up on the oldest
+		double reassemblyTimeout{ 1.0 }; //Seconds a packet can be missing pieces for before it's given up on
+
+		//Channel messages (events) go over UDP in front of the input packets - see NetworkConnection
+		NetworkConnectionConfig connection{};
+		std::uint32_t maxMessageBytesPerPacket{ 1024 }; //More than this waits for the next tick - the server doesn't put packets back together, keep input plus this under the MTU
 	};
 	
 	
@@ -30,13 +48,26 @@ namespace NK
 		virtual ~ClientNetworkLayer() override;
 
 		virtual void Update() override;
+		//Only has an Update() - left exclusive in there
+		[[nodiscard]] inline virtual LayerAccess GetAccess(const LAYER_PHASE _phase) const override { return (IsFixedUpdatePhase(_phase) ? LayerAccess{} : LayerAccess::Exclusive()); }
+		[[nodiscard]] inline virtual const char* GetName() const override { return "Client Network Layer"; }
 		NETWORK_LAYER_ERROR_CODE Connect(const char* _ip, const unsigned short _port);
 		NETWORK_LAYER_ERROR_CODE Disconnect();
+		inline void SetNetworkEventHandler(NetworkEventHandler* const _handler) { m_networkEventHandler = _handler; }
+
+		//Sends _event to the server as a channel message - picked up by its NetworkEventHandler
+		//Returns false if it couldn't be queued (see NetworkConnection::Send())
+		template<typename Event>
+		bool SendEvent(const Event& _event, const NETWORK_CHANNEL _channel = NETWORK_CHANNEL::RELIABLE_ORDERED) { return QueueMessage(_channel, CNetworkEvent{ _event }.eventPacket); }
 		
 		
 	private:
 		void PreAppUpdate();
 		void PostAppUpdate();
+		void ProcessUDPPacket(sf::Packet& _packet, bool _reassembled, bool _inMessages); //_reassembled / _inMessages stop a fragment claiming to be made of more fragments, or a MESSAGES packet claiming to be inside another
+		void ProcessMessage(const std::uint8_t* _data, std::size_t _size);
+		bool QueueMessage(NETWORK_CHANNEL _channel, const sf::Packet& _packet);
+		void DecodeAndApplyTransforms(const sf::Packet& _packet);
 		
 		ClientNetworkLayerDesc m_desc;
 		CLIENT_STATE m_state;
@@ -46,9 +77,22 @@ namespace NK
 		unsigned short m_serverPort;
 		ClientIndex m_index;
 
-		std::queue<sf::Packet> m_tcpEventQueue; //Queue of event packets to be sent and cleared in every PreAppUpdate() - structure: event packet code then the type registry constant for the event type then the event data itself
-		
 		std::unordered_map<std::uint32_t, Entity> m_networkIDToEntityMap; //Map from network-synced id to local entity index
+
+		std::array<NetworkTransformSnapshot, NetworkTransformCodec::SNAPSHOT_HISTORY_SIZE> m_transformSnapshots; //Ring buffer of the last few snapshots received, indexed by sequence % size - the baselines the server's deltas are decoded against
+		std::uint32_t m_lastAppliedSnapshot; //NetworkTransformCodec::NO_SNAPSHOT until the first one arrives
+		std::vector<QuantisedTransform> m_decodedTransforms; //Scratch space for the snapshot being decoded
+
+		NetworkBufferPool m_bufferPool;
+
+		PacketReassembler m_reassembler;
+		std::vector<std::uint8_t> m_reassembled; //Swapped in and out of m_reassembler so its buffers get reused
+		sf::Packet m_reassembledPacket;
+
+		NetworkConnection m_connection;
+		sf::Packet m_innerPacket; //Scratch space for the packet a MESSAGES packet is carrying
+		sf::Packet m_messagePacket; //Scratch space for the message being handled
+		NetworkEventHandler* m_networkEventHandler;
 	};
 
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "LayerAccess.h"
+
 #include <Core/Debug/ILogger.h>
 #include <Core-ECS/Registry.h>
 #include <Types/NekiTypes.h>
@@ -19,6 +21,13 @@ namespace NK
 		virtual void Update() {}
 		inline virtual void FixedUpdate() {}
 
+		//What this layer touches in _phase - queried whenever the application's layer list changes, not every frame
+		//Layers that don't override this stay exclusive and main-thread only, so they behave exactly as if layers were run one after another
+		[[nodiscard]] inline virtual LayerAccess GetAccess(const LAYER_PHASE _phase) const { return LayerAccess::Exclusive(); }
+
+		//Used in the per-layer timings (see Application::LogLayerTimings())
+		[[nodiscard]] inline virtual const char* GetName() const { return "Unnamed Layer"; }
+
 
 	protected:
 		//Dependency injections
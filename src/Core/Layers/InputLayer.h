@@ -24,6 +24,9 @@ namespace NK
 		virtual ~InputLayer() override;
 
 		virtual void Update() override;
+		//Reads glfw input state - main thread only
+		[[nodiscard]] inline virtual LayerAccess GetAccess(const LAYER_PHASE _phase) const override { return (IsFixedUpdatePhase(_phase) ? LayerAccess{} : LayerAccess::Exclusive()); }
+		[[nodiscard]] inline virtual const char* GetName() const override { return "Input Layer"; }
 		
 		
 	private:
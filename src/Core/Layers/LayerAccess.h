@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Types/NekiTypes.h>
+
+#include <algorithm>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+
+
+namespace NK
+{
+
+	[[nodiscard]] inline bool IsFixedUpdatePhase(const LAYER_PHASE _phase) { return _phase == LAYER_PHASE::PRE_APP_FIXED_UPDATE || _phase == LAYER_PHASE::POST_APP_FIXED_UPDATE; }
+
+
+	//What a layer touches during one phase of the frame - Application uses this to work out which layers can run at the same time (see LayerGraph)
+	//Read<T>() / Write<T>() usually take a component type, but any type works as a tag for some other shared state (e.g. Write<ModelLoader>() for its model cache)
+	//"Read" means the layer doesn't modify T in any way - including lazily-updated caches (use CTransform::ComputeModelMatrix() rather than GetModelMatrix() for read-only access)
+	//Creating / destroying entities or adding / removing components changes the registry's structure (its pool map included) rather than any one component, so layers that do it have to be Exclusive() - views and GetComponent() never create pools, so anything else is safe
+	//Layers that don't declare anything are Exclusive() - they run on the main thread, in order, and nothing overlaps with them (i.e. how every layer ran before access declarations existed)
+	class LayerAccess final
+	{
+	public:
+		//Touches nothing, can run on any thread
+		LayerAccess() = default;
+
+		//Conflicts with everything and runs on the main thread
+		[[nodiscard]] inline static LayerAccess Exclusive()
+		{
+			LayerAccess access;
+			access.m_exclusive = true;
+			access.m_mainThread = true;
+			return access;
+		}
+
+		template<typename T>
+		inline LayerAccess& Read() { m_reads.emplace_back(typeid(T)); return *this; }
+
+		template<typename T>
+		inline LayerAccess& Write() { m_writes.emplace_back(typeid(T)); return *this; }
+
+		//The layer has to run on the main thread (e.g. it talks to glfw or the graphics api) - it can still overlap with layers running on the workers
+		inline LayerAccess& MainThread() { m_mainThread = true; return *this; }
+
+
+		[[nodiscard]] inline bool IsExclusive() const { return m_exclusive; }
+		[[nodiscard]] inline bool IsMainThread() const { return m_mainThread; }
+
+		//Two layers conflict if either is exclusive or one writes something the other reads or writes
+		[[nodiscard]] inline bool ConflictsWith(const LayerAccess& _other) const
+		{
+			if (m_exclusive || _other.m_exclusive) { return true; }
+
+			const auto contains{ [](const std::vector<std::type_index>& _types, const std::type_index _type) { return std::ranges::find(_types, _type) != _types.end(); } };
+			for (const std::type_index type : m_writes)
+			{
+				if (contains(_other.m_reads, type) || contains(_other.m_writes, type)) { return true; }
+			}
+			for (const std::type_index type : m_reads)
+			{
+				if (contains(_other.m_writes, type)) { return true; }
+			}
+			return false;
+		}
+
+
+	private:
+		std::vector<std::type_index> m_reads;
+		std::vector<std::type_index> m_writes;
+		bool m_exclusive{ false };
+		bool m_mainThread{ false };
+	};
+
+}
@@ -0,0 +1,261 @@
+#include "LayerGraph.h"
+
+#include <Core/Context.h>
+#include <Core/Debug/Profiler.h>
+
+#include <limits>
+#include <string>
+#include <thread>
+
+
+namespace NK
+{
+
+	namespace
+	{
+		[[nodiscard]] double MillisecondsBetween(const std::chrono::steady_clock::time_point _start, const std::chrono::steady_clock::time_point _end)
+		{
+			return std::chrono::duration<double, std::milli>(_end - _start).count();
+		}
+	}
+
+
+
+	const char* LayerGraph::GetPhaseName(const LAYER_PHASE _phase)
+	{
+		switch (_phase)
+		{
+		case LAYER_PHASE::PRE_APP_FIXED_UPDATE:		return "Pre-App Fixed Update";
+		case LAYER_PHASE::PRE_APP_UPDATE:			return "Pre-App Update";
+		case LAYER_PHASE::POST_APP_FIXED_UPDATE:	return "Post-App Fixed Update";
+		case LAYER_PHASE::POST_APP_UPDATE:			return "Post-App Update";
+		}
+		return "Unknown Phase";
+	}
+
+
+
+	void LayerGraph::Execute(const std::vector<ILayer*>& _layers)
+	{
+		NK_PROFILE_SCOPE(GetPhaseName(m_phase));
+		
+		if (_layers != m_layers) { Build(_layers); }
+		if (m_nodes.empty())
+		{
+			m_wallTimeMs = 0.0;
+			m_criticalPathMs = 0.0;
+			return;
+		}
+
+		m_mainThreadID = std::this_thread::get_id();
+		m_phaseStart = std::chrono::steady_clock::now();
+
+		JobSystem* const jobSystem{ Context::GetJobSystem() };
+		if (m_parallel && jobSystem) { ExecuteParallel(*jobSystem); }
+		else { ExecuteSequential(); }
+
+		m_wallTimeMs = MillisecondsBetween(m_phaseStart, std::chrono::steady_clock::now());
+		UpdateCriticalPath();
+
+		if (m_exception)
+		{
+			const std::exception_ptr exception{ std::exchange(m_exception, nullptr) };
+			std::rethrow_exception(exception);
+		}
+	}
+
+
+
+	void LayerGraph::Build(const std::vector<ILayer*>& _layers)
+	{
+		m_layers = _layers;
+		m_nodes.clear();
+		m_nodes.reserve(m_layers.size());
+
+		//Every layer depends on each earlier layer it conflicts with, so list order is kept wherever it matters
+		for (std::size_t i{ 0 }; i < m_layers.size(); ++i)
+		{
+			m_nodes.push_back(Node{ m_layers[i], m_layers[i]->GetAccess(m_phase), {}, {} });
+			for (std::size_t j{ 0 }; j < i; ++j)
+			{
+				if (m_nodes[i].access.ConflictsWith(m_nodes[j].access))
+				{
+					m_nodes[i].predecessors.push_back(j);
+					m_nodes[j].successors.push_back(i);
+				}
+			}
+		}
+
+		//If every layer depends on the one before it, nothing can overlap - skip the job system entirely
+		m_parallel = false;
+		for (std::size_t i{ 1 }; i < m_nodes.size(); ++i)
+		{
+			if (m_nodes[i].predecessors.empty() || m_nodes[i].predecessors.back() != i - 1)
+			{
+				m_parallel = true;
+				break;
+			}
+		}
+
+		m_remainingDependencies = std::make_unique<std::atomic<std::uint32_t>[]>(m_nodes.size());
+		m_timings.clear();
+		for (const Node& node : m_nodes)
+		{
+			m_timings.push_back(LayerTiming{ node.layer, 0.0, 0.0, true, false });
+		}
+
+		Context::GetLogger()->IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::ENGINE, std::string(GetPhaseName(m_phase)) + " layer graph built - " + std::to_string(m_nodes.size()) + " layer(s), " + (m_parallel ? "running in parallel where possible\n" : "running sequentially\n"));
+	}
+
+
+
+	void LayerGraph::ExecuteSequential()
+	{
+		for (std::size_t i{ 0 }; i < m_nodes.size(); ++i)
+		{
+			RunLayer(i);
+		}
+	}
+
+
+
+	void LayerGraph::ExecuteParallel(JobSystem& _jobSystem)
+	{
+		m_completed.store(0, std::memory_order_relaxed);
+		m_failed.store(false, std::memory_order_relaxed);
+		m_mainThreadReady.clear();
+		for (std::size_t i{ 0 }; i < m_nodes.size(); ++i)
+		{
+			m_remainingDependencies[i].store(static_cast<std::uint32_t>(m_nodes[i].predecessors.size()), std::memory_order_relaxed);
+		}
+
+		for (std::size_t i{ 0 }; i < m_nodes.size(); ++i)
+		{
+			if (m_nodes[i].predecessors.empty()) { Schedule(_jobSystem, i); }
+		}
+
+		//Run main-thread-only layers as they become ready, and help with everything else in between
+		while (m_completed.load(std::memory_order_acquire) < m_nodes.size())
+		{
+			std::size_t index{ std::numeric_limits<std::size_t>::max() };
+			{
+				const std::lock_guard lock(m_mainThreadMutex);
+				if (!m_mainThreadReady.empty())
+				{
+					//Lowest index first so independent main-thread layers still run in list order
+					const std::vector<std::size_t>::iterator it{ std::ranges::min_element(m_mainThreadReady) };
+					index = *it;
+					m_mainThreadReady.erase(it);
+				}
+			}
+
+			if (index != std::numeric_limits<std::size_t>::max()) { RunNode(_jobSystem, index); }
+			else if (!_jobSystem.TryRunOne()) { std::this_thread::yield(); }
+		}
+
+		//The last layer can be marked complete a moment before its job is retired from the counter
+		_jobSystem.Wait(m_counter);
+	}
+
+
+
+	void LayerGraph::Schedule(JobSystem& _jobSystem, const std::size_t _index)
+	{
+		if (m_nodes[_index].access.IsMainThread())
+		{
+			const std::lock_guard lock(m_mainThreadMutex);
+			m_mainThreadReady.push_back(_index);
+			return;
+		}
+
+		_jobSystem.Run(m_counter, [this, &_jobSystem, _index]()
+		{
+			RunNode(_jobSystem, _index);
+		});
+	}
+
+
+
+	void LayerGraph::RunNode(JobSystem& _jobSystem, const std::size_t _index)
+	{
+		//Once a layer has thrown, the rest are skipped, but still released so Execute() can finish
+		if (!m_failed.load(std::memory_order_acquire))
+		{
+			try
+			{
+				RunLayer(_index);
+			}
+			catch (...)
+			{
+				const std::lock_guard lock(m_mainThreadMutex);
+				if (!m_exception) { m_exception = std::current_exception(); }
+				m_failed.store(true, std::memory_order_release);
+			}
+		}
+		else
+		{
+			m_timings[_index].startMs = MillisecondsBetween(m_phaseStart, std::chrono::steady_clock::now());
+			m_timings[_index].durationMs = 0.0;
+		}
+
+		for (const std::size_t successor : m_nodes[_index].successors)
+		{
+			if (m_remainingDependencies[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) { Schedule(_jobSystem, successor); }
+		}
+
+		m_completed.fetch_add(1, std::memory_order_release);
+	}
+
+
+
+	void LayerGraph::RunLayer(const std::size_t _index)
+	{
+		const std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+
+		ILayer* const layer{ m_nodes[_index].layer };
+		{
+			NK_PROFILE_SCOPE(layer->GetName());
+			if (IsFixedUpdatePhase(m_phase)) { layer->FixedUpdate(); }
+			else { layer->Update(); }
+		}
+
+		const std::chrono::steady_clock::time_point end{ std::chrono::steady_clock::now() };
+		LayerTiming& timing{ m_timings[_index] };
+		timing.startMs = MillisecondsBetween(m_phaseStart, start);
+		timing.durationMs = MillisecondsBetween(start, end);
+		timing.mainThread = (std::this_thread::get_id() == m_mainThreadID);
+	}
+
+
+
+	void LayerGraph::UpdateCriticalPath()
+	{
+		//Nodes are already in topological order (dependencies always point backwards), so one pass finds the longest chain
+		std::vector<double> finish(m_nodes.size(), 0.0);
+		std::vector<std::size_t> via(m_nodes.size(), std::numeric_limits<std::size_t>::max());
+		std::size_t last{ 0 };
+
+		for (std::size_t i{ 0 }; i < m_nodes.size(); ++i)
+		{
+			double start{ 0.0 };
+			for (const std::size_t predecessor : m_nodes[i].predecessors)
+			{
+				if (finish[predecessor] > start)
+				{
+					start = finish[predecessor];
+					via[i] = predecessor;
+				}
+			}
+			finish[i] = start + m_timings[i].durationMs;
+			m_timings[i].criticalPath = false;
+			if (finish[i] > finish[last]) { last = i; }
+		}
+
+		m_criticalPathMs = finish[last];
+		for (std::size_t i{ last }; i != std::numeric_limits<std::size_t>::max(); i = via[i])
+		{
+			m_timings[i].criticalPath = true;
+		}
+	}
+
+}
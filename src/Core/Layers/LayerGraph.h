@@ -0,0 +1,100 @@
+#pragma once
+
+#include "ILayer.h"
+#include "LayerAccess.h"
+
+#include <Core/Jobs/JobSystem.h>
+#include <Types/NekiTypes.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace NK
+{
+
+	//How long a layer took in the last Execute() of its LayerGraph
+	struct LayerTiming
+	{
+		ILayer* layer;
+		double startMs; //Relative to the start of the phase
+		double durationMs;
+		bool mainThread; //Whether it ran on the thread that called Execute() or a worker
+		bool criticalPath; //Whether it's on the longest chain of dependent layers - the chain that bounds how fast the phase can go however many workers there are
+	};
+
+
+	//Runs one phase's layers (e.g. all the pre-app layers' Update()s) as a dependency graph rather than one after another
+	//A layer depends on every earlier layer in the list that it conflicts with (see LayerAccess::ConflictsWith()), so conflicting layers still run in list order, and anything that doesn't conflict runs at the same time on the engine's JobSystem
+	//Main-thread-only layers are run by the thread calling Execute(), which helps out with other jobs while it waits on the rest
+	class LayerGraph final
+	{
+	public:
+		explicit LayerGraph(const LAYER_PHASE _phase) : m_phase(_phase) {}
+		LayerGraph(const LayerGraph&) = delete;
+		LayerGraph& operator=(const LayerGraph&) = delete;
+
+		//Run every layer in _layers for this graph's phase, rebuilding the graph first if _layers has changed since the last call
+		//Rethrows the first exception thrown by a layer once everything that was already running has finished - layers that hadn't started yet are skipped
+		void Execute(const std::vector<ILayer*>& _layers);
+
+		[[nodiscard]] inline LAYER_PHASE GetPhase() const { return m_phase; }
+		[[nodiscard]] inline const std::vector<LayerTiming>& GetTimings() const { return m_timings; }
+		[[nodiscard]] inline double GetWallTimeMs() const { return m_wallTimeMs; }
+		[[nodiscard]] inline double GetCriticalPathMs() const { return m_criticalPathMs; }
+
+		[[nodiscard]] static const char* GetPhaseName(LAYER_PHASE _phase);
+
+
+	private:
+		struct Node
+		{
+			ILayer* layer;
+			LayerAccess access;
+			std::vector<std::size_t> predecessors;
+			std::vector<std::size_t> successors;
+		};
+
+		void Build(const std::vector<ILayer*>& _layers);
+		void ExecuteSequential();
+		void ExecuteParallel(JobSystem& _jobSystem);
+
+		void Schedule(JobSystem& _jobSystem, std::size_t _index);
+		void RunNode(JobSystem& _jobSystem, std::size_t _index);
+		void RunLayer(std::size_t _index);
+
+		void UpdateCriticalPath();
+
+
+		const LAYER_PHASE m_phase;
+
+		std::vector<ILayer*> m_layers; //The layer list the graph was last built from
+		std::vector<Node> m_nodes;
+		bool m_parallel{ false }; //False if every layer depends on the one before it - then there's nothing to overlap and the graph just runs as a loop
+
+		//Per-Execute() state
+		std::unique_ptr<std::atomic<std::uint32_t>[]> m_remainingDependencies;
+		std::atomic<std::size_t> m_completed{ 0 };
+		std::mutex m_mainThreadMutex;
+		std::vector<std::size_t> m_mainThreadReady; //Main-thread-only layers whose dependencies have all finished
+		std::atomic<bool> m_failed{ false };
+		std::exception_ptr m_exception; //Guarded by m_mainThreadMutex
+		JobCounter m_counter;
+		std::chrono::steady_clock::time_point m_phaseStart;
+		std::thread::id m_mainThreadID; //The thread that called Execute()
+
+		std::vector<LayerTiming> m_timings; //One per layer, in list order - each entry is only written by the thread running that layer
+		double m_wallTimeMs{ 0.0 };
+		double m_criticalPathMs{ 0.0 };
+	};
+
+}
@@ -2,6 +2,7 @@
 
 #include <Components/CModelRenderer.h>
 #include <Components/CTransform.h>
+#include <Core/Utils/ModelLoader.h>
 
 
 namespace NK
@@ -17,6 +18,14 @@ namespace NK
 
 
 
+	LayerAccess ModelVisibilityLayer::GetAccess(const LAYER_PHASE _phase) const
+	{
+		if (IsFixedUpdatePhase(_phase)) { return {}; }
+		return LayerAccess{}.Read<CCamera>().Read<CTransform>().Write<CModelRenderer>().Write<ModelLoader>();
+	}
+
+
+
 	void ModelVisibilityLayer::Update()
 	{
 		//Get the camera's view frustum
@@ -54,10 +63,12 @@ namespace NK
 				modelRenderer.localSpaceOrigin = glm::vec3(0);
 			}
 			
+			//ComputeModelMatrix() rather than GetModelMatrix() - this layer only declares read access to CTransform
+			const glm::mat4 modelMatrix{ transform.ComputeModelMatrix() };
 			glm::vec3 minPoint{ modelRenderer.localSpaceOrigin - modelRenderer.localSpaceHalfExtents };
 			glm::vec3 maxPoint{ modelRenderer.localSpaceOrigin + modelRenderer.localSpaceHalfExtents };
-			minPoint = glm::vec3(transform.GetModelMatrix() * glm::vec4(minPoint, 1.0));
-			maxPoint = glm::vec3(transform.GetModelMatrix() * glm::vec4(maxPoint, 1.0));
+			minPoint = glm::vec3(modelMatrix * glm::vec4(minPoint, 1.0));
+			maxPoint = glm::vec3(modelMatrix * glm::vec4(maxPoint, 1.0));
 			modelRenderer.visible = m_frustum.BoxVisible(minPoint, maxPoint);
 		}
 	}
@@ -15,6 +15,8 @@ namespace NK
 		virtual ~ModelVisibilityLayer() override = default;
 
 		virtual void Update() override;
+		[[nodiscard]] virtual LayerAccess GetAccess(const LAYER_PHASE _phase) const override;
+		[[nodiscard]] inline virtual const char* GetName() const override { return "Model Visibility Layer"; }
 		
 		
 	private:
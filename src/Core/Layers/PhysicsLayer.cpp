@@ -42,9 +42,9 @@ namespace NK
 		JPH::RegisterTypes();
 
 		m_tempAllocator = new JPH::TempAllocatorImpl(10 * 1024 * 1024); //10MiB scratch
-		m_jobSystem = new JPH::JobSystemThreadPool(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, std::thread::hardware_concurrency() - 1);
+		m_jobSystem = new JobSystemImpl(*Context::GetJobSystem(), JPH::cMaxPhysicsBarriers); //Shares the engine's workers
 
-		m_physicsSystem.Init(1024, 0, 1024, 1024, m_broadPhaseInterface, m_objectBroadPhaseFilter, m_objectFilter);
+		m_physicsSystem.Init(_desc.maxBodies, 0, _desc.maxBodyPairs, _desc.maxContactConstraints, m_broadPhaseInterface, m_objectBroadPhaseFilter, m_objectFilter);
 		
 		m_entityDestroyEventSubscriptionID = EventManager::Subscribe<PhysicsLayer, EntityDestroyEvent>(this, &PhysicsLayer::OnEntityDestroy);
 		m_componentRemoveEventSubscriptionID = EventManager::Subscribe<PhysicsLayer, ComponentRemoveEvent>(this, &PhysicsLayer::OnComponentRemove);
@@ -60,9 +60,21 @@ namespace NK
 		EventManager::Unsubscribe<EntityDestroyEvent>(m_entityDestroyEventSubscriptionID);
 		EventManager::Unsubscribe<ComponentRemoveEvent>(m_componentRemoveEventSubscriptionID);
 		EventManager::Unsubscribe<ComponentAddEvent>(m_componentAddEventSubscriptionID);
+
+		delete m_jobSystem;
 	}
 
 
+
+	LayerAccess PhysicsLayer::GetAccess(const LAYER_PHASE _phase) const
+	{
+		if (!IsFixedUpdatePhase(_phase)) { return {}; }
+		//Collision events are queued (EventManager::Enqueue()), so nothing else needs guarding
+		return LayerAccess{}.Write<CPhysicsBody>().Write<CBoxCollider>().Write<CTransform>();
+	}
+
+
+
 	void PhysicsLayer::FixedUpdate()
 	{
 		JPH::BodyInterface& bodyInterface{ m_physicsSystem.GetBodyInterface() };
@@ -4,13 +4,14 @@
 
 #include <Physics/BroadPhaseLayerInterfaceImpl.h>
 #include <Physics/ContactListenerImpl.h>
+#include <Physics/JobSystemImpl.h>
 #include <Physics/ObjectLayerPairFilterImpl.h>
 #include <Physics/ObjectVsBroadPhaseLayerFilterImpl.h>
 
 #ifdef AddJob
 	#undef AddJob
 #endif
-#include <Jolt/Core/JobSystemThreadPool.h>
+#include <Jolt/Core/TempAllocator.h>
 
 
 
@@ -25,6 +26,8 @@ namespace NK
 
 		virtual void FixedUpdate() override;
 		virtual void SetRegistry(Registry& _reg) override;
+		[[nodiscard]] virtual LayerAccess GetAccess(const LAYER_PHASE _phase) const override;
+		[[nodiscard]] inline virtual const char* GetName() const override { return "Physics Layer"; }
 		
 		
 	private:
@@ -38,7 +41,7 @@ namespace NK
 		
 		JPH::PhysicsSystem m_physicsSystem;
 		JPH::TempAllocatorImpl* m_tempAllocator;
-		JPH::JobSystemThreadPool* m_jobSystem;
+		JobSystemImpl* m_jobSystem;
 		BroadPhaseLayerInterfaceImpl m_broadPhaseInterface;
 		ContactListenerImpl m_contactListener;
 		ObjectLayerPairFilterImpl m_objectFilter;
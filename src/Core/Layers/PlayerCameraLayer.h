@@ -17,6 +17,9 @@ namespace NK
 		virtual ~PlayerCameraLayer() override;
 
 		virtual void Update() override;
+		//Only has an Update() - left exclusive in there
+		[[nodiscard]] inline virtual LayerAccess GetAccess(const LAYER_PHASE _phase) const override { return (IsFixedUpdatePhase(_phase) ? LayerAccess{} : LayerAccess::Exclusive()); }
+		[[nodiscard]] inline virtual const char* GetName() const override { return "Player Camera Layer"; }
 	};
 
 }
\ No newline at end of file
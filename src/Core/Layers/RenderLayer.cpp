@@ -8,6 +8,9 @@
 #include <Components/CSelected.h>
 #include <Components/CSkybox.h>
 #include <Components/CTransform.h>
+#include <Core/Debug/Profiler.h>
+#include <Core/FixedStepScheduler.h>
+#include <Core/FramePacer.h>
 #include <Core/Utils/TextureCompressor.h>
 #include <Graphics/Lights/DirectionalLight.h>
 #include <Graphics/Lights/PointLight.h>
@@ -36,6 +39,7 @@
 #endif
 
 #include <cstring>
+#include <utility>
 #include <imgui.h>
 #include <backends/imgui_impl_glfw.h>
 #ifdef NEKI_VULKAN_SUPPORTED
@@ -98,6 +102,11 @@ namespace NK
 		m_entityDestroyEventSubscriptionID = EventManager::Subscribe<RenderLayer, EntityDestroyEvent>(this, &RenderLayer::OnEntityDestroy);
 		m_componentRemoveEventSubscriptionID = EventManager::Subscribe<RenderLayer, ComponentRemoveEvent>(this, &RenderLayer::OnComponentRemove);
 		m_sceneLoadEventSubscriptionID = EventManager::Subscribe<RenderLayer, SceneLoadEvent>(this, &RenderLayer::OnSceneLoad);
+
+		if (m_desc.enableRenderThread)
+		{
+			m_renderThread = std::thread(&RenderLayer::RenderThreadLoop, this);
+		}
 		
 		
 		m_logger.Unindent();
@@ -110,6 +119,18 @@ namespace NK
 		m_logger.Indent();
 		m_logger.Log(LOGGER_CHANNEL::HEADING, LOGGER_LAYER::RENDER_LAYER, "Shutting Down Render Layer\n");
 
+		//Let the render thread finish the frame it's on before anything is torn down
+		if (m_renderThread.joinable())
+		{
+			{
+				const std::lock_guard lock(m_renderThreadMutex);
+				m_renderThreadShutdown = true;
+			}
+			m_renderThreadCondition.notify_all();
+			m_renderThread.join();
+		}
+		ReleaseImGuiDrawData();
+
 		EventManager::Unsubscribe<EntityDestroyEvent>(m_entityDestroyEventSubscriptionID);
 		EventManager::Unsubscribe<ComponentRemoveEvent>(m_componentRemoveEventSubscriptionID);
 		EventManager::Unsubscribe<SceneLoadEvent>(m_sceneLoadEventSubscriptionID);
@@ -961,21 +982,21 @@ namespace NK
 
 				if (m_desc.enableMSAA)
 				{
-					_cmdBuf->BeginRendering(0, nullptr, nullptr, _texViews.Get("SCENE_DEPTH_MSAA_DSV"), _texViews.Get("SCENE_DEPTH_DSV"), nullptr, true, m_firstFrame);
+					_cmdBuf->BeginRendering(0, nullptr, nullptr, _texViews.Get("SCENE_DEPTH_MSAA_DSV"), _texViews.Get("SCENE_DEPTH_DSV"), nullptr, true, m_renderSnapshot.firstFrame);
 				}
 				else if (m_desc.enableSSAA)
 				{
-					_cmdBuf->BeginRendering(0, nullptr, nullptr, nullptr, _texViews.Get("SCENE_DEPTH_SSAA_DSV"), nullptr, true, m_firstFrame);
+					_cmdBuf->BeginRendering(0, nullptr, nullptr, nullptr, _texViews.Get("SCENE_DEPTH_SSAA_DSV"), nullptr, true, m_renderSnapshot.firstFrame);
 				}
 				else
 				{
-					_cmdBuf->BeginRendering(0, nullptr, nullptr, nullptr, _texViews.Get("SCENE_DEPTH_DSV"), nullptr, true, m_firstFrame);
+					_cmdBuf->BeginRendering(0, nullptr, nullptr, nullptr, _texViews.Get("SCENE_DEPTH_DSV"), nullptr, true, m_renderSnapshot.firstFrame);
 				}
 
 				_cmdBuf->BindRootSignature(m_modelVisibilityPassRootSignature.get(), PIPELINE_BIND_POINT::GRAPHICS);
 
-				_cmdBuf->SetViewport({ 0, 0 }, { m_desc.enableSSAA ? m_supersampleResolution : m_desc.window->GetFramebufferSize() });
-				_cmdBuf->SetScissor({ 0, 0 }, { m_desc.enableSSAA ? m_supersampleResolution : m_desc.window->GetFramebufferSize() });
+				_cmdBuf->SetViewport({ 0, 0 }, { m_desc.enableSSAA ? m_supersampleResolution : m_renderSnapshot.framebufferSize });
+				_cmdBuf->SetScissor({ 0, 0 }, { m_desc.enableSSAA ? m_supersampleResolution : m_renderSnapshot.framebufferSize });
 
 				ModelVisibilityPassPushConstantData pushConstantData{};
 				pushConstantData.camDataBufferIndex = _bufViews.Get("CAMERA_BUFFER_PREVIOUS_FRAME_VIEW")->GetIndex();
@@ -988,7 +1009,7 @@ namespace NK
 				_cmdBuf->BindPipeline(m_modelVisibilityPipeline.get(), PIPELINE_BIND_POINT::GRAPHICS);
 				_cmdBuf->BindVertexBuffers(0, 1, m_cubeVertBuffer.get(), &cubeVertexBufferStride);
 				_cmdBuf->BindIndexBuffer(m_cubeIndexBuffer.get(), DATA_FORMAT::R32_UINT);
-				_cmdBuf->DrawIndexed(36, m_modelMatrices.size(), 0, 0);
+				_cmdBuf->DrawIndexed(36, m_renderSnapshot.modelMatrixCount, 0, 0);
 				_cmdBuf->EndRendering(0, nullptr, nullptr);
 			});
 
@@ -1028,14 +1049,12 @@ namespace NK
 			
 			auto drawModels{ [&]()
 			{
-				for (auto&& [modelRenderer, transform] : m_reg.get().View<CModelRenderer, CTransform>())
+				for (const RenderSnapshot::ModelDraw& draw : m_renderSnapshot.models)
 				{
-					if (!modelRenderer.visible) { continue; }
-					const GPUModel* const model{ modelRenderer.model };
-					if (!model) { continue; }
-					pushConstantData.modelMat = transform.GetModelMatrix();
+					const GPUModel* const model{ draw.model };
+					pushConstantData.modelMat = draw.modelMatrix;
 
-					for (std::size_t meshIndex{ 0 }; meshIndex < modelRenderer.model->meshes.size(); ++meshIndex)
+					for (std::size_t meshIndex{ 0 }; meshIndex < model->meshes.size(); ++meshIndex)
 					{
 //						if (model->meshes[meshIndex] == nullptr) { continue; }
 //						if (model->meshes[meshIndex]->vertexBuffer == nullptr) { continue; }
@@ -1051,26 +1070,19 @@ namespace NK
 
 			
 			//Loop through all lights
-			//View is parallel to vector
-			//^todo: there's almost definitely a better way of handling this
-			ComponentView<CLight, CTransform> lightView{ m_reg.get().View<CLight, CTransform>() };
-			ComponentView<CLight, CTransform>::iterator lightIt{ lightView.begin() };
-			for (std::size_t i{ 0 }; i < m_cpuLightData.size(); ++i, ++lightIt)
-			{
-				auto [light, transform] = *lightIt;
-				if (light.GetLightType() == LIGHT_TYPE::UNDEFINED || !light.light) { continue; }
-				ITexture* shadowMap{ nullptr };
-				const LightShaderData& lightData{ m_cpuLightData[i] };
+			for (const RenderSnapshot::ShadowCaster& caster : m_renderSnapshot.shadowCasters)
+			{
+				ITexture* const shadowMap{ caster.shadowMap };
+				const LightShaderData& lightData{ caster.lightData };
 				if (lightData.type == LIGHT_TYPE::POINT)
 				{
-					shadowMap = m_shadowMapsCube[light.light->GetShadowMapVectorIndex()].get();
 					_cmdBuf->TransitionBarrier(shadowMap, shadowMap->GetState(), RESOURCE_STATE::DEPTH_WRITE);
 					
 					//shadow cubemap - need to render scene 6 times from all faces and set view matrix between each one
 					for (std::uint32_t faceIndex{ 0 }; faceIndex < 6; ++faceIndex)
 					{
 						pushConstantData.viewProjMat = m_pointLightProjMatrix * GetPointLightViewMatrix(lightData.position, faceIndex);
-						_cmdBuf->BeginRendering(0, nullptr, nullptr, nullptr, m_shadowMapCube_FaceDSVs[light.light->GetShadowMapVectorIndex()][faceIndex].get(), nullptr, true, true);
+						_cmdBuf->BeginRendering(0, nullptr, nullptr, nullptr, caster.shadowMapCubeFaceDSVs[faceIndex], nullptr, true, true);
 						_cmdBuf->SetViewport({ 0, 0 }, { shadowMap->GetSize().x, shadowMap->GetSize().y });
 						_cmdBuf->SetScissor({ 0, 0 }, { shadowMap->GetSize().x, shadowMap->GetSize().y });
 						drawModels();
@@ -1079,12 +1091,11 @@ namespace NK
 				}
 				else
 				{
-					shadowMap = m_shadowMaps2D[light.light->GetShadowMapVectorIndex()].get();
 					_cmdBuf->TransitionBarrier(shadowMap, shadowMap->GetState(), RESOURCE_STATE::DEPTH_WRITE);
 					
 					//2d shadow map
 					pushConstantData.viewProjMat = lightData.viewProjMat; //todo: this is so ugly, why is it being duplicated? find a better way of doing this !!
-					_cmdBuf->BeginRendering(0, nullptr, nullptr, nullptr, m_shadowMap2DDSVs[light.light->GetShadowMapVectorIndex()].get(), nullptr, true, true);
+					_cmdBuf->BeginRendering(0, nullptr, nullptr, nullptr, caster.shadowMap2DDSV, nullptr, true, true);
 					_cmdBuf->SetViewport({ 0, 0 }, { shadowMap->GetSize().x, shadowMap->GetSize().y });
 					_cmdBuf->SetScissor({ 0, 0 }, { shadowMap->GetSize().x, shadowMap->GetSize().y });
 					drawModels();
@@ -1128,12 +1139,12 @@ namespace NK
 			
 			_cmdBuf->BindRootSignature(m_meshPassRootSignature.get(), PIPELINE_BIND_POINT::GRAPHICS);
 
-			_cmdBuf->SetViewport({ 0, 0 }, { m_desc.enableSSAA ? m_supersampleResolution : m_desc.window->GetFramebufferSize() });
-			_cmdBuf->SetScissor({ 0, 0 }, { m_desc.enableSSAA ? m_supersampleResolution : m_desc.window->GetFramebufferSize() });
+			_cmdBuf->SetViewport({ 0, 0 }, { m_desc.enableSSAA ? m_supersampleResolution : m_renderSnapshot.framebufferSize });
+			_cmdBuf->SetScissor({ 0, 0 }, { m_desc.enableSSAA ? m_supersampleResolution : m_renderSnapshot.framebufferSize });
 
 			MeshPassPushConstantData pushConstantData{};
 			pushConstantData.camDataBufferIndex = _bufViews.Get("CAMERA_BUFFER_VIEW")->GetIndex();
-			pushConstantData.numLights = m_cpuLightData.size();
+			pushConstantData.numLights = m_renderSnapshot.lightCount;
 			pushConstantData.lightDataBufferIndex = _bufViews.Get("LIGHT_DATA_BUFFER_VIEW")->GetIndex();
 			pushConstantData.skyboxCubemapIndex = _texViews.Get("SKYBOX_VIEW") ? _texViews.Get("SKYBOX_VIEW")->GetIndex() : 0;
 			pushConstantData.irradianceCubemapIndex = _texViews.Get("IRRADIANCE_MAP_VIEW") ? _texViews.Get("IRRADIANCE_MAP_VIEW")->GetIndex() : 0;
@@ -1141,9 +1152,9 @@ namespace NK
 			pushConstantData.brdfLUTIndex = _texViews.Get("BRDF_LUT_VIEW")->GetIndex();
 			pushConstantData.brdfLUTSamplerIndex = _samplers.Get("BRDF_LUT_SAMPLER")->GetIndex();
 			pushConstantData.samplerIndex = _samplers.Get("SAMPLER")->GetIndex();
-			if (m_activeCamera)
+			if (m_renderSnapshot.camera.valid)
 			{
-				pushConstantData.maxIrradiance = m_activeCamera->GetMaxIrradiance();
+				pushConstantData.maxIrradiance = m_renderSnapshot.camera.maxIrradiance;
 			}
 
 			//Skybox
@@ -1159,14 +1170,12 @@ namespace NK
 
 			//Models
 			std::size_t modelVertexBufferStride{ sizeof(ModelVertex) };
-			for (auto&& [modelRenderer, transform] : m_reg.get().View<CModelRenderer, CTransform>())
+			for (const RenderSnapshot::ModelDraw& draw : m_renderSnapshot.models)
 			{
-				if (!modelRenderer.visible) { continue; }
-				const GPUModel* const model{ modelRenderer.model };
-				if (!model) { continue; }
-				pushConstantData.modelMat = transform.GetModelMatrix();
+				const GPUModel* const model{ draw.model };
+				pushConstantData.modelMat = draw.modelMatrix;
 
-				for (std::size_t i{ 0 }; i < modelRenderer.model->meshes.size(); ++i)
+				for (std::size_t i{ 0 }; i < model->meshes.size(); ++i)
 				{
 					const GPUMesh* mesh{ model->meshes[i].get() };
 					pushConstantData.materialBufferIndex = model->materials[mesh->materialIndex]->bufferIndex;
@@ -1234,7 +1243,7 @@ namespace NK
 		{ "SAT_FINAL", RESOURCE_STATE::UNORDERED_ACCESS }},
 		[&](ICommandBuffer* _cmdBuf, const BindingMap<IBuffer>& _bufs, const BindingMap<ITexture>& _texs, const BindingMap<IBufferView>& _bufViews, const BindingMap<ITextureView>& _texViews, const BindingMap<ISampler>& _samplers)
 		{
-			if (!m_activeCamera || !m_activeCamera->GetEnableDepthOfField()) { return; }
+			if (!m_renderSnapshot.camera.valid || !m_renderSnapshot.camera.enableDepthOfField) { return; }
 			
 			float clearColor[4] = {0.0f, 0.0f, 0.0f, 0.0f};
 			_cmdBuf->ClearTexture(_texs.Get("SAT_INTERMEDIATE"), clearColor);
@@ -1281,8 +1290,8 @@ namespace NK
 			_cmdBuf->BeginRendering(1, nullptr, _texViews.Get("BACKBUFFER_RTV"), nullptr, nullptr, nullptr);
 			_cmdBuf->BindRootSignature(m_postprocessPassRootSignature.get(), PIPELINE_BIND_POINT::GRAPHICS);
 
-			_cmdBuf->SetViewport({ 0, 0 }, { m_desc.window->GetFramebufferSize() });
-			_cmdBuf->SetScissor({ 0, 0 }, { m_desc.window->GetFramebufferSize() });
+			_cmdBuf->SetViewport({ 0, 0 }, { m_renderSnapshot.framebufferSize });
+			_cmdBuf->SetScissor({ 0, 0 }, { m_renderSnapshot.framebufferSize });
 
 			PostprocessPassPushConstantData pushConstantData{};
 			pushConstantData.sceneColourIndex = _texViews.Get("SCENE_COLOUR_SRV")->GetIndex();
@@ -1290,15 +1299,16 @@ namespace NK
 			pushConstantData.satTextureIndex = _texViews.Get("SAT_FINAL_SRV")->GetIndex();
 			pushConstantData.samplerIndex = _samplers.Get("SAMPLER")->GetIndex();
 
-			if (m_activeCamera)
+			if (m_renderSnapshot.camera.valid)
 			{
-				pushConstantData.nearPlane = m_activeCamera->camera->GetNearPlaneDistance();
-				pushConstantData.farPlane = m_activeCamera->camera->GetFarPlaneDistance();
-				pushConstantData.focalDistance = m_activeCamera->GetFocalDistance();
-				pushConstantData.focalDepth = m_activeCamera->GetFocalDepth();
-				pushConstantData.maxBlurRadius = (m_activeCamera->GetEnableDepthOfField() ? m_activeCamera->GetMaxBlurRadius() : 0.0f);
-				pushConstantData.dofDebugMode = (m_activeCamera->GetDOFDebugMode() ? 1 : 0);
-				pushConstantData.acesExposure = m_activeCamera->GetACESExposure();
+				const RenderSnapshot::CameraData& camera{ m_renderSnapshot.camera };
+				pushConstantData.nearPlane = camera.nearPlane;
+				pushConstantData.farPlane = camera.farPlane;
+				pushConstantData.focalDistance = camera.focalDistance;
+				pushConstantData.focalDepth = camera.focalDepth;
+				pushConstantData.maxBlurRadius = (camera.enableDepthOfField ? camera.maxBlurRadius : 0.0f);
+				pushConstantData.dofDebugMode = (camera.dofDebugMode ? 1 : 0);
+				pushConstantData.acesExposure = camera.acesExposure;
 			}
 			
 			//Screen Quad
@@ -1313,14 +1323,14 @@ namespace NK
 			if (m_desc.backend == GRAPHICS_BACKEND::VULKAN)
 			{
 				VkCommandBuffer vkCmdBuf{ dynamic_cast<VulkanCommandBuffer*>(_cmdBuf)->GetBuffer() };
-				ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), vkCmdBuf);
+				ImGui_ImplVulkan_RenderDrawData(&m_renderSnapshot.imguiDrawData, vkCmdBuf);
 			}
 			#endif
 			#ifdef NEKI_D3D12_SUPPORTED
 			if (m_desc.backend == GRAPHICS_BACKEND::D3D12)
 			{
 				ID3D12GraphicsCommandList* d3dCmdBuf{ dynamic_cast<D3D12CommandBuffer*>(_cmdBuf)->GetCommandList() };
-				ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), d3dCmdBuf);
+				ImGui_ImplDX12_RenderDrawData(&m_renderSnapshot.imguiDrawData, d3dCmdBuf);
 			}
 			#endif
 
@@ -1731,6 +1741,7 @@ namespace NK
 				ImGui::MenuItem("Inspector", nullptr, &m_showInspector, m_showEditor);
 				ImGui::MenuItem("Gizmo Settings", nullptr, &m_showGizmoSettings, m_showEditor);
 				ImGui::MenuItem("Editor Settings", nullptr, &m_showEditorSettings, m_showEditor);
+				ImGui::MenuItem("Profiler", nullptr, &m_showProfiler, m_showEditor);
 				ImGui::EndMenu();
 			}
 
@@ -1999,6 +2010,25 @@ namespace NK
 			if (ImGui::Checkbox("Pause", &paused)) { Context::SetPaused(paused); }
 			ImGui::SameLine();
 			if (ImGui::DragInt("Fixed Updates Per Second", &fixedUpdatesPerSecond, 1, 1)) { Context::SetFixedUpdateTimestep(1.0f / std::max(1, fixedUpdatesPerSecond)); }
+			if (const FixedStepScheduler* scheduler{ Context::GetFixedStepScheduler() })
+			{
+				ImGui::Text("Fixed updates last frame: %u, alpha: %.2f, time dilation: %.2f", scheduler->GetStepsLastFrame(), scheduler->GetAlpha(), scheduler->GetTimeDilation());
+				if (ImGui::IsItemHovered())
+				{
+					ImGui::SetTooltip("Time dilation drops below 1 when a frame takes too long to catch up on fixed updates (%u at most per frame) and simulation time is dropped rather than letting frames get slower and slower", scheduler->GetMaxStepsPerFrame());
+				}
+			}
+			if (FramePacer* framePacer{ Context::GetFramePacer() })
+			{
+				float targetFPS{ framePacer->GetTargetFPS() };
+				if (ImGui::DragFloat("Target FPS", &targetFPS, 1.0f, 0.0f, 1000.0f, "%.0f")) { framePacer->SetTargetFPS(std::max(0.0f, targetFPS)); }
+				if (ImGui::IsItemHovered()) { ImGui::SetTooltip("0 for no limit"); }
+				ImGui::SameLine();
+				float inactiveTargetFPS{ framePacer->GetInactiveTargetFPS() };
+				if (ImGui::DragFloat("Inactive Target FPS", &inactiveTargetFPS, 1.0f, 0.0f, 1000.0f, "%.0f")) { framePacer->SetInactiveTargetFPS(std::max(0.0f, inactiveTargetFPS)); }
+				if (ImGui::IsItemHovered()) { ImGui::SetTooltip("Frame rate while the window is unfocused or minimised, or the editor is paused - input still wakes it straight away. 0 to stay at the target FPS"); }
+				ImGui::Text("Frame time: %.2fms average, %.2fms std dev, %.2fms max, %u late%s", framePacer->GetAverageFrameTime() * 1000.0, framePacer->GetFrameTimeStdDev() * 1000.0, framePacer->GetMaxFrameTime() * 1000.0, framePacer->GetLateFrames(), framePacer->GetIdle() ? " (idle)" : "");
+			}
 			
 			ImGui::Separator();
 			
@@ -2018,6 +2048,13 @@ namespace NK
 			}
 		}
 		if (m_showEditor && m_showEditorSettings) { ImGui::End(); }
+
+
+		if (m_showEditor && m_showProfiler && ImGui::Begin("Profiler"))
+		{
+			Profiler::DrawImGuiPanel();
+		}
+		if (m_showEditor && m_showProfiler) { ImGui::End(); }
 		
 		
 		// if (ImGui::Begin("Asset Browser"))_path
@@ -2262,6 +2299,11 @@ namespace NK
 
 	void RenderLayer::PostAppUpdate()
 	{
+		NK_PROFILE_SCOPE("RenderLayer - Extract");
+
+		//The render thread (if there is one) could still be recording last frame from m_renderSnapshot
+		WaitForRenderThread();
+		
 		//Begin rendering
 		m_inFlightFences[m_currentFrame]->Wait();
 		m_inFlightFences[m_currentFrame]->Reset();
@@ -2525,27 +2567,101 @@ namespace NK
 		}
 		
 
-		const std::uint32_t imageIndex{ m_swapchain->AcquireNextImageIndex(m_imageAvailableSemaphores[m_currentFrame].get(), nullptr) };
+		//Extract everything the render graph needs - from here on, recording doesn't touch the registry
+		RenderSnapshot& snapshot{ m_renderSnapshot };
+		snapshot.frameIndex = m_currentFrame;
+		snapshot.firstFrame = m_firstFrame;
+		snapshot.newGPUUploaderUpload = m_newGPUUploaderUpload;
+		snapshot.framebufferSize = m_desc.window->GetFramebufferSize();
+		snapshot.modelMatrixCount = m_modelMatrices.size();
+		snapshot.lightCount = static_cast<std::uint32_t>(m_cpuLightData.size());
+
+		snapshot.camera = {};
+		if (m_activeCamera)
+		{
+			snapshot.camera.valid = true;
+			snapshot.camera.maxIrradiance = m_activeCamera->GetMaxIrradiance();
+			snapshot.camera.enableDepthOfField = m_activeCamera->GetEnableDepthOfField();
+			snapshot.camera.nearPlane = m_activeCamera->camera->GetNearPlaneDistance();
+			snapshot.camera.farPlane = m_activeCamera->camera->GetFarPlaneDistance();
+			snapshot.camera.focalDistance = m_activeCamera->GetFocalDistance();
+			snapshot.camera.focalDepth = m_activeCamera->GetFocalDepth();
+			snapshot.camera.maxBlurRadius = m_activeCamera->GetMaxBlurRadius();
+			snapshot.camera.dofDebugMode = m_activeCamera->GetDOFDebugMode();
+			snapshot.camera.acesExposure = m_activeCamera->GetACESExposure();
+		}
+
+		snapshot.skybox = m_skyboxTextures[m_currentFrame].get();
+		snapshot.skyboxView = m_skyboxTextureViews[m_currentFrame].get();
+		snapshot.irradianceMap = m_irradianceMaps[m_currentFrame].get();
+		snapshot.irradianceMapView = m_irradianceMapViews[m_currentFrame].get();
+		snapshot.prefilterMap = m_prefilterMaps[m_currentFrame].get();
+		snapshot.prefilterMapView = m_prefilterMapViews[m_currentFrame].get();
+
+		snapshot.models.clear();
+		const float fixedUpdateAlpha{ GetFixedUpdateAlpha() };
+		for (auto&& [modelRenderer, transform] : m_reg.get().View<CModelRenderer, CTransform>())
+		{
+			if (!modelRenderer.visible || !modelRenderer.model) { continue; }
+			snapshot.models.push_back({ modelRenderer.model, transform.ComputeInterpolatedModelMatrix(fixedUpdateAlpha) });
+		}
+
+		ImGui::Render();
+		CaptureImGuiDrawData();
+
+		m_newGPUUploaderUpload = false;
+		m_currentFrame = (m_currentFrame + 1) % m_desc.framesInFlight;
+		++m_globalFrame;
+		m_firstFrame = false;
+
+
+		//Record and submit - either right here, or on the render thread while the main thread gets on with the next frame
+		if (!m_renderThread.joinable())
+		{
+			RecordAndSubmitFrame();
+			return;
+		}
+
+		{
+			const std::lock_guard lock(m_renderThreadMutex);
+			m_renderFramePending = true;
+		}
+		m_renderThreadCondition.notify_all();
+
+		//ImGui's backend creates/updates its textures while rendering, and those are shared with the main thread's ImGui context
+		if (snapshot.imguiTexturesPending) { WaitForRenderThread(); }
+	}
+
+
+
+	void RenderLayer::RecordAndSubmitFrame()
+	{
+		NK_PROFILE_SCOPE("RenderLayer - Record And Submit");
+
+		const RenderSnapshot& snapshot{ m_renderSnapshot };
+		const std::uint32_t frame{ snapshot.frameIndex };
+
+		const std::uint32_t imageIndex{ m_swapchain->AcquireNextImageIndex(m_imageAvailableSemaphores[frame].get(), nullptr) };
 
 		
 		RenderGraphExecutionDesc execDesc{};
-		execDesc.commandBuffers["MODEL_VISIBILITY_PASS"] = m_graphicsCommandBuffers[m_currentFrame].get();
-		execDesc.commandBuffers["MODEL_VISIBILITY_BUFFER_COPY_PASS"] = m_graphicsCommandBuffers[m_currentFrame].get();
-		execDesc.commandBuffers["SHADOW_PASS"] = m_graphicsCommandBuffers[m_currentFrame].get();
-		execDesc.commandBuffers["DEPTH_BARRIER"] = m_graphicsCommandBuffers[m_currentFrame].get();
-		execDesc.commandBuffers["SCENE_PASS"] = m_graphicsCommandBuffers[m_currentFrame].get();
-		if (m_desc.enableMSAA) { execDesc.commandBuffers["MSAA_RESOLVE_PASS"] = m_graphicsCommandBuffers[m_currentFrame].get(); }
-		if (m_desc.enableSSAA) { execDesc.commandBuffers["SSAA_DOWNSAMPLE_PASS"] = m_graphicsCommandBuffers[m_currentFrame].get(); }
-		execDesc.commandBuffers["SUMMED_AREA_TABLE_PASS"] = m_graphicsCommandBuffers[m_currentFrame].get();
-		execDesc.commandBuffers["POSTPROCESS_PASS"] = m_graphicsCommandBuffers[m_currentFrame].get();
-		execDesc.commandBuffers["PRESENT_TRANSITION_PASS"] = m_graphicsCommandBuffers[m_currentFrame].get();
-
-		execDesc.buffers.Set("CAMERA_BUFFER", m_camDataBuffers[m_currentFrame].get());
-		execDesc.buffers.Set("CAMERA_BUFFER_PREVIOUS_FRAME", m_camDataBuffersPreviousFrame[m_currentFrame].get());
+		execDesc.commandBuffers["MODEL_VISIBILITY_PASS"] = m_graphicsCommandBuffers[frame].get();
+		execDesc.commandBuffers["MODEL_VISIBILITY_BUFFER_COPY_PASS"] = m_graphicsCommandBuffers[frame].get();
+		execDesc.commandBuffers["SHADOW_PASS"] = m_graphicsCommandBuffers[frame].get();
+		execDesc.commandBuffers["DEPTH_BARRIER"] = m_graphicsCommandBuffers[frame].get();
+		execDesc.commandBuffers["SCENE_PASS"] = m_graphicsCommandBuffers[frame].get();
+		if (m_desc.enableMSAA) { execDesc.commandBuffers["MSAA_RESOLVE_PASS"] = m_graphicsCommandBuffers[frame].get(); }
+		if (m_desc.enableSSAA) { execDesc.commandBuffers["SSAA_DOWNSAMPLE_PASS"] = m_graphicsCommandBuffers[frame].get(); }
+		execDesc.commandBuffers["SUMMED_AREA_TABLE_PASS"] = m_graphicsCommandBuffers[frame].get();
+		execDesc.commandBuffers["POSTPROCESS_PASS"] = m_graphicsCommandBuffers[frame].get();
+		execDesc.commandBuffers["PRESENT_TRANSITION_PASS"] = m_graphicsCommandBuffers[frame].get();
+
+		execDesc.buffers.Set("CAMERA_BUFFER", m_camDataBuffers[frame].get());
+		execDesc.buffers.Set("CAMERA_BUFFER_PREVIOUS_FRAME", m_camDataBuffersPreviousFrame[frame].get());
 		execDesc.buffers.Set("LIGHT_DATA_BUFFER", m_lightDataBuffer.get());
-		execDesc.buffers.Set("MODEL_MATRICES_BUFFER", m_modelMatricesBuffers[m_currentFrame].get());
-		execDesc.buffers.Set("MODEL_VISIBILITY_DEVICE_BUFFER", m_modelVisibilityDeviceBuffers[m_currentFrame].get());
-		execDesc.buffers.Set("MODEL_VISIBILITY_READBACK_BUFFER", m_modelVisibilityReadbackBuffers[m_currentFrame].get());
+		execDesc.buffers.Set("MODEL_MATRICES_BUFFER", m_modelMatricesBuffers[frame].get());
+		execDesc.buffers.Set("MODEL_VISIBILITY_DEVICE_BUFFER", m_modelVisibilityDeviceBuffers[frame].get());
+		execDesc.buffers.Set("MODEL_VISIBILITY_READBACK_BUFFER", m_modelVisibilityReadbackBuffers[frame].get());
 
 		execDesc.textures.Set("SCENE_COLOUR", m_sceneColour.get());
 		execDesc.textures.Set("SCENE_COLOUR_MSAA", m_sceneColourMSAA.get());
@@ -2559,16 +2675,16 @@ namespace NK
 		execDesc.textures.Set("SAT_FINAL", m_satFinal.get());
 		
 		execDesc.textures.Set("BACKBUFFER", m_swapchain->GetImage(imageIndex));
-		execDesc.textures.Set("SKYBOX", m_skyboxTextures[m_currentFrame].get());
-		execDesc.textures.Set("IRRADIANCE_MAP", m_irradianceMaps[m_currentFrame].get());
-		execDesc.textures.Set("PREFILTER_MAP", m_prefilterMaps[m_currentFrame].get());
+		execDesc.textures.Set("SKYBOX", snapshot.skybox);
+		execDesc.textures.Set("IRRADIANCE_MAP", snapshot.irradianceMap);
+		execDesc.textures.Set("PREFILTER_MAP", snapshot.prefilterMap);
 		execDesc.textures.Set("BRDF_LUT", m_brdfLUT.get());
 
 		execDesc.bufferViews.Set("LIGHT_DATA_BUFFER_VIEW", m_lightDataBufferView.get());
-		execDesc.bufferViews.Set("CAMERA_BUFFER_VIEW", m_camDataBufferViews[m_currentFrame].get());
-		execDesc.bufferViews.Set("CAMERA_BUFFER_PREVIOUS_FRAME_VIEW", m_camDataBufferPreviousFrameViews[m_currentFrame].get());
-		execDesc.bufferViews.Set("MODEL_MATRICES_BUFFER_VIEW", m_modelMatricesBufferViews[m_currentFrame].get());
-		execDesc.bufferViews.Set("MODEL_VISIBILITY_DEVICE_BUFFER_VIEW", m_modelVisibilityDeviceBufferViews[m_currentFrame].get());
+		execDesc.bufferViews.Set("CAMERA_BUFFER_VIEW", m_camDataBufferViews[frame].get());
+		execDesc.bufferViews.Set("CAMERA_BUFFER_PREVIOUS_FRAME_VIEW", m_camDataBufferPreviousFrameViews[frame].get());
+		execDesc.bufferViews.Set("MODEL_MATRICES_BUFFER_VIEW", m_modelMatricesBufferViews[frame].get());
+		execDesc.bufferViews.Set("MODEL_VISIBILITY_DEVICE_BUFFER_VIEW", m_modelVisibilityDeviceBufferViews[frame].get());
 
 		execDesc.textureViews.Set("SCENE_COLOUR_RTV", m_sceneColourRTV.get());
 		execDesc.textureViews.Set("SCENE_COLOUR_SRV", m_sceneColourSRV.get());
@@ -2590,37 +2706,137 @@ namespace NK
 		execDesc.textureViews.Set("SAT_FINAL_SRV", m_satFinalSRV.get());
 		
 		execDesc.textureViews.Set("BACKBUFFER_RTV", m_swapchain->GetImageView(imageIndex));
-		execDesc.textureViews.Set("SKYBOX_VIEW", m_skyboxTextureViews[m_currentFrame].get());
-		execDesc.textureViews.Set("IRRADIANCE_MAP_VIEW", m_irradianceMapViews[m_currentFrame].get());
-		execDesc.textureViews.Set("PREFILTER_MAP_VIEW", m_prefilterMapViews[m_currentFrame].get());
+		execDesc.textureViews.Set("SKYBOX_VIEW", snapshot.skyboxView);
+		execDesc.textureViews.Set("IRRADIANCE_MAP_VIEW", snapshot.irradianceMapView);
+		execDesc.textureViews.Set("PREFILTER_MAP_VIEW", snapshot.prefilterMapView);
 		execDesc.textureViews.Set("BRDF_LUT_VIEW", m_brdfLUTView.get());
 
 		execDesc.samplers.Set("SAMPLER", m_linearSampler.get());
 		execDesc.samplers.Set("BRDF_LUT_SAMPLER", m_linearSampler.get());
 		
-		ImGui::Render();
-		
 		m_meshRenderGraph->Execute(execDesc);
 		
 		
-		m_graphicsCommandBuffers[m_currentFrame]->End();
+		m_graphicsCommandBuffers[frame]->End();
 
-		if (m_newGPUUploaderUpload)
+		if (snapshot.newGPUUploaderUpload)
 		{
 			m_gpuUploaderFlushFence->Wait();
 			m_gpuUploaderFlushFence->Reset();
 			m_gpuUploader->Reset();
-			m_newGPUUploaderUpload = false;
 		}
 
 		//Submit
-		m_graphicsQueue->Submit(m_graphicsCommandBuffers[m_currentFrame].get(), m_imageAvailableSemaphores[m_currentFrame].get(), m_renderFinishedSemaphores[imageIndex].get(), m_inFlightFences[m_currentFrame].get());
+		m_graphicsQueue->Submit(m_graphicsCommandBuffers[frame].get(), m_imageAvailableSemaphores[frame].get(), m_renderFinishedSemaphores[imageIndex].get(), m_inFlightFences[frame].get());
 		m_swapchain->Present(m_renderFinishedSemaphores[imageIndex].get(), imageIndex);
+	}
 
-		m_currentFrame = (m_currentFrame + 1) % m_desc.framesInFlight;
-		++m_globalFrame;
 
-		m_firstFrame = false;
+
+	void RenderLayer::CaptureImGuiDrawData()
+	{
+		ReleaseImGuiDrawData();
+
+		//The draw lists belong to the ImGui context and get rebuilt by the next ImGui::NewFrame(), so take copies
+		const ImDrawData* const drawData{ ImGui::GetDrawData() };
+		ImDrawData& copy{ m_renderSnapshot.imguiDrawData };
+		copy.Valid = drawData->Valid;
+		copy.CmdListsCount = drawData->CmdListsCount;
+		copy.TotalIdxCount = drawData->TotalIdxCount;
+		copy.TotalVtxCount = drawData->TotalVtxCount;
+		copy.DisplayPos = drawData->DisplayPos;
+		copy.DisplaySize = drawData->DisplaySize;
+		copy.FramebufferScale = drawData->FramebufferScale;
+		copy.OwnerViewport = drawData->OwnerViewport;
+		for (const ImDrawList* const list : drawData->CmdLists)
+		{
+			copy.CmdLists.push_back(list->CloneOutput());
+		}
+
+		m_renderSnapshot.imguiTexturesPending = false;
+		if (drawData->Textures)
+		{
+			for (const ImTextureData* const texture : *drawData->Textures)
+			{
+				if (texture->Status != ImTextureStatus_OK)
+				{
+					m_renderSnapshot.imguiTexturesPending = true;
+					break;
+				}
+			}
+		}
+
+		//drawData->Textures is the context's own list, which the next ImGui::NewFrame() can grow (and reallocate) while the render thread is reading it
+		//The backend only needs it when something's pending (and then the main thread waits for the frame, so the textures themselves stay put) - hand over a copy of the list, or nothing
+		m_renderSnapshot.imguiTextures.clear();
+		if (m_renderSnapshot.imguiTexturesPending)
+		{
+			m_renderSnapshot.imguiTextures = *drawData->Textures;
+			copy.Textures = &m_renderSnapshot.imguiTextures;
+		}
+		else
+		{
+			copy.Textures = nullptr;
+		}
+	}
+
+
+
+	void RenderLayer::ReleaseImGuiDrawData()
+	{
+		for (ImDrawList* const list : m_renderSnapshot.imguiDrawData.CmdLists)
+		{
+			IM_DELETE(list);
+		}
+		m_renderSnapshot.imguiDrawData.Clear();
+	}
+
+
+
+	void RenderLayer::RenderThreadLoop()
+	{
+		Profiler::SetThreadName("Render");
+
+		while (true)
+		{
+			{
+				std::unique_lock lock(m_renderThreadMutex);
+				m_renderThreadCondition.wait(lock, [this]() { return m_renderFramePending || m_renderThreadShutdown; });
+				if (!m_renderFramePending) { return; }
+			}
+
+			try
+			{
+				RecordAndSubmitFrame();
+			}
+			catch (...)
+			{
+				//Handed back to the main thread by WaitForRenderThread()
+				const std::lock_guard lock(m_renderThreadMutex);
+				if (!m_renderThreadException) { m_renderThreadException = std::current_exception(); }
+			}
+
+			{
+				const std::lock_guard lock(m_renderThreadMutex);
+				m_renderFramePending = false;
+			}
+			m_renderThreadCondition.notify_all();
+		}
+	}
+
+
+
+	void RenderLayer::WaitForRenderThread()
+	{
+		if (!m_renderThread.joinable()) { return; }
+
+		std::unique_lock lock(m_renderThreadMutex);
+		m_renderThreadCondition.wait(lock, [this]() { return !m_renderFramePending; });
+		if (m_renderThreadException)
+		{
+			const std::exception_ptr exception{ std::exchange(m_renderThreadException, nullptr) };
+			std::rethrow_exception(exception);
+		}
 	}
 
 
@@ -2710,6 +2926,7 @@ namespace NK
 		
 		std::size_t sizeBefore{ m_cpuLightData.size() };
 		m_cpuLightData.clear();
+		m_renderSnapshot.shadowCasters.clear();
 		
 		for (auto&& [transform, light] : m_reg.get().View<CTransform, CLight>())
 		{
@@ -2802,6 +3019,25 @@ namespace NK
 			}
 			}
 
+			//Shadow map pointers are taken now - the vectors they live in get shuffled around by OnComponentRemove(), which can run while the frame is being recorded
+			RenderSnapshot::ShadowCaster caster{};
+			caster.lightData = shaderData;
+			const std::size_t shadowMapVectorIndex{ light.light->GetShadowMapVectorIndex() };
+			if (light.GetLightType() == LIGHT_TYPE::POINT)
+			{
+				caster.shadowMap = m_shadowMapsCube[shadowMapVectorIndex].get();
+				for (std::size_t faceIndex{ 0 }; faceIndex < 6; ++faceIndex)
+				{
+					caster.shadowMapCubeFaceDSVs[faceIndex] = m_shadowMapCube_FaceDSVs[shadowMapVectorIndex][faceIndex].get();
+				}
+			}
+			else
+			{
+				caster.shadowMap = m_shadowMaps2D[shadowMapVectorIndex].get();
+				caster.shadowMap2DDSV = m_shadowMap2DDSVs[shadowMapVectorIndex].get();
+			}
+			m_renderSnapshot.shadowCasters.push_back(caster);
+
 			transform.lightBufferDirty = false;
 			light.light->SetDirty(false);
 			m_cpuLightData.push_back(std::move(shaderData));
@@ -2826,6 +3062,7 @@ namespace NK
 		m_modelMatrices.clear();
 		m_modelMatricesEntitiesLookups[m_currentFrame].clear();
 
+		const float fixedUpdateAlpha{ GetFixedUpdateAlpha() };
 		for (auto&& [transform, model] : m_reg.get().View<CTransform, CModelRenderer>())
 		{
 			if (model.visibilityIndex == 0xFFFFFFFF)
@@ -2843,7 +3080,7 @@ namespace NK
 			}
 
 			constexpr float scaleBuffer{ 1.05f }; //Used as a scalar multiplier to the AABB's scale so that it's a bit larger than the model (eliminates z-fighting issues)
-			const glm::mat4 aabbMatrix{ transform.GetModelMatrix() * glm::translate(glm::mat4(1.0f), model.localSpaceOrigin) * glm::scale(glm::mat4(1.0f), model.localSpaceHalfExtents * 2.0f * scaleBuffer) };
+			const glm::mat4 aabbMatrix{ transform.ComputeInterpolatedModelMatrix(fixedUpdateAlpha) * glm::translate(glm::mat4(1.0f), model.localSpaceOrigin) * glm::scale(glm::mat4(1.0f), model.localSpaceHalfExtents * 2.0f * scaleBuffer) };
 			
 			ModelMatrixShaderData data{};
 			data.modelMatrix = aabbMatrix;
@@ -2859,6 +3096,15 @@ namespace NK
 	
 	
 	
+	float RenderLayer::GetFixedUpdateAlpha()
+	{
+		//Without a scheduler (i.e. not being run by an Engine) there's nothing to interpolate between - 1 is just the current state
+		const FixedStepScheduler* scheduler{ Context::GetFixedStepScheduler() };
+		return (scheduler ? scheduler->GetAlpha() : 1.0f);
+	}
+	
+	
+	
 	glm::mat4 RenderLayer::GetPointLightViewMatrix(const glm::vec3& _lightPos, const std::size_t _faceIndex)
 	{
 		//Standard cubemap face order: +X, -X, +Y, -Y, +Z, -Z
@@ -2990,6 +3236,7 @@ namespace NK
 	
 	void RenderLayer::OnSceneLoad(const SceneLoadEvent& _event)
 	{
+		WaitForRenderThread();
 		m_graphicsQueue->WaitIdle();
 		m_gpuModelReferenceCounter.clear();
 		m_textureDeletionQueue.clear();
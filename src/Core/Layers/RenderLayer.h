@@ -15,6 +15,12 @@
 #include <RHI/IDevice.h>
 #include <Types/NekiTypes.h>
 
+#include <array>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <imgui.h>
 #include <ImGuizmo.h>
 
 
@@ -42,6 +48,10 @@ namespace NK
 
 		std::uint32_t maxModels{ 10'000 };
 		std::uint32_t maxLights{ 16 };
+
+		//Record and submit each frame on a dedicated render thread, so frame N is recorded while the main thread simulates frame N+1
+		//Off by default - everything the render thread needs is extracted into a snapshot either way, so turning it on doesn't change what's drawn, only when
+		bool enableRenderThread{ false };
 	};
 
 
@@ -52,6 +62,9 @@ namespace NK
 		virtual ~RenderLayer() override;
 
 		virtual void Update() override;
+		//Talks to glfw and the graphics api, and reads most components - main thread only and exclusive
+		[[nodiscard]] inline virtual LayerAccess GetAccess(const LAYER_PHASE _phase) const override { return (IsFixedUpdatePhase(_phase) ? LayerAccess{} : LayerAccess::Exclusive()); }
+		[[nodiscard]] inline virtual const char* GetName() const override { return "Render Layer"; }
 		void SetRegistry(Registry& _reg) override;
 
 
@@ -85,7 +98,13 @@ namespace NK
 		void UpdateImGui(const CCamera& _camera);
 		void DrawImGuiHierarchy(CTransform& _transform); //Draw the entire hierarchy for a single entity (its node and all of its children's nodes)
 		void DrawImGuiHierarchyNode(CTransform& _transform); //Draw the node for a single entity in a hierarchy
-		void PostAppUpdate();
+		void PostAppUpdate(); //Extraction - everything that touches the registry, ending in a RenderSnapshot that's handed to RecordAndSubmitFrame()
+		void RecordAndSubmitFrame(); //Records, submits and presents m_renderSnapshot - on the render thread if it's enabled
+		void CaptureImGuiDrawData();
+		void ReleaseImGuiDrawData();
+
+		void RenderThreadLoop();
+		void WaitForRenderThread(); //Blocks until the render thread has finished its current frame (no-op without a render thread), rethrowing anything it threw
 
 		void UpdateSkybox(CSkybox& _skybox);
 		void UpdateCameraBuffer(const CCamera& _camera) const;
@@ -93,6 +112,7 @@ namespace NK
 		void UpdateModelMatricesBuffer();
 
 		static glm::mat4 GetPointLightViewMatrix(const glm::vec3& _lightPos, const std::size_t _faceIndex);
+		[[nodiscard]] static float GetFixedUpdateAlpha(); //How far between the last two fixed updates to draw transforms (see CTransform::ComputeInterpolatedModelMatrix())
 		
 		void OnEntityDestroy(const EntityDestroyEvent& _event);
 		void OnComponentRemove(const ComponentRemoveEvent& _event);
@@ -157,6 +177,73 @@ namespace NK
 			float padding[3];
 		};
 		std::vector<LightShaderData> m_cpuLightData;
+
+		//Everything the render graph needs to record a frame, copied out of the registry by PostAppUpdate() so recording never touches components
+		//The main thread waits for the render thread to finish with the snapshot before extracting the next one, so a single snapshot is enough
+		struct RenderSnapshot
+		{
+			struct ModelDraw
+			{
+				const GPUModel* model;
+				glm::mat4 modelMatrix;
+			};
+
+			struct ShadowCaster
+			{
+				LightShaderData lightData;
+				ITexture* shadowMap;
+				ITextureView* shadowMap2DDSV; //Directional and spot lights
+				std::array<ITextureView*, 6> shadowMapCubeFaceDSVs; //Point lights
+			};
+
+			//Only what the passes read from the active camera
+			struct CameraData
+			{
+				bool valid;
+				float maxIrradiance;
+				bool enableDepthOfField;
+				float nearPlane;
+				float farPlane;
+				float focalDistance;
+				float focalDepth;
+				float maxBlurRadius;
+				bool dofDebugMode;
+				float acesExposure;
+			};
+
+			std::uint32_t frameIndex;
+			bool firstFrame;
+			bool newGPUUploaderUpload;
+			glm::ivec2 framebufferSize;
+			std::size_t modelMatrixCount;
+			std::uint32_t lightCount;
+			CameraData camera;
+			std::vector<ModelDraw> models;
+			std::vector<ShadowCaster> shadowCasters;
+
+			//Raw pointers since OnComponentRemove(CSkybox) can move the owning pointers into a deletion bucket mid-frame (the resources themselves outlive the frame)
+			ITexture* skybox;
+			ITextureView* skyboxView;
+			ITexture* irradianceMap;
+			ITextureView* irradianceMapView;
+			ITexture* prefilterMap;
+			ITextureView* prefilterMapView;
+
+			//Deep copy of ImGui's draw data - the main thread starts on the next ImGui frame while this one is being recorded
+			ImDrawData imguiDrawData;
+			ImVector<ImTextureData*> imguiTextures; //What imguiDrawData.Textures points at, if anything
+			bool imguiTexturesPending; //ImGui wants a texture created or updated - the backend does that while rendering, so the main thread has to wait for the frame to be recorded
+		};
+		RenderSnapshot m_renderSnapshot;
+
+		//Render thread - hands off through m_renderFramePending, same as BinaryLogger's worker
+		std::thread m_renderThread;
+		std::mutex m_renderThreadMutex;
+		std::condition_variable m_renderThreadCondition;
+		bool m_renderFramePending{ false };
+		bool m_renderThreadShutdown{ false };
+		std::exception_ptr m_renderThreadException;
+
 		UniquePtr<IBuffer> m_lightDataBuffer;
 		UniquePtr<IBufferView> m_lightDataBufferView; //SRV
 		void* m_lightDataBufferMap;
@@ -386,6 +473,7 @@ namespace NK
 		bool m_showInspector{ true };
 		bool m_showGizmoSettings{ true };
 		bool m_showEditorSettings{ true };
+		bool m_showProfiler{ true };
 		
 		//By default, Neki is currently only set up to stream from RAM to VRAM and vice versa. Eventually, I will get around to making a proper streaming system from disk to vram (wip on 'streaming' git branch)
 		//For now though, full disk->ram->vram and vice versa streaming can be enabled with this flag, though there is no ram caching or threading, so it results in large stutters that are painfully slow. Enable at your own risk!
@@ -1,20 +1,32 @@
 #include "ServerNetworkLayer.h"
 
 #include <Components/CInput.h>
+#include <Components/CNetworkSync.h>
 #include <Components/CTransform.h>
+#include <Core/Debug/Profiler.h>
+#include <Core/Replay/Replay.h>
 #include <Core/Utils/Timer.h>
+#include <Managers/TimeManager.h>
+#include <Networking/NetworkInputCodec.h>
+#include <Networking/PacketHeader.h>
 
-#include <cereal/archives/binary.hpp>
+#include <algorithm>
+#include <iterator>
+#include <limits>
 
 
 namespace NK
 {
 
 	ServerNetworkLayer::ServerNetworkLayer(Registry& _reg, const ServerNetworkLayerDesc& _desc)
-	: ILayer(_reg), m_desc(_desc), m_state(SERVER_STATE::NOT_HOSTING), m_clientIndexAllocator(NK_NEW(FreeListAllocator, m_desc.maxClients))
+	: ILayer(_reg), m_desc(_desc), m_state(SERVER_STATE::NOT_HOSTING), m_ioThreadDroppedReceives(0), m_ioThreadFailedSends(0), m_clientIndexAllocator(NK_NEW(FreeListAllocator, m_desc.maxClients)), m_nextSnapshotSequence(0), m_fragmenter(m_desc.maxDatagramSize), m_interestGrid(m_desc.interestCellSize), m_networkEventHandler(nullptr)
 	{
 		m_logger.Indent();
 		m_logger.Log(LOGGER_CHANNEL::HEADING, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Initialising Server Network Layer\n");
+		
+		NetworkTransformCodec::ValidateQuantisation(m_desc.transformQuantisation);
+		for (NetworkTransformSnapshot& snapshot : m_transformSnapshots) { snapshot.sequence = NetworkTransformCodec::NO_SNAPSHOT; }
+		
 		m_logger.Unindent();
 	}
 
@@ -37,6 +49,20 @@ namespace NK
 
 
 
+	LayerAccess ServerNetworkLayer::GetAccess(const LAYER_PHASE _phase) const
+	{
+		switch (_phase)
+		{
+		//Accepts connections, applies client input and triggers events - keep it exclusive
+		case LAYER_PHASE::PRE_APP_UPDATE:	return LayerAccess::Exclusive();
+		//Only reads transforms and sends them out, so it can overlap with e.g. ModelVisibilityLayer
+		case LAYER_PHASE::POST_APP_UPDATE:	return LayerAccess{}.Read<CTransform>().Read<CNetworkSync>();
+		default:							return {};
+		}
+	}
+
+
+
 	NETWORK_LAYER_ERROR_CODE ServerNetworkLayer::Host(const unsigned short _port)
 	{
 		m_logger.Indent();
@@ -48,6 +74,15 @@ namespace NK
 			return NETWORK_LAYER_ERROR_CODE::SERVER__HOST_CALLED_ON_HOSTING_SERVER;
 		}
 
+		if (Replay::IsPlaying())
+		{
+			//Client packets are coming from the recording instead
+			m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Replay is being played back - not binding any sockets, client packets will come from the recording\n");
+			m_nextClientIndex = m_clientIndexAllocator->Allocate();
+			m_logger.Unindent();
+			return NETWORK_LAYER_ERROR_CODE::SUCCESS;
+		}
+
 		m_address = (m_desc.type == SERVER_TYPE::LAN ? sf::IpAddress::getLocalAddress() : sf::IpAddress::getPublicAddress());
 		m_port = _port;
 
@@ -73,6 +108,12 @@ namespace NK
 		}
 		m_logger.IndentLog(LOGGER_CHANNEL::SUCCESS, LOGGER_LAYER::SERVER_NETWORK_LAYER, "TCP listener successfully bound to port\n");
 		m_tcpListener.setBlocking(false);
+		if (!m_tcpPoller.Add(m_tcpListener, LISTENER_POLL_ID))
+		{
+			m_logger.IndentLog(LOGGER_CHANNEL::ERROR, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Failed to add TCP listener to m_tcpPoller\n");
+			m_logger.Unindent();
+			return NETWORK_LAYER_ERROR_CODE::SERVER__FAILED_TO_POLL_TCP_LISTENER;
+		}
 
 		
 		//Assign UDP socket to port
@@ -92,7 +133,7 @@ namespace NK
 			timer.Update();
 		}
 		m_logger.IndentLog(LOGGER_CHANNEL::SUCCESS, LOGGER_LAYER::SERVER_NETWORK_LAYER, "UDP socket successfully bound to port\n");
-		m_udpSocket.setBlocking(false);
+		m_ioThread = UniquePtr<NetworkIOThread>(NK_NEW(NetworkIOThread, m_udpSocket, m_desc.ioQueueCapacity));
 
 		m_logger.IndentLog(LOGGER_CHANNEL::SUCCESS, LOGGER_LAYER::SERVER_NETWORK_LAYER, std::string(m_desc.type == SERVER_TYPE::LAN ? "LAN" : "WAN") + " server set up on " + m_address.value().toString() + ":" + std::to_string(m_port) + "\n");
 
@@ -104,18 +145,42 @@ namespace NK
 
 
 
+	bool ServerNetworkLayer::PollTCPSockets()
+	{
+		NK_PROFILE_SCOPE("ServerNetworkLayer - TCP Poll");
+
+		//One call for every socket, however many clients there are - rather than a receive() on each of them to find out most have nothing
+		if (Replay::IsPlaying())
+		{
+			m_readyTCPSockets.clear();
+			return false;
+		}
+		m_tcpPoller.Wait(sf::Time::Zero, m_readyTCPSockets);
+
+		const std::vector<std::uint64_t>::iterator listener{ std::ranges::find(m_readyTCPSockets, LISTENER_POLL_ID) };
+		if (listener == m_readyTCPSockets.end()) { return false; }
+		*listener = m_readyTCPSockets.back();
+		m_readyTCPSockets.pop_back();
+		return true;
+	}
+
+
+
 	NETWORK_LAYER_ERROR_CODE ServerNetworkLayer::CheckForIncomingConnectionRequests()
 	{
-		//Create a temporary socket to accept the new connection
-		sf::TcpSocket socket;
-		socket.setBlocking(false);
-		if (m_tcpListener.accept(socket) == sf::Socket::Status::Done)
+		//Let in everyone that's waiting (up to m_desc.maxConnectionsPerTick) rather than one a tick, so a wave of clients joining doesn't queue up behind each other for seconds
+		for (std::uint32_t accepted{ 0 }; accepted < m_desc.maxConnectionsPerTick && m_nextClientIndex != FreeListAllocator::INVALID_INDEX; ++accepted)
 		{
-			m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Client (address: " + socket.getRemoteAddress()->toString() + ":" + std::to_string(socket.getRemotePort()) + ") connected to the server.\n");
+			//Create a temporary socket to accept the new connection
+			sf::TcpSocket socket;
+			socket.setBlocking(false);
+			if (m_tcpListener.accept(socket) != sf::Socket::Status::Done) { break; }
+
+			NK_INDENT_LOGF(m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Client (address: {}:{}) connected to the server.\n", socket.getRemoteAddress()->toString(), socket.getRemotePort());
 
 			//Connection was successful, add to maps
 			m_connectedClientTCPSockets[m_nextClientIndex] = std::move(socket);
-			const UniqueAddress address{ m_connectedClientTCPSockets[m_nextClientIndex].getRemoteAddress()->toString(), m_connectedClientTCPSockets[m_nextClientIndex].getRemotePort() };
+			const NetworkEndpoint address{ m_connectedClientTCPSockets[m_nextClientIndex].getRemoteAddress().value(), m_connectedClientTCPSockets[m_nextClientIndex].getRemotePort() };
 			m_connectedClientTCPAddresses[m_nextClientIndex] = address;
 			m_rev_connectedClientTCPAddresses[address] = m_nextClientIndex;
 			
@@ -129,6 +194,12 @@ namespace NK
 				return NETWORK_LAYER_ERROR_CODE::SERVER__FAILED_TO_SEND_CLIENT_INDEX_PACKET;
 			}
 
+			if (!m_tcpPoller.Add(m_connectedClientTCPSockets[m_nextClientIndex], m_nextClientIndex))
+			{
+				m_logger.IndentLog(LOGGER_CHANNEL::ERROR, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Failed to add client's TCP socket to m_tcpPoller - disconnecting them\n");
+				DisconnectClient(m_nextClientIndex);
+			}
+
 			m_nextClientIndex = m_clientIndexAllocator->Allocate();
 		}
 		
@@ -140,6 +211,8 @@ namespace NK
 
 	NETWORK_LAYER_ERROR_CODE ServerNetworkLayer::CheckForIncomingTCPData()
 	{
+		NK_PROFILE_SCOPE("ServerNetworkLayer - TCP Receive");
+
 		//In the event of an error, store error code in err rather than returning immediately
 		//^Returning immediately could lead to, for example, a client whom was able to repeatedly flood the server with error packets being able to stop data for subsequent client being received
 		NETWORK_LAYER_ERROR_CODE err{ NETWORK_LAYER_ERROR_CODE::SUCCESS };
@@ -150,26 +223,42 @@ namespace NK
 
 		
 		//Gather packets
-		//Loop through all connected TCP sockets to see if data is being received
+		//Only from the TCP sockets PollTCPSockets() found something waiting on
 		std::unordered_map<ClientIndex, std::vector<sf::Packet>> clientPackets;
-		for (std::unordered_map<ClientIndex, sf::TcpSocket>::iterator it{ m_connectedClientTCPSockets.begin() }; it != m_connectedClientTCPSockets.end(); ++it)
-		{			
-			const ClientIndex& index{ it->first };
+		for (std::pair<ClientIndex, sf::Packet>& packet : Replay::GetPackets(REPLAY_PACKET_CHANNEL::SERVER_TCP))
+		{
+			clientPackets[packet.first].push_back(std::move(packet.second));
+		}
+		std::vector<ClientIndex> hungUp; //Closed the connection without a DISCONNECT - let whatever they sent before that be processed first
+		for (const std::uint64_t id : m_readyTCPSockets)
+		{
+			const ClientIndex index{ static_cast<ClientIndex>(id) };
+			const std::unordered_map<ClientIndex, sf::TcpSocket>::iterator it{ m_connectedClientTCPSockets.find(index) };
+			if (it == m_connectedClientTCPSockets.end()) { continue; }
 			
 			sf::Packet incomingData;
-			while (it->second.receive(incomingData) == sf::Socket::Status::Done)
+			sf::Socket::Status status;
+			while ((status = it->second.receive(incomingData)) == sf::Socket::Status::Done)
 			{
 				clientPackets[index].push_back(incomingData);
 
 				//Ensure client hasn't sent more TCP packets this tick than is allowed
 				if (clientPackets[index].size() > m_desc.maxTCPPacketsPerClientPerTick)
 				{
-					m_logger.IndentLog(LOGGER_CHANNEL::WARNING, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Client (index = " + std::to_string(index) + ", address = " + it->second.getRemoteAddress()->toString() + ":" + std::to_string(it->second.getRemotePort()) + ") attempted to send " + std::to_string(clientPackets[index].size()) + " TCP packets this tick - this exceeds the limit set in m_desc.maxTCPPacketsPerClientPerTick (" + std::to_string(m_desc.maxTCPPacketsPerClientPerTick) + ") - disconnecting them\n");
-					it = DisconnectClient(index);
+					NK_INDENT_LOGF(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Client (index = {}, address = {}:{}) attempted to send {} TCP packets this tick - this exceeds the limit set in m_desc.maxTCPPacketsPerClientPerTick ({}) - disconnecting them\n", index, it->second.getRemoteAddress()->toString(), it->second.getRemotePort(), clientPackets[index].size(), m_desc.maxTCPPacketsPerClientPerTick);
+					DisconnectClient(index);
 					clientPackets.erase(index);
 					break;
 				}
 			}
+			//A closed socket is always ready, so it'd come back every tick until it's gone
+			if (status == sf::Socket::Status::Disconnected || status == sf::Socket::Status::Error) { hungUp.push_back(index); }
+		}
+
+		//Recorded once the packets of clients that went over the limit have been thrown away, so a replay processes exactly what was processed here
+		for (const std::pair<const ClientIndex, std::vector<sf::Packet>>& packets : clientPackets)
+		{
+			for (const sf::Packet& packet : packets.second) { Replay::RecordPacket(REPLAY_PACKET_CHANNEL::SERVER_TCP, packets.first, packet); }
 		}
 
 		
@@ -187,20 +276,14 @@ namespace NK
 				{
 				case PACKET_CODE::DISCONNECT:
 				{
-					m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Packet received: DISCONNECT\n");
+					NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Packet received: DISCONNECT\n");
 					DisconnectClient(it->first);
 					clientDisconnect = true;
 					break;
 				}
-				case PACKET_CODE::EVENT:
-				{
-					m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Packet received: EVENT\n");
-					m_tcpEventHandler->HandleEvent(packet);
-					break;
-				}
 				default:
 				{
-					m_logger.IndentLog(LOGGER_CHANNEL::WARNING, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Client sent invalid packet code - code = " + std::to_string(underlyingPacketCode) + " - disconnecting them\n");
+					NK_INDENT_LOGF(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Client sent invalid packet code - code = {} - disconnecting them\n", underlyingPacketCode);
 					DisconnectClient(it->first);
 					clientDisconnect = true;
 					break;
@@ -215,6 +298,13 @@ namespace NK
 			}
 		}
 
+		for (const ClientIndex index : hungUp)
+		{
+			if (!m_connectedClientTCPSockets.contains(index)) { continue; } //Their DISCONNECT got there first
+			NK_INDENT_LOGF(m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Client {} closed their connection - disconnecting them\n", index);
+			DisconnectClient(index);
+		}
+
 
 		return err;
 	}
@@ -223,6 +313,8 @@ namespace NK
 
 	NETWORK_LAYER_ERROR_CODE ServerNetworkLayer::CheckForIncomingUDPData()
 	{
+		NK_PROFILE_SCOPE("ServerNetworkLayer - UDP Receive");
+
 		//In the event of an error, store error code in err rather than returning immediately
 		//^Returning immediately could lead to, for example, a client whom was able to repeatedly flood the server with error packets being able to stop data for subsequent client being received
 		NETWORK_LAYER_ERROR_CODE err{ NETWORK_LAYER_ERROR_CODE::SUCCESS };
@@ -230,82 +322,186 @@ namespace NK
 		
 		//Split up the gathering of packets which is very fast from the processing of packets which might be (relatively) much slower
 		//This stops the server getting stuck in an infinite loop if packets are being sent faster than they can be processed
-		std::unordered_map<ClientIndex, std::vector<sf::Packet>> clientPackets;
+		//The socket itself is drained by the network thread (see NetworkIOThread) - this just picks up what it's received since last tick
+		std::unordered_map<ClientIndex, std::vector<std::pair<sf::Packet, double>>> clientPackets; //Client index -> packets and when they arrived
 
 		
 		//Gather packets
-		sf::Packet incomingData;
-		std::optional<sf::IpAddress> incomingClientIP;
-		unsigned short incomingClientPort;
-		m_udpSocket.setBlocking(false);
-		while (m_udpSocket.receive(incomingData, incomingClientIP, incomingClientPort) == sf::Socket::Status::Done)
-		{
-			sf::Packet packetCopy{ incomingData };
-			std::underlying_type_t<PACKET_CODE> codeValue;
-			packetCopy >> codeValue;
-			const PACKET_CODE code{ static_cast<PACKET_CODE>(codeValue) };
-			if (code == PACKET_CODE::UDP_PORT)
+		for (std::pair<ClientIndex, sf::Packet>& packet : Replay::GetPackets(REPLAY_PACKET_CHANNEL::SERVER_UDP))
+		{
+			clientPackets[packet.first].emplace_back(std::move(packet.second), TimeManager::GetTotalTime());
+		}
+		if (m_ioThread)
+		{
+			m_ioThread->Receive([&](const NetworkDatagram& _datagram)
 			{
-				ClientIndex index;
-				packetCopy >> index;
-				if (m_connectedClientTCPSockets.contains(index))
+				sf::Packet incomingData;
+				incomingData.append(_datagram.data.data(), _datagram.data.size());
+				sf::Packet packetCopy{ incomingData };
+				std::underlying_type_t<PACKET_CODE> codeValue;
+				packetCopy >> codeValue;
+				const PACKET_CODE code{ static_cast<PACKET_CODE>(codeValue) };
+				if (code == PACKET_CODE::UDP_PORT)
 				{
-					m_connectedClientUDPAddresses[index] = { incomingClientIP->toString(), incomingClientPort };
-					m_rev_connectedClientUDPAddresses[m_connectedClientUDPAddresses[index]] = index;
-					m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Registered UDP endpoint for client " + std::to_string(index) + " (address: " + incomingClientIP->toString() + ":" + std::to_string(incomingClientPort) + '\n');
+					ClientIndex index;
+					packetCopy >> index;
+					if (m_connectedClientTCPSockets.contains(index))
+					{
+						//Re-registering (e.g. their NAT mapping changed) - drop the old endpoint's reverse entry, or datagrams from it would still be taken as this client's
+						const std::unordered_map<ClientIndex, NetworkEndpoint>::const_iterator previous{ m_connectedClientUDPAddresses.find(index) };
+						if (previous != m_connectedClientUDPAddresses.end())
+						{
+							const std::unordered_map<NetworkEndpoint, ClientIndex>::const_iterator previousClient{ m_rev_connectedClientUDPAddresses.find(previous->second) };
+							if (previousClient != m_rev_connectedClientUDPAddresses.end() && previousClient->second == index) { m_rev_connectedClientUDPAddresses.erase(previousClient); }
+						}
+						m_connectedClientUDPAddresses[index] = _datagram.endpoint;
+						m_rev_connectedClientUDPAddresses[m_connectedClientUDPAddresses[index]] = index;
+						m_clientAckedSnapshots.erase(index); //Start them off with a full snapshot
+						m_clientReplication.erase(index); //And everything in range as newly entered
+						m_connections.erase(index); //And a fresh connection, like theirs
+						NK_INDENT_LOGF(m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Registered UDP endpoint for client {} (address: {}:{})\n", index, _datagram.endpoint.GetAddress().toString(), _datagram.endpoint.GetPort());
+					}
 				}
-			}
-			else
-			{
-				if (!m_rev_connectedClientUDPAddresses.contains({ incomingClientIP->toString(), incomingClientPort }))
+				else
 				{
-					continue;
+					const std::unordered_map<NetworkEndpoint, ClientIndex>::const_iterator client{ m_rev_connectedClientUDPAddresses.find(_datagram.endpoint) };
+					if (client == m_rev_connectedClientUDPAddresses.end())
+					{
+						return;
+					}
+					const ClientIndex index{ client->second };
+					Replay::RecordPacket(REPLAY_PACKET_CHANNEL::SERVER_UDP, index, incomingData);
+					clientPackets[index].emplace_back(std::move(incomingData), _datagram.time);
 				}
-				ClientIndex index{ m_rev_connectedClientUDPAddresses.at({ incomingClientIP->toString(), incomingClientPort }) };
-				clientPackets[index].push_back(std::move(incomingData));
+			});
+
+			const std::size_t droppedReceives{ m_ioThread->GetDroppedReceiveCount() };
+			if (droppedReceives != m_ioThreadDroppedReceives)
+			{
+				NK_INDENT_LOGF(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Network thread dropped {} incoming UDP packet(s) - more arrived in one tick than m_desc.ioQueueCapacity ({})\n", droppedReceives - m_ioThreadDroppedReceives, m_desc.ioQueueCapacity);
+				m_ioThreadDroppedReceives = droppedReceives;
+			}
+			const std::size_t failedSends{ m_ioThread->GetFailedSendCount() };
+			if (failedSends != m_ioThreadFailedSends)
+			{
+				NK_INDENT_LOGF(m_logger, LOGGER_CHANNEL::ERROR, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Network thread failed to send {} UDP packet(s)\n", failedSends - m_ioThreadFailedSends);
+				m_ioThreadFailedSends = failedSends;
 			}
 		}
 		
 		
 		//Process packets
-		for (std::unordered_map<ClientIndex, std::vector<sf::Packet>>::iterator it{ clientPackets.begin() }; it != clientPackets.end(); ++it)
+		for (std::pair<const ClientIndex, std::vector<std::pair<sf::Packet, double>>>& packets : clientPackets)
 		{
-			//So that we don't process anymore of a client's packets after they're disconnected
-			bool clientDisconnect{ false };
-
-			for (sf::Packet& packet : it->second)
+			for (std::pair<sf::Packet, double>& packet : packets.second)
 			{
-				std::underlying_type_t<PACKET_CODE> underlyingPacketCode;
-				packet >> underlyingPacketCode;
-				const PACKET_CODE code{ underlyingPacketCode };
+				//If the client has been disconnected (or an attempt has been made to disconnect the client), don't process any of their other packets for this tick
+				if (!ProcessUDPPacket(packets.first, packet.first, packet.second, false)) { break; }
+			}
+		}
 
-				switch (code)
-				{
-				case PACKET_CODE::INPUT:
-				{
-					m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::SERVER_NETWORK_LAYER, std::to_string(it->first) + ": Packet received: INPUT\n");
-					DecodeAndApplyInput(packet);
-					break;
-				}
-				default:
-				{
-					m_logger.IndentLog(LOGGER_CHANNEL::WARNING, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Client sent invalid packet code - code = " + std::to_string(underlyingPacketCode) + " - disconnecting them\n");
-					DisconnectClient(it->first);
-					clientDisconnect = true;
-					break;
-				}
-				}
+
+		return err;
+	}
+
+
+
+	bool ServerNetworkLayer::ProcessUDPPacket(const ClientIndex _index, sf::Packet& _packet, const double _receiveTime, const bool _inMessages)
+	{
+		std::underlying_type_t<PACKET_CODE> underlyingPacketCode;
+		_packet >> underlyingPacketCode;
+		const PACKET_CODE code{ underlyingPacketCode };
+
+		switch (code)
+		{
+		case PACKET_CODE::INPUT:
+		{
+			NK_INDENT_LOGF(m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::SERVER_NETWORK_LAYER, "{}: Packet received: INPUT\n", _index);
+			BitReader reader{ static_cast<const std::uint8_t*>(_packet.getData()) + _packet.getReadPosition(), _packet.getDataSize() - _packet.getReadPosition() };
+			if (!NetworkInputCodec::Decode(reader, m_reg.get()))
+			{
+				NK_INDENT_LOGF(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::SERVER_NETWORK_LAYER, "{}: Received a malformed input packet\n", _index);
 			}
-			
-			//If the client has been disconnected (or an attempt has been made to disconnect the client), don't process any of their other packets for this tick
-			if (clientDisconnect)
+			return true;
+		}
+		case PACKET_CODE::SNAPSHOT_ACK:
+		{
+			std::uint32_t sequence;
+			_packet >> sequence;
+			//Acks can arrive out of order or be made up - only ever move forward, and only to snapshots that have actually been sent
+			if (!_packet || sequence >= m_nextSnapshotSequence) { return true; }
+			const std::unordered_map<ClientIndex, std::uint32_t>::iterator ack{ m_clientAckedSnapshots.find(_index) };
+			if (ack == m_clientAckedSnapshots.end()) { m_clientAckedSnapshots[_index] = sequence; }
+			else { ack->second = std::max(ack->second, sequence); }
+			return true;
+		}
+		case PACKET_CODE::MESSAGES:
+		{
+			if (_inMessages) { break; }
+			const std::uint8_t* data{ static_cast<const std::uint8_t*>(_packet.getData()) + _packet.getReadPosition() };
+			const std::size_t size{ _packet.getDataSize() - _packet.getReadPosition() };
+			NetworkConnection& connection{ GetConnection(_index) };
+			const std::size_t messagesSize{ connection.Read(data, size, _receiveTime) }; //Arrival time rather than now, so a long frame doesn't inflate the round trip time
+			if (!messagesSize)
 			{
-				it = clientPackets.erase(it);
+				NK_INDENT_LOGF(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::SERVER_NETWORK_LAYER, "{}: Received a malformed messages packet\n", _index);
+				return true;
 			}
+
+			//Disconnecting them would take the connection out from under PopReceived() - wait until it's done
+			bool valid{ true };
+			connection.PopReceived([&](const NETWORK_CHANNEL, const std::uint8_t* _data, const std::size_t _size) { valid = valid && ProcessMessage(_index, _data, _size); });
+			if (!valid)
+			{
+				NK_INDENT_LOGF(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Client {} sent an invalid message - disconnecting them\n", _index);
+				DisconnectClient(_index);
+				return false;
+			}
+
+			//Then whatever it's carrying
+			if (messagesSize == size) { return true; }
+			m_innerPacket.clear();
+			m_innerPacket.append(data + messagesSize, size - messagesSize);
+			return ProcessUDPPacket(_index, m_innerPacket, _receiveTime, true);
+		}
+		default:
+		{
+			break;
+		}
 		}
 
+		NK_INDENT_LOGF(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Client sent invalid packet code - code = {} - disconnecting them\n", underlyingPacketCode);
+		DisconnectClient(_index);
+		return false;
+	}
 
-		return err;
+
+
+	bool ServerNetworkLayer::ProcessMessage(const ClientIndex _index, const std::uint8_t* _data, const std::size_t _size)
+	{
+		m_messagePacket.clear();
+		m_messagePacket.append(_data, _size);
+		std::underlying_type_t<PACKET_CODE> underlyingPacketCode;
+		m_messagePacket >> underlyingPacketCode;
+
+		switch (static_cast<PACKET_CODE>(underlyingPacketCode))
+		{
+		case PACKET_CODE::EVENT:
+		{
+			NK_INDENT_LOGF(m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::SERVER_NETWORK_LAYER, "{}: Message received: EVENT\n", _index);
+			if (!m_networkEventHandler)
+			{
+				NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Received an event with no NetworkEventHandler set (see SetNetworkEventHandler()) - ignoring it\n");
+				return true;
+			}
+			m_networkEventHandler->HandleEvent(m_messagePacket);
+			return true;
+		}
+		default:
+		{
+			return false;
+		}
+		}
 	}
 
 
@@ -314,6 +510,10 @@ namespace NK
 	{
 		m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Client (index: " + std::to_string(_index) + ") disconnected from the server\n");
 
+		//Clients in a replay never really connected (see Host()), there's nothing to tear down
+		if (!m_connectedClientTCPSockets.contains(_index)) { return m_connectedClientTCPSockets.end(); }
+		m_tcpPoller.Remove(m_connectedClientTCPSockets.at(_index));
+
 		m_rev_connectedClientTCPAddresses.erase(m_connectedClientTCPAddresses[_index]);
 		m_connectedClientTCPAddresses.erase(_index);
 		
@@ -322,6 +522,9 @@ namespace NK
 			m_rev_connectedClientUDPAddresses.erase(m_connectedClientUDPAddresses[_index]);
 			m_connectedClientUDPAddresses.erase(_index);
 		}
+		m_clientAckedSnapshots.erase(_index);
+		m_clientReplication.erase(_index);
+		m_connections.erase(_index);
 		
 		m_clientIndexAllocator->Free(_index);
 
@@ -338,7 +541,7 @@ namespace NK
 			m_nextClientIndex = m_clientIndexAllocator->Allocate();
 		}
 		
-		if (m_nextClientIndex != FreeListAllocator::INVALID_INDEX)
+		if (PollTCPSockets() && m_nextClientIndex != FreeListAllocator::INVALID_INDEX)
 		{
 			const NETWORK_LAYER_ERROR_CODE err{ CheckForIncomingConnectionRequests() };
 			if (err != NETWORK_LAYER_ERROR_CODE::SUCCESS)
@@ -367,58 +570,364 @@ namespace NK
 
 	void ServerNetworkLayer::PostAppUpdate()
 	{
-		//Serialise all CTransforms and send them to the clients
-		std::queue<NetworkTransformData> transformComponents;
+		NK_PROFILE_SCOPE("ServerNetworkLayer - Send");
+
+		//Snapshot all CTransforms, then send each client what's changed since the last snapshot they acked
+		const std::uint32_t sequence{ m_nextSnapshotSequence++ };
+		NetworkTransformSnapshot& snapshot{ m_transformSnapshots[sequence % NetworkTransformCodec::SNAPSHOT_HISTORY_SIZE] };
+		snapshot.sequence = sequence;
+		NetworkTransformCodec::Capture(m_reg.get(), m_desc.transformQuantisation, snapshot.states);
+		if (snapshot.states.empty())
+		{
+			NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::WARNING, LOGGER_LAYER::SERVER_NETWORK_LAYER, "No `CTransform`s found in registry\n");
+		}
+		else
+		{
+			GatherViewpoints();
+			if (m_desc.interestRadius > 0.0f) { UpdateInterest(); }
+			SendTransforms(sequence);
+		}
+
+		FlushMessages();
+		if (m_ioThread) { m_ioThread->Flush(); }
+	}
+
+
+
+	void ServerNetworkLayer::GatherViewpoints()
+	{
+		//Only clients that can be sent transforms need tracking
+		for (std::unordered_map<ClientIndex, NetworkEndpoint>::iterator it{ m_connectedClientUDPAddresses.begin() }; it != m_connectedClientUDPAddresses.end(); ++it)
+		{
+			ClientReplication& replication{ m_clientReplication[it->first] };
+			replication.owned.clear();
+			replication.viewpoints.clear();
+		}
+
+		//Computed rather than cached (ComputeModelMatrix() rather than GetModelMatrix()) - only read access to CTransform here
+		for (auto&& [sync, transform] : m_reg.get().View<CNetworkSync, CTransform>())
+		{
+			const std::unordered_map<ClientIndex, ClientReplication>::iterator replication{ m_clientReplication.find(sync.owner) };
+			if (replication == m_clientReplication.end()) { continue; }
+			replication->second.owned.push_back(m_reg.get().GetEntity(transform));
+			replication->second.viewpoints.emplace_back(transform.ComputeModelMatrix()[3]);
+		}
+		for (std::pair<const ClientIndex, ClientReplication>& client : m_clientReplication) { std::ranges::sort(client.second.owned); }
+	}
+
+
+
+	void ServerNetworkLayer::UpdateInterest()
+	{
+		NK_PROFILE_SCOPE("ServerNetworkLayer - Interest");
+
+		m_interestGrid.Clear();
 		for (auto&& [transform] : m_reg.get().View<CTransform>())
 		{
-			NetworkTransformData data{};
-			data.entity = m_reg.get().GetEntity(transform);
-			data.pos = transform.GetLocalPosition();
-			data.rot = transform.GetLocalRotation();
-			data.scale = transform.GetLocalScale();
-			transformComponents.push(data);
+			m_interestGrid.Insert(m_reg.get().GetEntity(transform), glm::vec3(transform.ComputeModelMatrix()[3]));
 		}
-		if (transformComponents.empty())
+
+
+		//Work out each client's new relevant set from the last one - anything already in it only leaves once it's past the hysteresis
+		const float enterRadiusSquared{ m_desc.interestRadius * m_desc.interestRadius };
+		const float leaveRadius{ m_desc.interestRadius + m_desc.interestHysteresis };
+		for (std::pair<const ClientIndex, ClientReplication>& client : m_clientReplication)
 		{
-			m_logger.IndentLog(LOGGER_CHANNEL::WARNING, LOGGER_LAYER::SERVER_NETWORK_LAYER, "No `CTransform`s found in registry\n");
-			return;
+			ClientReplication& replication{ client.second };
+			replication.nextRelevant.assign(replication.owned.begin(), replication.owned.end());
+			for (const glm::vec3& viewpoint : replication.viewpoints)
+			{
+				m_interestGrid.ForEachInRadius(viewpoint, leaveRadius, [&](const Entity _entity, const float _distanceSquared)
+				{
+					if (_distanceSquared <= enterRadiusSquared || std::ranges::binary_search(replication.relevant, _entity)) { replication.nextRelevant.push_back(_entity); }
+				});
+			}
+			std::ranges::sort(replication.nextRelevant);
+			replication.nextRelevant.erase(std::ranges::unique(replication.nextRelevant).begin(), replication.nextRelevant.end());
+
+			m_enteredScratch.clear();
+			m_leftScratch.clear();
+			std::ranges::set_difference(replication.nextRelevant, replication.relevant, std::back_inserter(m_enteredScratch));
+			std::ranges::set_difference(replication.relevant, replication.nextRelevant, std::back_inserter(m_leftScratch));
+			std::swap(replication.relevant, replication.nextRelevant);
+			if (m_enteredScratch.empty() && m_leftScratch.empty()) { continue; }
+
+			//Let the client know - reliably, they might be e.g. hiding anything that's out of range
+			//Split over as many messages as it takes to keep each under maxMessageSize - they're handled in order, so it comes out the same
+			NK_INDENT_LOGF(m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::SERVER_NETWORK_LAYER, "{}: {} entities entered and {} left area of interest\n", client.first, m_enteredScratch.size(), m_leftScratch.size());
+			constexpr std::size_t headerSize{ sizeof(std::underlying_type_t<PACKET_CODE>) + 2 * sizeof(std::uint32_t) };
+			const std::size_t perMessage{ std::max<std::size_t>((m_desc.connection.maxMessageSize - std::min<std::size_t>(m_desc.connection.maxMessageSize, headerSize)) / sizeof(Entity), 1) };
+			std::size_t entered{ 0 };
+			std::size_t left{ 0 };
+			while (entered < m_enteredScratch.size() || left < m_leftScratch.size())
+			{
+				const std::size_t enteredCount{ std::min(m_enteredScratch.size() - entered, perMessage) };
+				const std::size_t leftCount{ std::min(m_leftScratch.size() - left, perMessage - enteredCount) };
+				sf::Packet packet;
+				packet << std::to_underlying(PACKET_CODE::RELEVANCY) << static_cast<std::uint32_t>(enteredCount);
+				for (std::size_t i{ 0 }; i < enteredCount; ++i) { packet << m_enteredScratch[entered++]; }
+				packet << static_cast<std::uint32_t>(leftCount);
+				for (std::size_t i{ 0 }; i < leftCount; ++i) { packet << m_leftScratch[left++]; }
+				QueueMessage(client.first, NETWORK_CHANNEL::RELIABLE_ORDERED, packet);
+			}
 		}
-		std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+	}
+
+
+
+	void ServerNetworkLayer::SendTransforms(const std::uint32_t _sequence)
+	{
+		const std::size_t slot{ _sequence % NetworkTransformCodec::SNAPSHOT_HISTORY_SIZE };
+		const NetworkTransformSnapshot& snapshot{ m_transformSnapshots[slot] };
+
+		m_encodedTransforms.clear(); //Hands last tick's buffers back to the pool
+		const std::vector<QuantisedTransform> noBaseline;
+		for (std::unordered_map<ClientIndex, NetworkEndpoint>::const_iterator it{ m_connectedClientUDPAddresses.begin() }; it != m_connectedClientUDPAddresses.end(); ++it)
 		{
-			cereal::BinaryOutputArchive archive(ss);
-			archive(transformComponents);
+			ClientReplication& replication{ m_clientReplication.at(it->first) };
+
+			//Leave room for any channel messages waiting to go with it (see SendUDP())
+			const std::size_t messageBytes{ sizeof(std::underlying_type_t<PACKET_CODE>) + NetworkConnection::HEADER_SIZE + std::min<std::size_t>(GetConnection(it->first).GetPendingBytes(TimeManager::GetTotalTime()), m_desc.maxMessageBytesPerPacket) };
+			std::size_t maxBytes{ m_desc.maxTransformPacketSize ? m_desc.maxTransformPacketSize - std::min<std::size_t>(m_desc.maxTransformPacketSize, messageBytes) : std::numeric_limits<std::size_t>::max() };
+			if (m_desc.bandwidthBudget)
+			{
+				replication.budget = std::min(replication.budget + m_desc.bandwidthBudget * TimeManager::GetDeltaTime(), m_desc.bandwidthBudget * 0.25);
+				maxBytes = std::min(maxBytes, static_cast<std::size_t>(std::max(replication.budget, 0.0)));
+			}
+
+			//Fall back to a full snapshot if they haven't acked anything yet, or their ack is so old it's dropped out of the history
+			const std::vector<QuantisedTransform>* baseline{ nullptr };
+			std::uint32_t baselineSequence{ NetworkTransformCodec::NO_SNAPSHOT };
+			bool baselineFull{ false };
+			const std::unordered_map<ClientIndex, std::uint32_t>::const_iterator ack{ m_clientAckedSnapshots.find(it->first) };
+			if (ack != m_clientAckedSnapshots.end())
+			{
+				const std::size_t ackSlot{ ack->second % NetworkTransformCodec::SNAPSHOT_HISTORY_SIZE };
+				const bool sentFull{ replication.sentFull[ackSlot] };
+				if (replication.transformSnapshots[ackSlot].sequence == ack->second && (!sentFull || m_transformSnapshots[ackSlot].sequence == ack->second))
+				{
+					baseline = (sentFull ? &m_transformSnapshots[ackSlot].states : &replication.transformSnapshots[ackSlot].states);
+					baselineSequence = ack->second;
+					baselineFull = sentFull;
+				}
+			}
+
+			//Without interest management, clients on the same full baseline get byte-for-byte the same delta - encode it once for all of them, and if it fits, that's what they get
+			if (m_desc.interestRadius <= 0.0f && (!baseline || baselineFull))
+			{
+				//There's only ever a handful of distinct baselines in flight, a linear search is plenty
+				std::vector<std::pair<std::uint32_t, NetworkBufferPool::Buffer>>::iterator encoded{ std::ranges::find(m_encodedTransforms, baselineSequence, &std::pair<std::uint32_t, NetworkBufferPool::Buffer>::first) };
+				if (encoded == m_encodedTransforms.end())
+				{
+					encoded = m_encodedTransforms.emplace(m_encodedTransforms.end(), baselineSequence, m_bufferPool.Acquire());
+					std::vector<std::uint8_t>& bytes{ encoded->second.Get() };
+					PacketHeader::Write(bytes, PACKET_CODE::TRANSFORM);
+					NetworkTransformCodec::Encode(_sequence, snapshot.states, baselineSequence, baseline ? *baseline : noBaseline, m_desc.transformQuantisation, bytes);
+				}
+
+				const std::vector<std::uint8_t>& bytes{ encoded->second.Get() };
+				if (bytes.size() <= maxBytes)
+				{
+					SendUDP(it, bytes);
+					replication.transformSnapshots[slot].sequence = _sequence;
+					replication.transformSnapshots[slot].states.clear();
+					replication.sentFull[slot] = true;
+					replication.priorities.clear();
+					replication.budget -= static_cast<double>(bytes.size());
+					continue;
+				}
+			}
+
+			SendPrioritisedTransforms(it, replication, _sequence, baselineSequence, baseline ? *baseline : noBaseline, maxBytes);
 		}
-		sf::Packet outgoingPacket;
-		outgoingPacket << std::to_underlying(PACKET_CODE::TRANSFORM);
-		outgoingPacket.append(ss.str().c_str(), ss.str().size());
-		for (std::unordered_map<ClientIndex, UniqueAddress>::iterator it{ m_connectedClientUDPAddresses.begin() }; it != m_connectedClientUDPAddresses.end(); ++it)
+	}
+
+
+
+	void ServerNetworkLayer::SendPrioritisedTransforms(const std::unordered_map<ClientIndex, NetworkEndpoint>::const_iterator _client, ClientReplication& _replication, const std::uint32_t _sequence, const std::uint32_t _baselineSequence, const std::vector<QuantisedTransform>& _baseline, const std::size_t _maxBytes)
+	{
+		NK_PROFILE_SCOPE("ServerNetworkLayer - Prioritise");
+
+		const std::size_t slot{ _sequence % NetworkTransformCodec::SNAPSHOT_HISTORY_SIZE };
+		const NetworkTransformSnapshot& snapshot{ m_transformSnapshots[slot] };
+		const NetworkTransformSnapshot& previousSnapshot{ m_transformSnapshots[(_sequence - 1) % NetworkTransformCodec::SNAPSHOT_HISTORY_SIZE] };
+		const bool hasPrevious{ _sequence > 0 && previousSnapshot.sequence == _sequence - 1 };
+		const bool filtered{ m_desc.interestRadius > 0.0f };
+		const float dt{ static_cast<float>(TimeManager::GetDeltaTime()) };
+
+
+		//Everything relevant that differs from the baseline is a candidate - walk the (sorted) snapshot, baseline, relevant set, priorities and previous snapshot together
+		m_transformCandidates.clear();
+		std::size_t removedCount{ 0 };
+		std::size_t b{ 0 };
+		std::size_t r{ 0 };
+		std::size_t p{ 0 };
+		std::size_t v{ 0 };
+		for (std::size_t i{ 0 }; i < snapshot.states.size(); ++i)
 		{
-			if (m_udpSocket.send(outgoingPacket, sf::IpAddress::resolve(it->second.first).value(), it->second.second) == sf::Socket::Status::Error)
+			const QuantisedTransform& state{ snapshot.states[i] };
+			if (filtered)
 			{
-				m_logger.IndentLog(LOGGER_CHANNEL::ERROR, LOGGER_LAYER::CLIENT_NETWORK_LAYER, "Failed to send UDP packet to server\n");
+				for (; r < _replication.relevant.size() && _replication.relevant[r] < state.entity; ++r) {}
+				if (r == _replication.relevant.size() || _replication.relevant[r] != state.entity) { continue; }
 			}
+
+			for (; b < _baseline.size() && _baseline[b].entity < state.entity; ++b) { ++removedCount; }
+			const bool inBaseline{ b < _baseline.size() && _baseline[b].entity == state.entity };
+			const std::size_t bits{ NetworkTransformCodec::GetDeltaBits(inBaseline ? &_baseline[b] : nullptr, state, m_desc.transformQuantisation) };
+			if (inBaseline) { ++b; }
+			if (!bits) { continue; }
+
+			for (; p < _replication.priorities.size() && _replication.priorities[p].first < state.entity; ++p) {}
+			const float accumulated{ (p < _replication.priorities.size() && _replication.priorities[p].first == state.entity) ? _replication.priorities[p].second : 0.0f };
+			for (; hasPrevious && v < previousSnapshot.states.size() && previousSnapshot.states[v].entity < state.entity; ++v) {}
+			const QuantisedTransform* previous{ (hasPrevious && v < previousSnapshot.states.size() && previousSnapshot.states[v].entity == state.entity) ? &previousSnapshot.states[v] : nullptr };
+			m_transformCandidates.push_back({ i, bits, accumulated + GetPriority(_replication, state, previous) * dt, false });
+		}
+		removedCount += _baseline.size() - b;
+
+
+		//Highest priority first, until the packet's full - carry on down the list after something doesn't fit, something smaller might
+		//Anything left behind keeps its priority, so it's further up the list next time
+		const std::size_t maxBits{ _maxBytes > std::numeric_limits<std::size_t>::max() / 8 ? std::numeric_limits<std::size_t>::max() : _maxBytes * 8 };
+		std::size_t bits{ sizeof(std::underlying_type_t<PACKET_CODE>) * 8 + NetworkTransformCodec::MAX_HEADER_BITS + removedCount * NetworkTransformCodec::MAX_REMOVED_BITS + 7 };
+		if (bits > maxBits) { return; } //Not even room for the header and removals - wait for the budget to build back up
+		std::ranges::sort(m_transformCandidates, std::ranges::greater{}, &TransformCandidate::priority);
+		for (TransformCandidate& candidate : m_transformCandidates)
+		{
+			if (bits + candidate.bits > maxBits) { continue; }
+			bits += candidate.bits;
+			candidate.send = true;
+		}
+		std::ranges::sort(m_transformCandidates, {}, &TransformCandidate::index);
+
+
+		//What the client will have once it's applied this - the new state of whatever's being sent, the baseline state of whatever's waiting
+		NetworkTransformSnapshot& sent{ _replication.transformSnapshots[slot] };
+		sent.sequence = _sequence;
+		sent.states.clear();
+		_replication.sentFull[slot] = false;
+		_replication.nextPriorities.clear();
+		std::size_t c{ 0 };
+		b = 0;
+		r = 0;
+		for (std::size_t i{ 0 }; i < snapshot.states.size(); ++i)
+		{
+			const QuantisedTransform& state{ snapshot.states[i] };
+			if (filtered)
+			{
+				for (; r < _replication.relevant.size() && _replication.relevant[r] < state.entity; ++r) {}
+				if (r == _replication.relevant.size() || _replication.relevant[r] != state.entity) { continue; }
+			}
+			for (; b < _baseline.size() && _baseline[b].entity < state.entity; ++b) {}
+			const bool inBaseline{ b < _baseline.size() && _baseline[b].entity == state.entity };
+
+			//Anything that isn't a candidate is the same as in the baseline
+			if (c < m_transformCandidates.size() && m_transformCandidates[c].index == i && !m_transformCandidates[c].send)
+			{
+				if (inBaseline) { sent.states.push_back(_baseline[b]); }
+				_replication.nextPriorities.emplace_back(state.entity, m_transformCandidates[c].priority);
+			}
+			else
+			{
+				sent.states.push_back(state);
+			}
+			if (c < m_transformCandidates.size() && m_transformCandidates[c].index == i) { ++c; }
+		}
+		std::swap(_replication.priorities, _replication.nextPriorities);
+
+		NetworkBufferPool::Buffer buffer{ m_bufferPool.Acquire() };
+		std::vector<std::uint8_t>& bytes{ buffer.Get() };
+		PacketHeader::Write(bytes, PACKET_CODE::TRANSFORM);
+		NetworkTransformCodec::Encode(_sequence, sent.states, _baselineSequence, _baseline, m_desc.transformQuantisation, bytes);
+		SendUDP(_client, bytes);
+		_replication.budget -= static_cast<double>(bytes.size());
+	}
+
+
+
+	float ServerNetworkLayer::GetPriority(const ClientReplication& _replication, const QuantisedTransform& _state, const QuantisedTransform* _previous) const
+	{
+		float priority{ 1.0f };
+		if (std::ranges::binary_search(_replication.owned, _state.entity)) { priority *= m_desc.ownerPriority; }
+
+		//Local positions - exact for anything without a parent, close enough for prioritising otherwise
+		const glm::vec3 pos{ NetworkTransformCodec::GetLocalPosition(_state, m_desc.transformQuantisation) };
+		if (!_replication.viewpoints.empty() && m_desc.priorityFalloffDistance > 0.0f)
+		{
+			float nearest{ std::numeric_limits<float>::max() };
+			for (const glm::vec3& viewpoint : _replication.viewpoints) { nearest = std::min(nearest, glm::length(pos - viewpoint)); }
+			priority /= 1.0f + nearest / m_desc.priorityFalloffDistance;
+		}
+
+		const double dt{ TimeManager::GetDeltaTime() };
+		if (_previous && dt > 0.0)
+		{
+			const float speed{ glm::length(pos - NetworkTransformCodec::GetLocalPosition(*_previous, m_desc.transformQuantisation)) / static_cast<float>(dt) };
+			priority *= 1.0f + speed * m_desc.velocityPriority;
 		}
+
+		return priority;
 	}
 
 
 
-	void ServerNetworkLayer::DecodeAndApplyInput(const sf::Packet& _packet) const
+	void ServerNetworkLayer::FlushMessages()
 	{
-		//Deserialise all CInputs and apply them
-		std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
-		ss.write(static_cast<const char*>(_packet.getData()) + _packet.getReadPosition(), _packet.getDataSize());
-		std::queue<NetworkInputData> inputData;
+		//Anyone who didn't get a transform packet this tick, but has messages waiting or is owed an ack, gets one with nothing else in it
+		static const std::vector<std::uint8_t> noState;
+		const double time{ TimeManager::GetTotalTime() };
+		for (std::unordered_map<ClientIndex, NetworkEndpoint>::const_iterator it{ m_connectedClientUDPAddresses.begin() }; it != m_connectedClientUDPAddresses.end(); ++it)
 		{
-			cereal::BinaryInputArchive archive(ss);
-			archive(inputData);
+			if (GetConnection(it->first).NeedsPacket(time)) { SendUDP(it, noState); }
 		}
+	}
+
+
 
-		while (!inputData.empty())
+	void ServerNetworkLayer::SendUDP(const std::unordered_map<ClientIndex, NetworkEndpoint>::const_iterator _client, const std::vector<std::uint8_t>& _bytes)
+	{
+		//Messages get whatever room's left in the datagram - SendTransforms() left up to maxMessageBytesPerPacket free, so this only spills over into another fragment when there was nothing to leave it out of
+		if (!m_ioThread) { return; } //Replay - nowhere to send it
+
+		NetworkBufferPool::Buffer buffer{ m_bufferPool.Acquire() };
+		std::vector<std::uint8_t>& packet{ buffer.Get() };
+		PacketHeader::Write(packet, PACKET_CODE::MESSAGES);
+		const std::size_t used{ packet.size() + _bytes.size() };
+		GetConnection(_client->first).Write(packet, TimeManager::GetTotalTime(), std::max<std::size_t>(m_desc.maxDatagramSize - std::min<std::size_t>(m_desc.maxDatagramSize, used), m_desc.maxMessageBytesPerPacket));
+		packet.insert(packet.end(), _bytes.begin(), _bytes.end());
+
+		//Goes out on the network thread at the end of the tick (see PostAppUpdate())
+		const bool sent{ m_fragmenter.Send(packet, [&](const std::uint8_t* _data, const std::size_t _size)
 		{
-			const NetworkInputData& data{ inputData.back() };
-			m_reg.get().GetComponent<CInput>(data.entity).actionStates = data.actionStates;
-			inputData.pop();
+			if (!m_ioThread->Send(_client->second, _data, _size))
+			{
+				m_logger.IndentLog(LOGGER_CHANNEL::ERROR, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Failed to send UDP packet to client " + std::to_string(_client->first) + " - the network thread's send queue is full (see m_desc.ioQueueCapacity)\n");
+			}
+		}) };
+		if (!sent)
+		{
+			m_logger.IndentLog(LOGGER_CHANNEL::ERROR, LOGGER_LAYER::SERVER_NETWORK_LAYER, "UDP packet for client " + std::to_string(_client->first) + " is too big to fragment (" + std::to_string(packet.size()) + " bytes) - dropping it\n");
 		}
 	}
 
+
+
+	bool ServerNetworkLayer::QueueMessage(const ClientIndex _index, const NETWORK_CHANNEL _channel, const sf::Packet& _packet)
+	{
+		if (!GetConnection(_index).Send(_channel, static_cast<const std::uint8_t*>(_packet.getData()), _packet.getDataSize()))
+		{
+			NK_INDENT_LOGF(m_logger, LOGGER_CHANNEL::ERROR, LOGGER_LAYER::SERVER_NETWORK_LAYER, "Failed to queue a {} byte message for client {} - too big, or too many reliable messages waiting on acks\n", _packet.getDataSize(), _index);
+			return false;
+		}
+		return true;
+	}
+
+
+
+	NetworkConnection& ServerNetworkLayer::GetConnection(const ClientIndex _index)
+	{
+		return m_connections.try_emplace(_index, m_desc.connection).first->second;
+	}
+
 }
\ No newline at end of file
@@ -2,11 +2,25 @@
 
 #include "ILayer.h"
 
+#include <Components/CNetworkEvent.h>
 #include <Core-ECS/Registry.h>
-#include <Networking/TCPEventHandler.h>
+#include <Networking/InterestGrid.h>
+#include <Networking/NetworkBufferPool.h>
+#include <Networking/NetworkConnection.h>
+#include <Networking/NetworkEventHandler.h>
+#include <Networking/NetworkIOThread.h>
+#include <Networking/NetworkTransformCodec.h>
+#include <Networking/PacketFragmenter.h>
+#include <Networking/SocketPoller.h>
 #include <SFML/Network.hpp>
 #include <Types/NekiTypes.h>
 
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
 
 namespace NK
 {
@@ -22,7 +36,27 @@ namespace NK
 		std::uint32_t maxClients{ 0 };
 		double portClaimTimeout{ 999999 }; //Time in seconds the server is allowed to try and claim the port for before timing out
 		std::uint32_t maxTCPPacketsPerClientPerTick{ 128u }; //If a client sends more TCP packets than this in a single tick, they will be kicked from the server
-		std::uint32_t maxUDPPacketsPerClientPerTick{ 512u }; //If a client sends more TCP packets than this in a single tick, they will be kicked from the server
+		std::uint32_t maxConnectionsPerTick{ 64u }; //Connections accepted in a single tick - a wave of clients joining at once gets let in over a few ticks rather than one a tick, without any one tick taking too long
+		std::uint32_t maxUDPPacketsPerClientPerTick{ 512u }; //If a client sends more UDP packets than this in a single tick, they will be kicked from the server
+		NetworkTransformQuantisation transformQuantisation{}; //How transforms are compressed for sending - clients must use the same (see ClientNetworkLayerDesc)
+		std::uint32_t ioQueueCapacity{ 4096 }; //Datagrams that can be waiting each way between the main thread and the network thread (see NetworkIOThread) - any more arriving in one tick are dropped
+		std::uint32_t maxDatagramSize{ 1200 }; //Bytes - UDP packets bigger than this are split up by a PacketFragmenter and put back together by the client, rather than leaving it to IP fragmentation (where losing any piece loses the lot)
+
+		//Channel messages (events, relevancy) go over UDP alongside the transforms - see NetworkConnection
+		NetworkConnectionConfig connection{};
+		std::uint32_t maxMessageBytesPerPacket{ 256 }; //Room taken out of each client's transform packet for messages when there are some waiting - more than this waits for the next tick
+
+		//Area of interest - clients only get the transforms of entities within interestRadius of an entity they own (see CNetworkSync::owner), and are told as entities come into / go out of range by a PACKET_CODE::RELEVANCY message on NETWORK_CHANNEL::RELIABLE_ORDERED (see NetworkConnection)
+		float interestRadius{ 0.0f }; //0 turns it off - every client gets every transform
+		float interestHysteresis{ 8.0f }; //How much further than interestRadius an entity has to get before it leaves, so anything sat right on the edge doesn't flicker in and out
+		float interestCellSize{ 64.0f }; //See InterestGrid - around interestRadius is best
+
+		//Prioritisation - when a client's transforms won't all fit in a packet, everything that's changed builds up priority each tick it isn't sent, and the highest go first
+		std::uint32_t maxTransformPacketSize{ 1200 }; //Bytes - keep it at or under maxDatagramSize so transform packets never need fragmenting (0 = no limit - anything bigger than maxDatagramSize gets fragmented)
+		std::uint32_t bandwidthBudget{ 0 }; //Bytes per second of transform packets each client can be sent (0 = no limit) - unspent budget carries over, up to a quarter of a second's worth
+		float ownerPriority{ 4.0f }; //Priority multiplier for entities the client owns (see CNetworkSync::owner)
+		float priorityFalloffDistance{ 32.0f }; //Priority halves at this distance from the nearest entity the client owns, is a third at twice it, and so on - doesn't apply to clients that don't own anything
+		float velocityPriority{ 0.1f }; //Extra priority per world unit per second an entity is moving at
 	};
 	
 	
@@ -33,20 +67,42 @@ namespace NK
 		virtual ~ServerNetworkLayer() override;
 
 		virtual void Update() override;
+		[[nodiscard]] virtual LayerAccess GetAccess(const LAYER_PHASE _phase) const override;
+		[[nodiscard]] inline virtual const char* GetName() const override { return "Server Network Layer"; }
 		NETWORK_LAYER_ERROR_CODE Host(const unsigned short _port);
-		inline void SetTCPEventHandler(TCPEventHandler* const _handler) { m_tcpEventHandler = _handler; }
+		inline void SetNetworkEventHandler(NetworkEventHandler* const _handler) { m_networkEventHandler = _handler; }
+
+		//Sends _event to a client as a channel message - picked up by their NetworkEventHandler
+		//Returns false if it couldn't be queued (see NetworkConnection::Send())
+		template<typename Event>
+		bool SendEvent(const ClientIndex _index, const Event& _event, const NETWORK_CHANNEL _channel = NETWORK_CHANNEL::RELIABLE_ORDERED) { return QueueMessage(_index, _channel, CNetworkEvent{ _event }.eventPacket); }
 
 		
 	private:
 		//Init sub-functions
+		[[nodiscard]] bool PollTCPSockets(); //Fills m_readyTCPSockets with the clients that have something waiting - returns whether the listener does
 		[[nodiscard]] NETWORK_LAYER_ERROR_CODE CheckForIncomingConnectionRequests();
 		[[nodiscard]] NETWORK_LAYER_ERROR_CODE CheckForIncomingTCPData();
 		[[nodiscard]] NETWORK_LAYER_ERROR_CODE CheckForIncomingUDPData();
+		[[nodiscard]] bool ProcessUDPPacket(ClientIndex _index, sf::Packet& _packet, double _receiveTime, bool _inMessages); //Returns false if the client was disconnected - _inMessages stops a MESSAGES packet claiming to be inside another
+		[[nodiscard]] bool ProcessMessage(ClientIndex _index, const std::uint8_t* _data, std::size_t _size); //Returns false if the client should be disconnected
 		std::unordered_map<ClientIndex, sf::TcpSocket>::iterator DisconnectClient(const ClientIndex _index); //Returns iterator to next valid iterator position in m_connectedClientTCPSockets
 
 		void PreAppUpdate();
 		void PostAppUpdate();
-		void DecodeAndApplyInput(const sf::Packet& _packet) const;
+
+		//PostAppUpdate() sub-functions
+		struct ClientReplication;
+		void GatherViewpoints();
+		void UpdateInterest();
+		void SendTransforms(std::uint32_t _sequence);
+		void SendPrioritisedTransforms(std::unordered_map<ClientIndex, NetworkEndpoint>::const_iterator _client, ClientReplication& _replication, std::uint32_t _sequence, std::uint32_t _baselineSequence, const std::vector<QuantisedTransform>& _baseline, std::size_t _maxBytes);
+		[[nodiscard]] float GetPriority(const ClientReplication& _replication, const QuantisedTransform& _state, const QuantisedTransform* _previous) const;
+		void FlushMessages();
+		void SendUDP(std::unordered_map<ClientIndex, NetworkEndpoint>::const_iterator _client, const std::vector<std::uint8_t>& _bytes); //Channel messages for the client go in front of _bytes
+
+		bool QueueMessage(ClientIndex _index, NETWORK_CHANNEL _channel, const sf::Packet& _packet);
+		[[nodiscard]] NetworkConnection& GetConnection(ClientIndex _index);
 		
 		
 		ServerNetworkLayerDesc m_desc;
@@ -55,18 +111,71 @@ namespace NK
 		unsigned short m_port;
 		sf::TcpListener m_tcpListener;
 		sf::TcpSocket m_tcpSocket;
+		SocketPoller m_tcpPoller; //m_tcpListener and every client's TCP socket - so each tick only the ones with something waiting get touched
+		std::vector<std::uint64_t> m_readyTCPSockets; //This tick's from m_tcpPoller - client indices (PollTCPSockets() takes LISTENER_POLL_ID out)
+		inline static constexpr std::uint64_t LISTENER_POLL_ID{ std::numeric_limits<std::uint64_t>::max() };
 		sf::UdpSocket m_udpSocket;
+		UniquePtr<NetworkIOThread> m_ioThread; //Owns m_udpSocket once Host() has bound it - null in a replay
+		std::size_t m_ioThreadDroppedReceives; //As of the last time it was checked, so each drop only gets warned about once
+		std::size_t m_ioThreadFailedSends;
 		
-		std::unordered_map<ClientIndex, UniqueAddress> m_connectedClientTCPAddresses; //Client index -> client ip + tcp port
-		std::unordered_map<UniqueAddress, ClientIndex> m_rev_connectedClientTCPAddresses; //Client ip + tcp port -> client index
+		std::unordered_map<ClientIndex, NetworkEndpoint> m_connectedClientTCPAddresses; //Client index -> client ip + tcp port
+		std::unordered_map<NetworkEndpoint, ClientIndex> m_rev_connectedClientTCPAddresses; //Client ip + tcp port -> client index
 		std::unordered_map<ClientIndex, sf::TcpSocket> m_connectedClientTCPSockets;
-		std::unordered_map<ClientIndex, UniqueAddress> m_connectedClientUDPAddresses; //Client index -> client ip + udp port
-		std::unordered_map<UniqueAddress, ClientIndex> m_rev_connectedClientUDPAddresses; //Client ip + udp port -> client index
+		std::unordered_map<ClientIndex, NetworkEndpoint> m_connectedClientUDPAddresses; //Client index -> client ip + udp port - what gets sent to, as is
+		std::unordered_map<NetworkEndpoint, ClientIndex> m_rev_connectedClientUDPAddresses; //Client ip + udp port -> client index - looked up for every incoming UDP packet
 		
 		UniquePtr<FreeListAllocator> m_clientIndexAllocator;
 		ClientIndex m_nextClientIndex;
 
-		TCPEventHandler* m_tcpEventHandler;
+		std::array<NetworkTransformSnapshot, NetworkTransformCodec::SNAPSHOT_HISTORY_SIZE> m_transformSnapshots; //Ring buffer of the last few snapshots sent, indexed by sequence % size - the baselines clients' deltas are encoded against
+		std::uint32_t m_nextSnapshotSequence;
+		std::unordered_map<ClientIndex, std::uint32_t> m_clientAckedSnapshots; //Client index -> the newest snapshot they've acked
+
+		NetworkBufferPool m_bufferPool;
+		std::vector<std::pair<std::uint32_t, NetworkBufferPool::Buffer>> m_encodedTransforms; //This tick's transform packet for each baseline sequence in use - clients on the same baseline get the same bytes, so each is only encoded once
+		PacketFragmenter m_fragmenter; //Every UDP packet goes out through here (see SendUDP())
+
+		//Everything the server keeps per client to decide what to send them
+		struct ClientReplication final
+		{
+			ClientReplication() { for (NetworkTransformSnapshot& snapshot : transformSnapshots) { snapshot.sequence = NetworkTransformCodec::NO_SNAPSHOT; } }
+
+			std::vector<Entity> owned; //Entities whose CNetworkSync::owner is this client, sorted - always relevant, and prioritised
+			std::vector<glm::vec3> viewpoints; //Their world positions
+
+			std::vector<Entity> relevant; //Sorted - only used with interest management on
+			std::vector<Entity> nextRelevant; //Scratch space for working out the next tick's
+
+			std::vector<std::pair<Entity, float>> priorities; //Sorted by entity - accumulated priority of everything that's changed but hasn't been sent yet
+			std::vector<std::pair<Entity, float>> nextPriorities; //Scratch space for working out the next tick's
+			double budget{ 0.0 }; //Bytes they can be sent right now - only used with a bandwidthBudget
+
+			//What they were actually sent for the last few snapshots - each client's deltas are against what they'll have ended up with, which isn't the full snapshot if anything was filtered out or had to wait
+			//sentFull means they got all of m_transformSnapshots for that sequence (transformSnapshots's states are left empty rather than copying it)
+			std::array<NetworkTransformSnapshot, NetworkTransformCodec::SNAPSHOT_HISTORY_SIZE> transformSnapshots;
+			std::array<bool, NetworkTransformCodec::SNAPSHOT_HISTORY_SIZE> sentFull{};
+		};
+		std::unordered_map<ClientIndex, ClientReplication> m_clientReplication;
+
+		InterestGrid m_interestGrid;
+		std::vector<Entity> m_enteredScratch;
+		std::vector<Entity> m_leftScratch;
+
+		struct TransformCandidate
+		{
+			std::size_t index; //Into the snapshot's states
+			std::size_t bits; //Upper bound (see NetworkTransformCodec::GetDeltaBits())
+			float priority;
+			bool send;
+		};
+		std::vector<TransformCandidate> m_transformCandidates; //Scratch space for SendPrioritisedTransforms()
+
+		std::unordered_map<ClientIndex, NetworkConnection> m_connections; //Made on first use (see GetConnection()) - clients in a replay never register a UDP port
+		sf::Packet m_innerPacket; //Scratch space for the packet a MESSAGES packet is carrying
+		sf::Packet m_messagePacket; //Scratch space for the message being handled
+
+		NetworkEventHandler* m_networkEventHandler;
 	};
 
 }
\ No newline at end of file
@@ -1,13 +1,14 @@
 #include "WindowLayer.h"
 
 #include <Components/CWindow.h>
-#include <Graphics/Window.h>
+#include <Core/Context.h>
+#include <Core/FramePacer.h>
 
 
 namespace NK
 {
 
-	WindowLayer::WindowLayer(Registry& _reg) : ILayer(_reg)
+	WindowLayer::WindowLayer(Registry& _reg, const Window* _window) : ILayer(_reg), m_window(_window)
 	{
 		m_logger.Indent();
 		m_logger.Log(LOGGER_CHANNEL::HEADING, LOGGER_LAYER::WINDOW_LAYER, "Initialising Window Layer\n");
@@ -17,9 +18,37 @@ namespace NK
 
 
 
+	WindowLayer::~WindowLayer()
+	{
+		m_logger.Indent();
+		m_logger.Log(LOGGER_CHANNEL::HEADING, LOGGER_LAYER::WINDOW_LAYER, "Shutting Down Window Layer\n");
+
+		//The engine can outlive this layer, don't leave it calling into glfw after the window's gone
+		if (FramePacer* framePacer{ Context::GetFramePacer() })
+		{
+			framePacer->SetEventWaiter(nullptr);
+			framePacer->SetWindowInactive(false);
+		}
+		
+		m_logger.Unindent();
+	}
+
+
+
 	void WindowLayer::Update()
 	{
 		glfwPollEvents();
+
+		if (FramePacer* framePacer{ Context::GetFramePacer() })
+		{
+			//Idle frames wait on glfw's events rather than sleeping, so input wakes the engine straight back up
+			framePacer->SetEventWaiter(&glfwWaitEventsTimeout);
+			if (m_window)
+			{
+				GLFWwindow* window{ m_window->GetGLFWWindow() };
+				framePacer->SetWindowInactive(!glfwGetWindowAttrib(window, GLFW_FOCUSED) || glfwGetWindowAttrib(window, GLFW_ICONIFIED));
+			}
+		}
 	}
 	
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "ILayer.h"
 
+#include <Graphics/Window.h>
+
 
 namespace NK
 {
@@ -9,10 +11,18 @@ namespace NK
 	class WindowLayer final : public ILayer
 	{
 	public:
-		explicit WindowLayer(Registry& _reg);
-		virtual ~WindowLayer() override = default;
+		//_window is optional - with it, the engine drops to its inactive frame rate while the window is unfocused or minimised (see FramePacer)
+		explicit WindowLayer(Registry& _reg, const Window* _window = nullptr);
+		virtual ~WindowLayer() override;
 
 		virtual void Update() override;
+		//Polls glfw - main thread only, and nothing can run alongside it since the callbacks write all over the place
+		[[nodiscard]] inline virtual LayerAccess GetAccess(const LAYER_PHASE _phase) const override { return (IsFixedUpdatePhase(_phase) ? LayerAccess{} : LayerAccess::Exclusive()); }
+		[[nodiscard]] inline virtual const char* GetName() const override { return "Window Layer"; }
+
+
+	private:
+		const Window* m_window;
 	};
 
-}
\ No newline at end of file
+}
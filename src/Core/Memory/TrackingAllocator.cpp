@@ -129,7 +129,7 @@ namespace NK
 
 	void* TrackingAllocator::Allocate(const std::size_t _size, const char* _file, const int _line, const bool _static)
 	{
-		if (m_engineVerbose) { m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "Application Allocation: " + std::string(_file) + " - line " + std::to_string(_line) + " --- Request for " + FormatUtils::GetSizeString(_size) + " (implicitly aligned to " + FormatUtils::GetSizeString(m_defaultAlignment) + ")\n"); }
+		if (m_engineVerbose) { NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "Application Allocation: " + std::string(_file) + " - line " + std::to_string(_line) + " --- Request for " + FormatUtils::GetSizeString(_size) + " (implicitly aligned to " + FormatUtils::GetSizeString(m_defaultAlignment) + ")\n"); }
 		if (_static) { m_logger.IndentLog(LOGGER_CHANNEL::WARNING, LOGGER_LAYER::TRACKING_ALLOCATOR, "TrackingAllocator::Allocate() - _static flag set to true which can be dangerous, was this intended?\n"); }
 		void* ptr{ AllocateAligned(_size, m_defaultAlignment) };
 
@@ -148,7 +148,7 @@ namespace NK
 	{
 		m_logger.Indent();
 		
-		if (m_engineVerbose) { m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "Application Reallocation: " + std::string(_file) + " - line " + std::to_string(_line) + " --- Request for " + FormatUtils::GetSizeString(_size) + " (implicitly aligned to " + FormatUtils::GetSizeString(m_defaultAlignment) + "). Freeing previous " + FormatUtils::GetSizeString(m_hostAllocationMap[_original].size) + " from " + m_hostAllocationMap[_original].file + "- line " + std::to_string(m_hostAllocationMap[_original].line)); }
+		if (m_engineVerbose) { NK_INDENT_LOG(m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "Application Reallocation: " + std::string(_file) + " - line " + std::to_string(_line) + " --- Request for " + FormatUtils::GetSizeString(_size) + " (implicitly aligned to " + FormatUtils::GetSizeString(m_defaultAlignment) + "). Freeing previous " + FormatUtils::GetSizeString(m_hostAllocationMap[_original].size) + " from " + m_hostAllocationMap[_original].file + "- line " + std::to_string(m_hostAllocationMap[_original].line)); }
 		if (_static) { m_logger.IndentLog(LOGGER_CHANNEL::WARNING, LOGGER_LAYER::TRACKING_ALLOCATOR, "TrackingAllocator::Reallocate() - _static flag set to true which can be dangerous, was this intended?\n"); }
 		void* ptr{ ReallocateAligned(_original, _size, m_defaultAlignment) };
 
@@ -177,10 +177,11 @@ namespace NK
 		}
 		if (_static) { m_logger.IndentLog(LOGGER_CHANNEL::WARNING, LOGGER_LAYER::TRACKING_ALLOCATOR, "TrackingAllocator::Free() - _static flag set to true which can be dangerous, was this intended?\n"); }
 
-		const std::string size{ FormatUtils::GetSizeString(m_hostAllocationMap[_ptr].size) };
-		const std::string file{ m_hostAllocationMap[_ptr].file };
-		const std::string line{ std::to_string(m_hostAllocationMap[_ptr].line) };
-		if (m_engineVerbose) { m_logger.Log(LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "Application Free: " + file + " - line " + line + " --- Freeing " + size + " (implicitly aligned to " + FormatUtils::GetSizeString(m_defaultAlignment) + ")\n"); }
+		if (m_engineVerbose)
+		{
+			const AllocationInfo& info{ m_hostAllocationMap[_ptr] };
+			NK_LOG(m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "Application Free: " + std::string(info.file) + " - line " + std::to_string(info.line) + " --- Freeing " + FormatUtils::GetSizeString(info.size) + " (implicitly aligned to " + FormatUtils::GetSizeString(m_defaultAlignment) + ")\n");
+		}
 
 		FreeAligned(_ptr);
 
@@ -212,7 +213,7 @@ namespace NK
 		void* VKAPI_CALL TrackingAllocator::AllocationVK(void* _pUserData, std::size_t _size, std::size_t _alignment, VkSystemAllocationScope _allocationScope)
 		{
 			TrackingAllocator* allocator{ static_cast<TrackingAllocator*>(_pUserData) };
-			if (allocator->m_vulkanVerbose) { allocator->m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "Vulkan Allocation: " + VulkanAllocationScopeToString(_allocationScope) + " --- Request for " + FormatUtils::GetSizeString(_size) + " (aligned to " + FormatUtils::GetSizeString(_alignment) + ")\n"); }
+			if (allocator->m_vulkanVerbose) { NK_INDENT_LOG(allocator->m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "Vulkan Allocation: " + VulkanAllocationScopeToString(_allocationScope) + " --- Request for " + FormatUtils::GetSizeString(_size) + " (aligned to " + FormatUtils::GetSizeString(_alignment) + ")\n"); }
 			void* ptr{ allocator->AllocateAligned(_size, _alignment) };
 
 			std::lock_guard<std::mutex> lock(allocator->m_hostAllocationMapMtx);
@@ -226,7 +227,7 @@ namespace NK
 		void* VKAPI_CALL TrackingAllocator::ReallocationVK(void* _pUserData, void* _pOriginal, std::size_t _size, std::size_t _alignment, VkSystemAllocationScope _allocationScope)
 		{
 			TrackingAllocator* allocator{ static_cast<TrackingAllocator*>(_pUserData) };
-			if (allocator->m_vulkanVerbose) { allocator->m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "Vulkan Reallocation: " + VulkanAllocationScopeToString(_allocationScope) + " --- Request for " + FormatUtils::GetSizeString(_size) + " (aligned to " + FormatUtils::GetSizeString(_alignment) + ")\n"); }
+			if (allocator->m_vulkanVerbose) { NK_INDENT_LOG(allocator->m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "Vulkan Reallocation: " + VulkanAllocationScopeToString(_allocationScope) + " --- Request for " + FormatUtils::GetSizeString(_size) + " (aligned to " + FormatUtils::GetSizeString(_alignment) + ")\n"); }
 			void* ptr{ allocator->ReallocateAligned(_pOriginal, _size, _alignment) };
 
 			std::lock_guard<std::mutex> lock(allocator->m_hostAllocationMapMtx);
@@ -258,7 +259,7 @@ namespace NK
 			if (allocator->m_vulkanVerbose) 
 			{
 				const std::string sizeStr{ (it != allocator->m_hostAllocationMap.end() ? FormatUtils::GetSizeString(it->second.size)  : "Unknown size") };
-				allocator->m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR,  "Vulkan Free --- Freeing " + sizeStr + "\n");
+				NK_INDENT_LOG(allocator->m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR,  "Vulkan Free --- Freeing " + sizeStr + "\n");
 			}
 
 			allocator->FreeAligned(_pMemory);
@@ -289,7 +290,7 @@ namespace NK
 		void TrackingAllocator::VMADeviceMemoryAllocation(VmaAllocator _allocator, std::uint32_t _memType, VkDeviceMemory _memory, VkDeviceSize _size, void* _pUserData)
 		{
 			TrackingAllocator* allocator{ static_cast<TrackingAllocator*>(_pUserData) };
-			if (allocator->m_vmaVerbose) { allocator->m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "VMADeviceMemoryAllocation --- Allocating " + FormatUtils::GetSizeString(_size) + " on memory type index " + std::to_string(_memType) + "\n"); }
+			if (allocator->m_vmaVerbose) { NK_INDENT_LOG(allocator->m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "VMADeviceMemoryAllocation --- Allocating " + FormatUtils::GetSizeString(_size) + " on memory type index " + std::to_string(_memType) + "\n"); }
 
 			//Not implemented
 		
@@ -302,7 +303,7 @@ namespace NK
 		void TrackingAllocator::VMADeviceMemoryFree(VmaAllocator _allocator, std::uint32_t _memType, VkDeviceMemory _memory, VkDeviceSize _size, void* _pUserData)
 		{
 			TrackingAllocator* allocator{ static_cast<TrackingAllocator*>(_pUserData) };
-			if (allocator->m_vmaVerbose) { allocator->m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "VMADeviceMemoryFree --- Freeing " + FormatUtils::GetSizeString(_size) + " on memory type index " + std::to_string(_memType) + "\n"); }
+			if (allocator->m_vmaVerbose) { NK_INDENT_LOG(allocator->m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "VMADeviceMemoryFree --- Freeing " + FormatUtils::GetSizeString(_size) + " on memory type index " + std::to_string(_memType) + "\n"); }
 
 			//Not implemented
 		
@@ -316,7 +317,7 @@ namespace NK
 		void* TrackingAllocator::AllocationDX(std::size_t _Size, std::size_t _Alignment, void* _pPrivateData)
 		{
 			TrackingAllocator* allocator{ static_cast<TrackingAllocator*>(_pPrivateData) };
-			if (allocator->m_d3d12maVerbose) { allocator->m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "D3D12MA Host-Allocation --- Request for " + FormatUtils::GetSizeString(_Size) + " (aligned to " + FormatUtils::GetSizeString(_Alignment) + ")\n"); }
+			if (allocator->m_d3d12maVerbose) { NK_INDENT_LOG(allocator->m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "D3D12MA Host-Allocation --- Request for " + FormatUtils::GetSizeString(_Size) + " (aligned to " + FormatUtils::GetSizeString(_Alignment) + ")\n"); }
 			void* ptr{ allocator->AllocateAligned(_Size, _Alignment) };
 
 			std::lock_guard<std::mutex> lock(allocator->m_hostAllocationMapMtx);
@@ -329,7 +330,7 @@ namespace NK
 		void TrackingAllocator::FreeDX(void* _pMemory, void* _pPrivateData)
 		{
 			TrackingAllocator* allocator{ static_cast<TrackingAllocator*>(_pPrivateData) };
-			if (allocator->m_d3d12maVerbose) { allocator->m_logger.IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "D3D12MA Host-Free --- Freeing " + FormatUtils::GetSizeString(allocator->m_hostAllocationMap[_pMemory].size) + "\n"); }
+			if (allocator->m_d3d12maVerbose) { NK_INDENT_LOG(allocator->m_logger, LOGGER_CHANNEL::INFO, LOGGER_LAYER::TRACKING_ALLOCATOR, "D3D12MA Host-Free --- Freeing " + FormatUtils::GetSizeString(allocator->m_hostAllocationMap[_pMemory].size) + "\n"); }
 			
 			//0-Byte Free calls permitted by D3D12MA, just skip the actual free (as instructed by the docs)
 			if (_pMemory)
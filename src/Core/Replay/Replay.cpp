@@ -0,0 +1,263 @@
+#include "Replay.h"
+
+#include <Components/CInput.h>
+#include <Core/Context.h>
+#include <Core-ECS/Registry.h>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <cereal/archives/binary.hpp>
+
+
+namespace NK
+{
+
+	namespace
+	{
+		[[nodiscard]] std::string SerialiseActionStates(const std::unordered_map<ActionTypeMapKey, INPUT_STATE_VARIANT>& _states)
+		{
+			std::ostringstream stream(std::ios::binary);
+			{
+				cereal::BinaryOutputArchive archive(stream);
+				archive(_states);
+			}
+			return stream.str();
+		}
+	}
+
+
+
+	void Replay::StartRecording(const std::filesystem::path& _path)
+	{
+		if (m_mode != REPLAY_MODE::NONE)
+		{
+			throw std::runtime_error("Replay::StartRecording() - A replay is already being recorded or played back");
+		}
+
+		m_outFile.open(_path, std::ios::binary | std::ios::trunc);
+		if (!m_outFile.is_open())
+		{
+			throw std::runtime_error("Replay::StartRecording() - Failed to open " + _path.string() + " for writing");
+		}
+		{
+			//cereal's binary archives write straight through to the stream, so each write just makes its own archive over the same file
+			cereal::BinaryOutputArchive archive(m_outFile);
+			archive(FILE_MAGIC, FILE_VERSION);
+		}
+
+		m_mode = REPLAY_MODE::RECORD;
+		m_path = _path;
+		m_frame = {};
+		m_frameIndex = 0;
+		m_recordedInputStates.clear();
+		Context::GetLogger()->IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::REPLAY, "Recording replay to " + _path.string() + "\n");
+	}
+
+
+
+	void Replay::StartPlayback(const std::filesystem::path& _path, const bool _asFastAsPossible)
+	{
+		if (m_mode != REPLAY_MODE::NONE)
+		{
+			throw std::runtime_error("Replay::StartPlayback() - A replay is already being recorded or played back");
+		}
+
+		m_inFile.open(_path, std::ios::binary);
+		if (!m_inFile.is_open())
+		{
+			throw std::runtime_error("Replay::StartPlayback() - Failed to open " + _path.string() + " for reading");
+		}
+		std::uint32_t magic{ 0 };
+		std::uint32_t version{ 0 };
+		try
+		{
+			cereal::BinaryInputArchive archive(m_inFile);
+			archive(magic, version);
+		}
+		catch (const cereal::Exception&) {}
+		if (magic != FILE_MAGIC)
+		{
+			m_inFile.close();
+			throw std::runtime_error("Replay::StartPlayback() - " + _path.string() + " isn't a replay file");
+		}
+		if (version != FILE_VERSION)
+		{
+			m_inFile.close();
+			throw std::runtime_error("Replay::StartPlayback() - " + _path.string() + " is version " + std::to_string(version) + ", expected version " + std::to_string(FILE_VERSION));
+		}
+
+		m_mode = REPLAY_MODE::PLAYBACK;
+		m_asFastAsPossible = _asFastAsPossible;
+		m_path = _path;
+		m_frame = {};
+		m_frameIndex = 0;
+		m_playbackInputStates.clear();
+		m_playbackStart = std::chrono::steady_clock::now();
+		m_lastFrameStart = m_playbackStart;
+		m_longestFrameMs = 0.0;
+		m_recordedTime = 0.0;
+		Context::GetLogger()->IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::REPLAY, "Playing back replay from " + _path.string() + (_asFastAsPossible ? " as fast as possible\n" : "\n"));
+	}
+
+
+
+	void Replay::Stop()
+	{
+		if (m_mode == REPLAY_MODE::RECORD)
+		{
+			{
+				//A zero tag marks the end - anything cut off without one (e.g. a crash mid-recording) still plays back up to the last whole frame
+				cereal::BinaryOutputArchive archive(m_outFile);
+				archive(std::uint8_t{ 0 });
+			}
+			m_outFile.close();
+			Context::GetLogger()->IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::REPLAY, "Recorded " + std::to_string(m_frameIndex) + " frame(s) to " + m_path.string() + "\n");
+		}
+		else if (m_mode == REPLAY_MODE::PLAYBACK)
+		{
+			m_inFile.close();
+		}
+
+		m_mode = REPLAY_MODE::NONE;
+		m_frame = {};
+		m_recordedInputStates.clear();
+		m_playbackInputStates.clear();
+	}
+
+
+
+	bool Replay::PlayNextFrame()
+	{
+		if (m_mode != REPLAY_MODE::PLAYBACK) { return false; }
+
+		const std::chrono::steady_clock::time_point now{ std::chrono::steady_clock::now() };
+		if (m_frameIndex > 0) { m_longestFrameMs = std::max(m_longestFrameMs, std::chrono::duration<double, std::milli>(now - m_lastFrameStart).count()); }
+		m_lastFrameStart = now;
+
+		std::uint8_t tag{ 0 };
+		{
+			const std::lock_guard lock(m_packetMutex);
+			try
+			{
+				cereal::BinaryInputArchive archive(m_inFile);
+				archive(tag);
+				if (tag) { archive(m_frame); }
+			}
+			catch (const cereal::Exception&)
+			{
+				//Ran off the end of a recording that was never stopped properly - treat it as the end
+				tag = 0;
+			}
+		}
+		if (!tag)
+		{
+			LogPlaybackSummary();
+			Stop();
+			return false;
+		}
+
+		m_recordedTime += m_frame.deltaTime;
+		for (const std::pair<Entity, std::string>& input : m_frame.inputs)
+		{
+			std::istringstream stream(input.second, std::ios::binary);
+			cereal::BinaryInputArchive archive(stream);
+			archive(m_playbackInputStates[input.first]);
+		}
+		return true;
+	}
+
+
+
+	void Replay::BeginRecordingFrame(const double _deltaTime, const float _fixedUpdateTimestep)
+	{
+		if (m_mode != REPLAY_MODE::RECORD) { return; }
+
+		m_frame.deltaTime = _deltaTime;
+		m_frame.fixedUpdateTimestep = _fixedUpdateTimestep;
+	}
+
+
+
+	void Replay::SyncInputs(Registry& _reg)
+	{
+		if (m_mode == REPLAY_MODE::RECORD)
+		{
+			for (auto&& [input] : _reg.View<CInput>())
+			{
+				const Entity entity{ _reg.GetEntity(input) };
+				std::string states{ SerialiseActionStates(input.actionStates) };
+				const std::unordered_map<Entity, std::string>::iterator it{ m_recordedInputStates.find(entity) };
+				if (it != m_recordedInputStates.end() && it->second == states) { continue; }
+
+				m_frame.inputs.emplace_back(entity, states);
+				m_recordedInputStates[entity] = std::move(states);
+			}
+		}
+		else if (m_mode == REPLAY_MODE::PLAYBACK)
+		{
+			for (auto&& [input] : _reg.View<CInput>())
+			{
+				const std::unordered_map<Entity, std::unordered_map<ActionTypeMapKey, INPUT_STATE_VARIANT>>::const_iterator it{ m_playbackInputStates.find(_reg.GetEntity(input)) };
+				if (it != m_playbackInputStates.end()) { input.actionStates = it->second; }
+			}
+		}
+	}
+
+
+
+	void Replay::EndFrame()
+	{
+		if (m_mode == REPLAY_MODE::NONE) { return; }
+
+		if (m_mode == REPLAY_MODE::RECORD)
+		{
+			const std::lock_guard lock(m_packetMutex);
+			{
+				cereal::BinaryOutputArchive archive(m_outFile);
+				archive(std::uint8_t{ 1 }, m_frame);
+			}
+			m_frame.inputs.clear();
+			m_frame.packets.clear();
+		}
+		++m_frameIndex;
+	}
+
+
+
+	void Replay::RecordPacket(const REPLAY_PACKET_CHANNEL _channel, const ClientIndex _source, const sf::Packet& _packet)
+	{
+		if (m_mode != REPLAY_MODE::RECORD) { return; }
+
+		const std::lock_guard lock(m_packetMutex);
+		m_frame.packets.push_back(RecordedPacket{ _channel, _source, std::string(static_cast<const char*>(_packet.getData()), _packet.getDataSize()) });
+	}
+
+
+
+	std::vector<std::pair<ClientIndex, sf::Packet>> Replay::GetPackets(const REPLAY_PACKET_CHANNEL _channel)
+	{
+		std::vector<std::pair<ClientIndex, sf::Packet>> packets;
+		if (m_mode != REPLAY_MODE::PLAYBACK) { return packets; }
+
+		const std::lock_guard lock(m_packetMutex);
+		for (const RecordedPacket& recordedPacket : m_frame.packets)
+		{
+			if (recordedPacket.channel != _channel) { continue; }
+			sf::Packet packet;
+			packet.append(recordedPacket.data.data(), recordedPacket.data.size());
+			packets.emplace_back(recordedPacket.source, std::move(packet));
+		}
+		return packets;
+	}
+
+
+
+	void Replay::LogPlaybackSummary()
+	{
+		const double wallTime{ std::chrono::duration<double>(std::chrono::steady_clock::now() - m_playbackStart).count() };
+		const double averageFrameMs{ m_frameIndex > 0 ? wallTime * 1000.0 / static_cast<double>(m_frameIndex) : 0.0 };
+		Context::GetLogger()->IndentLog(LOGGER_CHANNEL::INFO, LOGGER_LAYER::REPLAY, "Replay finished - " + std::to_string(m_frameIndex) + " frame(s) covering " + std::to_string(m_recordedTime) + "s of recorded time, played back in " + std::to_string(wallTime) + "s (" + std::to_string(averageFrameMs) + "ms average frame, " + std::to_string(m_longestFrameMs) + "ms longest)\n");
+	}
+
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <Types/NekiTypes.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace NK
+{
+	class Registry;
+	
+	
+	enum class REPLAY_MODE
+	{
+		NONE,
+		RECORD,
+		PLAYBACK,
+	};
+
+
+	//Which receive path a recorded packet came in on - each network layer only gets back its own packets
+	enum class REPLAY_PACKET_CHANNEL : std::uint8_t
+	{
+		CLIENT_TCP,
+		CLIENT_UDP,
+		SERVER_TCP,
+		SERVER_UDP,
+	};
+
+
+	//Records everything that makes one run of Engine::Run() differ from the next - each frame's delta time and fixed timestep, the CInput states after the pre-app layers have filled them, and the packets the network layers received - and plays it back
+	//Playback steps TimeManager by the recorded delta times, overwrites the CInputs and feeds the network layers the recorded packets instead of reading their sockets, so the same ticks run with the same inputs every time, without a window or anyone at the controls
+	//With as-fast-as-possible playback, the frames are run back-to-back rather than at their recorded pace, which makes for reproducible perf regression runs of real gameplay (see ReplayConfig)
+	//Started by the Context and driven by the Engine - the network layers call RecordPacket() / GetPackets() and skip their sockets during playback
+	class Replay final
+	{
+	public:
+		static void StartRecording(const std::filesystem::path& _path);
+		static void StartPlayback(const std::filesystem::path& _path, bool _asFastAsPossible);
+		//Flushes and closes the recording, or ends playback early
+		static void Stop();
+
+		[[nodiscard]] static inline REPLAY_MODE GetMode() { return m_mode; }
+		[[nodiscard]] static inline bool IsRecording() { return m_mode == REPLAY_MODE::RECORD; }
+		[[nodiscard]] static inline bool IsPlaying() { return m_mode == REPLAY_MODE::PLAYBACK; }
+		[[nodiscard]] static inline bool GetAsFastAsPossible() { return m_asFastAsPossible; }
+		[[nodiscard]] static inline std::uint64_t GetFrameIndex() { return m_frameIndex; }
+
+
+		//Engine - once per frame, in place of TimeManager::Update()
+		//Reads the next frame of the recording and returns false once there are none left
+		[[nodiscard]] static bool PlayNextFrame();
+		//The recorded values for the frame PlayNextFrame() just read
+		[[nodiscard]] static inline double GetFrameDeltaTime() { return m_frame.deltaTime; }
+		[[nodiscard]] static inline float GetFrameFixedUpdateTimestep() { return m_frame.fixedUpdateTimestep; }
+
+		//Engine - once per frame, straight after TimeManager::Update()
+		static void BeginRecordingFrame(double _deltaTime, float _fixedUpdateTimestep);
+
+		//Engine - after the pre-app layers' Update() (which is where InputLayer / ServerNetworkLayer fill the CInputs)
+		//Recording: stores every CInput whose states have changed since the last frame
+		//Playback: overwrites every CInput with its recorded states
+		static void SyncInputs(Registry& _reg);
+
+		//Engine - at the end of each frame, writes the frame out when recording
+		static void EndFrame();
+
+
+		//Network layers - a packet that's just been received from _source (a ClientIndex on the server, unused on the client)
+		static void RecordPacket(REPLAY_PACKET_CHANNEL _channel, ClientIndex _source, const sf::Packet& _packet);
+		//Network layers - the packets received on _channel during this frame of the recording, in the order they were received
+		[[nodiscard]] static std::vector<std::pair<ClientIndex, sf::Packet>> GetPackets(REPLAY_PACKET_CHANNEL _channel);
+
+
+	private:
+		struct RecordedPacket
+		{
+			REPLAY_PACKET_CHANNEL channel;
+			ClientIndex source;
+			std::string data;
+
+			SERIALISE_MEMBER_FUNC(channel, source, data)
+		};
+
+		struct RecordedFrame
+		{
+			double deltaTime;
+			float fixedUpdateTimestep;
+			std::vector<std::pair<Entity, std::string>> inputs; //Entity -> its serialised CInput::actionStates, only for the ones that changed
+			std::vector<RecordedPacket> packets;
+
+			SERIALISE_MEMBER_FUNC(deltaTime, fixedUpdateTimestep, inputs, packets)
+		};
+
+
+		static void LogPlaybackSummary();
+
+
+		inline static constexpr std::uint32_t FILE_MAGIC{ 0x50524B4E }; //"NKRP"
+		inline static constexpr std::uint32_t FILE_VERSION{ 1 };
+
+		inline static REPLAY_MODE m_mode{ REPLAY_MODE::NONE };
+		inline static bool m_asFastAsPossible{ false };
+		inline static std::filesystem::path m_path;
+		inline static std::ofstream m_outFile;
+		inline static std::ifstream m_inFile;
+
+		inline static RecordedFrame m_frame{};
+		inline static std::uint64_t m_frameIndex{ 0 };
+		inline static std::mutex m_packetMutex; //Guards m_frame.packets - the network layers could be running on a worker
+
+		inline static std::unordered_map<Entity, std::string> m_recordedInputStates; //The last states written for each entity, so unchanged ones can be skipped
+		inline static std::unordered_map<Entity, std::unordered_map<ActionTypeMapKey, INPUT_STATE_VARIANT>> m_playbackInputStates; //The latest recorded states for each entity
+
+		//Playback timing, for the summary logged when it finishes
+		inline static std::chrono::steady_clock::time_point m_playbackStart;
+		inline static std::chrono::steady_clock::time_point m_lastFrameStart;
+		inline static double m_longestFrameMs{ 0.0 };
+		inline static double m_recordedTime{ 0.0 };
+	};
+
+}
@@ -1,8 +1,10 @@
 #include "InputUtils.h"
 
-#include <GLFW/glfw3.h>
 #include <stdexcept>
 #include <string>
+#ifndef NEKI_HEADLESS
+	#include <GLFW/glfw3.h>
+#endif
 
 
 namespace NK
@@ -18,6 +20,7 @@ namespace NK
 
 
 
+	#ifndef NEKI_HEADLESS
 	std::uint32_t InputUtils::GetGLFWKeyboardKey(const KEYBOARD _key)
 	{
 		switch (_key)
@@ -95,5 +98,6 @@ namespace NK
 		}
 		}
 	}
+	#endif
 
 }
\ No newline at end of file
@@ -10,8 +10,10 @@ namespace NK
 	{
 	public:
 		[[nodiscard]] static INPUT_VARIANT_ENUM_TYPE GetInputType(const INPUT_VARIANT _input);
-		[[nodiscard]] static std::uint32_t GetGLFWKeyboardKey(const KEYBOARD _key);
-		[[nodiscard]] static std::uint32_t GetGLFWMouseButton(const MOUSE_BUTTON _button);
+		#ifndef NEKI_HEADLESS
+			[[nodiscard]] static std::uint32_t GetGLFWKeyboardKey(const KEYBOARD _key);
+			[[nodiscard]] static std::uint32_t GetGLFWMouseButton(const MOUSE_BUTTON _button);
+		#endif
 	};
 	
 }
\ No newline at end of file
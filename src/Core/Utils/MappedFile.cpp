@@ -0,0 +1,150 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <cerrno>
+	#include <cstring>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+
+namespace NK
+{
+
+	MappedFile::MappedFile(const std::filesystem::path& _path, const std::size_t _size)
+	: m_path(_path), m_size(_size)
+	{
+		if (_size == 0)
+		{
+			throw std::invalid_argument("MappedFile::MappedFile() - _size must be greater than 0");
+		}
+
+		#if defined(_WIN32)
+
+			m_fileHandle = CreateFileW(_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (m_fileHandle == INVALID_HANDLE_VALUE)
+			{
+				m_fileHandle = nullptr;
+				throw std::runtime_error("MappedFile::MappedFile() - failed to create " + _path.string() + " (error " + std::to_string(GetLastError()) + ")");
+			}
+
+			//Mapping a file larger than its current size grows it, zero-filled
+			const ULARGE_INTEGER size{ .QuadPart = _size };
+			m_mappingHandle = CreateFileMappingW(m_fileHandle, nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);
+			if (!m_mappingHandle)
+			{
+				const DWORD error{ GetLastError() };
+				CloseHandle(m_fileHandle);
+				throw std::runtime_error("MappedFile::MappedFile() - failed to create file mapping for " + _path.string() + " (error " + std::to_string(error) + ")");
+			}
+
+			m_data = static_cast<std::byte*>(MapViewOfFile(m_mappingHandle, FILE_MAP_WRITE, 0, 0, _size));
+			if (!m_data)
+			{
+				const DWORD error{ GetLastError() };
+				CloseHandle(m_mappingHandle);
+				CloseHandle(m_fileHandle);
+				throw std::runtime_error("MappedFile::MappedFile() - failed to map " + _path.string() + " (error " + std::to_string(error) + ")");
+			}
+
+		#else
+
+			m_fd = open(_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+			if (m_fd == -1)
+			{
+				throw std::runtime_error("MappedFile::MappedFile() - failed to create " + _path.string() + " (" + std::strerror(errno) + ")");
+			}
+
+			//ftruncate() grows the file with zeroes (sparse, so this doesn't actually write _size bytes)
+			if (ftruncate(m_fd, static_cast<off_t>(_size)) == -1)
+			{
+				const int error{ errno };
+				close(m_fd);
+				throw std::runtime_error("MappedFile::MappedFile() - failed to resize " + _path.string() + " (" + std::strerror(error) + ")");
+			}
+
+			void* data{ mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0) };
+			if (data == MAP_FAILED)
+			{
+				const int error{ errno };
+				close(m_fd);
+				throw std::runtime_error("MappedFile::MappedFile() - failed to map " + _path.string() + " (" + std::strerror(error) + ")");
+			}
+			m_data = static_cast<std::byte*>(data);
+
+		#endif
+	}
+
+
+
+	MappedFile::~MappedFile()
+	{
+		if (m_data) { Close(m_size); }
+	}
+
+
+
+	void MappedFile::Prefault()
+	{
+		#if defined(_WIN32)
+			constexpr std::size_t pageSize{ 4096 };
+		#else
+			const std::size_t pageSize{ static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) };
+		#endif
+
+		//Write rather than read - a read fault on a shared mapping maps the zero page and the first write faults again
+		volatile std::byte* data{ m_data };
+		for (std::size_t offset{ 0 }; offset < m_size; offset += pageSize)
+		{
+			data[offset] = std::byte{ 0 };
+		}
+	}
+
+
+
+	void MappedFile::FlushAsync() const
+	{
+		#if defined(_WIN32)
+			FlushViewOfFile(m_data, 0);
+		#else
+			msync(m_data, m_size, MS_ASYNC);
+		#endif
+	}
+
+
+
+	void MappedFile::Close(const std::size_t _usedSize)
+	{
+		if (!m_data) { return; }
+
+		#if defined(_WIN32)
+
+			UnmapViewOfFile(m_data);
+			CloseHandle(m_mappingHandle);
+			LARGE_INTEGER size{ .QuadPart = static_cast<LONGLONG>(_usedSize) };
+			SetFilePointerEx(m_fileHandle, size, nullptr, FILE_BEGIN);
+			SetEndOfFile(m_fileHandle);
+			CloseHandle(m_fileHandle);
+			m_mappingHandle = nullptr;
+			m_fileHandle = nullptr;
+
+		#else
+
+			munmap(m_data, m_size);
+			//Not much that can be done if this fails - the file just keeps its zero-filled tail, which readers treat as the end anyway
+			[[maybe_unused]] const int result{ ftruncate(m_fd, static_cast<off_t>(_usedSize)) };
+			close(m_fd);
+			m_fd = -1;
+
+		#endif
+
+		m_data = nullptr;
+	}
+
+}
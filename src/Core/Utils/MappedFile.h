@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+
+namespace NK
+{
+
+	//Read-write memory mapping of a newly created file
+	//The file is created (or truncated) and grown to _size on construction, zero-filled
+	//Writes go straight into the page cache, so whatever has been written survives the process crashing
+	class MappedFile final
+	{
+	public:
+		explicit MappedFile(const std::filesystem::path& _path, std::size_t _size);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		//Touch every page so the first writes to them don't take a page fault on the logging thread
+		void Prefault();
+
+		//Ask the OS to start writing dirty pages back to disk without waiting for it to finish
+		void FlushAsync() const;
+
+		//Unmap and shrink the file to _usedSize - called automatically (with the full size) by the destructor if it hasn't been called already
+		void Close(std::size_t _usedSize);
+
+		[[nodiscard]] inline std::byte* GetData() const { return m_data; }
+		[[nodiscard]] inline std::size_t GetSize() const { return m_size; }
+		[[nodiscard]] inline const std::filesystem::path& GetPath() const { return m_path; }
+
+
+	private:
+		std::filesystem::path m_path;
+		std::size_t m_size;
+		std::byte* m_data{ nullptr };
+
+		#if defined(_WIN32)
+			void* m_fileHandle{ nullptr };
+			void* m_mappingHandle{ nullptr };
+		#else
+			int m_fd{ -1 };
+		#endif
+	};
+
+}
@@ -6,7 +6,7 @@ namespace NK
 
 	Timer::Timer(const double _time)
 	{
-		m_lastTime = glfwGetTime();
+		m_lastTime = std::chrono::steady_clock::now();
 		m_timeLeft = _time;
 	}
 
@@ -14,8 +14,8 @@ namespace NK
 
 	void Timer::Update()
 	{
-		const double currentTime{ glfwGetTime() };
-		const double dt{ currentTime - m_lastTime };
+		const std::chrono::steady_clock::time_point currentTime{ std::chrono::steady_clock::now() };
+		const double dt{ std::chrono::duration<double>(currentTime - m_lastTime).count() };
 		m_timeLeft -= dt;
 		m_lastTime = currentTime;
 	}
@@ -1,7 +1,7 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
-#include <GLFW/glfw3.h>
 
 
 namespace NK
@@ -10,7 +10,7 @@ namespace NK
 	class Timer final
 	{
 	public:
-		//Start a timer for _time milliseconds
+		//Start a timer for _time seconds
 		explicit Timer(const double _time);
 
 		//Query the timer's completion
@@ -28,7 +28,7 @@ namespace NK
 
 	private:
 		double m_timeLeft;
-		double m_lastTime;
+		std::chrono::steady_clock::time_point m_lastTime;
 	};
 	
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "GPUUploader.h"
 
+#include <Core/Debug/Profiler.h>
 #include <Core/Utils/ImageLoader.h>
 #include <RHI/IBuffer.h>
 #include <RHI/IBufferView.h>
@@ -484,6 +485,8 @@ void GPUUploader::EnqueueTextureDataUpload(const void* _data, ITexture* _dstText
 
 	void GPUUploader::Flush(bool _waitIdle, IFence* _signalFence, ISemaphore* _signalSemaphore)
 	{
+		NK_PROFILE_SCOPE("GPUUploader::Flush()");
+
 		if (!_waitIdle && !_signalFence && !_signalSemaphore)
 		{
 			m_logger.IndentLog(LOGGER_CHANNEL::WARNING, LOGGER_LAYER::GPU_UPLOADER, "In Flush() - _waitIdle = false, _signalFence = nullptr, _signalSemaphore - you have no way of knowing when the flush has finished - this is considered bad practice and is almost certainly a mistake.\n");
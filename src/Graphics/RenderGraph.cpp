@@ -1,5 +1,6 @@
 #include "RenderGraph.h"
 
+#include <Core/Debug/Profiler.h>
 #include <RHI/ICommandBuffer.h>
 #include <RHI/RHIUtils.h>
 
@@ -98,14 +99,24 @@ namespace NK
 
 		//Nodes were added in reverse order, so reverse the list
 		std::ranges::reverse(m_requiredNodes);
+
+		for (const std::pair<NODE_NAME, Node>& node : m_requiredNodes)
+		{
+			m_requiredNodeProfileNames.push_back(Profiler::InternName(node.first));
+		}
 	}
 
 
 
 	void RenderGraph::Execute(RenderGraphExecutionDesc& _desc) const
 	{
-		for (const std::pair<NODE_NAME, Node>& node : m_requiredNodes)
+		NK_PROFILE_SCOPE("RenderGraph::Execute()");
+
+		for (std::size_t nodeIndex{ 0 }; nodeIndex < m_requiredNodes.size(); ++nodeIndex)
 		{
+			const std::pair<NODE_NAME, Node>& node{ m_requiredNodes[nodeIndex] };
+			NK_PROFILE_SCOPE(m_requiredNodeProfileNames[nodeIndex]);
+
 			if (!_desc.commandBuffers.contains(node.first))
 			{
 				throw std::invalid_argument("RenderGraph::Execute() - no command buffer was bound to node \"" + node.first + "\" - all nodes require a command buffer");
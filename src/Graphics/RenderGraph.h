@@ -91,6 +91,7 @@ namespace NK
 
 	private:
 		std::vector<std::pair<NODE_NAME, Node>> m_requiredNodes;
+		std::vector<const char*> m_requiredNodeProfileNames; //Interned copies of the node names for NK_PROFILE_SCOPE(), parallel to m_requiredNodes
 		std::unordered_map<NODE_NAME, std::vector<std::pair<BINDING_NAME, RESOURCE_STATE>>> m_requiredResources; //Subset of RenderGraphDesc::resources for all required nodes
 		std::unordered_map<NODE_NAME, std::function<void(ICommandBuffer*, const BindingMap<IBuffer>&, const BindingMap<ITexture>&, const BindingMap<IBufferView>&, const BindingMap<ITextureView>&, const BindingMap<ISampler>&)>> m_requiredExecutionFunctions; //Subset of RenderGraphDesc::executionFunctions for all required execution functions
 	};
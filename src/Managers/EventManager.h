@@ -1,86 +1,418 @@
 #pragma once
 
-#include <any>
 #include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <stdexcept>
-#include <typeindex>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 
 namespace NK
 {
 
 	typedef std::uint64_t EventSubscriptionID;
-	
-	
+
+
+	//Two ways of sending events:
+	//- Trigger(): immediate-mode, callbacks run synchronously on the calling thread. Main thread only.
+	//- Enqueue(): queued, safe to call from any thread. Events are buffered per-thread and handed to subscribers in one batch when DispatchQueued() is called (the engine does this between layer phases).
+	//  Queued subscribers (SubscribeQueued()) receive a std::span of every event queued since the last dispatch; regular subscribers (Subscribe()) still receive them one at a time, on the main thread.
 	class EventManager final
 	{
 	public:
-		template<typename EventPacket>
-		static inline EventSubscriptionID Subscribe(std::function<void(const EventPacket&)> _callback)
+		//For free functions, static class methods, and lambdas
+		template<typename EventPacket, typename Callback>
+		static inline EventSubscriptionID Subscribe(Callback&& _callback)
 		{
-			const EventSubscriptionID id{ m_nextID++ };
-
-			//Provided _callback parameter is of EventPacket type but needs to be std::any to be in the map
-			//Create a small wrapper over the function that casts the parameter
-			const std::function<void(const std::any&)> wrapper
-			{
-				[_callback](const std::any& _data)
-				{
-					_callback(std::any_cast<const EventPacket&>(_data));
-				}
-			};
-			m_callbacks[std::type_index(typeid(EventPacket))][id] = wrapper;
-			return id;
+			return SubscribeCallable<const EventPacket&>(std::forward<Callback>(_callback));
 		}
 
 
 		//For non-static class methods
 		template<typename Class, typename EventPacket>
-		static inline EventSubscriptionID Subscribe(Class* _classInstance, std::function<void(Class*, const EventPacket&)> _memberCallback)
+		static inline EventSubscriptionID Subscribe(Class* _classInstance, void(Class::*_memberCallback)(const EventPacket&))
+		{
+			return SubscribeMember<Class, const EventPacket&>(_classInstance, _memberCallback);
+		}
+
+
+		//For non-static const class methods
+		template<typename Class, typename EventPacket>
+		static inline EventSubscriptionID Subscribe(Class* _classInstance, void(Class::*_memberCallback)(const EventPacket&) const)
 		{
-			return Subscribe<EventPacket>(std::bind(_memberCallback, _classInstance, std::placeholders::_1));
+			return SubscribeMember<Class, const EventPacket&>(_classInstance, _memberCallback);
 		}
 
-		
+
 		template<typename EventPacket>
 		static inline void Unsubscribe(const EventSubscriptionID _subscriptionID)
 		{
-			std::unordered_map<EventSubscriptionID, std::function<void(const std::any&)>>& callbacks{ m_callbacks[std::type_index(typeid(EventPacket))] };
-			if (callbacks.erase(_subscriptionID) == 0)
+			if (!RemoveSubscriber<const EventPacket&>(_subscriptionID))
 			{
 				//No elements were removed
 				throw std::runtime_error("EventManager::Unsubscribe() - provided subscription id is not subscribed to the provided event type");
 			}
 		}
 
-		
+
 		template<typename EventPacket>
 		static inline void Trigger(const EventPacket& _packet)
 		{
-			//Get all callbacks for this event
-			const std::unordered_map<std::type_index, std::unordered_map<EventSubscriptionID, std::function<void(const std::any&)>>>::iterator it{ m_callbacks.find(std::type_index(typeid(EventPacket))) };
-			if (it == m_callbacks.end())
+			Invoke<const EventPacket&>(_packet);
+		}
+
+
+		//Batch handlers for queued events - for free functions, static class methods, and lambdas taking a std::span<const EventPacket>
+		template<typename EventPacket, typename Callback>
+		static inline EventSubscriptionID SubscribeQueued(Callback&& _callback)
+		{
+			return SubscribeCallable<std::span<const EventPacket>>(std::forward<Callback>(_callback));
+		}
+
+
+		//Batch handlers for queued events - for non-static class methods taking a std::span<const EventPacket>
+		template<typename Class, typename EventPacket>
+		static inline EventSubscriptionID SubscribeQueued(Class* _classInstance, void(Class::*_memberCallback)(std::span<const EventPacket>))
+		{
+			return SubscribeMember<Class, std::span<const EventPacket>>(_classInstance, _memberCallback);
+		}
+
+
+		template<typename EventPacket>
+		static inline void UnsubscribeQueued(const EventSubscriptionID _subscriptionID)
+		{
+			if (!RemoveSubscriber<std::span<const EventPacket>>(_subscriptionID))
+			{
+				//No elements were removed
+				throw std::runtime_error("EventManager::UnsubscribeQueued() - provided subscription id is not subscribed to the provided event type");
+			}
+		}
+
+
+		//Thread-safe - buffers the event until the next DispatchQueued()
+		template<typename EventPacket>
+		static inline void Enqueue(const EventPacket& _packet)
+		{
+			ThreadBuffer<EventPacket>& buffer{ GetThreadBuffer<EventPacket>() };
+			AcquireGuard(buffer.guard);
+			buffer.events.push_back(_packet);
+			ReleaseGuard(buffer.guard);
+		}
+
+
+		//Drain a single queued event type and dispatch it to its subscribers. Main thread only.
+		template<typename EventPacket>
+		static inline void DispatchQueued()
+		{
+			QueuedChannel<EventPacket>& channel{ GetQueuedChannel<EventPacket>() };
+
+			//Gather every thread's events into one contiguous batch
+			//Producers are only held up for the duration of a vector swap - the copy into the batch happens outside the guard
+			std::size_t bufferIndex{ 0 };
+			while (true)
+			{
+				ThreadBuffer<EventPacket>* buffer;
+				{
+					const std::lock_guard<std::mutex> lock{ channel.threadBuffersMutex };
+					if (bufferIndex >= channel.threadBuffers.size()) { break; }
+					buffer = channel.threadBuffers[bufferIndex++].get();
+				}
+
+				AcquireGuard(buffer->guard);
+				std::swap(buffer->events, buffer->drained);
+				ReleaseGuard(buffer->guard);
+
+				channel.batch.insert(channel.batch.end(), buffer->drained.begin(), buffer->drained.end());
+				buffer->drained.clear();
+			}
+
+			if (channel.batch.empty()) { return; }
+
+			//Handlers are free to Enqueue() more events of this type - they land in the thread buffers and go out next dispatch
+			//Swap out the batch first so a nested DispatchQueued<EventPacket>() can't clear it from under us
+			std::vector<EventPacket> batch;
+			std::swap(batch, channel.batch);
+			Invoke<std::span<const EventPacket>>(std::span<const EventPacket>(batch));
+			for (const EventPacket& packet : batch)
+			{
+				Invoke<const EventPacket&>(packet);
+			}
+			batch.clear();
+			if (channel.batch.empty()) { std::swap(batch, channel.batch); } //Hand the capacity back
+		}
+
+
+		//Drain every queued event type that has been used. Main thread only.
+		static inline void DispatchQueued()
+		{
+			//Index-based and re-locked every iteration - a handler might enqueue an event type that's never been used before, which registers a new channel
+			std::size_t channelIndex{ 0 };
+			while (true)
+			{
+				void(*dispatch)();
+				{
+					const std::lock_guard<std::mutex> lock{ m_queuedChannelsMutex };
+					if (channelIndex >= m_queuedChannelDispatchers.size()) { break; }
+					dispatch = m_queuedChannelDispatchers[channelIndex++];
+				}
+				dispatch();
+			}
+		}
+
+
+	private:
+		//Big enough to hold any member function pointer on the supported compilers (msvc pointers to members of incomplete classes can be up to 24 bytes on x64)
+		static constexpr std::size_t CALLABLE_STORAGE_SIZE{ 3 * sizeof(void*) };
+
+		//A direct delegate - an instance pointer and a plain function pointer that knows how to call into it
+		//No type erasure of the payload, the invoke thunk takes the concrete argument type (const EventPacket& for immediate subscribers, std::span<const EventPacket> for queued ones)
+		template<typename Arg>
+		struct Delegate
+		{
+			EventSubscriptionID id{ 0 };
+			void* instance{ nullptr };
+			void(*invoke)(void* _instance, const void* _callable, Arg _arg){ nullptr };
+			void(*destroy)(void* _instance){ nullptr }; //Only set for subscriptions that own their instance (std::function callbacks)
+			alignas(void*) unsigned char callable[CALLABLE_STORAGE_SIZE]{};
+		};
+
+
+		//All subscribers for a single argument type, stored contiguously
+		template<typename Arg>
+		struct Subscribers
+		{
+			std::vector<Delegate<Arg>> delegates;
+			std::uint32_t dispatchDepth{ 0 };
+			bool compactPending{ false };
+		};
+
+
+		//Holds dispatchDepth up for as long as a dispatch is running, and puts it back even if a callback throws - otherwise every Unsubscribe() after that would be deferred forever
+		template<typename Arg>
+		struct DispatchScope
+		{
+			explicit DispatchScope(Subscribers<Arg>& _subscribers) : subscribers(_subscribers) { ++subscribers.dispatchDepth; }
+			~DispatchScope() { --subscribers.dispatchDepth; }
+			DispatchScope(const DispatchScope&) = delete;
+			DispatchScope& operator=(const DispatchScope&) = delete;
+
+			Subscribers<Arg>& subscribers;
+		};
+
+
+		//One producer thread's pending events for a queued channel
+		template<typename EventPacket>
+		struct ThreadBuffer
+		{
+			//Only ever contended by the single DispatchQueued() swap per frame, never between producers
+			std::atomic_flag guard;
+			std::vector<EventPacket> events;
+			std::vector<EventPacket> drained; //Swapped in on dispatch so both vectors keep their capacity
+		};
+
+
+		template<typename EventPacket>
+		struct QueuedChannel
+		{
+			std::mutex threadBuffersMutex; //Only taken when a new thread first enqueues, and while the dispatcher walks the list
+			std::vector<std::unique_ptr<ThreadBuffer<EventPacket>>> threadBuffers;
+			std::vector<EventPacket> batch;
+		};
+
+
+		//One instantiation per argument type - resolved at compile time, no runtime type lookup
+		template<typename Arg>
+		[[nodiscard]] static inline Subscribers<Arg>& GetSubscribers()
+		{
+			static Subscribers<Arg> subscribers;
+			return subscribers;
+		}
+
+
+		template<typename EventPacket>
+		[[nodiscard]] static inline QueuedChannel<EventPacket>& GetQueuedChannel()
+		{
+			//Function-local static initialisation is thread-safe, and registering the dispatcher here means the first Enqueue() from any thread is enough for DispatchQueued() to pick the channel up
+			static QueuedChannel<EventPacket>& channel{ []() -> QueuedChannel<EventPacket>&
+			{
+				static QueuedChannel<EventPacket> instance;
+				const std::lock_guard<std::mutex> lock{ m_queuedChannelsMutex };
+				m_queuedChannelDispatchers.push_back(static_cast<void(*)()>(&DispatchQueued<EventPacket>));
+				return instance;
+			}() };
+			return channel;
+		}
+
+
+		template<typename EventPacket>
+		[[nodiscard]] static inline ThreadBuffer<EventPacket>& GetThreadBuffer()
+		{
+			//Cached per thread, the channel owns the buffer so it outlives the thread
+			thread_local ThreadBuffer<EventPacket>* buffer{ nullptr };
+			if (buffer == nullptr)
+			{
+				QueuedChannel<EventPacket>& channel{ GetQueuedChannel<EventPacket>() };
+				const std::lock_guard<std::mutex> lock{ channel.threadBuffersMutex };
+				channel.threadBuffers.push_back(std::make_unique<ThreadBuffer<EventPacket>>());
+				buffer = channel.threadBuffers.back().get();
+			}
+			return *buffer;
+		}
+
+
+		static inline void AcquireGuard(std::atomic_flag& _guard)
+		{
+			while (_guard.test_and_set(std::memory_order_acquire))
+			{
+				_guard.wait(true, std::memory_order_relaxed);
+			}
+		}
+
+
+		static inline void ReleaseGuard(std::atomic_flag& _guard)
+		{
+			_guard.clear(std::memory_order_release);
+			_guard.notify_one();
+		}
+
+
+		template<typename Arg>
+		static inline EventSubscriptionID AddSubscriber(Delegate<Arg>& _delegate)
+		{
+			_delegate.id = m_nextID++;
+			GetSubscribers<Arg>().delegates.push_back(_delegate);
+			return _delegate.id;
+		}
+
+
+		template<typename Arg, typename Callback>
+		static inline EventSubscriptionID SubscribeCallable(Callback&& _callback)
+		{
+			Delegate<Arg> delegate{};
+			if constexpr (std::is_convertible_v<Callback, void(*)(Arg)>)
+			{
+				//Plain function pointer (includes captureless lambdas) - can be stored and called directly
+				StoreCallable(delegate, static_cast<void(*)(Arg)>(_callback));
+				delegate.invoke = [](void*, const void* _callable, Arg _arg) { LoadCallable<void(*)(Arg)>(_callable)(_arg); };
+			}
+			else
+			{
+				//Arbitrary callables (capturing lambdas, std::function, etc.) have to be owned by the event manager - heap allocate a copy and bind the subscriber to it
+				//This is the only subscription type that pays for std::function, prefer the other overloads on hot events
+				using Owned = std::function<void(Arg)>;
+				delegate.instance = new Owned(std::forward<Callback>(_callback));
+				delegate.invoke = [](void* _instance, const void*, Arg _arg) { (*static_cast<Owned*>(_instance))(_arg); };
+				delegate.destroy = [](void* _instance) { delete static_cast<Owned*>(_instance); };
+			}
+			return AddSubscriber<Arg>(delegate);
+		}
+
+
+		template<typename Class, typename Arg, typename MemberCallback>
+		static inline EventSubscriptionID SubscribeMember(Class* _classInstance, MemberCallback _memberCallback)
+		{
+			Delegate<Arg> delegate{};
+			delegate.instance = _classInstance;
+			StoreCallable(delegate, _memberCallback);
+			delegate.invoke = [](void* _instance, const void* _callable, Arg _arg) { (static_cast<Class*>(_instance)->*LoadCallable<MemberCallback>(_callable))(_arg); };
+			return AddSubscriber<Arg>(delegate);
+		}
+
+
+		//Returns false if the subscription id wasn't found
+		template<typename Arg>
+		[[nodiscard]] static inline bool RemoveSubscriber(const EventSubscriptionID _subscriptionID)
+		{
+			Subscribers<Arg>& subscribers{ GetSubscribers<Arg>() };
+			for (std::size_t i{ 0 }; i < subscribers.delegates.size(); ++i)
+			{
+				Delegate<Arg>& delegate{ subscribers.delegates[i] };
+				if (delegate.id != _subscriptionID || delegate.invoke == nullptr) { continue; }
+
+				if (subscribers.dispatchDepth > 0)
+				{
+					//Currently inside an Invoke() for this argument type - erasing would shift the vector out from under it (and the delegate might be the one currently executing)
+					//Tombstone the delegate and let the outermost Invoke() destroy it and compact the vector once it's finished
+					delegate.invoke = nullptr;
+					subscribers.compactPending = true;
+				}
+				else
+				{
+					if (delegate.destroy) { delegate.destroy(delegate.instance); }
+
+					//Erase rather than swap-and-pop so callbacks keep being called in subscription order
+					subscribers.delegates.erase(subscribers.delegates.begin() + static_cast<std::ptrdiff_t>(i));
+				}
+				return true;
+			}
+			return false;
+		}
+
+
+		template<typename Arg>
+		static inline void Invoke(Arg _arg)
+		{
+			Subscribers<Arg>& subscribers{ GetSubscribers<Arg>() };
+			if (subscribers.delegates.empty())
 			{
 				//No callbacks subscribed to this event
 				return;
 			}
 
 			//Call all callbacks subscribed to this event
-			for (std::unordered_map<EventSubscriptionID, std::function<void(const std::any&)>>::const_iterator callbacksIt{ it->second.begin() }; callbacksIt != it->second.end(); ++callbacksIt)
+			//Index-based with the size re-read every iteration so callbacks are free to subscribe more listeners (they'll be called this time around too)
+			{
+				const DispatchScope<Arg> scope{ subscribers };
+				for (std::size_t i{ 0 }; i < subscribers.delegates.size(); ++i)
+				{
+					const Delegate<Arg>& delegate{ subscribers.delegates[i] };
+					if (delegate.invoke) { delegate.invoke(delegate.instance, delegate.callable, _arg); }
+				}
+			}
+
+			if (subscribers.dispatchDepth == 0 && subscribers.compactPending)
 			{
-				callbacksIt->second(_packet);
+				std::erase_if(subscribers.delegates, [](const Delegate<Arg>& _delegate)
+				{
+					if (_delegate.invoke != nullptr) { return false; }
+					if (_delegate.destroy) { _delegate.destroy(_delegate.instance); }
+					return true;
+				});
+				subscribers.compactPending = false;
 			}
 		}
 
 
-	private:
+		template<typename Arg, typename Callable>
+		static inline void StoreCallable(Delegate<Arg>& _delegate, const Callable _callable)
+		{
+			static_assert(sizeof(Callable) <= CALLABLE_STORAGE_SIZE, "EventManager::StoreCallable() - Callable is too large for the delegate's inline storage");
+			static_assert(std::is_trivially_copyable_v<Callable>, "EventManager::StoreCallable() - Callable must be trivially copyable");
+			std::memcpy(_delegate.callable, &_callable, sizeof(Callable));
+		}
+
+
+		template<typename Callable>
+		[[nodiscard]] static inline Callable LoadCallable(const void* _storage)
+		{
+			Callable callable;
+			std::memcpy(&callable, _storage, sizeof(Callable));
+			return callable;
+		}
+
+
 		//Atomic to maintain uniqueness between threads
 		static inline std::atomic<EventSubscriptionID> m_nextID{ 0 };
-		
-		//Map from event (identified by its unique packet type) to all callbacks subscribed to the event
-		//"All callbacks subscribed to the event" is stored as a map from subscription id to the corresponding callback to make lookup easier
-		static inline std::unordered_map<std::type_index, std::unordered_map<EventSubscriptionID, std::function<void(const std::any&)>>> m_callbacks;
+
+		//Type-erased DispatchQueued<EventPacket>() for every queued event type that's been used, so DispatchQueued() can drain them all
+		static inline std::mutex m_queuedChannelsMutex;
+		static inline std::vector<void(*)()> m_queuedChannelDispatchers;
 	};
 
-}
\ No newline at end of file
+}
@@ -5,6 +5,8 @@ namespace NK
 {
 
 
+	#ifndef NEKI_HEADLESS
+	
 	void InputManager::Update()
 	{
 		if (!m_window) { throw std::runtime_error("InputManager::Update() was called, but m_window is nullptr. Set the window with InputManager::SetWindow()"); }
@@ -53,6 +55,18 @@ namespace NK
 		return (glfwGetMouseButton(m_window->GetGLFWWindow(), InputUtils::GetGLFWMouseButton(_button)) == GLFW_RELEASE);
 	}
 
+	#else
+
+	//Headless builds have no devices to poll - every key and mouse button reads as up, so bindings evaluate to their resting state
+
+	void InputManager::Update() {}
+	bool InputManager::GetKeyPressed(const KEYBOARD) { return false; }
+	bool InputManager::GetKeyReleased(const KEYBOARD) { return true; }
+	bool InputManager::GetMouseButtonPressed(const MOUSE_BUTTON) { return false; }
+	bool InputManager::GetMouseButtonReleased(const MOUSE_BUTTON) { return true; }
+
+	#endif
+
 
 
 	glm::vec2 InputManager::GetMouseDiff()
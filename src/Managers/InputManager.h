@@ -3,7 +3,9 @@
 #include "Input-Bindings/Axis2DBinding.h"
 
 #include <Core/Utils/Serialisation/TypeRegistry.h>
-#include <Graphics/Window.h>
+#ifndef NEKI_HEADLESS
+	#include <Graphics/Window.h>
+#endif
 #include <Types/NekiTypes.h>
 
 #include <stdexcept>
@@ -12,6 +14,10 @@
 
 namespace NK
 {
+	
+	#ifdef NEKI_HEADLESS
+		class Window; //No windows in headless builds - devices are never pressed, but bindings and action types still work for input arriving over the network
+	#endif
 
 	typedef std::variant<ButtonBinding, Axis1DBinding, Axis2DBinding> INPUT_BINDING_VARIANT;
 	
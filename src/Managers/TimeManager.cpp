@@ -1,7 +1,10 @@
 #include "TimeManager.h"
 
-#include <iostream>
-#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <thread>
+#if defined(_WIN32)
+	#include <windows.h>
+#endif
 
 
 namespace NK
@@ -9,9 +12,74 @@ namespace NK
 	
 	void TimeManager::Update()
 	{
-		m_totalTime = glfwGetTime();
-		m_dt = m_totalTime - m_lastTime;
-		m_lastTime = m_totalTime;
+		const std::chrono::steady_clock::time_point now{ std::chrono::steady_clock::now() };
+		m_dt = std::chrono::duration<double>(now - m_lastTimePoint).count();
+		m_totalTime = std::chrono::duration<double>(now - m_startTimePoint).count();
+		m_lastTimePoint = now;
+	}
+
+
+
+	void TimeManager::Update(const double _deltaTime)
+	{
+		m_dt = _deltaTime;
+		m_totalTime += _deltaTime;
+		m_lastTimePoint = std::chrono::steady_clock::now();
+	}
+
+
+
+	double TimeManager::GetTimeSinceStartup()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTimePoint).count();
+	}
+
+
+
+	void TimeManager::SleepUntil(const std::chrono::steady_clock::time_point _timePoint)
+	{
+		#if defined(_WIN32)
+
+			//Sleep() (and so sleep_until()) rounds up to the next system timer tick - ~15.6ms by default, which is most of a 60Hz tick
+			//A high resolution waitable timer (Windows 10 1803+) wakes within about half a millisecond instead, fall back to sleep_until() if it isn't available
+			thread_local const HANDLE timer{ CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS) };
+			if (timer)
+			{
+				const std::chrono::steady_clock::duration remaining{ _timePoint - std::chrono::steady_clock::now() };
+				if (remaining <= std::chrono::steady_clock::duration::zero()) { return; }
+
+				//Negative = relative, in 100ns units
+				LARGE_INTEGER dueTime{};
+				dueTime.QuadPart = -static_cast<LONGLONG>(std::chrono::duration_cast<std::chrono::duration<LONGLONG, std::ratio<1, 10'000'000>>>(remaining).count());
+				if (SetWaitableTimerEx(timer, &dueTime, 0, nullptr, nullptr, nullptr, 0))
+				{
+					WaitForSingleObject(timer, INFINITE);
+					return;
+				}
+			}
+
+		#endif
+
+		//clock_nanosleep on linux - already precise to tens of microseconds
+		std::this_thread::sleep_until(_timePoint);
+	}
+
+
+
+	void TimeManager::WaitUntil(const std::chrono::steady_clock::time_point _timePoint)
+	{
+		const std::chrono::steady_clock::time_point sleepUntil{ _timePoint - m_spinMargin };
+		if (std::chrono::steady_clock::now() < sleepUntil)
+		{
+			SleepUntil(sleepUntil);
+
+			//Sleeps wake up late, never early - the margin jumps straight up to the latest overshoot and creeps back down, so it covers the worst recent case without spinning for ages after one bad wake
+			const std::chrono::steady_clock::duration overshoot{ std::chrono::steady_clock::now() - sleepUntil };
+			const std::chrono::steady_clock::duration decayed{ m_spinMargin - m_spinMargin / 64 };
+			m_spinMargin = std::clamp(std::max(overshoot + overshoot / 4, decayed), std::chrono::steady_clock::duration{ std::chrono::microseconds(50) }, std::chrono::steady_clock::duration{ std::chrono::milliseconds(4) });
+		}
+
+		while (std::chrono::steady_clock::now() < _timePoint) { std::this_thread::yield(); }
 	}
 	
-}
\ No newline at end of file
+}
@@ -1,21 +1,38 @@
 #pragma once
 
+#include <chrono>
+
 
 namespace NK
 {
 	
+	//Time comes from std::chrono::steady_clock rather than glfw so it's monotonic and works without a window (e.g. in NEKI_HEADLESS builds)
 	class TimeManager final
 	{
 	public:
 		static void Update();
+		//Step time forward by exactly _deltaTime rather than measuring it - for replays (see Replay), so everything reading the delta/total time sees the recorded values
+		static void Update(double _deltaTime);
 		[[nodiscard]] static inline double GetDeltaTime() { return m_dt; }
-		[[nodiscard]] static inline double GetTotalTime() { return m_totalTime; }
+		[[nodiscard]] static inline double GetTotalTime() { return m_totalTime; } //Seconds since startup, as of the last Update()
+		[[nodiscard]] static inline std::chrono::steady_clock::time_point GetLastUpdateTimePoint() { return m_lastTimePoint; }
+		
+		//Seconds since startup, right now
+		[[nodiscard]] static double GetTimeSinceStartup();
+
+		//Block the calling thread until _timePoint without spinning
+		static void SleepUntil(const std::chrono::steady_clock::time_point _timePoint);
+		//Block the calling thread until _timePoint, to within a few microseconds - sleeps most of the way, then spins for the last bit, which is as long as sleeps have recently been overshooting by
+		//Main thread only
+		static void WaitUntil(const std::chrono::steady_clock::time_point _timePoint);
 		
 		
 	private:
+		inline static const std::chrono::steady_clock::time_point m_startTimePoint{ std::chrono::steady_clock::now() };
+		inline static std::chrono::steady_clock::time_point m_lastTimePoint{ m_startTimePoint };
 		inline static double m_dt{ 0.0 };
-		inline static double m_lastTime{ 0.0 };
 		inline static double m_totalTime{ 0.0 };
+		inline static std::chrono::steady_clock::duration m_spinMargin{ std::chrono::milliseconds(1) }; //How early WaitUntil() stops sleeping and starts spinning
 	};
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace NK
+{
+
+	//Reads back what a BitWriter wrote
+	//Bounds-checked - reading past the end returns 0s and marks the reader as overrun rather than touching memory it shouldn't, so a whole packet can be read and checked once at the end (HasOverrun()) instead of after every value
+	class BitReader final
+	{
+	public:
+		explicit BitReader(const std::uint8_t* _data, const std::size_t _size) : m_data(_data), m_size(_size) {}
+
+
+		//Reads _bits bits - _bits must be 32 or fewer
+		[[nodiscard]] inline std::uint32_t ReadBits(const std::uint32_t _bits)
+		{
+			if (_bits == 0) { return 0; }
+			while (m_scratchBits < _bits)
+			{
+				if (m_position >= m_size)
+				{
+					m_overrun = true;
+					return 0;
+				}
+				m_scratch |= static_cast<std::uint64_t>(m_data[m_position++]) << m_scratchBits;
+				m_scratchBits += 8;
+			}
+			const std::uint32_t value{ static_cast<std::uint32_t>(m_scratch & ((std::uint64_t{ 1 } << _bits) - 1)) };
+			m_scratch >>= _bits;
+			m_scratchBits -= _bits;
+			return value;
+		}
+
+		[[nodiscard]] inline bool ReadBool() { return ReadBits(1) != 0; }
+		[[nodiscard]] inline float ReadFloat() { return std::bit_cast<float>(ReadBits(32)); }
+
+		[[nodiscard]] inline std::uint32_t ReadVarUInt()
+		{
+			std::uint32_t value{ 0 };
+			//5 groups of 7 bits covers 32 bits - any more and the data's bad
+			for (std::uint32_t shift{ 0 }; shift < 35; shift += 7)
+			{
+				const bool more{ ReadBool() };
+				value |= ReadBits(7) << shift;
+				if (!more || m_overrun) { return value; }
+			}
+			m_overrun = true;
+			return 0;
+		}
+
+		//Whether anything has been read past the end of the data (or a malformed varint was hit) - everything read since then is 0s
+		[[nodiscard]] inline bool HasOverrun() const { return m_overrun; }
+
+
+	private:
+		const std::uint8_t* m_data;
+		std::size_t m_size;
+		std::size_t m_position{ 0 };
+		std::uint64_t m_scratch{ 0 };
+		std::uint32_t m_scratchBits{ 0 };
+		bool m_overrun{ false };
+	};
+
+}
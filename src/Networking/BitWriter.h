@@ -0,0 +1,75 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace NK
+{
+
+	//Packs values into a byte buffer at bit granularity - least significant bit first, so a value can straddle bytes without any shuffling on the other end (see BitReader)
+	//Appends to a caller-owned buffer so it can be reused from one packet to the next without reallocating
+	class BitWriter final
+	{
+	public:
+		explicit BitWriter(std::vector<std::uint8_t>& _buffer) : m_buffer(_buffer) {}
+		~BitWriter() { Flush(); }
+
+		BitWriter(const BitWriter&) = delete;
+		BitWriter& operator=(const BitWriter&) = delete;
+
+
+		//Writes the low _bits bits of _value - _bits must be 32 or fewer
+		inline void WriteBits(const std::uint32_t _value, const std::uint32_t _bits)
+		{
+			if (_bits == 0) { return; }
+			m_scratch |= (static_cast<std::uint64_t>(_value) & ((std::uint64_t{ 1 } << _bits) - 1)) << m_scratchBits;
+			m_scratchBits += _bits;
+			m_bitsWritten += _bits;
+			while (m_scratchBits >= 8)
+			{
+				m_buffer.push_back(static_cast<std::uint8_t>(m_scratch));
+				m_scratch >>= 8;
+				m_scratchBits -= 8;
+			}
+		}
+
+		inline void WriteBool(const bool _value) { WriteBits(_value ? 1u : 0u, 1); }
+		inline void WriteFloat(const float _value) { WriteBits(std::bit_cast<std::uint32_t>(_value), 32); }
+
+		//7 bits at a time with a continuation bit in front of each group - small values (counts, gaps between sorted ids) only take a byte
+		inline void WriteVarUInt(std::uint32_t _value)
+		{
+			while (_value >= 0x80)
+			{
+				WriteBits(1, 1);
+				WriteBits(_value & 0x7F, 7);
+				_value >>= 7;
+			}
+			WriteBits(0, 1);
+			WriteBits(_value, 7);
+		}
+
+		//Pads out to a whole byte and writes it - done automatically on destruction, only needed to read the buffer while the writer's still alive
+		inline void Flush()
+		{
+			if (m_scratchBits == 0) { return; }
+			m_buffer.push_back(static_cast<std::uint8_t>(m_scratch));
+			m_bitsWritten += 8 - m_scratchBits;
+			m_scratch = 0;
+			m_scratchBits = 0;
+		}
+
+		[[nodiscard]] inline std::size_t GetBitsWritten() const { return m_bitsWritten; }
+
+
+	private:
+		std::vector<std::uint8_t>& m_buffer;
+		std::uint64_t m_scratch{ 0 }; //Bits not yet written out - always fewer than 8 between calls
+		std::uint32_t m_scratchBits{ 0 };
+		std::size_t m_bitsWritten{ 0 };
+	};
+
+}
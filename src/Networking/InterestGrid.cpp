@@ -0,0 +1,40 @@
+#include "InterestGrid.h"
+
+#include <stdexcept>
+
+
+namespace NK
+{
+
+	InterestGrid::InterestGrid(const float _cellSize) : m_cellSize(_cellSize)
+	{
+		if (!(m_cellSize > 0.0f))
+		{
+			throw std::runtime_error("InterestGrid::InterestGrid() - _cellSize must be greater than 0");
+		}
+	}
+
+
+
+	void InterestGrid::Clear()
+	{
+		for (std::unordered_map<std::uint64_t, std::vector<std::pair<Entity, glm::vec3>>>::iterator it{ m_cells.begin() }; it != m_cells.end();)
+		{
+			if (it->second.empty())
+			{
+				it = m_cells.erase(it);
+				continue;
+			}
+			it->second.clear();
+			++it;
+		}
+	}
+
+
+
+	void InterestGrid::Insert(const Entity _entity, const glm::vec3& _pos)
+	{
+		m_cells[GetCellKey(GetCellCoord(_pos.x), GetCellCoord(_pos.y), GetCellCoord(_pos.z))].emplace_back(_entity, _pos);
+	}
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <Core-ECS/Entity.h>
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+
+namespace NK
+{
+
+	//Uniform spatial hash over replicated entities' positions, rebuilt every server tick - answers "what's within r of here" by only looking at the cells that overlap the query sphere
+	//Cells are only created where there's something in them, so the world doesn't need bounds. Works best with a cell size around the query radius - much smaller and queries walk lots of empty cells, much bigger and they test lots of far-away entities
+	//Used by ServerNetworkLayer for area-of-interest filtering
+	class InterestGrid final
+	{
+	public:
+		explicit InterestGrid(float _cellSize);
+
+		//Empties every cell, keeping their capacity for the next rebuild - cells that were already empty are dropped so the map doesn't grow forever as things move around
+		void Clear();
+		void Insert(Entity _entity, const glm::vec3& _pos);
+
+		//Calls _func(entity, distanceSquared) for every entity within _radius of _centre
+		template<typename Func>
+		void ForEachInRadius(const glm::vec3& _centre, float _radius, Func&& _func) const;
+
+		[[nodiscard]] inline float GetCellSize() const { return m_cellSize; }
+
+
+	private:
+		[[nodiscard]] inline std::int32_t GetCellCoord(const float _value) const { return static_cast<std::int32_t>(std::floor(_value / m_cellSize)); }
+		//21 bits per axis - over a million cells in each direction, which is plenty
+		[[nodiscard]] inline static std::uint64_t GetCellKey(const std::int32_t _x, const std::int32_t _y, const std::int32_t _z)
+		{
+			constexpr std::uint64_t mask{ (std::uint64_t{ 1 } << 21) - 1 };
+			return ((static_cast<std::uint64_t>(_x) & mask) << 42) | ((static_cast<std::uint64_t>(_y) & mask) << 21) | (static_cast<std::uint64_t>(_z) & mask);
+		}
+
+
+		float m_cellSize;
+		std::unordered_map<std::uint64_t, std::vector<std::pair<Entity, glm::vec3>>> m_cells;
+	};
+
+
+
+	template<typename Func>
+	void InterestGrid::ForEachInRadius(const glm::vec3& _centre, const float _radius, Func&& _func) const
+	{
+		const float radiusSquared{ _radius * _radius };
+		const glm::ivec3 min{ GetCellCoord(_centre.x - _radius), GetCellCoord(_centre.y - _radius), GetCellCoord(_centre.z - _radius) };
+		const glm::ivec3 max{ GetCellCoord(_centre.x + _radius), GetCellCoord(_centre.y + _radius), GetCellCoord(_centre.z + _radius) };
+		for (std::int32_t x{ min.x }; x <= max.x; ++x)
+		{
+			for (std::int32_t y{ min.y }; y <= max.y; ++y)
+			{
+				for (std::int32_t z{ min.z }; z <= max.z; ++z)
+				{
+					const std::unordered_map<std::uint64_t, std::vector<std::pair<Entity, glm::vec3>>>::const_iterator cell{ m_cells.find(GetCellKey(x, y, z)) };
+					if (cell == m_cells.end()) { continue; }
+					for (const std::pair<Entity, glm::vec3>& entry : cell->second)
+					{
+						const glm::vec3 offset{ entry.second - _centre };
+						const float distanceSquared{ glm::dot(offset, offset) };
+						if (distanceSquared <= radiusSquared) { _func(entry.first, distanceSquared); }
+					}
+				}
+			}
+		}
+	}
+
+}
@@ -0,0 +1,30 @@
+#include "NetworkBufferPool.h"
+
+
+namespace NK
+{
+
+	NetworkBufferPool::Buffer NetworkBufferPool::Acquire()
+	{
+		std::vector<std::uint8_t> bytes;
+		{
+			const std::lock_guard lock(m_mutex);
+			if (!m_freeBuffers.empty())
+			{
+				bytes = std::move(m_freeBuffers.back());
+				m_freeBuffers.pop_back();
+			}
+		}
+		bytes.clear();
+		return Buffer(*this, std::move(bytes));
+	}
+
+
+
+	void NetworkBufferPool::Release(std::vector<std::uint8_t>&& _bytes)
+	{
+		const std::lock_guard lock(m_mutex);
+		m_freeBuffers.push_back(std::move(_bytes));
+	}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+
+namespace NK
+{
+
+	//Byte buffers for building packets in, handed back out again once they've been sent - they keep their capacity, so once every buffer has grown to the biggest packet it's needed for, building a packet never allocates
+	//Thread-safe, so buffers can be filled on one thread and sent (and released) on another
+	class NetworkBufferPool final
+	{
+	public:
+		//A buffer on loan from the pool - goes back when this is destroyed
+		class Buffer final
+		{
+		public:
+			Buffer(NetworkBufferPool& _pool, std::vector<std::uint8_t>&& _bytes) : m_pool(&_pool), m_bytes(std::move(_bytes)) {}
+			~Buffer() { if (m_pool) { m_pool->Release(std::move(m_bytes)); } }
+
+			Buffer(const Buffer&) = delete;
+			Buffer& operator=(const Buffer&) = delete;
+			Buffer(Buffer&& _other) noexcept : m_pool(std::exchange(_other.m_pool, nullptr)), m_bytes(std::move(_other.m_bytes)) {}
+			Buffer& operator=(Buffer&& _other) noexcept
+			{
+				if (this != &_other)
+				{
+					if (m_pool) { m_pool->Release(std::move(m_bytes)); }
+					m_pool = std::exchange(_other.m_pool, nullptr);
+					m_bytes = std::move(_other.m_bytes);
+				}
+				return *this;
+			}
+
+			[[nodiscard]] inline std::vector<std::uint8_t>& Get() { return m_bytes; }
+			[[nodiscard]] inline const std::vector<std::uint8_t>& Get() const { return m_bytes; }
+
+
+		private:
+			NetworkBufferPool* m_pool;
+			std::vector<std::uint8_t> m_bytes;
+		};
+
+
+		NetworkBufferPool() = default;
+		~NetworkBufferPool() = default;
+
+		NetworkBufferPool(const NetworkBufferPool&) = delete;
+		NetworkBufferPool& operator=(const NetworkBufferPool&) = delete;
+
+		//An empty buffer - the pool must outlive it
+		[[nodiscard]] Buffer Acquire();
+
+
+	private:
+		void Release(std::vector<std::uint8_t>&& _bytes);
+
+
+		std::mutex m_mutex;
+		std::vector<std::vector<std::uint8_t>> m_freeBuffers;
+	};
+
+}
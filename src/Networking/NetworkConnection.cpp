@@ -0,0 +1,331 @@
+#include "NetworkConnection.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+
+namespace NK
+{
+
+	namespace
+	{
+		//Big-endian, like sf::Packet
+		void WriteUInt16(std::vector<std::uint8_t>& _buffer, const std::uint16_t _value)
+		{
+			_buffer.push_back(static_cast<std::uint8_t>(_value >> 8));
+			_buffer.push_back(static_cast<std::uint8_t>(_value));
+		}
+
+		void WriteUInt32(std::vector<std::uint8_t>& _buffer, const std::uint32_t _value)
+		{
+			WriteUInt16(_buffer, static_cast<std::uint16_t>(_value >> 16));
+			WriteUInt16(_buffer, static_cast<std::uint16_t>(_value));
+		}
+
+		[[nodiscard]] std::uint16_t ReadUInt16(const std::uint8_t* _data)
+		{
+			return static_cast<std::uint16_t>((_data[0] << 8) | _data[1]);
+		}
+
+		[[nodiscard]] std::uint32_t ReadUInt32(const std::uint8_t* _data)
+		{
+			return (static_cast<std::uint32_t>(ReadUInt16(_data)) << 16) | ReadUInt16(_data + 2);
+		}
+
+		[[nodiscard]] std::size_t GetMessageHeaderSize(const NETWORK_CHANNEL _channel)
+		{
+			return 1 + (_channel == NETWORK_CHANNEL::UNRELIABLE ? 0 : 2) + 2;
+		}
+	}
+
+
+
+	NetworkConnection::NetworkConnection(const NetworkConnectionConfig& _config)
+	: m_config(_config), m_nextSequence(0), m_nextReliableID(0), m_nextSequencedID(0),
+	  m_receivedAny(false), m_remoteSequence(0), m_receivedBits(0), m_ackOwed(false), m_nextExpectedID(0), m_reliableInReceived{}, m_receivedSequenced(false), m_lastSequencedID(0), m_receivedCount(0),
+	  m_measuredRTT(false), m_smoothedRTT(0.0), m_rttVariance(0.0), m_resendTimeout(_config.initialResendTimeout), m_resent(0), m_dropped(0)
+	{
+		if (m_config.maxMessageSize > std::numeric_limits<std::uint16_t>::max())
+		{
+			throw std::runtime_error("NetworkConnection::NetworkConnection() - _config.maxMessageSize must fit in 16 bits");
+		}
+		if (!(m_config.minResendTimeout > 0.0) || m_config.maxResendTimeout < m_config.minResendTimeout)
+		{
+			throw std::runtime_error("NetworkConnection::NetworkConnection() - _config.minResendTimeout must be greater than 0, and no greater than _config.maxResendTimeout");
+		}
+	}
+
+
+
+	bool NetworkConnection::Send(const NETWORK_CHANNEL _channel, const std::uint8_t* _data, const std::size_t _size)
+	{
+		if (_size > m_config.maxMessageSize) { return false; }
+
+		switch (_channel)
+		{
+		case NETWORK_CHANNEL::RELIABLE_ORDERED:
+		{
+			if (m_reliableOut.size() >= RELIABLE_WINDOW) { return false; }
+			m_reliableOut.push_back({ m_nextReliableID++, std::vector<std::uint8_t>(_data, _data + _size) });
+			return true;
+		}
+		case NETWORK_CHANNEL::UNRELIABLE_SEQUENCED:
+		{
+			m_queued.push_back({ _channel, m_nextSequencedID++, std::vector<std::uint8_t>(_data, _data + _size) });
+			return true;
+		}
+		case NETWORK_CHANNEL::UNRELIABLE:
+		{
+			m_queued.push_back({ _channel, 0, std::vector<std::uint8_t>(_data, _data + _size) });
+			return true;
+		}
+		default:
+		{
+			return false;
+		}
+		}
+	}
+
+
+
+	void NetworkConnection::Write(std::vector<std::uint8_t>& _buffer, const double _time, const std::size_t _maxBytes)
+	{
+		const std::uint16_t sequence{ m_nextSequence++ };
+		SentPacket& sent{ m_sentPackets[sequence % PACKET_HISTORY_SIZE] };
+		sent.sequence = sequence;
+		sent.pending = true;
+		sent.time = _time;
+		sent.reliableIDs.clear();
+
+		WriteUInt16(_buffer, sequence);
+		WriteUInt16(_buffer, m_remoteSequence);
+		WriteUInt32(_buffer, m_receivedAny ? m_receivedBits : 0);
+		const std::size_t countPosition{ _buffer.size() };
+		_buffer.push_back(0);
+
+		std::size_t used{ HEADER_SIZE };
+		std::uint8_t count{ 0 };
+		const auto fits{ [&](const std::size_t _size) { return count < std::numeric_limits<std::uint8_t>::max() && (count == 0 || used + _size <= _maxBytes); } };
+		const auto write{ [&](const NETWORK_CHANNEL _channel, const std::uint16_t _id, const std::vector<std::uint8_t>& _data)
+		{
+			_buffer.push_back(static_cast<std::uint8_t>(std::to_underlying(_channel)));
+			if (_channel != NETWORK_CHANNEL::UNRELIABLE) { WriteUInt16(_buffer, _id); }
+			WriteUInt16(_buffer, static_cast<std::uint16_t>(_data.size()));
+			_buffer.insert(_buffer.end(), _data.begin(), _data.end());
+			used += GetMessageHeaderSize(_channel) + _data.size();
+			++count;
+		} };
+
+		//Reliable first - oldest first, and carry on past anything that doesn't fit in case something smaller behind it does
+		for (OutgoingMessage& message : m_reliableOut)
+		{
+			if (message.acked || !IsDue(message, _time) || !fits(GetMessageHeaderSize(NETWORK_CHANNEL::RELIABLE_ORDERED) + message.data.size())) { continue; }
+			write(NETWORK_CHANNEL::RELIABLE_ORDERED, message.id, message.data);
+			if (message.lastSent >= 0.0) { ++m_resent; }
+			message.lastSent = _time;
+			sent.reliableIDs.push_back(message.id);
+		}
+
+		for (const QueuedMessage& message : m_queued)
+		{
+			if (!fits(GetMessageHeaderSize(message.channel) + message.data.size()))
+			{
+				++m_dropped;
+				continue;
+			}
+			write(message.channel, message.id, message.data);
+		}
+		m_queued.clear();
+
+		_buffer[countPosition] = count;
+		m_ackOwed = false;
+	}
+
+
+
+	std::size_t NetworkConnection::Read(const std::uint8_t* _data, const std::size_t _size, const double _time)
+	{
+		if (_size < HEADER_SIZE) { return 0; }
+
+		//Check it all makes sense before touching anything
+		const std::uint8_t count{ _data[HEADER_SIZE - 1] };
+		std::size_t offset{ HEADER_SIZE };
+		bool reliable{ false };
+		for (std::uint8_t i{ 0 }; i < count; ++i)
+		{
+			if (offset >= _size || _data[offset] > std::to_underlying(NETWORK_CHANNEL::RELIABLE_ORDERED)) { return 0; }
+			const NETWORK_CHANNEL channel{ static_cast<NETWORK_CHANNEL>(_data[offset]) };
+			const std::size_t headerSize{ GetMessageHeaderSize(channel) };
+			if (offset + headerSize > _size) { return 0; }
+			const std::size_t size{ ReadUInt16(_data + offset + headerSize - 2) };
+			if (size > m_config.maxMessageSize || offset + headerSize + size > _size) { return 0; }
+			reliable |= (channel == NETWORK_CHANNEL::RELIABLE_ORDERED);
+			offset += headerSize + size;
+		}
+		const std::size_t end{ offset };
+
+
+		//Acks
+		const std::uint16_t sequence{ ReadUInt16(_data) };
+		const std::uint16_t ack{ ReadUInt16(_data + 2) };
+		const std::uint32_t ackBits{ ReadUInt32(_data + 4) };
+		for (std::uint16_t i{ 0 }; i < 32; ++i)
+		{
+			if (ackBits & (std::uint32_t{ 1 } << i)) { ProcessAck(static_cast<std::uint16_t>(ack - i), _time); }
+		}
+
+
+		//Keep track of what's been received to ack it back - and throw away the messages in anything that's already been received (the network duplicated it)
+		bool duplicate{ false };
+		if (!m_receivedAny || IsNewer(sequence, m_remoteSequence))
+		{
+			const std::uint16_t shift{ static_cast<std::uint16_t>(sequence - m_remoteSequence) };
+			m_receivedBits = (!m_receivedAny || shift >= 32) ? 1u : ((m_receivedBits << shift) | 1u);
+			m_remoteSequence = sequence;
+			m_receivedAny = true;
+		}
+		else
+		{
+			const std::uint16_t age{ static_cast<std::uint16_t>(m_remoteSequence - sequence) };
+			if (age < 32)
+			{
+				duplicate = (m_receivedBits & (std::uint32_t{ 1 } << age)) != 0;
+				m_receivedBits |= std::uint32_t{ 1 } << age;
+			}
+		}
+		if (duplicate) { return end; }
+		m_ackOwed |= reliable; //No need to ack back packets that don't need it - otherwise two ends with nothing else to send would keep acking each other's acks forever
+
+
+		//Messages
+		offset = HEADER_SIZE;
+		for (std::uint8_t i{ 0 }; i < count; ++i)
+		{
+			const NETWORK_CHANNEL channel{ static_cast<NETWORK_CHANNEL>(_data[offset]) };
+			const std::size_t headerSize{ GetMessageHeaderSize(channel) };
+			const std::uint16_t id{ channel == NETWORK_CHANNEL::UNRELIABLE ? std::uint16_t{ 0 } : ReadUInt16(_data + offset + 1) };
+			const std::size_t size{ ReadUInt16(_data + offset + headerSize - 2) };
+			const std::uint8_t* message{ _data + offset + headerSize };
+			offset += headerSize + size;
+
+			switch (channel)
+			{
+			case NETWORK_CHANNEL::UNRELIABLE:
+			{
+				PushReceived(channel).data.assign(message, message + size);
+				break;
+			}
+			case NETWORK_CHANNEL::UNRELIABLE_SEQUENCED:
+			{
+				if (m_receivedSequenced && !IsNewer(id, m_lastSequencedID)) { break; }
+				m_receivedSequenced = true;
+				m_lastSequencedID = id;
+				PushReceived(channel).data.assign(message, message + size);
+				break;
+			}
+			case NETWORK_CHANNEL::RELIABLE_ORDERED:
+			{
+				ReceiveReliable(id, message, size);
+				break;
+			}
+			}
+		}
+
+		return end;
+	}
+
+
+
+	bool NetworkConnection::NeedsPacket(const double _time) const
+	{
+		return m_ackOwed || !m_queued.empty() || std::ranges::any_of(m_reliableOut, [&](const OutgoingMessage& _message) { return !_message.acked && IsDue(_message, _time); });
+	}
+
+
+
+	std::size_t NetworkConnection::GetPendingBytes(const double _time) const
+	{
+		std::size_t bytes{ 0 };
+		for (const OutgoingMessage& message : m_reliableOut)
+		{
+			if (!message.acked && IsDue(message, _time)) { bytes += GetMessageHeaderSize(NETWORK_CHANNEL::RELIABLE_ORDERED) + message.data.size(); }
+		}
+		for (const QueuedMessage& message : m_queued) { bytes += GetMessageHeaderSize(message.channel) + message.data.size(); }
+		return bytes;
+	}
+
+
+
+	bool NetworkConnection::IsDue(const OutgoingMessage& _message, const double _time) const
+	{
+		return _message.lastSent < 0.0 || _time - _message.lastSent >= m_resendTimeout;
+	}
+
+
+
+	void NetworkConnection::ProcessAck(const std::uint16_t _sequence, const double _time)
+	{
+		SentPacket& sent{ m_sentPackets[_sequence % PACKET_HISTORY_SIZE] };
+		if (!sent.pending || sent.sequence != _sequence) { return; }
+		sent.pending = false;
+
+		//Acks are per packet rather than per message, so a resent message's ack can't be mistaken for the original's - every ack is a good round trip sample
+		const double sample{ std::max(_time - sent.time, 0.0) };
+		if (!m_measuredRTT)
+		{
+			m_smoothedRTT = sample;
+			m_rttVariance = sample / 2.0;
+			m_measuredRTT = true;
+		}
+		else
+		{
+			m_rttVariance = 0.75 * m_rttVariance + 0.25 * std::abs(m_smoothedRTT - sample);
+			m_smoothedRTT = 0.875 * m_smoothedRTT + 0.125 * sample;
+		}
+		m_resendTimeout = std::clamp(m_smoothedRTT + 4.0 * m_rttVariance, m_config.minResendTimeout, m_config.maxResendTimeout);
+
+		//m_reliableOut has no gaps in its ids, so each one's position is just its distance from the front
+		for (const std::uint16_t id : sent.reliableIDs)
+		{
+			if (m_reliableOut.empty()) { break; }
+			const std::uint16_t index{ static_cast<std::uint16_t>(id - m_reliableOut.front().id) };
+			if (index < m_reliableOut.size()) { m_reliableOut[index].acked = true; }
+		}
+		while (!m_reliableOut.empty() && m_reliableOut.front().acked) { m_reliableOut.pop_front(); }
+	}
+
+
+
+	void NetworkConnection::ReceiveReliable(const std::uint16_t _id, const std::uint8_t* _data, const std::size_t _size)
+	{
+		//Anything behind the next expected id has already been handed over - the sender never has more than RELIABLE_WINDOW in flight, so anything further ahead than that is nonsense
+		if (static_cast<std::uint16_t>(_id - m_nextExpectedID) >= RELIABLE_WINDOW) { return; }
+		const std::size_t slot{ _id % RELIABLE_WINDOW };
+		if (m_reliableInReceived[slot]) { return; }
+		m_reliableIn[slot].assign(_data, _data + _size);
+		m_reliableInReceived[slot] = true;
+
+		//Hand over everything that's now in order - swapping the buffers so both sides keep theirs for reuse
+		while (m_reliableInReceived[m_nextExpectedID % RELIABLE_WINDOW])
+		{
+			const std::size_t next{ m_nextExpectedID % RELIABLE_WINDOW };
+			std::swap(PushReceived(NETWORK_CHANNEL::RELIABLE_ORDERED).data, m_reliableIn[next]);
+			m_reliableInReceived[next] = false;
+			++m_nextExpectedID;
+		}
+	}
+
+
+
+	NetworkConnection::ReceivedMessage& NetworkConnection::PushReceived(const NETWORK_CHANNEL _channel)
+	{
+		if (m_receivedCount == m_received.size()) { m_received.emplace_back(); }
+		ReceivedMessage& message{ m_received[m_receivedCount++] };
+		message.channel = _channel;
+		return message;
+	}
+
+}
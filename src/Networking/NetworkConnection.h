@@ -0,0 +1,154 @@
+#pragma once
+
+#include <Types/NekiTypes.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+
+namespace NK
+{
+
+	struct NetworkConnectionConfig
+	{
+		std::uint32_t maxMessageSize{ 1024 }; //Bytes - NetworkConnection::Send() turns down anything bigger
+		double initialResendTimeout{ 0.2 }; //Seconds before an unacked reliable message is resent, until there's a round trip time to go off
+		double minResendTimeout{ 0.05 }; //The resend timeout follows the measured round trip time (plus some leeway for jitter), within these
+		double maxResendTimeout{ 1.0 };
+	};
+
+
+	//One end of a message-based connection over UDP, on top of whatever else gets sent (state packets) - the other end has one too
+	//Every packet sent through it gets a 16-bit sequence number, and carries an ack for the last 32 it received from the other end - so acks come for free on the state packets that are going every tick anyway
+	//Messages go on one of three channels (see NETWORK_CHANNEL):
+	//- UNRELIABLE: sent once, in the next packet, and that's it
+	//- UNRELIABLE_SEQUENCED: the same, but anything older than the newest one already received is thrown away
+	//- RELIABLE_ORDERED: resent until acked - on a timeout from the measured round trip time - and handed over in the order they were sent
+	//Unlike TCP, a lost packet only holds up the reliable messages behind it, not the state that came with it - and everything in one packet (events, state) arrives together
+	//
+	//Wire format (big-endian, like sf::Packet), written in front of the state packet it's riding on:
+	//[u16 sequence][u16 ack][u32 ack bits - bit i means ack - i was received, 0 if nothing has been][u8 message count]
+	//then per message: [u8 channel][u16 message id - not for UNRELIABLE][u16 size][size bytes]
+	class NetworkConnection final
+	{
+	public:
+		explicit NetworkConnection(const NetworkConnectionConfig& _config);
+
+		//Queues a message to go in the next packet(s) - returns false (queueing nothing) if it's bigger than maxMessageSize, or the reliable channel has too many messages waiting on acks
+		bool Send(NETWORK_CHANNEL _channel, const std::uint8_t* _data, std::size_t _size);
+
+		//Writes a header and as many queued messages as fit in _maxBytes onto the end of _buffer - reliable messages that are due first, then the rest in the order they were queued
+		//The first message always goes in even if it doesn't fit, so one bigger than _maxBytes can't hold everything up (the packet will just need fragmenting) - unreliable messages that don't fit are dropped
+		void Write(std::vector<std::uint8_t>& _buffer, double _time, std::size_t _maxBytes);
+		//_data / _size start at a header written by the other end's Write() - processes its acks and takes out its messages, ready for PopReceived()
+		//Returns how many bytes it took up (the state packet it was riding on comes after), or 0 if it didn't make sense
+		[[nodiscard]] std::size_t Read(const std::uint8_t* _data, std::size_t _size, double _time);
+		//Calls _func(NETWORK_CHANNEL channel, const std::uint8_t* data, std::size_t size) for every message received since the last call, in the order they should be handled
+		template<typename Func>
+		void PopReceived(Func&& _func);
+
+		//Whether there's anything worth sending a packet for at _time, even with no state to go with it - acks owed, or messages queued / due a resend
+		[[nodiscard]] bool NeedsPacket(double _time) const;
+		//Roughly how many bytes of messages the next Write() would like to send
+		[[nodiscard]] std::size_t GetPendingBytes(double _time) const;
+
+		[[nodiscard]] inline double GetRoundTripTime() const { return m_smoothedRTT; } //0 until the first ack comes back
+		[[nodiscard]] inline double GetResendTimeout() const { return m_resendTimeout; }
+		[[nodiscard]] inline std::size_t GetUnackedCount() const { return m_reliableOut.size(); }
+		[[nodiscard]] inline std::size_t GetResentCount() const { return m_resent; }
+		[[nodiscard]] inline std::size_t GetDroppedCount() const { return m_dropped; }
+
+		inline static constexpr std::size_t HEADER_SIZE{ 2 + 2 + 4 + 1 };
+		inline static constexpr std::size_t RELIABLE_WINDOW{ 256 }; //Reliable messages that can be waiting on acks at once - the other end buffers up to this many out of order (must divide 65536, like PACKET_HISTORY_SIZE)
+
+
+	private:
+		inline static constexpr std::size_t PACKET_HISTORY_SIZE{ 256 }; //Must divide 65536, so sequence numbers wrapping around land in the same slots
+
+		struct OutgoingMessage
+		{
+			std::uint16_t id;
+			std::vector<std::uint8_t> data;
+			double lastSent{ -1.0 }; //-1 if never
+			bool acked{ false };
+		};
+
+		struct QueuedMessage
+		{
+			NETWORK_CHANNEL channel;
+			std::uint16_t id; //Only for UNRELIABLE_SEQUENCED
+			std::vector<std::uint8_t> data;
+		};
+
+		struct SentPacket
+		{
+			std::uint16_t sequence{ 0 };
+			bool pending{ false }; //Sent and not acked yet
+			double time{ 0.0 };
+			std::vector<std::uint16_t> reliableIDs; //What went in it
+		};
+
+		struct ReceivedMessage
+		{
+			NETWORK_CHANNEL channel;
+			std::vector<std::uint8_t> data;
+		};
+
+
+		[[nodiscard]] bool IsDue(const OutgoingMessage& _message, double _time) const;
+		void ProcessAck(std::uint16_t _sequence, double _time);
+		void ReceiveReliable(std::uint16_t _id, const std::uint8_t* _data, std::size_t _size);
+		[[nodiscard]] ReceivedMessage& PushReceived(NETWORK_CHANNEL _channel);
+		//Wraps around - _a is newer if it's less than half the range ahead of _b
+		[[nodiscard]] inline static bool IsNewer(const std::uint16_t _a, const std::uint16_t _b) { return _a != _b && static_cast<std::uint16_t>(_a - _b) < 0x8000; }
+
+
+		NetworkConnectionConfig m_config;
+
+		//Sending
+		std::uint16_t m_nextSequence;
+		std::array<SentPacket, PACKET_HISTORY_SIZE> m_sentPackets; //Indexed by sequence % size - a packet that's dropped out without an ack has its reliable messages resent on the timeout anyway
+		std::uint16_t m_nextReliableID;
+		std::deque<OutgoingMessage> m_reliableOut; //Unacked, in id order with no gaps - acked ones are popped off the front
+		std::uint16_t m_nextSequencedID;
+		std::vector<QueuedMessage> m_queued; //Unreliable and sequenced, just for the next packet
+
+		//Receiving
+		bool m_receivedAny;
+		std::uint16_t m_remoteSequence; //Newest received
+		std::uint32_t m_receivedBits; //Bit i means m_remoteSequence - i was received
+		bool m_ackOwed;
+		std::uint16_t m_nextExpectedID; //Next reliable message to hand over
+		std::array<std::vector<std::uint8_t>, RELIABLE_WINDOW> m_reliableIn; //Arrived out of order, indexed by id % size
+		std::array<bool, RELIABLE_WINDOW> m_reliableInReceived;
+		bool m_receivedSequenced;
+		std::uint16_t m_lastSequencedID;
+		std::vector<ReceivedMessage> m_received; //Ready for PopReceived()
+		std::size_t m_receivedCount; //How much of m_received is in use - the rest keep their buffers for reuse
+
+		//Round trip time (RFC 6298 style smoothing)
+		bool m_measuredRTT;
+		double m_smoothedRTT;
+		double m_rttVariance;
+		double m_resendTimeout;
+
+		std::size_t m_resent;
+		std::size_t m_dropped;
+	};
+
+
+
+	template<typename Func>
+	void NetworkConnection::PopReceived(Func&& _func)
+	{
+		for (std::size_t i{ 0 }; i < m_receivedCount; ++i)
+		{
+			_func(m_received[i].channel, m_received[i].data.data(), m_received[i].data.size());
+		}
+		m_receivedCount = 0;
+	}
+
+}
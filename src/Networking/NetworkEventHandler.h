@@ -0,0 +1,21 @@
+#pragma once
+
+#include <SFML/Network.hpp>
+
+
+namespace NK
+{
+	
+	//Pure virtual abstract base class for handling network events
+	//Derive from this class and overload the HandleEvent() function to handle all events (that could be sent over the network) for your project
+	//Call ServerNetworkLayer::SetNetworkEventHandler() / ClientNetworkLayer::SetNetworkEventHandler(), passing in your derived class
+	//Events arrive as channel messages (see NetworkConnection) - in the order they were sent, if they were sent on NETWORK_CHANNEL::RELIABLE_ORDERED
+	class NetworkEventHandler
+	{
+	public:
+		//_packet structure: type registry constant for the event type then the event data itself
+		//The event data is a cereal binary archive - read it in place with a PacketInputStreamBuf (see PacketStreamBuf.h) once the type constant's been read out
+		virtual void HandleEvent(sf::Packet _packet) = 0;
+	};
+
+}
\ No newline at end of file
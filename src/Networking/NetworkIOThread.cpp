@@ -0,0 +1,142 @@
+#include "NetworkIOThread.h"
+
+#include <Core/Debug/Profiler.h>
+#include <Managers/TimeManager.h>
+
+#include <optional>
+#include <stdexcept>
+
+
+namespace NK
+{
+
+	NetworkIOThread::NetworkIOThread(sf::UdpSocket& _socket, const std::size_t _queueCapacity)
+	: m_socket(_socket), m_wakePort(0), m_received(_queueCapacity), m_toSend(_queueCapacity), m_sendQueued(false), m_receiveScratch(sf::UdpSocket::MaxDatagramSize)
+	{
+		if (m_wakeSocket.bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost) != sf::Socket::Status::Done)
+		{
+			throw std::runtime_error("NetworkIOThread::NetworkIOThread() - failed to bind the wake-up socket to loopback");
+		}
+		m_wakePort = m_wakeSocket.getLocalPort();
+
+		//The thread only ever touches either socket once select() says it's ready - they're non-blocking so a spurious wake-up can't hang it
+		m_socket.setBlocking(false);
+		m_wakeSocket.setBlocking(false);
+
+		m_thread = std::thread(&NetworkIOThread::Run, this);
+	}
+
+
+
+	NetworkIOThread::~NetworkIOThread()
+	{
+		m_shutdown.store(true, std::memory_order_release);
+		Wake();
+		m_thread.join();
+	}
+
+
+
+	bool NetworkIOThread::Send(const NetworkEndpoint& _endpoint, const std::uint8_t* _data, const std::size_t _size)
+	{
+		NetworkDatagram* const datagram{ m_toSend.BeginPush() };
+		if (!datagram) { return false; }
+		datagram->endpoint = _endpoint;
+		datagram->data.assign(_data, _data + _size);
+		m_toSend.Push();
+		m_sendQueued = true;
+		return true;
+	}
+
+
+
+	void NetworkIOThread::Flush()
+	{
+		if (!m_sendQueued) { return; }
+		m_sendQueued = false;
+		Wake();
+	}
+
+
+
+	void NetworkIOThread::Run()
+	{
+		Profiler::SetThreadName("Network IO");
+
+		sf::SocketSelector selector;
+		selector.add(m_socket);
+		selector.add(m_wakeSocket);
+
+		while (!m_shutdown.load(std::memory_order_acquire))
+		{
+			SendQueued();
+
+			//The timeout's just a backstop in case a wake-up byte goes missing - Flush() normally gets it going straight away
+			if (!selector.wait(sf::milliseconds(10))) { continue; }
+
+			if (selector.isReady(m_wakeSocket))
+			{
+				std::uint8_t wake[16];
+				std::size_t received;
+				std::optional<sf::IpAddress> address;
+				unsigned short port;
+				while (m_wakeSocket.receive(wake, sizeof(wake), received, address, port) == sf::Socket::Status::Done) {}
+			}
+			if (selector.isReady(m_socket)) { ReceiveAll(); }
+		}
+
+		//Whatever the main thread queued up before shutting down (e.g. the last of the acks) still goes out
+		SendQueued();
+	}
+
+
+
+	void NetworkIOThread::SendQueued()
+	{
+		NK_PROFILE_SCOPE("NetworkIOThread - Send");
+
+		for (NetworkDatagram* datagram{ m_toSend.Front() }; datagram; datagram = m_toSend.Front())
+		{
+			if (m_socket.send(datagram->data.data(), datagram->data.size(), datagram->endpoint.GetAddress(), datagram->endpoint.GetPort()) != sf::Socket::Status::Done)
+			{
+				m_failedSends.fetch_add(1, std::memory_order_relaxed);
+			}
+			m_toSend.Pop();
+		}
+	}
+
+
+
+	void NetworkIOThread::ReceiveAll()
+	{
+		NK_PROFILE_SCOPE("NetworkIOThread - Receive");
+
+		//Stops after one queue's worth so a flood can't hold up sending
+		std::size_t received;
+		std::optional<sf::IpAddress> address;
+		unsigned short port;
+		for (std::size_t i{ 0 }; i < m_received.GetCapacity() && m_socket.receive(m_receiveScratch.data(), m_receiveScratch.size(), received, address, port) == sf::Socket::Status::Done; ++i)
+		{
+			NetworkDatagram* const datagram{ m_received.BeginPush() };
+			if (!datagram)
+			{
+				//The main thread's fallen behind - it's UDP, this is no different to the socket buffer filling up
+				m_droppedReceives.fetch_add(1, std::memory_order_relaxed);
+				continue;
+			}
+			datagram->endpoint = NetworkEndpoint{ address.value(), port };
+			datagram->time = TimeManager::GetTimeSinceStartup();
+			datagram->data.assign(m_receiveScratch.data(), m_receiveScratch.data() + received);
+			m_received.Push();
+		}
+	}
+
+
+
+	void NetworkIOThread::Wake()
+	{
+		const std::uint8_t wake{ 0 };
+		static_cast<void>(m_wakeSocket.send(&wake, sizeof(wake), sf::IpAddress::LocalHost, m_wakePort));
+	}
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "SPSCQueue.h"
+
+#include <SFML/Network.hpp>
+#include <Types/NekiTypes.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+
+namespace NK
+{
+
+	struct NetworkDatagram
+	{
+		NetworkEndpoint endpoint; //Who it came from / is going to
+		double time{ 0.0 }; //Received only - when it came off the socket, in TimeManager::GetTimeSinceStartup() seconds
+		std::vector<std::uint8_t> data;
+	};
+
+
+	//Does all the socket i/o for a UDP socket on its own thread, so a long frame doesn't leave datagrams sat in the socket buffer (inflating the latency measured off them) and sending doesn't eat into the frame
+	//The thread sleeps in a select() on the socket, stamps each datagram with the time it arrived, and hands it to the main thread through a lock-free ring - outgoing datagrams come the other way through another
+	//Outgoing datagrams are sent in a batch when the main thread calls Flush() - it's woken up by a byte sent to a second socket on loopback, as select() can't wait on anything else portably
+	//Both rings are fixed size and drop on overflow, same as a full socket buffer would
+	class NetworkIOThread final
+	{
+	public:
+		//_socket must already be bound - from here until this is destroyed it belongs to the network thread, and nothing else may touch it
+		explicit NetworkIOThread(sf::UdpSocket& _socket, std::size_t _queueCapacity);
+		~NetworkIOThread(); //Sends whatever's still queued before returning
+
+		NetworkIOThread(const NetworkIOThread&) = delete;
+		NetworkIOThread& operator=(const NetworkIOThread&) = delete;
+
+		//Everything from here down is for the one thread that owns this (i.e. the main thread)
+
+		//Queues a datagram to go out on the next Flush() - returns false if the queue's full
+		[[nodiscard]] bool Send(const NetworkEndpoint& _endpoint, const std::uint8_t* _data, std::size_t _size);
+		//Wakes the network thread up to send everything queued since the last call - once a tick, after the last Send()
+		void Flush();
+		//Calls _func(const NetworkDatagram&) for each datagram received since the last call, oldest first - at most one queue's worth, so a flood can't keep it going forever
+		template<typename Func>
+		std::size_t Receive(Func&& _func);
+
+		//Since construction - datagrams thrown away because the main thread wasn't keeping up, and ones that couldn't be sent (the socket said no)
+		[[nodiscard]] inline std::size_t GetDroppedReceiveCount() const { return m_droppedReceives.load(std::memory_order_relaxed); }
+		[[nodiscard]] inline std::size_t GetFailedSendCount() const { return m_failedSends.load(std::memory_order_relaxed); }
+
+
+	private:
+		//Network thread
+		void Run();
+		void SendQueued();
+		void ReceiveAll();
+
+		//Any thread
+		void Wake();
+
+
+		sf::UdpSocket& m_socket;
+		sf::UdpSocket m_wakeSocket; //Bound to loopback - Wake() sends itself a byte through it
+		unsigned short m_wakePort;
+
+		SPSCQueue<NetworkDatagram> m_received; //Network thread -> main thread
+		SPSCQueue<NetworkDatagram> m_toSend; //Main thread -> network thread
+		bool m_sendQueued; //Anything pushed to m_toSend since the last Flush()
+		std::vector<std::uint8_t> m_receiveScratch; //Biggest possible datagram - network thread only
+
+		std::atomic<std::size_t> m_droppedReceives{ 0 };
+		std::atomic<std::size_t> m_failedSends{ 0 };
+		std::atomic<bool> m_shutdown{ false };
+
+		std::thread m_thread;
+	};
+
+
+
+	template<typename Func>
+	std::size_t NetworkIOThread::Receive(Func&& _func)
+	{
+		std::size_t count{ 0 };
+		for (NetworkDatagram* datagram{ m_received.Front() }; datagram && count < m_received.GetCapacity(); datagram = m_received.Front())
+		{
+			_func(static_cast<const NetworkDatagram&>(*datagram));
+			m_received.Pop();
+			++count;
+		}
+		return count;
+	}
+
+}
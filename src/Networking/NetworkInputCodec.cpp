@@ -0,0 +1,125 @@
+#include "NetworkInputCodec.h"
+
+#include "BitWriter.h"
+
+#include <Components/CInput.h>
+
+#include <type_traits>
+#include <variant>
+
+
+namespace NK
+{
+
+	namespace
+	{
+		void WriteState(BitWriter& _writer, const INPUT_STATE_VARIANT& _state)
+		{
+			_writer.WriteBits(static_cast<std::uint32_t>(_state.index()), 2);
+			std::visit([&](const auto& _s)
+			{
+				using State = std::decay_t<decltype(_s)>;
+				if constexpr (std::is_same_v<State, ButtonState>)
+				{
+					_writer.WriteBool(_s.held);
+					_writer.WriteBool(_s.released);
+				}
+				else if constexpr (std::is_same_v<State, Axis1DState>)
+				{
+					_writer.WriteFloat(_s.value);
+				}
+				else
+				{
+					_writer.WriteFloat(_s.values.x);
+					_writer.WriteFloat(_s.values.y);
+				}
+			}, _state);
+		}
+
+		//Returns false on an unknown variant index
+		[[nodiscard]] bool ReadState(BitReader& _reader, INPUT_STATE_VARIANT& _state)
+		{
+			switch (_reader.ReadBits(2))
+			{
+			case 0:
+			{
+				ButtonState state{};
+				state.held = _reader.ReadBool();
+				state.released = _reader.ReadBool();
+				_state = state;
+				return true;
+			}
+			case 1:
+			{
+				_state = Axis1DState{ _reader.ReadFloat() };
+				return true;
+			}
+			case 2:
+			{
+				Axis2DState state{};
+				state.values.x = _reader.ReadFloat();
+				state.values.y = _reader.ReadFloat();
+				_state = state;
+				return true;
+			}
+			default:
+			{
+				return false;
+			}
+			}
+		}
+	}
+
+
+
+	std::size_t NetworkInputCodec::Encode(Registry& _reg, std::vector<std::uint8_t>& _buffer)
+	{
+		static_assert(std::variant_size_v<INPUT_STATE_VARIANT> <= 4, "NetworkInputCodec::Encode() - INPUT_STATE_VARIANT has outgrown its 2 bits on the wire");
+
+		BitWriter writer{ _buffer };
+		std::size_t count{ 0 };
+		for (auto&& [input] : _reg.View<CInput>())
+		{
+			writer.WriteBool(true);
+			writer.WriteVarUInt(_reg.GetEntity(input));
+			writer.WriteVarUInt(static_cast<std::uint32_t>(input.actionStates.size()));
+			for (const std::pair<const ActionTypeMapKey, INPUT_STATE_VARIANT>& action : input.actionStates)
+			{
+				writer.WriteVarUInt(action.first.first);
+				writer.WriteVarUInt(action.first.second);
+				WriteState(writer, action.second);
+			}
+			++count;
+		}
+		writer.WriteBool(false);
+
+		return count;
+	}
+
+
+
+	bool NetworkInputCodec::Decode(BitReader& _reader, Registry& _reg)
+	{
+		while (_reader.ReadBool())
+		{
+			const Entity entity{ _reader.ReadVarUInt() };
+			const std::uint32_t stateCount{ _reader.ReadVarUInt() };
+			if (_reader.HasOverrun()) { return false; }
+
+			//Still have to read past the states of anything that can't take them
+			CInput* input{ (_reg.EntityInRegistry(entity) && _reg.HasComponent<CInput>(entity)) ? &_reg.GetComponent<CInput>(entity) : nullptr };
+			for (std::uint32_t i{ 0 }; i < stateCount; ++i)
+			{
+				ActionTypeMapKey key;
+				key.first = _reader.ReadVarUInt();
+				key.second = _reader.ReadVarUInt();
+				INPUT_STATE_VARIANT state;
+				if (!ReadState(_reader, state) || _reader.HasOverrun()) { return false; }
+				if (input) { input->actionStates.insert_or_assign(key, state); }
+			}
+		}
+
+		return !_reader.HasOverrun();
+	}
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "BitReader.h"
+
+#include <Core-ECS/Registry.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace NK
+{
+
+	//The wire format for PACKET_CODE::INPUT - every CInput's action states, bit-packed (see BitWriter)
+	//Each entity is preceded by a continue bit (so the entities don't need counting up first), then written as its id and how many action states follow
+	//Each action state is its key as two varints, 2 bits for which INPUT_STATE_VARIANT alternative it is, then the state itself - buttons are 2 bits, axes are raw floats
+	//Shared by ClientNetworkLayer (encode) and ServerNetworkLayer (decode) so the format lives in one place
+	class NetworkInputCodec final
+	{
+	public:
+		//Appends every CInput in _reg to _buffer, returning how many were written - doesn't allocate beyond growing _buffer
+		static std::size_t Encode(Registry& _reg, std::vector<std::uint8_t>& _buffer);
+
+		//Writes the action states in _reader into the matching CInputs in _reg - entities that don't exist or don't have a CInput are skipped
+		//Returns false if the packet was malformed, in which case some of it may already have been applied
+		static bool Decode(BitReader& _reader, Registry& _reg);
+	};
+
+}
@@ -0,0 +1,338 @@
+#include "NetworkTransformCodec.h"
+
+#include "BitWriter.h"
+
+#include <Components/CTransform.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <glm/gtc/quaternion.hpp>
+
+
+namespace NK
+{
+
+	namespace
+	{
+		//Change mask bits
+		constexpr std::uint32_t POSITION_CHANGED{ 1u << 0 };
+		constexpr std::uint32_t ROTATION_CHANGED{ 1u << 1 };
+		constexpr std::uint32_t SCALE_CHANGED{ 1u << 2 };
+		constexpr std::uint32_t CHANGE_MASK_BITS{ 3 };
+
+		//Smallest-three - the largest component is dropped and the other three can't be bigger than this
+		constexpr float SMALLEST_THREE_RANGE{ 0.70710678f }; //1/sqrt(2)
+
+
+		[[nodiscard]] std::uint32_t MaxValue(const std::uint32_t _bits)
+		{
+			return static_cast<std::uint32_t>((std::uint64_t{ 1 } << _bits) - 1);
+		}
+
+
+		void QuantisePosition(const glm::vec3 _pos, const NetworkTransformQuantisation& _quantisation, std::array<std::uint32_t, 3>& _out)
+		{
+			for (std::size_t axis{ 0 }; axis < 3; ++axis)
+			{
+				const double steps{ std::round((static_cast<double>(_pos[axis]) - _quantisation.worldMin[axis]) / _quantisation.positionPrecision) };
+				_out[axis] = static_cast<std::uint32_t>(std::clamp(steps, 0.0, static_cast<double>(MaxValue(_quantisation.GetPositionBits(axis)))));
+			}
+		}
+
+
+		[[nodiscard]] glm::vec3 DequantisePosition(const std::array<std::uint32_t, 3>& _pos, const NetworkTransformQuantisation& _quantisation)
+		{
+			glm::vec3 pos;
+			for (std::size_t axis{ 0 }; axis < 3; ++axis)
+			{
+				pos[axis] = static_cast<float>(_quantisation.worldMin[axis] + static_cast<double>(_pos[axis]) * _quantisation.positionPrecision);
+			}
+			return pos;
+		}
+
+
+		void QuantiseRotation(const glm::quat _rot, const NetworkTransformQuantisation& _quantisation, std::uint8_t& _largest, std::array<std::uint16_t, 3>& _out)
+		{
+			const glm::quat rot{ glm::normalize(_rot) };
+			std::uint8_t largest{ 0 };
+			for (std::uint8_t i{ 1 }; i < 4; ++i)
+			{
+				if (std::abs(rot[i]) > std::abs(rot[largest])) { largest = i; }
+			}
+
+			//q and -q are the same rotation - flip it so the dropped component is positive and can be rebuilt from the other three
+			const float sign{ rot[largest] < 0.0f ? -1.0f : 1.0f };
+			const float maxValue{ static_cast<float>(MaxValue(_quantisation.rotationBits)) };
+			std::size_t out{ 0 };
+			for (std::uint8_t i{ 0 }; i < 4; ++i)
+			{
+				if (i == largest) { continue; }
+				const float normalised{ std::clamp((rot[i] * sign / SMALLEST_THREE_RANGE + 1.0f) * 0.5f, 0.0f, 1.0f) };
+				_out[out++] = static_cast<std::uint16_t>(std::round(normalised * maxValue));
+			}
+			_largest = largest;
+		}
+
+
+		[[nodiscard]] glm::quat DequantiseRotation(const std::uint8_t _largest, const std::array<std::uint16_t, 3>& _rot, const NetworkTransformQuantisation& _quantisation)
+		{
+			const float maxValue{ static_cast<float>(MaxValue(_quantisation.rotationBits)) };
+			glm::quat rot;
+			float sumOfSquares{ 0.0f };
+			std::size_t in{ 0 };
+			for (std::uint8_t i{ 0 }; i < 4; ++i)
+			{
+				if (i == _largest) { continue; }
+				rot[i] = (static_cast<float>(_rot[in++]) / maxValue * 2.0f - 1.0f) * SMALLEST_THREE_RANGE;
+				sumOfSquares += rot[i] * rot[i];
+			}
+			rot[_largest] = std::sqrt(std::max(0.0f, 1.0f - sumOfSquares));
+			return glm::normalize(rot);
+		}
+
+
+		//What an entity that isn't in the baseline is diffed against - the origin, no rotation, unit scale
+		[[nodiscard]] QuantisedTransform DefaultState(const Entity _entity, const NetworkTransformQuantisation& _quantisation)
+		{
+			QuantisedTransform state{};
+			state.entity = _entity;
+			QuantisePosition(glm::vec3(0.0f), _quantisation, state.pos);
+			QuantiseRotation(glm::quat(1.0f, 0.0f, 0.0f, 0.0f), _quantisation, state.rotLargest, state.rot);
+			state.scale = glm::vec3(1.0f);
+			return state;
+		}
+
+
+		[[nodiscard]] std::uint32_t ComputeChangeMask(const QuantisedTransform& _from, const QuantisedTransform& _to)
+		{
+			std::uint32_t mask{ 0 };
+			if (_from.pos != _to.pos) { mask |= POSITION_CHANGED; }
+			if (_from.rotLargest != _to.rotLargest || _from.rot != _to.rot) { mask |= ROTATION_CHANGED; }
+			if (_from.scale != _to.scale) { mask |= SCALE_CHANGED; } //Exact on purpose - anything the client has that isn't bit-for-bit what the server has would never get corrected
+			return mask;
+		}
+
+
+		//Walks two sorted snapshots together, calling _func(entity, state, changeMask) for everything that has to be sent - state is nullptr for entities that have gone since _baseline
+		template<typename Func>
+		void ForEachOp(const std::vector<QuantisedTransform>& _current, const std::vector<QuantisedTransform>& _baseline, Func&& _func)
+		{
+			std::size_t b{ 0 };
+			for (const QuantisedTransform& state : _current)
+			{
+				for (; b < _baseline.size() && _baseline[b].entity < state.entity; ++b) { _func(_baseline[b].entity, nullptr, 0u); }
+
+				const bool inBaseline{ b < _baseline.size() && _baseline[b].entity == state.entity };
+				//New entities always get their position and rotation sent (so the client has them even if they happen to match the default), scale only if it isn't 1
+				const std::uint32_t mask{ inBaseline ? ComputeChangeMask(_baseline[b], state) : (POSITION_CHANGED | ROTATION_CHANGED | (state.scale != glm::vec3(1.0f) ? SCALE_CHANGED : 0u)) };
+				if (mask) { _func(state.entity, &state, mask); }
+				if (inBaseline) { ++b; }
+			}
+			for (; b < _baseline.size(); ++b) { _func(_baseline[b].entity, nullptr, 0u); }
+		}
+	}
+
+
+
+	std::uint32_t NetworkTransformQuantisation::GetPositionBits(const std::size_t _axis) const
+	{
+		const double steps{ std::ceil((static_cast<double>(worldMax[_axis]) - worldMin[_axis]) / positionPrecision) };
+		return static_cast<std::uint32_t>(std::bit_width(static_cast<std::uint64_t>(std::max(steps, 1.0))));
+	}
+
+
+
+	void NetworkTransformCodec::ValidateQuantisation(const NetworkTransformQuantisation& _quantisation)
+	{
+		if (!(_quantisation.positionPrecision > 0.0f))
+		{
+			throw std::runtime_error("NetworkTransformCodec::ValidateQuantisation() - positionPrecision must be greater than 0");
+		}
+		for (std::size_t axis{ 0 }; axis < 3; ++axis)
+		{
+			if (!(_quantisation.worldMax[axis] > _quantisation.worldMin[axis]))
+			{
+				throw std::runtime_error("NetworkTransformCodec::ValidateQuantisation() - worldMax must be greater than worldMin on every axis");
+			}
+			if (_quantisation.GetPositionBits(axis) > 32)
+			{
+				throw std::runtime_error("NetworkTransformCodec::ValidateQuantisation() - the world bounds need " + std::to_string(_quantisation.GetPositionBits(axis)) + " bits on axis " + std::to_string(axis) + " at this positionPrecision - at most 32 are supported");
+			}
+		}
+		if (_quantisation.rotationBits < 2 || _quantisation.rotationBits > 16)
+		{
+			throw std::runtime_error("NetworkTransformCodec::ValidateQuantisation() - rotationBits must be between 2 and 16 - rotationBits = " + std::to_string(_quantisation.rotationBits));
+		}
+	}
+
+
+
+	void NetworkTransformCodec::Capture(Registry& _reg, const NetworkTransformQuantisation& _quantisation, std::vector<QuantisedTransform>& _states)
+	{
+		_states.clear();
+		for (auto&& [transform] : _reg.View<CTransform>())
+		{
+			QuantisedTransform& state{ _states.emplace_back() };
+			state.entity = _reg.GetEntity(transform);
+			QuantisePosition(transform.GetLocalPosition(), _quantisation, state.pos);
+			QuantiseRotation(transform.GetLocalRotationQuat(), _quantisation, state.rotLargest, state.rot);
+			state.scale = transform.GetLocalScale();
+		}
+		std::ranges::sort(_states, {}, &QuantisedTransform::entity);
+	}
+
+
+
+	std::size_t NetworkTransformCodec::Encode(const std::uint32_t _sequence, const std::vector<QuantisedTransform>& _current, const std::uint32_t _baselineSequence, const std::vector<QuantisedTransform>& _baseline, const NetworkTransformQuantisation& _quantisation, std::vector<std::uint8_t>& _buffer)
+	{
+		//Two walks over both (sorted) snapshots - one to count the ops, one to write them - rather than gathering them up into a list first
+		std::uint32_t opCount{ 0 };
+		std::size_t changedCount{ 0 };
+		ForEachOp(_current, _baseline, [&](const Entity, const QuantisedTransform* _state, const std::uint32_t)
+		{
+			++opCount;
+			if (_state) { ++changedCount; }
+		});
+
+		BitWriter writer{ _buffer };
+		writer.WriteBits(_sequence, 32);
+		writer.WriteVarUInt(_baselineSequence == NO_SNAPSHOT ? 0 : _sequence - _baselineSequence); //0 = full snapshot
+		writer.WriteVarUInt(opCount);
+
+		const std::array<std::uint32_t, 3> positionBits{ _quantisation.GetPositionBits(0), _quantisation.GetPositionBits(1), _quantisation.GetPositionBits(2) };
+		Entity previous{ 0 };
+		ForEachOp(_current, _baseline, [&](const Entity _entity, const QuantisedTransform* _state, const std::uint32_t _mask)
+		{
+			writer.WriteVarUInt(_entity - previous);
+			previous = _entity;
+			writer.WriteBool(_state == nullptr); //Removed
+			if (!_state) { return; }
+
+			writer.WriteBits(_mask, CHANGE_MASK_BITS);
+			if (_mask & POSITION_CHANGED)
+			{
+				for (std::size_t axis{ 0 }; axis < 3; ++axis) { writer.WriteBits(_state->pos[axis], positionBits[axis]); }
+			}
+			if (_mask & ROTATION_CHANGED)
+			{
+				writer.WriteBits(_state->rotLargest, 2);
+				for (const std::uint16_t component : _state->rot) { writer.WriteBits(component, _quantisation.rotationBits); }
+			}
+			if (_mask & SCALE_CHANGED)
+			{
+				const bool uniform{ _state->scale.x == _state->scale.y && _state->scale.x == _state->scale.z };
+				writer.WriteBool(uniform);
+				writer.WriteFloat(_state->scale.x);
+				if (!uniform)
+				{
+					writer.WriteFloat(_state->scale.y);
+					writer.WriteFloat(_state->scale.z);
+				}
+			}
+		});
+
+		return changedCount;
+	}
+
+
+
+	void NetworkTransformCodec::DecodeHeader(BitReader& _reader, std::uint32_t& _sequence, std::uint32_t& _baselineSequence)
+	{
+		_sequence = _reader.ReadBits(32);
+		const std::uint32_t baselineOffset{ _reader.ReadVarUInt() };
+		_baselineSequence = (baselineOffset == 0 ? NO_SNAPSHOT : _sequence - baselineOffset);
+	}
+
+
+
+	bool NetworkTransformCodec::Decode(BitReader& _reader, const std::vector<QuantisedTransform>& _baseline, const NetworkTransformQuantisation& _quantisation, std::vector<QuantisedTransform>& _states)
+	{
+		const std::array<std::uint32_t, 3> positionBits{ _quantisation.GetPositionBits(0), _quantisation.GetPositionBits(1), _quantisation.GetPositionBits(2) };
+
+		//Ops come in the same (sorted) order as the snapshots, so the new snapshot can be built in one walk along _baseline - everything between two ops is carried over as-is
+		_states.clear();
+		const std::uint32_t opCount{ _reader.ReadVarUInt() };
+		std::size_t b{ 0 };
+		Entity previous{ 0 };
+		for (std::uint32_t i{ 0 }; i < opCount; ++i)
+		{
+			const std::uint32_t gap{ _reader.ReadVarUInt() };
+			if (_reader.HasOverrun() || (i > 0 && gap == 0)) { return false; } //Truncated, or out of order / duplicated
+			const Entity entity{ previous + gap };
+			previous = entity;
+			for (; b < _baseline.size() && _baseline[b].entity < entity; ++b) { _states.push_back(_baseline[b]); }
+			const bool inBaseline{ b < _baseline.size() && _baseline[b].entity == entity };
+			if (inBaseline) { ++b; }
+
+			if (_reader.ReadBool()) { continue; } //Removed - just don't carry it over
+
+			QuantisedTransform& state{ _states.emplace_back(inBaseline ? _baseline[b - 1] : DefaultState(entity, _quantisation)) };
+			const std::uint32_t mask{ _reader.ReadBits(CHANGE_MASK_BITS) };
+			if (mask & POSITION_CHANGED)
+			{
+				for (std::size_t axis{ 0 }; axis < 3; ++axis) { state.pos[axis] = _reader.ReadBits(positionBits[axis]); }
+			}
+			if (mask & ROTATION_CHANGED)
+			{
+				state.rotLargest = static_cast<std::uint8_t>(_reader.ReadBits(2));
+				for (std::uint16_t& component : state.rot) { component = static_cast<std::uint16_t>(_reader.ReadBits(_quantisation.rotationBits)); }
+			}
+			if (mask & SCALE_CHANGED)
+			{
+				const bool uniform{ _reader.ReadBool() };
+				state.scale.x = _reader.ReadFloat();
+				state.scale.y = (uniform ? state.scale.x : _reader.ReadFloat());
+				state.scale.z = (uniform ? state.scale.x : _reader.ReadFloat());
+			}
+		}
+		for (; b < _baseline.size(); ++b) { _states.push_back(_baseline[b]); }
+
+		return !_reader.HasOverrun();
+	}
+
+
+
+	std::size_t NetworkTransformCodec::GetDeltaBits(const QuantisedTransform* _baseline, const QuantisedTransform& _current, const NetworkTransformQuantisation& _quantisation)
+	{
+		const std::uint32_t mask{ _baseline ? ComputeChangeMask(*_baseline, _current) : (POSITION_CHANGED | ROTATION_CHANGED | (_current.scale != glm::vec3(1.0f) ? SCALE_CHANGED : 0u)) };
+		if (!mask) { return 0; }
+
+		//The gap from the previous entity is at most the entity itself
+		std::size_t bits{ (static_cast<std::size_t>(std::bit_width(_current.entity | 1u)) + 6) / 7 * 8 + 1 + CHANGE_MASK_BITS };
+		if (mask & POSITION_CHANGED) { bits += _quantisation.GetPositionBits(0) + _quantisation.GetPositionBits(1) + _quantisation.GetPositionBits(2); }
+		if (mask & ROTATION_CHANGED) { bits += 2 + 3 * _quantisation.rotationBits; }
+		if (mask & SCALE_CHANGED) { bits += 1 + 3 * 32; }
+		return bits;
+	}
+
+
+
+	glm::vec3 NetworkTransformCodec::GetLocalPosition(const QuantisedTransform& _state, const NetworkTransformQuantisation& _quantisation)
+	{
+		return DequantisePosition(_state.pos, _quantisation);
+	}
+
+
+
+	void NetworkTransformCodec::Apply(const std::vector<QuantisedTransform>& _states, const std::vector<QuantisedTransform>& _previous, const NetworkTransformQuantisation& _quantisation, Registry& _reg)
+	{
+		std::size_t p{ 0 };
+		for (const QuantisedTransform& state : _states)
+		{
+			for (; p < _previous.size() && _previous[p].entity < state.entity; ++p) {}
+			//Only set what's changed - the setters reset physics velocities, among other things
+			const std::uint32_t mask{ (p < _previous.size() && _previous[p].entity == state.entity) ? ComputeChangeMask(_previous[p], state) : (POSITION_CHANGED | ROTATION_CHANGED | SCALE_CHANGED) };
+			if (!mask) { continue; }
+
+			CTransform& trans{ _reg.GetComponent<CTransform>(state.entity) };
+			if (mask & POSITION_CHANGED) { trans.SetLocalPosition(DequantisePosition(state.pos, _quantisation)); }
+			if (mask & ROTATION_CHANGED) { trans.SetLocalRotation(DequantiseRotation(state.rotLargest, state.rot, _quantisation)); }
+			if (mask & SCALE_CHANGED) { trans.SetLocalScale(state.scale); }
+		}
+	}
+
+}
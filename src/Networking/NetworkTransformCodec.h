@@ -0,0 +1,94 @@
+#pragma once
+
+#include "BitReader.h"
+
+#include <Core-ECS/Registry.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <glm/glm.hpp>
+
+
+namespace NK
+{
+
+	//How transforms are squeezed down for the wire - the server and its clients must agree on this (see ServerNetworkLayerDesc / ClientNetworkLayerDesc)
+	struct NetworkTransformQuantisation
+	{
+		//Positions are sent as fixed-point offsets into this box - anything outside it is clamped to the edge
+		glm::vec3 worldMin{ -1024.0f };
+		glm::vec3 worldMax{ 1024.0f };
+		float positionPrecision{ 1.0f / 256.0f }; //Size of one fixed-point step in world units - with the default bounds that's 19 bits per axis
+		std::uint32_t rotationBits{ 10 }; //Bits for each of the three smallest quaternion components (at most 16) - 10 is well under a tenth of a degree of error
+
+		//Bits needed for _axis (0-2) to cover the world bounds at positionPrecision
+		[[nodiscard]] std::uint32_t GetPositionBits(std::size_t _axis) const;
+	};
+
+
+	//One entity's transform as it's actually replicated - snapshots hold these rather than raw floats so the server diffs exactly what the client will end up with, and jitter below the precision costs nothing
+	struct QuantisedTransform
+	{
+		Entity entity;
+		std::array<std::uint32_t, 3> pos; //Fixed-point, see NetworkTransformQuantisation
+		std::uint8_t rotLargest; //Smallest-three - which of the quaternion's components was dropped (x, y, z, w)
+		std::array<std::uint16_t, 3> rot; //The other three, in order
+		glm::vec3 scale; //Full precision - it rarely changes, so rarely gets sent
+	};
+
+
+	//Every replicated CTransform at one server tick, sorted by entity so two snapshots can be diffed in a single pass
+	struct NetworkTransformSnapshot
+	{
+		std::uint32_t sequence;
+		std::vector<QuantisedTransform> states;
+	};
+
+
+	//The wire format for PACKET_CODE::TRANSFORM - a snapshot of every CTransform's local pos/rot/scale, delta-encoded against an older snapshot (the baseline) that the client has acknowledged
+	//Only the entities that changed or went away since the baseline are written, in one sorted stream - anything static costs nothing
+	//Everything's bit-packed (see BitWriter):
+	//- Entities are written as varint gaps from the previous one (they're sorted, so the gaps are small), then a bit saying whether it was removed
+	//- Each changed entity then has 3 bits saying which of its position / rotation / scale changed, then only those
+	//- Positions are fixed-point within the world bounds, rotations are smallest-three quaternions, and scales are one float when uniform or three when not
+	//With no baseline (a client that hasn't acked anything yet, or whose last ack is too old) the whole snapshot is sent, against a default of the origin with unit scale
+	//Shared by ServerNetworkLayer (encode) and ClientNetworkLayer (decode) so the format lives in one place, and so it can be benchmarked on its own (see Benchmarks/MicroBench)
+	class NetworkTransformCodec final
+	{
+	public:
+		inline static constexpr std::uint32_t NO_SNAPSHOT{ std::numeric_limits<std::uint32_t>::max() };
+		//How many snapshots the server and client each keep around to use as baselines - a client whose last ack is older than this gets a full snapshot
+		inline static constexpr std::size_t SNAPSHOT_HISTORY_SIZE{ 32 };
+
+
+		//Throws if _quantisation can't be encoded (e.g. bounds too big for 32 bits at the given precision)
+		static void ValidateQuantisation(const NetworkTransformQuantisation& _quantisation);
+
+		//Every CTransform in _reg, quantised and sorted by entity
+		static void Capture(Registry& _reg, const NetworkTransformQuantisation& _quantisation, std::vector<QuantisedTransform>& _states);
+
+		//Appends _current to _buffer as a delta against _baseline (pass NO_SNAPSHOT and an empty _baseline for a full snapshot), returning how many changed entities had to be written
+		//Doesn't allocate beyond growing _buffer - so a pooled buffer (see NetworkBufferPool) makes this allocation-free once it's warmed up
+		static std::size_t Encode(std::uint32_t _sequence, const std::vector<QuantisedTransform>& _current, std::uint32_t _baselineSequence, const std::vector<QuantisedTransform>& _baseline, const NetworkTransformQuantisation& _quantisation, std::vector<std::uint8_t>& _buffer);
+
+		//Reads which snapshot _reader holds and which one it's relative to (NO_SNAPSHOT for a full snapshot) - call before Decode()
+		static void DecodeHeader(BitReader& _reader, std::uint32_t& _sequence, std::uint32_t& _baselineSequence);
+		//Rebuilds the full snapshot from _baseline and the rest of _reader into _states (reusing its capacity) - returns false if the packet was malformed
+		static bool Decode(BitReader& _reader, const std::vector<QuantisedTransform>& _baseline, const NetworkTransformQuantisation& _quantisation, std::vector<QuantisedTransform>& _states);
+
+		//For picking what to send when it won't all fit (see ServerNetworkLayerDesc::maxTransformPacketSize) - an upper bound on the bits Encode() would spend on _current against _baseline (nullptr if it's not in the baseline), or 0 if it wouldn't be written at all
+		[[nodiscard]] static std::size_t GetDeltaBits(const QuantisedTransform* _baseline, const QuantisedTransform& _current, const NetworkTransformQuantisation& _quantisation);
+		//Upper bounds on everything else Encode() writes - the header up front (sequence, baseline offset, op count) and one removed entity
+		inline static constexpr std::size_t MAX_HEADER_BITS{ 32 + 40 + 40 };
+		inline static constexpr std::size_t MAX_REMOVED_BITS{ 40 + 1 };
+
+		[[nodiscard]] static glm::vec3 GetLocalPosition(const QuantisedTransform& _state, const NetworkTransformQuantisation& _quantisation);
+
+		//Writes every state in _states that differs from _previous (the last snapshot applied, or empty) into the matching CTransforms in _reg
+		static void Apply(const std::vector<QuantisedTransform>& _states, const std::vector<QuantisedTransform>& _previous, const NetworkTransformQuantisation& _quantisation, Registry& _reg);
+	};
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "PacketHeader.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+namespace NK
+{
+
+	//Splits packets that are too big for one datagram into PACKET_CODE::FRAGMENT datagrams that each fit, for a PacketReassembler on the other end to put back together
+	//Bigger than the path MTU and the IP layer fragments it anyway - losing any one piece loses the lot, and past 64KB it can't be sent at all
+	//Each fragment is the PACKET_CODE, then (big-endian, like sf::Packet) a 16-bit message id, the fragment's index, how many fragments there are, and how big every fragment but the last is - then that slice of the packet
+	class PacketFragmenter final
+	{
+	public:
+		inline static constexpr std::size_t HEADER_SIZE{ sizeof(std::underlying_type_t<PACKET_CODE>) + 4 * sizeof(std::uint16_t) };
+
+
+		//_maxDatagramSize is the biggest datagram that gets sent, header included
+		explicit PacketFragmenter(const std::size_t _maxDatagramSize) : m_maxDatagramSize(_maxDatagramSize), m_nextMessageID(0)
+		{
+			if (m_maxDatagramSize <= HEADER_SIZE)
+			{
+				throw std::runtime_error("PacketFragmenter::PacketFragmenter() - _maxDatagramSize (" + std::to_string(m_maxDatagramSize) + ") must be bigger than the fragment header (" + std::to_string(HEADER_SIZE) + ")");
+			}
+		}
+
+		//Calls _send(const std::uint8_t* data, std::size_t size) once with _packet if it fits in a datagram, or once per fragment if it doesn't - returns false (sending nothing) if it would take more than 65535 fragments
+		template<typename SendFunc>
+		bool Send(const std::vector<std::uint8_t>& _packet, SendFunc&& _send)
+		{
+			if (_packet.size() <= m_maxDatagramSize)
+			{
+				_send(_packet.data(), _packet.size());
+				return true;
+			}
+
+			const std::size_t fragmentSize{ std::min<std::size_t>(m_maxDatagramSize - HEADER_SIZE, std::numeric_limits<std::uint16_t>::max()) };
+			const std::size_t fragmentCount{ (_packet.size() + fragmentSize - 1) / fragmentSize };
+			if (fragmentCount > std::numeric_limits<std::uint16_t>::max()) { return false; }
+
+			const std::uint16_t messageID{ m_nextMessageID++ };
+			for (std::size_t i{ 0 }; i < fragmentCount; ++i)
+			{
+				m_fragment.clear();
+				PacketHeader::Write(m_fragment, PACKET_CODE::FRAGMENT);
+				WriteUInt16(messageID);
+				WriteUInt16(static_cast<std::uint16_t>(i));
+				WriteUInt16(static_cast<std::uint16_t>(fragmentCount));
+				WriteUInt16(static_cast<std::uint16_t>(fragmentSize));
+				const std::size_t offset{ i * fragmentSize };
+				m_fragment.insert(m_fragment.end(), _packet.begin() + offset, _packet.begin() + std::min(offset + fragmentSize, _packet.size()));
+				_send(m_fragment.data(), m_fragment.size());
+			}
+			return true;
+		}
+
+		[[nodiscard]] inline std::size_t GetMaxDatagramSize() const { return m_maxDatagramSize; }
+
+
+	private:
+		inline void WriteUInt16(const std::uint16_t _value)
+		{
+			m_fragment.push_back(static_cast<std::uint8_t>(_value >> 8));
+			m_fragment.push_back(static_cast<std::uint8_t>(_value));
+		}
+
+
+		std::size_t m_maxDatagramSize;
+		std::uint16_t m_nextMessageID;
+		std::vector<std::uint8_t> m_fragment; //Reused for every fragment
+	};
+
+}
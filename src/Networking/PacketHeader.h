@@ -0,0 +1,28 @@
+#pragma once
+
+#include <Types/NekiTypes.h>
+
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace NK
+{
+
+	//The PACKET_CODE every packet starts with, written the same way sf::Packet's operator<< writes it (big-endian) - so a packet built straight into a byte buffer and sent raw reads back on the other end exactly like one built with an sf::Packet
+	class PacketHeader final
+	{
+	public:
+		inline static void Write(std::vector<std::uint8_t>& _buffer, const PACKET_CODE _code)
+		{
+			std::underlying_type_t<PACKET_CODE> value{ std::to_underlying(_code) };
+			if constexpr (std::endian::native == std::endian::little) { value = std::byteswap(value); }
+			const std::uint8_t* bytes{ reinterpret_cast<const std::uint8_t*>(&value) };
+			_buffer.insert(_buffer.end(), bytes, bytes + sizeof(value));
+		}
+	};
+
+}
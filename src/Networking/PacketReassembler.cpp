@@ -0,0 +1,142 @@
+#include "PacketReassembler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+
+namespace NK
+{
+
+	namespace
+	{
+		//Big-endian, see PacketFragmenter
+		[[nodiscard]] std::uint16_t ReadUInt16(const std::uint8_t* _data)
+		{
+			return static_cast<std::uint16_t>((_data[0] << 8) | _data[1]);
+		}
+	}
+
+
+
+	PacketReassembler::PacketReassembler(const std::size_t _maxPacketSize, const std::size_t _maxPendingPackets, const double _timeout)
+	: m_maxPacketSize(_maxPacketSize), m_timeout(_timeout), m_pending(_maxPendingPackets), m_completed{}, m_completedCount(0), m_droppedPackets(0), m_malformedFragments(0)
+	{
+		if (_maxPendingPackets == 0)
+		{
+			throw std::runtime_error("PacketReassembler::PacketReassembler() - _maxPendingPackets must be at least 1");
+		}
+	}
+
+
+
+	bool PacketReassembler::Add(const std::uint8_t* _data, const std::size_t _size, const double _time, std::vector<std::uint8_t>& _packet)
+	{
+		ExpireOld(_time);
+
+		constexpr std::size_t headerSize{ 4 * sizeof(std::uint16_t) };
+		if (_size <= headerSize)
+		{
+			++m_malformedFragments;
+			return false;
+		}
+		const std::uint16_t messageID{ ReadUInt16(_data) };
+		const std::uint16_t index{ ReadUInt16(_data + 2) };
+		const std::uint16_t fragmentCount{ ReadUInt16(_data + 4) };
+		const std::uint16_t fragmentSize{ ReadUInt16(_data + 6) };
+		const std::uint8_t* payload{ _data + headerSize };
+		const std::size_t payloadSize{ _size - headerSize };
+
+		//Every fragment but the last is exactly fragmentSize, the last is no bigger
+		const bool last{ index + 1u == fragmentCount };
+		if (fragmentCount < 2 || index >= fragmentCount || fragmentSize == 0 || static_cast<std::size_t>(fragmentCount) * fragmentSize > m_maxPacketSize + fragmentSize - 1 ||
+			(last ? payloadSize > fragmentSize : payloadSize != fragmentSize))
+		{
+			++m_malformedFragments;
+			return false;
+		}
+
+
+		//Find the packet this is part of, or start a new one - in a free slot if there is one, otherwise in place of the oldest
+		std::vector<PendingPacket>::iterator pending{ std::ranges::find_if(m_pending, [&](const PendingPacket& _p) { return _p.active && _p.messageID == messageID; }) };
+		if (pending != m_pending.end() && (pending->fragmentCount != fragmentCount || pending->fragmentSize != fragmentSize))
+		{
+			//Message ids wrap around - a different layout means this is a new packet with an old id, and the old one's never going to finish
+			pending->active = false;
+			++m_droppedPackets;
+			pending = m_pending.end();
+		}
+		if (pending == m_pending.end())
+		{
+			const std::array<std::uint16_t, 16>::const_iterator completedEnd{ m_completed.begin() + std::min(m_completedCount, m_completed.size()) };
+			if (std::find(m_completed.cbegin(), completedEnd, messageID) != completedEnd) { return false; } //Late duplicate of one that's already done
+
+			pending = std::ranges::find_if(m_pending, [](const PendingPacket& _p) { return !_p.active; });
+			if (pending == m_pending.end())
+			{
+				pending = std::ranges::min_element(m_pending, {}, &PendingPacket::startTime);
+				++m_droppedPackets;
+			}
+			pending->active = true;
+			pending->messageID = messageID;
+			pending->fragmentCount = fragmentCount;
+			pending->fragmentSize = fragmentSize;
+			pending->fragmentsReceived = 0;
+			pending->size = 0;
+			pending->startTime = _time;
+			pending->data.resize(static_cast<std::size_t>(fragmentCount) * fragmentSize);
+			pending->received.assign(fragmentCount, false);
+		}
+
+		if (pending->received[index]) { return false; } //Duplicate
+		pending->received[index] = true;
+		++pending->fragmentsReceived;
+		std::memcpy(pending->data.data() + static_cast<std::size_t>(index) * fragmentSize, payload, payloadSize);
+		if (last) { pending->size = static_cast<std::size_t>(index) * fragmentSize + payloadSize; }
+		if (pending->fragmentsReceived < pending->fragmentCount) { return false; }
+
+
+		//Done - hand it over, and take the caller's old buffer in exchange to reuse
+		pending->data.resize(pending->size);
+		std::swap(pending->data, _packet);
+		pending->active = false;
+		m_completed[m_completedCount++ % m_completed.size()] = messageID;
+		return true;
+	}
+
+
+
+	void PacketReassembler::Clear()
+	{
+		for (PendingPacket& pending : m_pending) { pending.active = false; }
+		m_completedCount = 0;
+	}
+
+
+
+	std::size_t PacketReassembler::GetPendingBytes() const
+	{
+		std::size_t bytes{ 0 };
+		for (const PendingPacket& pending : m_pending)
+		{
+			if (pending.active) { bytes += pending.data.size(); }
+		}
+		return bytes;
+	}
+
+
+
+	void PacketReassembler::ExpireOld(const double _time)
+	{
+		for (PendingPacket& pending : m_pending)
+		{
+			if (pending.active && _time - pending.startTime > m_timeout)
+			{
+				pending.active = false;
+				++m_droppedPackets;
+			}
+		}
+	}
+
+}
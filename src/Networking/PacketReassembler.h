@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace NK
+{
+
+	//Puts packets split up by a PacketFragmenter back together, for one sender
+	//Fragments can arrive in any order, duplicated, or not at all - a packet that's missing pieces for longer than the timeout is given up on (UDP's on the hook for it either way, and whatever it held will be out of date by then)
+	//Memory is bounded - at most _maxPendingPackets are put together at once (starting another drops the oldest), none bigger than _maxPacketSize - so a sender can't make it allocate without limit by starting packets it never finishes
+	class PacketReassembler final
+	{
+	public:
+		explicit PacketReassembler(std::size_t _maxPacketSize, std::size_t _maxPendingPackets, double _timeout);
+
+		//_data / _size are one PACKET_CODE::FRAGMENT datagram, from just after the PACKET_CODE - _time is the current time in seconds (e.g. TimeManager::GetTotalTime())
+		//Returns true when that fragment completes a packet, which is swapped into _packet - hand the same vector back in each time and nothing needs allocating once it's grown
+		[[nodiscard]] bool Add(const std::uint8_t* _data, std::size_t _size, double _time, std::vector<std::uint8_t>& _packet);
+		//Drops everything part-way through
+		void Clear();
+
+		//Packets given up on (timed out or pushed out by newer ones) and fragments that didn't make sense, since construction
+		[[nodiscard]] inline std::size_t GetDroppedPacketCount() const { return m_droppedPackets; }
+		[[nodiscard]] inline std::size_t GetMalformedFragmentCount() const { return m_malformedFragments; }
+		[[nodiscard]] std::size_t GetPendingBytes() const;
+
+
+	private:
+		struct PendingPacket
+		{
+			bool active{ false };
+			std::uint16_t messageID{ 0 };
+			std::uint16_t fragmentCount{ 0 };
+			std::uint16_t fragmentSize{ 0 };
+			std::uint16_t fragmentsReceived{ 0 };
+			std::size_t size{ 0 }; //Only known once the last fragment arrives
+			double startTime{ 0.0 };
+			std::vector<std::uint8_t> data;
+			std::vector<bool> received;
+		};
+
+
+		void ExpireOld(double _time);
+
+
+		std::size_t m_maxPacketSize;
+		double m_timeout;
+		std::vector<PendingPacket> m_pending; //Fixed size - inactive slots keep their buffers for reuse
+		std::array<std::uint16_t, 16> m_completed; //Ring of the last few message ids put together - so a duplicate fragment turning up late doesn't start the packet all over again
+		std::size_t m_completedCount;
+		std::size_t m_droppedPackets;
+		std::size_t m_malformedFragments;
+	};
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <SFML/Network.hpp>
+
+#include <streambuf>
+
+
+namespace NK
+{
+
+	//std::streambufs over an sf::Packet, so cereal can archive straight into / out of one for payloads too irregular to bit-pack by hand (e.g. events)
+	//Saves going through a std::stringstream and copying its contents out (or in) on the way
+	//Usage: PacketOutputStreamBuf buf{ packet }; std::ostream stream{ &buf }; cereal::BinaryOutputArchive archive(stream);
+
+
+	//Appends everything written to it onto the end of the packet
+	class PacketOutputStreamBuf final : public std::streambuf
+	{
+	public:
+		explicit PacketOutputStreamBuf(sf::Packet& _packet) : m_packet(_packet) {}
+
+
+	protected:
+		inline virtual std::streamsize xsputn(const char* _data, const std::streamsize _size) override
+		{
+			m_packet.append(_data, static_cast<std::size_t>(_size));
+			return _size;
+		}
+
+		inline virtual int_type overflow(const int_type _c) override
+		{
+			if (traits_type::eq_int_type(_c, traits_type::eof())) { return traits_type::not_eof(_c); }
+			const char c{ traits_type::to_char_type(_c) };
+			m_packet.append(&c, 1);
+			return _c;
+		}
+
+
+	private:
+		sf::Packet& m_packet;
+	};
+
+
+	//Reads the packet's data from its current read position onwards, in place - the packet must outlive it and not be modified in the meantime
+	class PacketInputStreamBuf final : public std::streambuf
+	{
+	public:
+		explicit PacketInputStreamBuf(const sf::Packet& _packet)
+		{
+			//std::streambuf's get area is non-const, but nothing here writes through it
+			char* begin{ const_cast<char*>(static_cast<const char*>(_packet.getData())) };
+			setg(begin + _packet.getReadPosition(), begin + _packet.getReadPosition(), begin + _packet.getDataSize());
+		}
+	};
+
+}
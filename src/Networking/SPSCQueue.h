@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+
+namespace NK
+{
+
+	//Fixed-capacity lock-free ring for handing things from exactly one producer thread to exactly one consumer thread
+	//Slots are filled and read in place and never destroyed, so a T that owns memory (e.g. a byte vector) keeps its capacity from lap to lap and nothing allocates once they've all grown
+	//Each side keeps a cached copy of the other side's index and only reloads it when the ring looks full / empty, so the cache line holding it isn't bounced between cores on every push and pop
+	template<typename T>
+	class SPSCQueue final
+	{
+	public:
+		//_capacity is rounded up to a power of 2
+		explicit SPSCQueue(const std::size_t _capacity)
+		: m_capacity(std::bit_ceil(std::max<std::size_t>(_capacity, 2))), m_mask(m_capacity - 1), m_slots(std::make_unique<T[]>(m_capacity)) {}
+
+		SPSCQueue(const SPSCQueue&) = delete;
+		SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+
+		//Producer only - the slot to fill in, or nullptr if the ring is full
+		//Whatever was in it last lap is still there, so overwrite all of it - it isn't handed over until Push()
+		[[nodiscard]] T* BeginPush()
+		{
+			const std::uint64_t head{ m_head.load(std::memory_order_relaxed) };
+			if (head - m_cachedTail >= m_capacity)
+			{
+				m_cachedTail = m_tail.load(std::memory_order_acquire);
+				if (head - m_cachedTail >= m_capacity) { return nullptr; }
+			}
+			return &m_slots[head & m_mask];
+		}
+
+		//Producer only - hands over the slot from the last BeginPush()
+		void Push()
+		{
+			m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+
+		//Consumer only - the oldest slot that's been pushed, or nullptr if there isn't one
+		[[nodiscard]] T* Front()
+		{
+			const std::uint64_t tail{ m_tail.load(std::memory_order_relaxed) };
+			if (tail == m_cachedHead)
+			{
+				m_cachedHead = m_head.load(std::memory_order_acquire);
+				if (tail == m_cachedHead) { return nullptr; }
+			}
+			return &m_slots[tail & m_mask];
+		}
+
+		//Consumer only - hands the slot from Front() back to the producer
+		void Pop()
+		{
+			m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+
+		[[nodiscard]] inline std::size_t GetCapacity() const { return m_capacity; }
+
+
+	private:
+		const std::size_t m_capacity;
+		const std::size_t m_mask;
+		std::unique_ptr<T[]> m_slots;
+
+		alignas(64) std::atomic<std::uint64_t> m_head{ 0 }; //Next slot to be pushed
+		std::uint64_t m_cachedTail{ 0 }; //Producer's copy of m_tail
+		alignas(64) std::atomic<std::uint64_t> m_tail{ 0 }; //Next slot to be popped
+		std::uint64_t m_cachedHead{ 0 }; //Consumer's copy of m_head
+	};
+
+}
@@ -0,0 +1,107 @@
+#include "SocketPoller.h"
+
+#include <algorithm>
+#include <stdexcept>
+#if defined(__linux__)
+	#include <unistd.h>
+#endif
+
+
+namespace NK
+{
+
+	namespace
+	{
+		//sf::Socket::getNativeHandle() is protected - naming it through a derived class gets a pointer to it that works on any sf::Socket
+		struct NativeHandleAccess : sf::Socket
+		{
+			[[nodiscard]] static sf::SocketHandle Get(const sf::Socket& _socket) { return (_socket.*(&NativeHandleAccess::getNativeHandle))(); }
+		};
+	}
+
+
+
+	SocketPoller::SocketPoller()
+	{
+		#if defined(__linux__)
+			m_epoll = epoll_create1(EPOLL_CLOEXEC);
+			if (m_epoll == -1)
+			{
+				throw std::runtime_error("SocketPoller::SocketPoller() - epoll_create1() failed");
+			}
+		#endif
+	}
+
+
+
+	SocketPoller::~SocketPoller()
+	{
+		#if defined(__linux__)
+			close(m_epoll);
+		#endif
+	}
+
+
+
+	bool SocketPoller::Add(sf::Socket& _socket, const std::uint64_t _id)
+	{
+		#if defined(__linux__)
+			epoll_event event{};
+			event.events = EPOLLIN | EPOLLRDHUP;
+			event.data.u64 = _id;
+			if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, NativeHandleAccess::Get(_socket), &event) != 0) { return false; }
+		#else
+			m_selector.add(_socket);
+		#endif
+
+		m_sockets.emplace_back(&_socket, _id);
+		return true;
+	}
+
+
+
+	void SocketPoller::Remove(sf::Socket& _socket)
+	{
+		const std::vector<std::pair<sf::Socket*, std::uint64_t>>::iterator it{ std::ranges::find(m_sockets, &_socket, &std::pair<sf::Socket*, std::uint64_t>::first) };
+		if (it == m_sockets.end()) { return; }
+
+		#if defined(__linux__)
+			epoll_ctl(m_epoll, EPOLL_CTL_DEL, NativeHandleAccess::Get(_socket), nullptr);
+		#else
+			m_selector.remove(_socket);
+		#endif
+
+		//Order doesn't matter
+		*it = m_sockets.back();
+		m_sockets.pop_back();
+	}
+
+
+
+	std::size_t SocketPoller::Wait(const sf::Time _timeout, std::vector<std::uint64_t>& _ready)
+	{
+		_ready.clear();
+		if (m_sockets.empty()) { return 0; }
+
+		#if defined(__linux__)
+
+			//Room for every socket to be ready at once, so nothing's left for next time
+			m_events.resize(m_sockets.size());
+			const int count{ epoll_wait(m_epoll, m_events.data(), static_cast<int>(m_events.size()), static_cast<int>(_timeout.asMilliseconds())) };
+			for (int i{ 0 }; i < count; ++i) { _ready.push_back(m_events[i].data.u64); }
+
+		#else
+
+			//sf::SocketSelector::wait() treats sf::Time::Zero as "forever"
+			if (!m_selector.wait(_timeout == sf::Time::Zero ? sf::microseconds(1) : _timeout)) { return 0; }
+			for (const std::pair<sf::Socket*, std::uint64_t>& socket : m_sockets)
+			{
+				if (m_selector.isReady(*socket.first)) { _ready.push_back(socket.second); }
+			}
+
+		#endif
+
+		return _ready.size();
+	}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <SFML/Network.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#if defined(__linux__)
+	#include <sys/epoll.h>
+#endif
+
+
+namespace NK
+{
+
+	//Finds out which of a set of sockets have something waiting (data, a connection to accept, or the other end hanging up) in a single call, so only those need touching
+	//On linux it's epoll, which costs next to nothing for sockets that aren't ready and has no limit on how many there are - everywhere else it falls back to sf::SocketSelector (select()), which is still one call but checks every socket, and on some platforms can't go past 1024 of them
+	//Level triggered - a socket that still has something waiting after Wait() comes back again next time
+	class SocketPoller final
+	{
+	public:
+		SocketPoller();
+		~SocketPoller();
+
+		SocketPoller(const SocketPoller&) = delete;
+		SocketPoller& operator=(const SocketPoller&) = delete;
+
+		//_id is what Wait() hands back when _socket is ready - _socket has to stay where it is until it's removed
+		//Returns false if it couldn't be added
+		[[nodiscard]] bool Add(sf::Socket& _socket, std::uint64_t _id);
+		//Call before _socket is closed or destroyed
+		void Remove(sf::Socket& _socket);
+
+		//Waits up to _timeout (sf::Time::Zero = don't wait, just check) for any sockets to be ready, and fills _ready with their ids - returns how many
+		std::size_t Wait(sf::Time _timeout, std::vector<std::uint64_t>& _ready);
+
+		[[nodiscard]] inline std::size_t GetSocketCount() const { return m_sockets.size(); }
+
+
+	private:
+		std::vector<std::pair<sf::Socket*, std::uint64_t>> m_sockets;
+
+		#if defined(__linux__)
+			int m_epoll;
+			std::vector<epoll_event> m_events; //Scratch space for epoll_wait()
+		#else
+			sf::SocketSelector m_selector;
+		#endif
+	};
+
+}
@@ -23,7 +23,8 @@ namespace NK
 		{
 			const Entity e1{ static_cast<Entity>(_inBody1.GetUserData()) };
 			const Entity e2{ static_cast<Entity>(_inBody2.GetUserData()) };
-			EventManager::Trigger(CollisionEvent{ e1, e2 });
+			//Called from jolt's worker threads mid-step - queue the event, it gets dispatched on the main thread once the layer phase finishes
+			EventManager::Enqueue(CollisionEvent{ e1, e2 });
 		}
 	};
 	
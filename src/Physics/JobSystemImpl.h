@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Core/Jobs/JobSystem.h>
+#ifdef AddJob
+	#undef AddJob
+#endif
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+
+
+namespace NK
+{
+
+	//Runs Jolt's jobs on the engine's JobSystem so physics shares its workers rather than spinning up a thread pool of its own
+	//Barriers come from JPH::JobSystemWithBarrier - a thread waiting on one runs the barrier's jobs itself where it can, same as with Jolt's own thread pool
+	class JobSystemImpl final : public JPH::JobSystemWithBarrier
+	{
+	public:
+		explicit JobSystemImpl(JobSystem& _jobSystem, const JPH::uint _maxBarriers)
+		: JPH::JobSystemWithBarrier(_maxBarriers), m_jobSystem(_jobSystem) {}
+
+
+		inline virtual int GetMaxConcurrency() const override
+		{
+			return static_cast<int>(m_jobSystem.GetWorkerCount()) + 1;
+		}
+
+
+		inline virtual JobHandle CreateJob(const char* _name, const JPH::ColorArg _colour, const JobFunction& _function, const JPH::uint32 _numDependencies = 0) override
+		{
+			Job* const job{ new Job(_name, _colour, this, _function, _numDependencies) };
+
+			//Handle holds a reference, the job could finish (and be freed) as soon as it's queued
+			JobHandle handle{ job };
+
+			//Jobs with dependencies get queued by Jolt once the last one is removed
+			if (_numDependencies == 0) { QueueJob(job); }
+
+			return handle;
+		}
+
+
+	protected:
+		inline virtual void QueueJob(Job* _job) override
+		{
+			//Reference is released once the job has run
+			_job->AddRef();
+			m_jobSystem.Run([_job]()
+			{
+				_job->Execute();
+				_job->Release();
+			});
+		}
+
+
+		inline virtual void QueueJobs(Job** _jobs, const JPH::uint _numJobs) override
+		{
+			for (JPH::uint i{ 0 }; i < _numJobs; ++i)
+			{
+				QueueJob(_jobs[i]);
+			}
+		}
+
+
+		inline virtual void FreeJob(Job* _job) override
+		{
+			delete _job;
+		}
+
+
+	private:
+		JobSystem& m_jobSystem;
+	};
+
+}
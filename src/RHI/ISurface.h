@@ -2,12 +2,18 @@
 
 #include "IDevice.h"
 
-#include <Graphics/Window.h>
+#ifndef NEKI_HEADLESS
+	#include <Graphics/Window.h>
+#endif
 
 
 namespace NK
 {
 	
+	#ifdef NEKI_HEADLESS
+		class Window; //No windows (or glfw) in headless builds - surfaces are never created there, but the header stays includable
+	#endif
+	
 	class ISurface
 	{
 	public:
@@ -497,6 +497,9 @@ namespace NK
 		ENGINE,
 		CONTEXT,
 		TRACKING_ALLOCATOR,
+		JOB_SYSTEM,
+		PROFILER,
+		REPLAY,
 
 		RENDER_LAYER,
 		CLIENT_NETWORK_LAYER,
@@ -527,12 +530,37 @@ namespace NK
 		GPU_UPLOADER,
 		WINDOW,
 		
-		APPLICATION,
+		APPLICATION, //Must stay last - LOGGER_LAYER_COUNT depends on it
 	};
+	inline constexpr std::size_t LOGGER_LAYER_COUNT{ static_cast<std::size_t>(LOGGER_LAYER::APPLICATION) + 1 };
 	
 	enum class LOGGER_TYPE
 	{
 		CONSOLE,
+		ASYNC_CONSOLE, //Same output as CONSOLE, but formatting and writing happen on a background thread
+		BINARY, //Compact binary records written to memory-mapped rotating files - decode them with the NekiLogDecoder tool
+	};
+
+	//What an asynchronous logger does when its ring buffer is full
+	enum class LOGGER_OVERFLOW_POLICY
+	{
+		DROP,	//Discard the message (the number of dropped messages is reported once there's room again)
+		BLOCK,	//Wait for the background thread to make room
+	};
+
+	struct AsyncLoggerConfig
+	{
+		std::uint32_t capacity{ 8192 }; //Number of ring buffer slots, rounded up to a power of 2 - long messages take multiple slots
+		LOGGER_OVERFLOW_POLICY overflowPolicy{ LOGGER_OVERFLOW_POLICY::DROP }; //Errors are never dropped, regardless of policy
+	};
+
+	struct BinaryLoggerConfig
+	{
+		std::string directory{ "Logs" }; //Created if it doesn't exist
+		std::string baseName{ "neki" }; //Files are named <baseName>_<start time>_<index>.nklog
+		std::uint64_t fileSize{ 64ull * 1024 * 1024 }; //Size each file is mapped at - a file is rotated once the next record doesn't fit, and shrunk to what was actually written
+		std::uint32_t maxFiles{ 8 }; //Number of finished files kept on disk (not counting the one being written) - the oldest are deleted past this, 0 keeps everything
+		bool mirrorErrorsToConsole{ true }; //Errors are usually followed by a throw, so it's handy to see them without decoding the log
 	};
 	
 	enum class TRACKING_ALLOCATOR_VERBOSITY_FLAGS : std::uint32_t
@@ -562,6 +590,20 @@ namespace NK
 		TrackingAllocatorConfig trackingAllocator;
 	};
 
+	struct JobSystemConfig
+	{
+		std::uint32_t workerCount{ 0 }; //Number of worker threads - 0 uses one per hardware thread, minus one for the main thread
+		std::uint32_t dequeCapacity{ 4096 }; //Per-thread job deque size, must be a power of 2 - jobs submitted while the deque is full go through a shared queue instead
+	};
+
+	//Each path can also be set with an environment variable (NEKI_REPLAY_RECORD / NEKI_REPLAY_PLAYBACK, and NEKI_REPLAY_FAST=1), which takes priority - so any build can record or replay without being changed
+	struct ReplayConfig
+	{
+		std::string recordPath; //Record each frame's timing, inputs and received network packets to this file (see Replay) - empty to not record
+		std::string playbackPath; //Play back a recording instead of reading real time, input and sockets - the application shuts down when it runs out. Empty to not play back
+		bool asFastAsPossible{ false }; //Run playback frames back-to-back rather than at the pace they were recorded at
+	};
+
 	enum class ALLOCATION_SOURCE
 	{
 		UNKNOWN,
@@ -610,19 +652,29 @@ namespace NK
 	};
 
 	typedef std::uint32_t ClientIndex;
+
+	//IP + port, packed into one integer - hashing and comparing it is as cheap as it gets, and the sf::IpAddress to send to comes straight back out of it without resolving anything
+	//IPv4 only, like sf::IpAddress
+	struct NetworkEndpoint
+	{
+		NetworkEndpoint() = default;
+		NetworkEndpoint(const sf::IpAddress& _address, const unsigned short _port) : key((static_cast<std::uint64_t>(_address.toInteger()) << 16) | _port) {}
+
+		[[nodiscard]] inline sf::IpAddress GetAddress() const { return sf::IpAddress(static_cast<std::uint32_t>(key >> 16)); }
+		[[nodiscard]] inline unsigned short GetPort() const { return static_cast<unsigned short>(key); }
+		[[nodiscard]] inline bool operator==(const NetworkEndpoint& _other) const = default;
+
+		std::uint64_t key{ 0 }; //Address in the top 48 bits (only 32 used), port in the bottom 16
+	};
 }
 
 
-//std::pair doesn't have a default hashing function for whatever reason
-//Solution adapted from https://stackoverflow.com/a/17017281
-typedef std::pair<std::string, std::uint32_t> UniqueAddress; //IP + port
 template<>
-struct std::hash<UniqueAddress>
+struct std::hash<NK::NetworkEndpoint>
 {
-	[[nodiscard]] inline std::size_t operator()(const UniqueAddress& _key) const noexcept
+	[[nodiscard]] inline std::size_t operator()(const NK::NetworkEndpoint& _endpoint) const noexcept
 	{
-		//Compute individual hash values for first and second and combine them using XOR and bit shifting
-		return (std::hash<std::string>{}(_key.first) ^ (std::hash<std::uint32_t>()(_key.second)) << 1);
+		return std::hash<std::uint64_t>{}(_endpoint.key);
 	}
 };
 
@@ -652,6 +704,7 @@ namespace NK
 		SERVER__FAILED_TO_SEND_CLIENT_INDEX_PACKET,
 		SERVER__UDP_FAILED_TO_RECEIVE_PACKET,
 		SERVER__HOST_CALLED_ON_HOSTING_SERVER,
+		SERVER__FAILED_TO_POLL_TCP_LISTENER,
 		
 		CLIENT__INVALID_SERVER_IP_ADDRESS,
 		CLIENT__SERVER_CONNECTION_TIMED_OUT,
@@ -666,13 +719,26 @@ namespace NK
 	{
 		//TCP
 		DISCONNECT,
-		EVENT,
 		ENTITY_SPAWN,
 
 		//UDP
 		UDP_PORT,
 		INPUT,
-		TRANSFORM, //lazy workaround - find a better way of sending a registry diff between start and end of frame
+		TRANSFORM, //Delta-compressed transform snapshot (see NetworkTransformCodec)
+		SNAPSHOT_ACK, //Client -> server, the sequence number of the last transform snapshot it applied
+		FRAGMENT, //One piece of a packet too big for a single datagram (see PacketFragmenter / PacketReassembler)
+		MESSAGES, //Acks and channel messages (see NetworkConnection), then the packet they're riding on, if there is one
+
+		//Channel messages (inside a MESSAGES packet)
+		EVENT, //Type registry constant for the event type then the event data itself (see CNetworkEvent)
+		RELEVANCY, //Server -> client, the entities that have come into / gone out of the client's area of interest (see ServerNetworkLayerDesc::interestRadius)
+	};
+
+	enum class NETWORK_CHANNEL : std::uint8_t
+	{
+		UNRELIABLE, //Might not arrive, might arrive out of order
+		UNRELIABLE_SEQUENCED, //Might not arrive - anything older than what's already arrived is thrown away
+		RELIABLE_ORDERED, //Always arrives, in the order it was sent
 	};
 
 	enum class CLIENT_STATE
@@ -781,22 +847,14 @@ namespace NK
 		POST_APP,
 	};
 
-	struct NetworkInputData
-	{
-		Entity entity;
-		std::unordered_map<ActionTypeMapKey, INPUT_STATE_VARIANT> actionStates;
-	};
-	SERIALISE(NetworkInputData, v.entity, v.actionStates)
-
-	//todo: this is just a hacky test to see if it works - find a better way to serialise a registry diff between start and end of frame
-	struct NetworkTransformData
+	//The four points in a frame that an Application's layers get run at
+	enum class LAYER_PHASE
 	{
-		Entity entity;
-		glm::vec3 pos;
-		glm::vec3 rot; //Euler in radians
-		glm::vec3 scale;
+		PRE_APP_FIXED_UPDATE,
+		PRE_APP_UPDATE,
+		POST_APP_FIXED_UPDATE,
+		POST_APP_UPDATE,
 	};
-	SERIALISE(NetworkTransformData, v.entity, v.pos, v.rot, v.scale)
 
 	enum class RESOURCE_ACCESS_TYPE
 	{
@@ -834,6 +892,11 @@ namespace NK
 	{
 		std::vector<PhysicsObjectLayer> objectLayers;
 		std::unordered_map<PhysicsObjectLayer, std::vector<PhysicsObjectLayer>> objectLayerCollisionPartners; //For any given object layer, stores a vector of all the other object layers that it can collide with
+		
+		//Jolt's fixed capacities - bodies past maxBodies fail to be created, pairs / contacts past the others are dropped. Default: 1024 each
+		std::uint32_t maxBodies{ 1024 };
+		std::uint32_t maxBodyPairs{ 1024 };
+		std::uint32_t maxContactConstraints{ 1024 };
 	};
 	
 	
@@ -914,6 +977,13 @@ namespace NK
 	{
 		
 	};
+
+	//Triggered on a client when an entity comes into (relevant = true) or goes out of its area of interest on the server - while it's out, the server stops sending its transform
+	struct NetworkRelevancyEvent
+	{
+		Entity entity;
+		bool relevant;
+	};
 	
 	static const PhysicsBroadPhaseLayer DynamicBroadPhaseLayer{ 0 };
 	static const PhysicsBroadPhaseLayer KinematicBroadPhaseLayer{ 1 };